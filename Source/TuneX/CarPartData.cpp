@@ -0,0 +1,355 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "CarPartData.h"
+#include "VehicleCatalogManifest.h"
+#include "Hash/CityHash.h"
+#include "Serialization/ObjectWriter.h"
+
+FOnVehicleCatalogEdited UVehicleConfigDataAsset::OnContentEdited;
+
+namespace CarPartData
+{
+	/**
+	 * Hashes every property of a struct; soft references and names go in as strings
+	 */
+	static uint64 HashStruct(const UScriptStruct& Struct, const void* Data, TArray<uint8>& Scratch)
+	{
+		Scratch.Reset();
+		FObjectWriter Writer(Scratch);
+		Struct.SerializeBin(Writer, const_cast<void*>(Data));
+		return CityHash64(reinterpret_cast<const char*>(Scratch.GetData()), Scratch.Num());
+	}
+
+	static void DiffEntries(TConstArrayView<uint64> Before, TConstArrayView<uint64> After, TBitArray<>& OutChanged)
+	{
+		const int32 NumEntries = FMath::Max(Before.Num(), After.Num());
+		OutChanged.Init(false, NumEntries);
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			if (!Before.IsValidIndex(Index) || !After.IsValidIndex(Index) || Before[Index] != After[Index])
+			{
+				OutChanged[Index] = true;
+			}
+		}
+	}
+}
+
+const TCHAR* LexToString(EVehiclePartSlot Slot)
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::FrontBumper:	return TEXT("FrontBumper");
+	case EVehiclePartSlot::RearBumper:	return TEXT("RearBumper");
+	case EVehiclePartSlot::SideSkirts:	return TEXT("SideSkirts");
+	case EVehiclePartSlot::Spoiler:		return TEXT("Spoiler");
+	case EVehiclePartSlot::Wheels:		return TEXT("Wheels");
+	default:							return TEXT("Invalid");
+	}
+}
+
+const TArray<FCarPart>& UVehicleConfigDataAsset::GetParts(EVehiclePartSlot Slot) const
+{
+	return const_cast<UVehicleConfigDataAsset*>(this)->GetParts(Slot);
+}
+
+TArray<FCarPart>& UVehicleConfigDataAsset::GetParts(EVehiclePartSlot Slot)
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::RearBumper:	return RearBumpers;
+	case EVehiclePartSlot::SideSkirts:	return SideSkirts;
+	case EVehiclePartSlot::Spoiler:		return Spoilers;
+	case EVehiclePartSlot::Wheels:		return Wheels;
+	default:
+		checkf(Slot == EVehiclePartSlot::FrontBumper, TEXT("Invalid part slot %d"), static_cast<int32>(Slot));
+		return FrontBumpers;
+	}
+}
+
+void UVehicleConfigDataAsset::GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const
+{
+	Super::GetAssetRegistryTags(OutTags);
+
+	OutTags.Add(FAssetRegistryTag(
+		FVehicleCatalogManifest::AssetRegistryTagName,
+		FVehicleCatalogManifest::FromConfig(*this).Encode(),
+		FAssetRegistryTag::TT_Hidden));
+}
+
+uint32 UVehicleConfigDataAsset::GetCatalogFingerprint() const
+{
+	if (CachedCatalogFingerprint != 0)
+	{
+		return CachedCatalogFingerprint;
+	}
+
+	// FName hashes differ between processes, so hash the ID strings instead
+	uint32 Crc = 0;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& SlotParts = GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		const int32 NumParts = SlotParts.Num();
+		Crc = FCrc::MemCrc32(&NumParts, sizeof(NumParts), Crc);
+		for (const FCarPart& Part : SlotParts)
+		{
+			Crc = FCrc::StrCrc32(*Part.PartID.ToString(), Crc);
+		}
+	}
+
+	const int32 NumPaints = PaintColors.Num();
+	Crc = FCrc::MemCrc32(&NumPaints, sizeof(NumPaints), Crc);
+	for (const FPaintColor& Paint : PaintColors)
+	{
+		Crc = FCrc::StrCrc32(*Paint.PaintID.ToString(), Crc);
+	}
+
+	CachedCatalogFingerprint = Crc != 0 ? Crc : 1;
+	return CachedCatalogFingerprint;
+}
+
+void FVehicleCatalogLookup::AddParts(EVehiclePartSlot Slot, TConstArrayView<FCarPart> Parts, int32 FirstIndex)
+{
+	TMap<FName, int32>& SlotIndices = PartIndices[static_cast<int32>(Slot)];
+	TMap<FName, TArray<int32>>& SlotTags = TaggedParts[static_cast<int32>(Slot)];
+	SlotIndices.Reserve(SlotIndices.Num() + Parts.Num() - FirstIndex);
+
+	for (int32 PartIndex = FirstIndex; PartIndex < Parts.Num(); ++PartIndex)
+	{
+		const FCarPart& Part = Parts[PartIndex];
+		if (!Part.PartID.IsNone() && !SlotIndices.Contains(Part.PartID))
+		{
+			SlotIndices.Add(Part.PartID, PartIndex);
+		}
+		for (const FName Tag : Part.CompatibilityTags)
+		{
+			SlotTags.FindOrAdd(Tag).Add(PartIndex);
+		}
+	}
+}
+
+void FVehicleCatalogLookup::AddPaints(TConstArrayView<FPaintColor> Paints, int32 FirstIndex)
+{
+	PaintIndices.Reserve(PaintIndices.Num() + Paints.Num() - FirstIndex);
+	for (int32 PaintIndex = FirstIndex; PaintIndex < Paints.Num(); ++PaintIndex)
+	{
+		if (!Paints[PaintIndex].PaintID.IsNone() && !PaintIndices.Contains(Paints[PaintIndex].PaintID))
+		{
+			PaintIndices.Add(Paints[PaintIndex].PaintID, PaintIndex);
+		}
+	}
+}
+
+const FVehicleCatalogLookup& UVehicleConfigDataAsset::GetLookup() const
+{
+	check(IsInGameThread());
+
+	if (!Lookup || Lookup->ContentRevision != ContentRevision)
+	{
+		Lookup = MakeUnique<FVehicleCatalogLookup>();
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+			Lookup->AddParts(Slot, GetParts(Slot), 0);
+		}
+		Lookup->AddPaints(PaintColors, 0);
+		Lookup->ContentRevision = ContentRevision;
+	}
+
+	return *Lookup;
+}
+
+int32 UVehicleConfigDataAsset::FindPartIndex(EVehiclePartSlot Slot, FName PartID) const
+{
+	const int32* Index = GetLookup().PartIndices[static_cast<int32>(Slot)].Find(PartID);
+	return Index ? *Index : INDEX_NONE;
+}
+
+int32 UVehicleConfigDataAsset::FindPaintIndex(FName PaintID) const
+{
+	const int32* Index = GetLookup().PaintIndices.Find(PaintID);
+	return Index ? *Index : INDEX_NONE;
+}
+
+TConstArrayView<int32> UVehicleConfigDataAsset::GetPartsWithTag(EVehiclePartSlot Slot, FName Tag) const
+{
+	const TArray<int32>* Parts = GetLookup().TaggedParts[static_cast<int32>(Slot)].Find(Tag);
+	return Parts ? TConstArrayView<int32>(*Parts) : TConstArrayView<int32>();
+}
+
+void UVehicleConfigDataAsset::AppendContent(TArray<FCarPart> (&NewParts)[NumVehiclePartSlots], TArray<FPaintColor>& NewPaints)
+{
+	check(IsInGameThread());
+
+	// Extend the lookups only if they were current; otherwise they rebuild on next use anyway
+	FVehicleCatalogLookup* CurrentLookup = Lookup && Lookup->ContentRevision == ContentRevision ? Lookup.Get() : nullptr;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		TArray<FCarPart>& Parts = GetParts(Slot);
+		const int32 FirstIndex = Parts.Num();
+		Parts.Append(MoveTemp(NewParts[SlotIndex]));
+		if (CurrentLookup)
+		{
+			CurrentLookup->AddParts(Slot, Parts, FirstIndex);
+		}
+	}
+
+	const int32 FirstPaint = PaintColors.Num();
+	PaintColors.Append(MoveTemp(NewPaints));
+	if (CurrentLookup)
+	{
+		CurrentLookup->AddPaints(PaintColors, FirstPaint);
+	}
+
+	InvalidateCatalogFingerprint();
+	if (CurrentLookup)
+	{
+		CurrentLookup->ContentRevision = ContentRevision;
+	}
+}
+
+bool FVehicleCatalogChange::IsEmpty() const
+{
+	if (bCatalogWide || ChangedPaints.Contains(true))
+	{
+		return false;
+	}
+
+	for (const TBitArray<>& Bits : ChangedParts)
+	{
+		if (Bits.Contains(true))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int32 FVehicleCatalogChange::GetNumChangedEntries() const
+{
+	int32 NumChanged = ChangedPaints.CountSetBits();
+	for (const TBitArray<>& Bits : ChangedParts)
+	{
+		NumChanged += Bits.CountSetBits();
+	}
+	return NumChanged;
+}
+
+void UVehicleConfigDataAsset::HashEntries(FVehicleCatalogEntryHashes& OutHashes) const
+{
+	TArray<uint8> Scratch;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		TArray<uint64>& Hashes = OutHashes.Entries[SlotIndex];
+		Hashes.Reset(Parts.Num());
+		for (const FCarPart& Part : Parts)
+		{
+			Hashes.Add(CarPartData::HashStruct(*FCarPart::StaticStruct(), &Part, Scratch));
+		}
+	}
+
+	TArray<uint64>& PaintHashes = OutHashes.Entries[NumVehiclePartSlots];
+	PaintHashes.Reset(PaintColors.Num());
+	for (const FPaintColor& Paint : PaintColors)
+	{
+		PaintHashes.Add(CarPartData::HashStruct(*FPaintColor::StaticStruct(), &Paint, Scratch));
+	}
+
+	// Everything outside the entries in one hash
+	FName Tag = ChassisTag;
+	FVehiclePerformanceStats Stats = BaseStats;
+	int32 Defaults[] = { DefaultFrontBumperIndex, DefaultRearBumperIndex, DefaultPaintIndex };
+
+	Scratch.Reset();
+	FObjectWriter Writer(Scratch);
+	Writer << Tag;
+	FVehiclePerformanceStats::StaticStruct()->SerializeBin(Writer, &Stats);
+	for (int32& DefaultIndex : Defaults)
+	{
+		Writer << DefaultIndex;
+	}
+	OutHashes.CatalogWide = CityHash64(reinterpret_cast<const char*>(Scratch.GetData()), Scratch.Num());
+
+	OutHashes.ContentRevision = ContentRevision;
+}
+
+void UVehicleConfigDataAsset::PreContentEdit()
+{
+	// Interactive edits come here before every step; the baseline left by the last PostContentEdit still holds
+	if (EditBaseline && EditBaseline->ContentRevision == ContentRevision)
+	{
+		return;
+	}
+
+	if (!EditBaseline)
+	{
+		EditBaseline = MakeUnique<FVehicleCatalogEntryHashes>();
+	}
+	HashEntries(*EditBaseline);
+}
+
+void UVehicleConfigDataAsset::PostContentEdit()
+{
+	check(IsInGameThread());
+
+	InvalidateCatalogFingerprint();
+
+	TUniquePtr<FVehicleCatalogEntryHashes> Current = MakeUnique<FVehicleCatalogEntryHashes>();
+	HashEntries(*Current);
+
+	FVehicleCatalogChange Change;
+	for (int32 Kind = 0; Kind <= NumVehiclePartSlots; ++Kind)
+	{
+		const TConstArrayView<uint64> Before = EditBaseline ? TConstArrayView<uint64>(EditBaseline->Entries[Kind]) : TConstArrayView<uint64>();
+		CarPartData::DiffEntries(Before, Current->Entries[Kind], Kind < NumVehiclePartSlots ? Change.ChangedParts[Kind] : Change.ChangedPaints);
+	}
+	Change.bCatalogWide = !EditBaseline || EditBaseline->CatalogWide != Current->CatalogWide;
+
+	// The next edit diffs against this one
+	EditBaseline = MoveTemp(Current);
+
+	if (!Change.IsEmpty())
+	{
+		OnContentEdited.Broadcast(*this, Change);
+	}
+}
+
+void UVehicleConfigDataAsset::AdoptEditBaseline(UVehicleConfigDataAsset& Previous)
+{
+	Previous.PreContentEdit();
+	EditBaseline = MoveTemp(Previous.EditBaseline);
+	EditBaseline->ContentRevision = ContentRevision;
+}
+
+#if WITH_EDITOR
+void UVehicleConfigDataAsset::PreEditChange(FProperty* PropertyAboutToChange)
+{
+	Super::PreEditChange(PropertyAboutToChange);
+
+	PreContentEdit();
+}
+
+void UVehicleConfigDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	PostContentEdit();
+}
+
+void UVehicleConfigDataAsset::PreEditUndo()
+{
+	Super::PreEditUndo();
+
+	PreContentEdit();
+}
+
+void UVehicleConfigDataAsset::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	PostContentEdit();
+}
+#endif
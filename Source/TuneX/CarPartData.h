@@ -6,6 +6,115 @@
 #include "Engine/DataAsset.h"
 #include "CarPartData.generated.h"
 
+class UStaticMesh;
+
+/**
+ * Attachable part slots on a vehicle
+ * Paint is handled separately since it is an FPaintColor rather than an FCarPart
+ */
+UENUM(BlueprintType)
+enum class EVehiclePartSlot : uint8
+{
+	FrontBumper,
+	RearBumper,
+	SideSkirts,
+	Spoiler,
+	Wheels,
+	Count UMETA(Hidden)
+};
+
+/** Number of attachable part slots */
+static constexpr int32 NumVehiclePartSlots = static_cast<int32>(EVehiclePartSlot::Count);
+
+/** Short, stable name for a part slot (used in logs and reports) */
+TUNEX_API const TCHAR* LexToString(EVehiclePartSlot Slot);
+
+/**
+ * Performance figures: a part's deltas, a chassis' base values, or a vehicle's totals
+ */
+USTRUCT(BlueprintType)
+struct FVehiclePerformanceStats
+{
+	GENERATED_BODY()
+
+	// Mass in kg
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+	float Weight;
+
+	// Downforce coefficient
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+	float Downforce;
+
+	// Drag coefficient
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+	float Drag;
+
+	// Tyre grip multiplier contribution
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+	float Grip;
+
+	FVehiclePerformanceStats()
+		: Weight(0.0f)
+		, Downforce(0.0f)
+		, Drag(0.0f)
+		, Grip(0.0f)
+	{
+	}
+
+	FVehiclePerformanceStats& operator+=(const FVehiclePerformanceStats& Other)
+	{
+		Weight += Other.Weight;
+		Downforce += Other.Downforce;
+		Drag += Other.Drag;
+		Grip += Other.Grip;
+		return *this;
+	}
+};
+
+/**
+ * Properties of a part's mesh, baked by the TuneXBakePartMetadata commandlet
+ * Lets budgeting, placement and UI know a part's size and footprint without resolving MeshAsset.
+ */
+USTRUCT(BlueprintType)
+struct FCarPartMetadata
+{
+	GENERATED_BODY()
+
+	// Local bounds of the mesh
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metadata")
+	FBox Bounds = FBox(ForceInit);
+
+	// Estimated memory of the mesh, CPU and GPU, in bytes
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metadata")
+	int64 ResourceSizeBytes = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metadata")
+	int32 NumLODs = 0;
+
+	// Render sections of LOD 0
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metadata")
+	int32 NumSections = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Metadata")
+	int32 NumMaterialSlots = 0;
+
+	// Mesh the metadata was baked from, and the saved hash of its package at the time; empty until baked
+	UPROPERTY(VisibleAnywhere, Category = "Metadata")
+	FSoftObjectPath SourceMesh;
+
+	UPROPERTY(VisibleAnywhere, Category = "Metadata")
+	FString SourcePackageHash;
+
+	/**
+	 * Checks whether the metadata was baked from a mesh (it may still predate the mesh's last save; the
+	 * validation commandlet compares SourcePackageHash against the Asset Registry)
+	 */
+	bool IsBakedFor(const TSoftObjectPtr<UObject>& MeshAsset) const
+	{
+		return !SourcePackageHash.IsEmpty() && SourceMesh == MeshAsset.ToSoftObjectPath();
+	}
+};
+
 /**
  * Structure that defines a single car part with all its metadata
  * Used for bumpers, lights, wheels, interior components, etc.
@@ -28,9 +137,18 @@ struct FCarPart
 	float Price;
 
 	// Tags used for compatibility checking (e.g., "BMW_G82", "Front_Bumper")
+	// When the catalog has a ChassisTag, a tagged part only fits if its tags include it
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part")
 	TArray<FName> CompatibilityTags;
 
+	// Parts this part needs, by PartID: every slot mentioned must hold one of the parts listed for it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part|Rules")
+	TArray<FName> RequiresPartIDs;
+
+	// Parts that cannot be installed together with this one, by PartID (applies both ways)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part|Rules")
+	TArray<FName> ExcludesPartIDs;
+
 	// Optional material overrides for this part
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part")
 	TArray<TSoftObjectPtr<UMaterialInterface>> MaterialOverrides;
@@ -43,6 +161,18 @@ struct FCarPart
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part")
 	FName PartID;
 
+	// Optional low-detail stand-in shown while scrubbing through the catalog
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part")
+	TSoftObjectPtr<UStaticMesh> ProxyMesh;
+
+	// What installing this part adds to the vehicle's performance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Car Part")
+	FVehiclePerformanceStats Stats;
+
+	// Baked properties of MeshAsset (bounds, memory, LODs, sections)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Car Part|Metadata")
+	FCarPartMetadata Metadata;
+
 	FCarPart()
 		: Price(0.0f)
 		, PartID(NAME_None)
@@ -81,6 +211,78 @@ struct FPaintColor
 	}
 };
 
+/**
+ * Runtime lookups of one catalog: IDs to indices and compatibility tags to the parts carrying them
+ */
+struct FVehicleCatalogLookup
+{
+	// Index of each part ID (indexed by EVehiclePartSlot) and paint ID
+	TMap<FName, int32> PartIndices[NumVehiclePartSlots];
+	TMap<FName, int32> PaintIndices;
+
+	// Parts carrying each compatibility tag, ascending (indexed by EVehiclePartSlot)
+	TMap<FName, TArray<int32>> TaggedParts[NumVehiclePartSlots];
+
+	// UVehicleConfigDataAsset::GetContentRevision() the lookups match
+	uint32 ContentRevision = 0;
+
+	/**
+	 * Adds the entries of a slot from FirstIndex on; earlier entries keep their mapping (first ID wins)
+	 */
+	void AddParts(EVehiclePartSlot Slot, TConstArrayView<FCarPart> Parts, int32 FirstIndex);
+	void AddPaints(TConstArrayView<FPaintColor> Paints, int32 FirstIndex);
+};
+
+/**
+ * Which entries of a catalog an edit touched, by index (see UVehicleConfigDataAsset::PostContentEdit)
+ * An entry counts as changed when any of its properties differs, when it was added or removed, or when another
+ * entry moved into its index.
+ */
+struct TUNEX_API FVehicleCatalogChange
+{
+	// One bit per index, over the larger of the old and new counts (indexed by EVehiclePartSlot)
+	TBitArray<> ChangedParts[NumVehiclePartSlots];
+	TBitArray<> ChangedPaints;
+
+	// Something every vehicle depends on changed (chassis tag, base stats, defaults)
+	bool bCatalogWide = false;
+
+	bool IsPartChanged(EVehiclePartSlot Slot, int32 Index) const
+	{
+		const TBitArray<>& Bits = ChangedParts[static_cast<int32>(Slot)];
+		return Bits.IsValidIndex(Index) && Bits[Index];
+	}
+
+	bool IsPaintChanged(int32 Index) const
+	{
+		return ChangedPaints.IsValidIndex(Index) && ChangedPaints[Index];
+	}
+
+	bool IsEmpty() const;
+
+	/**
+	 * Gets the number of changed parts and paints
+	 */
+	int32 GetNumChangedEntries() const;
+};
+
+/**
+ * Content hashes of a catalog's entries, taken before an edit to tell afterwards what it changed
+ */
+struct FVehicleCatalogEntryHashes
+{
+	// Indexed by EVehiclePartSlot, then paints last
+	TArray<uint64> Entries[NumVehiclePartSlots + 1];
+	uint64 CatalogWide = 0;
+
+	// UVehicleConfigDataAsset::GetContentRevision() when taken
+	uint32 ContentRevision = 0;
+};
+
+class UVehicleConfigDataAsset;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnVehicleCatalogEdited, UVehicleConfigDataAsset& /*Catalog*/, const FVehicleCatalogChange& /*Change*/);
+
 /**
  * Data Asset that stores vehicle configuration options
  * Contains all available parts and paint colors for a specific vehicle
@@ -115,6 +317,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint")
 	TArray<FPaintColor> PaintColors;
 
+	// Chassis these parts go on; tagged parts must list it in their CompatibilityTags to fit (None disables fitment checks)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rules")
+	FName ChassisTag;
+
+	// Performance of the bare chassis, before any part is installed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Performance")
+	FVehiclePerformanceStats BaseStats;
+
 	// Default selections (indices)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Defaults")
 	int32 DefaultFrontBumperIndex;
@@ -131,4 +341,121 @@ public:
 		, DefaultPaintIndex(0)
 	{
 	}
+
+	/**
+	 * Gets the part list for a slot
+	 * @param Slot - The part slot
+	 * @return The available parts for that slot
+	 */
+	const TArray<FCarPart>& GetParts(EVehiclePartSlot Slot) const;
+	TArray<FCarPart>& GetParts(EVehiclePartSlot Slot);
+
+	/**
+	 * Publishes a compact catalog manifest (IDs, soft references, tags, defaults) as a hidden
+	 * Asset Registry tag so tools can inspect the catalog without loading the package.
+	 * Assets saved before this tag existed must be resaved to be validated.
+	 */
+	virtual void GetAssetRegistryTags(TArray<FAssetRegistryTag>& OutTags) const override;
+
+	/**
+	 * Gets a stable hash of the catalog layout (part and paint IDs in order, per slot)
+	 * Two machines with the same content produce the same value, so slot indices can be exchanged safely
+	 * Game thread only: the value is cached on first use; workers should be handed it.
+	 * @return Non-zero fingerprint
+	 */
+	uint32 GetCatalogFingerprint() const;
+
+	/**
+	 * Drops the cached fingerprint and bumps the content revision; call after modifying the catalog at runtime
+	 */
+	void InvalidateCatalogFingerprint()
+	{
+		CachedCatalogFingerprint = 0;
+		++ContentRevision;
+	}
+
+	/**
+	 * Gets a counter that changes with any content edit, including ones the fingerprint ignores (names, prices, stats)
+	 * Only meaningful within one process; caches derived from the catalog compare it to know when to refresh.
+	 */
+	uint32 GetContentRevision() const { return ContentRevision; }
+
+	/**
+	 * Finds a part by ID (game thread)
+	 * @return Its index in the slot, or INDEX_NONE
+	 */
+	int32 FindPartIndex(EVehiclePartSlot Slot, FName PartID) const;
+
+	/**
+	 * Finds a paint by ID (game thread)
+	 * @return Its index in PaintColors, or INDEX_NONE
+	 */
+	int32 FindPaintIndex(FName PaintID) const;
+
+	/**
+	 * Gets the parts of a slot carrying a compatibility tag, ascending (game thread)
+	 */
+	TConstArrayView<int32> GetPartsWithTag(EVehiclePartSlot Slot, FName Tag) const;
+
+	/**
+	 * Gets the lookups, rebuilding them if the content changed since (game thread)
+	 * Other threads may read the result until the catalog next changes.
+	 */
+	const FVehicleCatalogLookup& GetLookup() const;
+
+	/**
+	 * Appends parts and paints after the existing ones, so every index (and selection) stays valid
+	 * The lookups are extended rather than rebuilt, and the content revision is bumped once.
+	 * Entries whose ID is already taken should be filtered out by the caller.
+	 * @param NewParts - Parts to append to each slot (indexed by EVehiclePartSlot), moved from
+	 * @param NewPaints - Paints to append, moved from
+	 */
+	void AppendContent(TArray<FCarPart> (&NewParts)[NumVehiclePartSlots], TArray<FPaintColor>& NewPaints);
+
+	/**
+	 * Remembers the current entries so PostContentEdit can tell what an edit changed
+	 * Call before modifying the catalog at runtime (live tuning); the editor does it before every property change.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Live Tuning")
+	void PreContentEdit();
+
+	/**
+	 * Bumps the content revision and broadcasts OnContentEdited with the entries that differ from PreContentEdit
+	 * Without a PreContentEdit, every entry counts as changed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Live Tuning")
+	void PostContentEdit();
+
+	/**
+	 * Takes over the entry hashes of the object this one replaces (package reload), so PostContentEdit diffs against it
+	 */
+	void AdoptEditBaseline(UVehicleConfigDataAsset& Previous);
+
+	// Broadcast by PostContentEdit for edits that changed something (game thread)
+	static FOnVehicleCatalogEdited OnContentEdited;
+
+#if WITH_EDITOR
+	virtual void PreEditChange(FProperty* PropertyAboutToChange) override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PreEditUndo() override;
+	virtual void PostEditUndo() override;
+#endif
+
+private:
+	/**
+	 * Hashes every entry as it is now
+	 */
+	void HashEntries(FVehicleCatalogEntryHashes& OutHashes) const;
+
+	// Lazily computed by GetCatalogFingerprint, 0 when stale
+	mutable uint32 CachedCatalogFingerprint = 0;
+
+	// Bumped by InvalidateCatalogFingerprint
+	uint32 ContentRevision = 0;
+
+	// Built on first use
+	mutable TUniquePtr<FVehicleCatalogLookup> Lookup;
+
+	// Entries as of the last PreContentEdit or PostContentEdit
+	TUniquePtr<FVehicleCatalogEntryHashes> EditBaseline;
 };
@@ -17,6 +17,10 @@ public class TuneX : ModuleRules
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[] {
+			"AssetRegistry",
+			"Json",
+			"MeshDescription",
+			"StaticMeshDescription"
 		});
 
 		// Uncomment if you have Slate dependencies
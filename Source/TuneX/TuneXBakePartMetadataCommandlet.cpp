@@ -0,0 +1,308 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuneXBakePartMetadataCommandlet.h"
+#include "CarPartData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetCompilingManager.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace TuneXBakePartMetadata
+{
+	// Stale meshes resident at once; bounds the commandlet's memory on large content sets
+	static constexpr int32 MeshesPerBatch = 64;
+
+	// A catalog entry and the unique mesh it refers to
+	struct FEntryRef
+	{
+		int32 ConfigIndex = INDEX_NONE;
+		EVehiclePartSlot Slot = EVehiclePartSlot::FrontBumper;
+		int32 PartIndex = INDEX_NONE;
+
+		// Index into the unique meshes, INDEX_NONE for a part without MeshAsset
+		int32 MeshIndex = INDEX_NONE;
+	};
+
+	struct FMeshRecord
+	{
+		FSoftObjectPath Path;
+
+		// Saved hash of the package, empty if the Asset Registry does not know it
+		FString PackageHash;
+
+		bool bNeedsBake = false;
+		FCarPartMetadata Metadata;
+		bool bBaked = false;
+	};
+
+	static bool IsEntryFresh(const FCarPart& Part, const FMeshRecord* Mesh)
+	{
+		if (!Mesh)
+		{
+			// Nothing to describe; fresh once any old metadata is cleared
+			return Part.Metadata.SourcePackageHash.IsEmpty();
+		}
+		return Part.Metadata.IsBakedFor(Part.MeshAsset) && Part.Metadata.SourcePackageHash == Mesh->PackageHash;
+	}
+
+	/**
+	 * Computes the metadata of a loaded mesh; only reads the mesh, so meshes can be processed in parallel
+	 */
+	static FCarPartMetadata ComputeMetadata(UStaticMesh& Mesh, const FMeshRecord& Record)
+	{
+		FCarPartMetadata Metadata;
+		Metadata.Bounds = Mesh.GetBoundingBox();
+		Metadata.ResourceSizeBytes = Mesh.GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		Metadata.NumLODs = Mesh.GetNumLODs();
+		Metadata.NumSections = Metadata.NumLODs > 0 ? Mesh.GetNumSections(0) : 0;
+		Metadata.NumMaterialSlots = Mesh.GetStaticMaterials().Num();
+		Metadata.SourceMesh = Record.Path;
+		Metadata.SourcePackageHash = Record.PackageHash;
+		return Metadata;
+	}
+
+	static bool SaveConfig(UVehicleConfigDataAsset& Config)
+	{
+		UPackage* Package = Config.GetPackage();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		return UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs);
+	}
+}
+
+UTuneXBakePartMetadataCommandlet::UTuneXBakePartMetadataCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTuneXBakePartMetadataCommandlet::Main(const FString& Params)
+{
+	using namespace TuneXBakePartMetadata;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FString PackagePath;
+	FParse::Value(*Params, TEXT("Path="), PackagePath);
+	const bool bCheckOnly = FParse::Param(*Params, TEXT("Check"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(/*bSynchronousSearch*/ true);
+
+	TArray<FAssetData> ConfigAssets;
+	{
+		FARFilter Filter;
+		Filter.ClassPaths.Add(UVehicleConfigDataAsset::StaticClass()->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+		if (!PackagePath.IsEmpty())
+		{
+			Filter.PackagePaths.Add(FName(*PackagePath));
+			Filter.bRecursivePaths = true;
+		}
+		AssetRegistry.GetAssets(Filter, ConfigAssets);
+	}
+
+	// Catalogs are small; their meshes are what this avoids loading
+	TArray<TStrongObjectPtr<UVehicleConfigDataAsset>> Configs;
+	TArray<FEntryRef> Entries;
+	TArray<FMeshRecord> Meshes;
+	TMap<FSoftObjectPath, int32> MeshIndices;
+	for (const FAssetData& ConfigAsset : ConfigAssets)
+	{
+		UVehicleConfigDataAsset* Config = Cast<UVehicleConfigDataAsset>(ConfigAsset.GetAsset());
+		if (!Config)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TuneXBakePartMetadata: Could not load %s"), *ConfigAsset.GetObjectPathString());
+			continue;
+		}
+
+		const int32 ConfigIndex = Configs.Emplace(Config);
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+			const TArray<FCarPart>& Parts = Config->GetParts(Slot);
+			for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+			{
+				FEntryRef& Entry = Entries.AddDefaulted_GetRef();
+				Entry.ConfigIndex = ConfigIndex;
+				Entry.Slot = Slot;
+				Entry.PartIndex = PartIndex;
+
+				const FSoftObjectPath MeshPath = Parts[PartIndex].MeshAsset.ToSoftObjectPath();
+				if (!MeshPath.IsNull())
+				{
+					int32& MeshIndex = MeshIndices.FindOrAdd(MeshPath, INDEX_NONE);
+					if (MeshIndex == INDEX_NONE)
+					{
+						MeshIndex = Meshes.Num();
+						Meshes.AddDefaulted_GetRef().Path = MeshPath;
+					}
+					Entry.MeshIndex = MeshIndex;
+				}
+			}
+		}
+	}
+
+	// Current package hashes, straight from the registry
+	ParallelFor(Meshes.Num(), [&Meshes, &AssetRegistry](int32 MeshIndex)
+	{
+		FMeshRecord& Mesh = Meshes[MeshIndex];
+		if (const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Mesh.Path.GetLongPackageFName()))
+		{
+			Mesh.PackageHash = LexToString(PackageData->GetPackageSavedHash());
+		}
+	});
+
+	int32 NumStale = 0;
+	int32 NumUnknownMeshes = 0;
+	for (const FEntryRef& Entry : Entries)
+	{
+		const FCarPart& Part = Configs[Entry.ConfigIndex]->GetParts(Entry.Slot)[Entry.PartIndex];
+		FMeshRecord* Mesh = Entry.MeshIndex != INDEX_NONE ? &Meshes[Entry.MeshIndex] : nullptr;
+		if (Mesh && Mesh->PackageHash.IsEmpty())
+		{
+			++NumUnknownMeshes;
+			continue;
+		}
+		if (!IsEntryFresh(Part, Mesh))
+		{
+			++NumStale;
+			if (Mesh)
+			{
+				Mesh->bNeedsBake = true;
+			}
+			if (bCheckOnly)
+			{
+				UE_LOG(LogTemp, Display, TEXT("TuneXBakePartMetadata: %s %s '%s' is stale"),
+					*Configs[Entry.ConfigIndex]->GetPathName(), LexToString(Entry.Slot), *Part.PartID.ToString());
+			}
+		}
+	}
+
+	if (bCheckOnly)
+	{
+		UE_LOG(LogTemp, Display, TEXT("TuneXBakePartMetadata: %d catalogs, %d entries, %d stale, %d with a mesh the Asset Registry does not know (%.2fs)"),
+			Configs.Num(), Entries.Num(), NumStale, NumUnknownMeshes, FPlatformTime::Seconds() - StartTime);
+		return NumStale > 0 ? 1 : 0;
+	}
+
+	TArray<int32> MeshesToBake;
+	for (int32 MeshIndex = 0; MeshIndex < Meshes.Num(); ++MeshIndex)
+	{
+		if (Meshes[MeshIndex].bNeedsBake)
+		{
+			MeshesToBake.Add(MeshIndex);
+		}
+	}
+
+	// A batch streams in together, finishes compiling, is described in parallel and is released before the next one
+	FStreamableManager Streamable;
+	for (int32 BatchStart = 0; BatchStart < MeshesToBake.Num(); BatchStart += MeshesPerBatch)
+	{
+		const TConstArrayView<int32> Batch = TConstArrayView<int32>(MeshesToBake).Slice(BatchStart, FMath::Min(MeshesPerBatch, MeshesToBake.Num() - BatchStart));
+
+		TArray<FSoftObjectPath> PathsToLoad;
+		PathsToLoad.Reserve(Batch.Num());
+		for (const int32 MeshIndex : Batch)
+		{
+			PathsToLoad.Add(Meshes[MeshIndex].Path);
+		}
+
+		TSharedPtr<FStreamableHandle> LoadHandle = Streamable.RequestAsyncLoad(PathsToLoad);
+		if (LoadHandle)
+		{
+			LoadHandle->WaitUntilComplete();
+		}
+
+		TArray<UStaticMesh*> LoadedMeshes;
+		LoadedMeshes.SetNumZeroed(Batch.Num());
+		for (int32 BatchIndex = 0; BatchIndex < Batch.Num(); ++BatchIndex)
+		{
+			LoadedMeshes[BatchIndex] = Cast<UStaticMesh>(Meshes[Batch[BatchIndex]].Path.ResolveObject());
+			if (!LoadedMeshes[BatchIndex])
+			{
+				UE_LOG(LogTemp, Warning, TEXT("TuneXBakePartMetadata: %s is not a loadable StaticMesh"), *Meshes[Batch[BatchIndex]].Path.ToString());
+			}
+		}
+
+		// Loaded meshes may still be building their render data; bounds and sizes are only final afterwards
+		FAssetCompilingManager::Get().FinishAllCompilation();
+
+		ParallelFor(Batch.Num(), [&](int32 BatchIndex)
+		{
+			if (UStaticMesh* Mesh = LoadedMeshes[BatchIndex])
+			{
+				FMeshRecord& Record = Meshes[Batch[BatchIndex]];
+				Record.Metadata = ComputeMetadata(*Mesh, Record);
+				Record.bBaked = true;
+			}
+		});
+
+		if (LoadHandle)
+		{
+			LoadHandle->ReleaseHandle();
+		}
+		LoadedMeshes.Reset();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	// Write back, one edit per catalog
+	TArray<TArray<const FEntryRef*>> EntriesByConfig;
+	EntriesByConfig.SetNum(Configs.Num());
+	for (const FEntryRef& Entry : Entries)
+	{
+		const FCarPart& Part = Configs[Entry.ConfigIndex]->GetParts(Entry.Slot)[Entry.PartIndex];
+		const FMeshRecord* Mesh = Entry.MeshIndex != INDEX_NONE ? &Meshes[Entry.MeshIndex] : nullptr;
+		if ((!Mesh || Mesh->bBaked) && !IsEntryFresh(Part, Mesh))
+		{
+			EntriesByConfig[Entry.ConfigIndex].Add(&Entry);
+		}
+	}
+
+	int32 NumUpdated = 0;
+	int32 NumSaved = 0;
+	int32 NumSaveFailures = 0;
+	for (int32 ConfigIndex = 0; ConfigIndex < Configs.Num(); ++ConfigIndex)
+	{
+		if (EntriesByConfig[ConfigIndex].Num() == 0)
+		{
+			continue;
+		}
+
+		UVehicleConfigDataAsset& Config = *Configs[ConfigIndex];
+		Config.Modify();
+		Config.PreContentEdit();
+		for (const FEntryRef* Entry : EntriesByConfig[ConfigIndex])
+		{
+			Config.GetParts(Entry->Slot)[Entry->PartIndex].Metadata = Entry->MeshIndex != INDEX_NONE ? Meshes[Entry->MeshIndex].Metadata : FCarPartMetadata();
+		}
+		Config.PostContentEdit();
+		NumUpdated += EntriesByConfig[ConfigIndex].Num();
+
+		if (SaveConfig(Config))
+		{
+			++NumSaved;
+		}
+		else
+		{
+			++NumSaveFailures;
+			UE_LOG(LogTemp, Error, TEXT("TuneXBakePartMetadata: Failed to save %s"), *Config.GetPathName());
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("TuneXBakePartMetadata: %d catalogs, %d entries; %d meshes loaded, %d entries updated, %d catalogs saved, %d failed; %d with a mesh the Asset Registry does not know (%.2fs)"),
+		Configs.Num(), Entries.Num(), MeshesToBake.Num(), NumUpdated, NumSaved, NumSaveFailures, NumUnknownMeshes, FPlatformTime::Seconds() - StartTime);
+
+	return NumSaveFailures > 0 ? 1 : 0;
+}
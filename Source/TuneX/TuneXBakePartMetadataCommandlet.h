@@ -0,0 +1,33 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TuneXBakePartMetadataCommandlet.generated.h"
+
+/**
+ * Bakes FCarPart::Metadata (bounds, memory size, LOD and section counts) into every catalog, so runtime code can
+ * plan loads, estimate memory and lay out UI without resolving a single part mesh
+ * Each entry records the saved hash of its mesh's package; only entries whose hash no longer matches the Asset
+ * Registry (or that were never baked) have their mesh loaded. Stale meshes stream in batches, finish compiling,
+ * have their metadata computed in parallel and are released before the next batch; only catalogs that changed are
+ * saved. Run it before cooking; TuneXValidateCatalog
+ * reports entries it left stale.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd TuneX.uproject -run=TuneXBakePartMetadata [-Path=/Game/Cars] [-Check]
+ *
+ * -Check only reports stale entries, loading no mesh and saving nothing.
+ * Returns 0 when everything is (or was made) up to date, 1 if entries are stale under -Check or a save failed.
+ */
+UCLASS()
+class TUNEX_API UTuneXBakePartMetadataCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTuneXBakePartMetadataCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
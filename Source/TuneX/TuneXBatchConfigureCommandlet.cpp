@@ -0,0 +1,698 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuneXBatchConfigureCommandlet.h"
+#include "VehicleBuild.h"
+#include "VehicleDerivedDataCache.h"
+#include "VehiclePartConstraints.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Containers/Queue.h"
+#include "Dom/JsonObject.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/OutputDeviceConsole.h"
+#include "Misc/OutputDeviceHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+#include <stdio.h>
+
+namespace TuneXBatchConfigure
+{
+	static constexpr int32 DefaultBatchSize = 4096;
+
+	// How long stdin may stay quiet before a partial batch is answered
+	static constexpr int32 DefaultStallMs = 5;
+
+	// Bytes read from the input at a time
+	static constexpr int32 ReadChunkSize = 64 * 1024;
+
+	enum class EError : uint8
+	{
+		None,
+		BadRequest,
+		UnknownCatalog,
+		UnknownPart,
+		UnknownPaint,
+		// Resolved, but breaks a rule of the catalog
+		Rule,
+	};
+
+	struct FRequest
+	{
+		FString Id;
+		FString CatalogPath;
+
+		// As given, and found in the name table (NAME_None if the name was never created, so cannot exist)
+		FString PartStrings[NumVehiclePartSlots];
+		FName PartIDs[NumVehiclePartSlots];
+		FString PaintString;
+		FName PaintID;
+
+		int32 ContextIndex = INDEX_NONE;
+
+		EError Error = EError::None;
+
+		// Slot of an unknown part, or the offending key of a bad request
+		int32 ErrorSlot = INDEX_NONE;
+		FString ErrorDetail;
+	};
+
+	/**
+	 * Everything a worker needs about one catalog, prepared on the game thread
+	 */
+	struct FCatalogContext
+	{
+		TStrongObjectPtr<UVehicleConfigDataAsset> Config;
+		const FVehicleCatalogLookup* Lookup = nullptr;
+		FVehiclePartConstraintsPtr Rules;
+		uint32 Fingerprint = 0;
+	};
+
+	static int32 ParseSlot(const FString& Name)
+	{
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			if (Name.Equals(LexToString(static_cast<EVehiclePartSlot>(SlotIndex)), ESearchCase::IgnoreCase))
+			{
+				return SlotIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	static const TCHAR* ErrorToString(EError Error, EVehicleConstraintViolation Violation)
+	{
+		switch (Error)
+		{
+		case EError::BadRequest:		return TEXT("BadRequest");
+		case EError::UnknownCatalog:	return TEXT("UnknownCatalog");
+		case EError::UnknownPart:		return TEXT("UnknownPart");
+		case EError::UnknownPaint:		return TEXT("UnknownPaint");
+		default:						break;
+		}
+
+		switch (Violation)
+		{
+		case EVehicleConstraintViolation::InvalidIndex:	return TEXT("InvalidIndex");
+		case EVehicleConstraintViolation::Fitment:		return TEXT("Fitment");
+		case EVehicleConstraintViolation::Requires:		return TEXT("Requires");
+		case EVehicleConstraintViolation::Excludes:		return TEXT("Excludes");
+		default:										return TEXT("None");
+		}
+	}
+
+	static void ParseRequest(const FString& Line, FRequest& Out)
+	{
+		TSharedPtr<FJsonObject> Object;
+		TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(Line);
+		if (!FJsonSerializer::Deserialize(Reader, Object) || !Object.IsValid())
+		{
+			Out.Error = EError::BadRequest;
+			Out.ErrorDetail = TEXT("json");
+			return;
+		}
+
+		// Numbers are accepted as IDs too
+		Object->TryGetStringField(TEXT("id"), Out.Id);
+
+		if (!Object->TryGetStringField(TEXT("catalog"), Out.CatalogPath) || Out.CatalogPath.IsEmpty())
+		{
+			Out.Error = EError::BadRequest;
+			Out.ErrorDetail = TEXT("catalog");
+			return;
+		}
+
+		const TSharedPtr<FJsonObject>* Parts = nullptr;
+		if (Object->TryGetObjectField(TEXT("parts"), Parts))
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*Parts)->Values)
+			{
+				const int32 SlotIndex = ParseSlot(Pair.Key);
+				FString PartString;
+				if (SlotIndex == INDEX_NONE || !Pair.Value.IsValid() || !Pair.Value->TryGetString(PartString))
+				{
+					Out.Error = EError::BadRequest;
+					Out.ErrorDetail = Pair.Key;
+					return;
+				}
+
+				Out.PartIDs[SlotIndex] = FName(*PartString, FNAME_Find);
+				Out.PartStrings[SlotIndex] = MoveTemp(PartString);
+			}
+		}
+
+		if (Object->TryGetStringField(TEXT("paint"), Out.PaintString))
+		{
+			Out.PaintID = FName(*Out.PaintString, FNAME_Find);
+		}
+	}
+
+	/**
+	 * Resolves, validates and prices one request and formats its result line
+	 */
+	static void Evaluate(FRequest& Request, const TArray<FCatalogContext>& Contexts, FString& OutLine)
+	{
+		FVehicleBuild Build;
+		FVehicleConstraintResult Violation;
+		FVehicleBuildDerivedData Derived;
+		uint64 Hash = 0;
+		bool bResolved = false;
+
+		if (Request.Error == EError::None)
+		{
+			if (!Contexts.IsValidIndex(Request.ContextIndex))
+			{
+				Request.Error = EError::UnknownCatalog;
+			}
+			else
+			{
+				const FCatalogContext& Context = Contexts[Request.ContextIndex];
+
+				for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots && Request.Error == EError::None; ++SlotIndex)
+				{
+					if (Request.PartStrings[SlotIndex].IsEmpty())
+					{
+						continue;
+					}
+
+					const int32* Index = Context.Lookup->PartIndices[SlotIndex].Find(Request.PartIDs[SlotIndex]);
+					if (!Index || Request.PartIDs[SlotIndex].IsNone())
+					{
+						Request.Error = EError::UnknownPart;
+						Request.ErrorSlot = SlotIndex;
+						Request.ErrorDetail = Request.PartStrings[SlotIndex];
+						break;
+					}
+					Build.PartIndices[SlotIndex] = *Index;
+				}
+
+				if (Request.Error == EError::None && !Request.PaintString.IsEmpty())
+				{
+					const int32* Index = Context.Lookup->PaintIndices.Find(Request.PaintID);
+					if (!Index || Request.PaintID.IsNone())
+					{
+						Request.Error = EError::UnknownPaint;
+						Request.ErrorDetail = Request.PaintString;
+					}
+					else
+					{
+						Build.PaintIndex = *Index;
+					}
+				}
+
+				if (Request.Error == EError::None)
+				{
+					bResolved = true;
+					Violation = Context.Rules->Validate(Build);
+					if (!Violation.IsValid())
+					{
+						Request.Error = EError::Rule;
+					}
+					Derived = FVehicleDerivedDataCache::Get().GetOrCompute(*Context.Config, Context.Fingerprint, Build);
+					Hash = Build.GetCanonicalHash(Context.Fingerprint);
+				}
+			}
+		}
+
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&OutLine);
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("id"), Request.Id);
+		Writer->WriteValue(TEXT("valid"), Request.Error == EError::None);
+
+		if (Request.Error != EError::None)
+		{
+			Writer->WriteValue(TEXT("error"), ErrorToString(Request.Error, Violation.Violation));
+			if (Request.Error == EError::Rule)
+			{
+				if (Violation.Slot != EVehiclePartSlot::Count)
+				{
+					Writer->WriteValue(TEXT("slot"), LexToString(Violation.Slot));
+				}
+				if (Violation.Violation == EVehicleConstraintViolation::Requires || Violation.Violation == EVehicleConstraintViolation::Excludes)
+				{
+					Writer->WriteValue(TEXT("otherSlot"), LexToString(Violation.OtherSlot));
+				}
+			}
+			else
+			{
+				if (Request.ErrorSlot != INDEX_NONE)
+				{
+					Writer->WriteValue(TEXT("slot"), LexToString(static_cast<EVehiclePartSlot>(Request.ErrorSlot)));
+				}
+				if (!Request.ErrorDetail.IsEmpty())
+				{
+					Writer->WriteValue(TEXT("detail"), Request.ErrorDetail);
+				}
+			}
+		}
+
+		if (bResolved)
+		{
+			Writer->WriteValue(TEXT("price"), Derived.TotalPrice);
+			Writer->WriteValue(TEXT("weight"), Derived.Stats.Weight);
+			Writer->WriteValue(TEXT("downforce"), Derived.Stats.Downforce);
+			Writer->WriteValue(TEXT("drag"), Derived.Stats.Drag);
+			Writer->WriteValue(TEXT("grip"), Derived.Stats.Grip);
+
+			Writer->WriteArrayStart(TEXT("build"));
+			for (const int32 PartIndex : Build.PartIndices)
+			{
+				Writer->WriteValue(PartIndex);
+			}
+			Writer->WriteValue(Build.PaintIndex);
+			Writer->WriteArrayEnd();
+
+			Writer->WriteValue(TEXT("hash"), FString::Printf(TEXT("%016llx"), Hash));
+		}
+
+		Writer->WriteObjectEnd();
+		Writer->Close();
+	}
+
+	/**
+	 * Reads UTF-8 lines from a file, or from stdin
+	 */
+	class FLineReader
+	{
+	public:
+		explicit FLineReader(FArchive* InFile)
+			: File(InFile)
+		{
+			Buffer.SetNumUninitialized(ReadChunkSize + 1);
+		}
+
+		bool ReadLine(FString& OutLine)
+		{
+			Pending.Reset();
+			for (;;)
+			{
+				if (Pos == End && !Refill())
+				{
+					break;
+				}
+
+				const ANSICHAR* Start = Buffer.GetData() + Pos;
+				const ANSICHAR* Newline = static_cast<const ANSICHAR*>(FMemory::Memchr(Start, '\n', End - Pos));
+				if (Newline)
+				{
+					Pending.Append(Start, static_cast<int32>(Newline - Start));
+					Pos += static_cast<int32>(Newline - Start) + 1;
+					return Convert(OutLine);
+				}
+
+				Pending.Append(Start, End - Pos);
+				Pos = End;
+			}
+
+			// Last line without a newline
+			return Pending.Num() > 0 && Convert(OutLine);
+		}
+
+	private:
+		bool Refill()
+		{
+			Pos = 0;
+			End = 0;
+			if (File)
+			{
+				const int64 Remaining = File->TotalSize() - File->Tell();
+				End = static_cast<int32>(FMath::Min<int64>(Remaining, ReadChunkSize));
+				if (End > 0)
+				{
+					File->Serialize(Buffer.GetData(), End);
+				}
+				return End > 0 && !File->IsError();
+			}
+
+			if (!fgets(Buffer.GetData(), ReadChunkSize + 1, stdin))
+			{
+				return false;
+			}
+			End = FCStringAnsi::Strlen(Buffer.GetData());
+			return End > 0;
+		}
+
+		bool Convert(FString& OutLine)
+		{
+			if (Pending.Num() > 0 && Pending.Last() == '\r')
+			{
+				Pending.Pop(/*bAllowShrinking*/ false);
+			}
+			FUTF8ToTCHAR Converted(reinterpret_cast<const UTF8CHAR*>(Pending.GetData()), Pending.Num());
+			OutLine = FString(Converted.Length(), Converted.Get());
+			return true;
+		}
+
+		TUniquePtr<FArchive> File;
+		TArray<ANSICHAR> Buffer;
+		TArray<ANSICHAR> Pending;
+		int32 Pos = 0;
+		int32 End = 0;
+	};
+
+	/**
+	 * Reads stdin on its own thread, so a partial batch can be answered as soon as input stalls
+	 */
+	class FStdinLineQueue
+	{
+	public:
+		FStdinLineQueue()
+			: LineReady(FPlatformProcess::GetSynchEventFromPool(/*bIsManualReset*/ false))
+		{
+			Reader = Async(EAsyncExecution::Thread, [this]()
+			{
+				FLineReader Input(nullptr);
+				FString Line;
+				while (Input.ReadLine(Line))
+				{
+					Lines.Enqueue(MoveTemp(Line));
+					LineReady->Trigger();
+				}
+				bEndOfInput = true;
+				LineReady->Trigger();
+			});
+		}
+
+		~FStdinLineQueue()
+		{
+			Reader.Wait();
+			FPlatformProcess::ReturnSynchEventToPool(LineReady);
+		}
+
+		/**
+		 * Gets the next line
+		 * @param WaitSeconds - How long to wait for one; negative waits until a line arrives or the input ends
+		 * @return false if none arrived in time or the input ended (see IsDone)
+		 */
+		bool ReadLine(FString& OutLine, double WaitSeconds)
+		{
+			for (;;)
+			{
+				if (Lines.Dequeue(OutLine))
+				{
+					return true;
+				}
+				if (bEndOfInput)
+				{
+					return Lines.Dequeue(OutLine);
+				}
+				if (WaitSeconds < 0.0)
+				{
+					LineReady->Wait();
+				}
+				else if (!LineReady->Wait(FTimespan::FromSeconds(WaitSeconds)))
+				{
+					return false;
+				}
+			}
+		}
+
+		bool IsDone() const { return bEndOfInput && Lines.IsEmpty(); }
+
+	private:
+		TQueue<FString, EQueueMode::Spsc> Lines;
+		FEvent* LineReady;
+		std::atomic<bool> bEndOfInput = false;
+		TFuture<void> Reader;
+	};
+
+	/**
+	 * Writes UTF-8 text to a file, or to stdout (flushed per write)
+	 */
+	class FResultWriter
+	{
+	public:
+		explicit FResultWriter(FArchive* InFile)
+			: File(InFile)
+		{
+		}
+
+		void Write(const FString& Text)
+		{
+			FTCHARToUTF8 Utf8(*Text, Text.Len());
+			if (File)
+			{
+				File->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+				File->Flush();
+			}
+			else
+			{
+				fwrite(Utf8.Get(), 1, Utf8.Length(), stdout);
+				fflush(stdout);
+			}
+		}
+
+	private:
+		TUniquePtr<FArchive> File;
+	};
+
+	/**
+	 * Sends log lines to stderr while results go to stdout
+	 */
+	class FStderrOutputDevice : public FOutputDevice
+	{
+	public:
+		virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override
+		{
+			const FString Line = FOutputDeviceHelper::FormatLogLine(Verbosity, Category, V) + TEXT("\n");
+			FTCHARToUTF8 Utf8(*Line, Line.Len());
+			fwrite(Utf8.Get(), 1, Utf8.Length(), stderr);
+		}
+
+		virtual bool CanBeUsedOnAnyThread() const override { return true; }
+		virtual bool CanBeUsedOnMultipleThreads() const override { return true; }
+	};
+}
+
+UTuneXBatchConfigureCommandlet::UTuneXBatchConfigureCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTuneXBatchConfigureCommandlet::Main(const FString& Params)
+{
+	using namespace TuneXBatchConfigure;
+
+	FString InputPath;
+	FParse::Value(*Params, TEXT("Input="), InputPath);
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("BatchResults.ndjson");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	int32 BatchSize = DefaultBatchSize;
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	BatchSize = FMath::Max(1, BatchSize);
+
+	int32 StallMs = DefaultStallMs;
+	FParse::Value(*Params, TEXT("StallMs="), StallMs);
+	const double StallSeconds = FMath::Max(0, StallMs) / 1000.0;
+
+	FArchive* InputFile = nullptr;
+	if (!InputPath.IsEmpty() && InputPath != TEXT("-"))
+	{
+		InputFile = IFileManager::Get().CreateFileReader(*InputPath);
+		if (!InputFile)
+		{
+			UE_LOG(LogTemp, Error, TEXT("TuneXBatchConfigure: Could not open input %s"), *InputPath);
+			return 1;
+		}
+	}
+	FLineReader Input(InputFile);
+	TUniquePtr<FStdinLineQueue> StdinLines = InputFile ? nullptr : MakeUnique<FStdinLineQueue>();
+
+	FArchive* OutputFile = nullptr;
+	if (OutputPath != TEXT("-"))
+	{
+		OutputFile = IFileManager::Get().CreateFileWriter(*OutputPath);
+		if (!OutputFile)
+		{
+			UE_LOG(LogTemp, Error, TEXT("TuneXBatchConfigure: Could not open output %s"), *OutputPath);
+			return 1;
+		}
+	}
+	else if (FParse::Param(FCommandLine::Get(), TEXT("stdout")))
+	{
+		// That device writes every log line to stdout and cannot be detached from here
+		UE_LOG(LogTemp, Error, TEXT("TuneXBatchConfigure: -Output=- cannot be combined with -stdout, which logs to stdout too"));
+		return 1;
+	}
+	FResultWriter Output(OutputFile);
+
+	// With results on stdout, the console log moves to stderr for the rest of the run
+	FStderrOutputDevice StderrLog;
+	const bool bRedirectLog = !OutputFile && GLog;
+	if (bRedirectLog)
+	{
+		if (GLogConsole)
+		{
+			GLog->RemoveOutputDevice(GLogConsole);
+		}
+		GLog->AddOutputDevice(&StderrLog);
+	}
+	ON_SCOPE_EXIT
+	{
+		if (bRedirectLog)
+		{
+			GLog->Flush();
+			GLog->RemoveOutputDevice(&StderrLog);
+			if (GLogConsole)
+			{
+				GLog->AddOutputDevice(GLogConsole);
+			}
+		}
+	};
+
+	UVehiclePartConstraintSubsystem* RulesSubsystem = UVehiclePartConstraintSubsystem::Get();
+
+	// Catalogs are loaded on first mention and kept; failed paths map to INDEX_NONE so they are not retried
+	TArray<FCatalogContext> Contexts;
+	TMap<FString, int32> ContextByPath;
+	auto FindOrLoadContext = [&](const FString& Path) -> int32
+	{
+		if (const int32* Existing = ContextByPath.Find(Path))
+		{
+			return *Existing;
+		}
+
+		FString ObjectPath = Path;
+		if (!ObjectPath.Contains(TEXT(".")))
+		{
+			ObjectPath += TEXT(".") + FPackageName::GetShortName(ObjectPath);
+		}
+
+		int32 ContextIndex = INDEX_NONE;
+		if (UVehicleConfigDataAsset* Config = LoadObject<UVehicleConfigDataAsset>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn))
+		{
+			// Everything workers touch is computed here, so they only read
+			FCatalogContext& Context = Contexts.AddDefaulted_GetRef();
+			Context.Config.Reset(Config);
+			Context.Fingerprint = Config->GetCatalogFingerprint();
+			Context.Lookup = &Config->GetLookup();
+			Context.Rules = RulesSubsystem ? RulesSubsystem->GetConstraints(*Config) : FVehiclePartConstraints::Compile(*Config);
+			ContextIndex = Contexts.Num() - 1;
+
+			UE_LOG(LogTemp, Display, TEXT("TuneXBatchConfigure: Loaded catalog %s"), *ObjectPath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TuneXBatchConfigure: No catalog at %s"), *Path);
+		}
+
+		ContextByPath.Add(Path, ContextIndex);
+		return ContextIndex;
+	};
+
+	TArray<FString> Lines;
+	TArray<FRequest> Requests;
+	TArray<FString> Results;
+	FString BatchText;
+
+	int64 NumBuilds = 0;
+	int64 NumValid = 0;
+	int64 NumRuleViolations = 0;
+	int64 NumUnresolved = 0;
+	double ProcessSeconds = 0.0;
+
+	const double StartTime = FPlatformTime::Seconds();
+	bool bInputDone = false;
+	while (!bInputDone)
+	{
+		Lines.Reset();
+		FString Line;
+		while (Lines.Num() < BatchSize)
+		{
+			bool bGotLine = false;
+			if (StdinLines)
+			{
+				// A batch waits for its first line; after that a stall sends what there is
+				bGotLine = StdinLines->ReadLine(Line, Lines.Num() == 0 ? -1.0 : StallSeconds);
+				if (!bGotLine && !StdinLines->IsDone())
+				{
+					break;
+				}
+			}
+			else
+			{
+				bGotLine = Input.ReadLine(Line);
+			}
+
+			if (!bGotLine)
+			{
+				bInputDone = true;
+				break;
+			}
+			if (!Line.TrimStartAndEnd().IsEmpty())
+			{
+				Lines.Add(MoveTemp(Line));
+			}
+		}
+
+		if (Lines.Num() == 0)
+		{
+			continue;
+		}
+
+		const double BatchStartTime = FPlatformTime::Seconds();
+
+		Requests.Reset();
+		Requests.SetNum(Lines.Num());
+		ParallelFor(Lines.Num(), [&Lines, &Requests](int32 Index)
+		{
+			ParseRequest(Lines[Index], Requests[Index]);
+		});
+
+		for (FRequest& Request : Requests)
+		{
+			if (Request.Error == EError::None)
+			{
+				Request.ContextIndex = FindOrLoadContext(Request.CatalogPath);
+			}
+		}
+
+		Results.Reset();
+		Results.SetNum(Requests.Num());
+		ParallelFor(Requests.Num(), [&Requests, &Contexts, &Results](int32 Index)
+		{
+			Evaluate(Requests[Index], Contexts, Results[Index]);
+		});
+
+		BatchText.Reset();
+		for (int32 Index = 0; Index < Results.Num(); ++Index)
+		{
+			BatchText += Results[Index];
+			BatchText.AppendChar(TEXT('\n'));
+
+			switch (Requests[Index].Error)
+			{
+			case EError::None:	++NumValid; break;
+			case EError::Rule:	++NumRuleViolations; break;
+			default:			++NumUnresolved; break;
+			}
+		}
+		NumBuilds += Results.Num();
+		ProcessSeconds += FPlatformTime::Seconds() - BatchStartTime;
+
+		Output.Write(BatchText);
+	}
+
+	const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+	const FVehicleDerivedDataCacheStats CacheStats = FVehicleDerivedDataCache::Get().GetStats();
+
+	UE_LOG(LogTemp, Display, TEXT("TuneXBatchConfigure: %lld builds (%lld valid, %lld breaking rules, %lld unresolved) from %d catalogs in %.2f s"),
+		NumBuilds, NumValid, NumRuleViolations, NumUnresolved, Contexts.Num(), TotalSeconds);
+	UE_LOG(LogTemp, Display, TEXT("TuneXBatchConfigure: %.0f builds/s excluding input waits, derived data cache %llu hits / %llu misses"),
+		ProcessSeconds > 0.0 ? NumBuilds / ProcessSeconds : 0.0, CacheStats.NumHits, CacheStats.NumMisses);
+
+	return 0;
+}
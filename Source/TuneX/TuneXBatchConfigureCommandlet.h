@@ -0,0 +1,44 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TuneXBatchConfigureCommandlet.generated.h"
+
+/**
+ * Validates, resolves and prices builds headlessly with the game's own rules, for backend services
+ * Only catalogs are loaded (part meshes and materials are soft references and stay on disk); no world, actor or
+ * component is created. Requests are read as newline-delimited JSON and answered in the same order, a batch at a
+ * time: parsing, rule checks (FVehiclePartConstraints), pricing and stats (FVehicleDerivedDataCache) and result
+ * formatting run in parallel across the batch.
+ *
+ * Request, one per line (missing slots stay empty):
+ *   {"id":"order-1","catalog":"/Game/Cars/DA_Coupe.DA_Coupe","parts":{"FrontBumper":"fb_carbon","Wheels":"rim_19"},"paint":"red"}
+ *
+ * Result, one per line:
+ *   {"id":"order-1","valid":true,"price":1234.5,"weight":..,"downforce":..,"drag":..,"grip":..,"build":[0,-1,-1,-1,3,2],"hash":"..."}
+ *   Invalid builds carry "error" (a rule: Fitment, Requires, Excludes; or UnknownPart, UnknownPaint, UnknownCatalog,
+ *   BadRequest) with "slot" and "otherSlot" where they apply. Builds that resolve are priced even when invalid.
+ *   "build" holds the part indices (EVehiclePartSlot order) then the paint index; "hash" is FVehicleBuild::GetCanonicalHash.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd TuneX.uproject -run=TuneXBatchConfigure -nullrhi [-Input=<file.ndjson>] [-Output=<file.ndjson>] [-BatchSize=N] [-StallMs=N]
+ *
+ * -Input defaults to stdin. A batch is answered once it holds BatchSize requests (default 4096) or, on stdin, once no
+ * request arrived for StallMs milliseconds (default 5), so interactive callers get answers without filling a batch.
+ * -Output defaults to Saved/TuneX/BatchResults.ndjson; -Output=- writes to stdout, which then carries results only:
+ * the console log moves to stderr (so -Output=- is refused together with -stdout).
+ *
+ * Returns 0 once the input is exhausted, 1 if the input or output could not be opened.
+ */
+UCLASS()
+class TUNEX_API UTuneXBatchConfigureCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTuneXBatchConfigureCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
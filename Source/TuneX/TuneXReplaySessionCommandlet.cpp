@@ -0,0 +1,235 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuneXReplaySessionCommandlet.h"
+#include "TuningController.h"
+#include "TuningSessionLog.h"
+#include "VehicleActor.h"
+#include "VehicleMasterComponent.h"
+#include "CarPartData.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace TuneXReplaySession
+{
+	// Longest single world tick while catching up on recorded time
+	static constexpr double MaxTickSeconds = 1.0 / 30.0;
+
+	static float Percentile(const TArray<float>& SortedSamples, float Fraction)
+	{
+		if (SortedSamples.Num() == 0)
+		{
+			return 0.0f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+
+	/**
+	 * Advances the world and everything that completes work on the game thread
+	 */
+	static void TickWorld(UWorld* World, double DeltaSeconds)
+	{
+		ProcessAsyncLoading(/*bUseTimeLimit*/ true, /*bUseFullTimeLimit*/ false, 0.005);
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FTSTicker::GetCoreTicker().Tick(static_cast<float>(DeltaSeconds));
+		World->Tick(LEVELTICK_All, static_cast<float>(DeltaSeconds));
+	}
+
+	/**
+	 * Lets DeltaSeconds of recorded time pass: in real time, or in a single tick at maximum speed
+	 */
+	static void AdvanceTime(UWorld* World, double DeltaSeconds, bool bMaxSpeed)
+	{
+		if (DeltaSeconds <= 0.0)
+		{
+			return;
+		}
+
+		if (bMaxSpeed)
+		{
+			TickWorld(World, FMath::Min(DeltaSeconds, MaxTickSeconds));
+			return;
+		}
+
+		const double EndTime = FPlatformTime::Seconds() + DeltaSeconds;
+		double LastTime = FPlatformTime::Seconds();
+		while (LastTime < EndTime)
+		{
+			FPlatformProcess::Sleep(static_cast<float>(FMath::Min(EndTime - LastTime, MaxTickSeconds)));
+			const double Now = FPlatformTime::Seconds();
+			TickWorld(World, Now - LastTime);
+			LastTime = Now;
+		}
+	}
+}
+
+UTuneXReplaySessionCommandlet::UTuneXReplaySessionCommandlet()
+{
+	IsClient = true;
+	IsEditor = true;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UTuneXReplaySessionCommandlet::Main(const FString& Params)
+{
+	using namespace TuneXReplaySession;
+
+	FString SessionPath;
+	if (!FParse::Value(*Params, TEXT("Session="), SessionPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuneXReplaySession: Missing -Session=<file.txsession>"));
+		return 1;
+	}
+
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("Replay.csv");
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+
+	int32 NumPasses = 1;
+	FParse::Value(*Params, TEXT("Repeat="), NumPasses);
+	NumPasses = FMath::Max(1, NumPasses);
+
+	const bool bMaxSpeed = FParse::Param(*Params, TEXT("MaxSpeed"));
+
+	FTuningSessionLog Log;
+	if (!Log.LoadFromFile(SessionPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuneXReplaySession: Could not read session %s"), *SessionPath);
+		return 1;
+	}
+
+	UVehicleConfigDataAsset* Config = Cast<UVehicleConfigDataAsset>(Log.ConfigPath.TryLoad());
+	if (!Config)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuneXReplaySession: Could not load catalog %s"), *Log.ConfigPath.ToString());
+		return 1;
+	}
+
+	if (Config->GetCatalogFingerprint() != Log.CatalogFingerprint)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuneXReplaySession: Catalog %s changed since the recording (%08x, recorded %08x); selections may diverge"),
+			*Config->GetName(), Config->GetCatalogFingerprint(), Log.CatalogFingerprint);
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false, TEXT("TuneXReplay"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// The recorded class brings the same components, sockets and defaults as the session had
+	UClass* VehicleClass = Log.VehicleClass.IsNull() ? nullptr : Log.VehicleClass.TryLoadClass<AActor>();
+	if (!VehicleClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuneXReplaySession: Could not load vehicle class '%s', replaying on AVehicleActor"), *Log.VehicleClass.ToString());
+		VehicleClass = AVehicleActor::StaticClass();
+	}
+
+	AActor* Vehicle = World->SpawnActor<AActor>(VehicleClass, FTransform::Identity, SpawnParams);
+	UVehicleMasterComponent* VehicleComponent = Vehicle ? Vehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	ATuningController* Controller = World->SpawnActor<ATuningController>(ATuningController::StaticClass(), FTransform::Identity, SpawnParams);
+
+	int32 ExitCode = 0;
+	if (!VehicleComponent || !Controller)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuneXReplaySession: Could not spawn the replay vehicle and controller"));
+		ExitCode = 1;
+	}
+	else
+	{
+		VehicleComponent->SetVehicleConfig(Config);
+		Controller->SetTargetVehicle(Vehicle);
+
+		// The picks were counted when the session was recorded
+		Controller->bOperationsArePicks = false;
+
+		TArray<float> Samples[NumTuningOperations];
+		int32 NumMismatches = 0;
+
+		FString Csv = TEXT("Pass,Entry,Time,Operation,Slot,Microseconds,Matched\n");
+		Csv.Reserve(Csv.Len() + Log.Entries.Num() * NumPasses * 64);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			// Every pass starts from the recorded build with its assets resident
+			VehicleComponent->ApplyBuildAsync(Log.InitialBuild);
+			FlushAsyncLoading();
+			TickWorld(World, MaxTickSeconds);
+
+			double PreviousTime = 0.0;
+			for (int32 EntryIndex = 0; EntryIndex < Log.Entries.Num(); ++EntryIndex)
+			{
+				const FTuningSessionEntry& Entry = Log.Entries[EntryIndex];
+				AdvanceTime(World, Entry.Time - PreviousTime, bMaxSpeed);
+				PreviousTime = Entry.Time;
+
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+				Controller->ExecuteTuningOperation(Entry.Operation);
+				const float Microseconds = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0);
+
+				Samples[static_cast<int32>(Entry.Operation.Type)].Add(Microseconds);
+
+				const bool bMatched = VehicleComponent->GetCurrentBuild() == Entry.Result;
+				if (!bMatched && ++NumMismatches <= 10)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("TuneXReplaySession: Entry %d (%s %s) produced a different build than recorded"),
+						EntryIndex, LexToString(Entry.Operation.Type), LexToString(Entry.Operation.Slot));
+				}
+
+				Csv.Appendf(TEXT("%d,%d,%.3f,%s,%s,%.1f,%d\n"), Pass, EntryIndex, Entry.Time,
+					LexToString(Entry.Operation.Type), LexToString(Entry.Operation.Slot), Microseconds, bMatched ? 1 : 0);
+			}
+
+			FlushAsyncLoading();
+		}
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogTemp, Display, TEXT("TuneXReplaySession: %d operations x %d passes in %.2f s (%s), %d mismatched builds"),
+			Log.Entries.Num(), NumPasses, TotalSeconds, bMaxSpeed ? TEXT("max speed") : TEXT("recorded speed"), NumMismatches);
+
+		for (int32 TypeIndex = 0; TypeIndex < NumTuningOperations; ++TypeIndex)
+		{
+			TArray<float>& TypeSamples = Samples[TypeIndex];
+			if (TypeSamples.Num() == 0)
+			{
+				continue;
+			}
+
+			TypeSamples.Sort();
+			double Sum = 0.0;
+			for (float Sample : TypeSamples)
+			{
+				Sum += Sample;
+			}
+
+			UE_LOG(LogTemp, Display, TEXT("TuneXReplaySession:   %-16s %8d ops, mean %.1f us, p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us"),
+				LexToString(static_cast<ETuningOperation>(TypeIndex)), TypeSamples.Num(), Sum / TypeSamples.Num(),
+				Percentile(TypeSamples, 0.50f), Percentile(TypeSamples, 0.95f), Percentile(TypeSamples, 0.99f), TypeSamples.Last());
+		}
+
+		if (FFileHelper::SaveStringToFile(Csv, *ReportPath))
+		{
+			UE_LOG(LogTemp, Display, TEXT("TuneXReplaySession: Report written to %s"), *ReportPath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("TuneXReplaySession: Failed to write report %s"), *ReportPath);
+		}
+
+		ExitCode = NumMismatches > 0 ? 1 : 0;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+
+	return ExitCode;
+}
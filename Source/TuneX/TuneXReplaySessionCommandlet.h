@@ -0,0 +1,36 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TuneXReplaySessionCommandlet.generated.h"
+
+/**
+ * Replays a recorded tuning session (.txsession) headlessly and reports per-operation timing
+ * A game world is created with one vehicle of the recorded class (AVehicleActor if it cannot be loaded) on the
+ * recorded catalog and a tuning controller; every operation goes through ATuningController::ExecuteTuningOperation,
+ * as it did when recorded. The world is ticked between operations so streaming, merging and audio run as they would
+ * in a session.
+ *
+ * Each resulting build is compared with the recorded one, so content changes that alter the
+ * workload are reported instead of silently producing different numbers.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd TuneX.uproject -run=TuneXReplaySession -Session=<file.txsession> [-MaxSpeed] [-Repeat=N] [-Report=<file.csv>]
+ *
+ * -MaxSpeed skips the recorded pauses (the world still advances by the recorded time, in one tick).
+ * The report has one row per operation: Pass, Entry, Time, Operation, Slot, Microseconds, Matched.
+ *
+ * Returns 0 when every build matched the recording, 1 otherwise.
+ */
+UCLASS()
+class TUNEX_API UTuneXReplaySessionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTuneXReplaySessionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,12 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+/**
+ * Stats group for TuneX runtime systems
+ * View in game with: stat TuneX
+ */
+DECLARE_STATS_GROUP(TEXT("TuneX"), STATGROUP_TuneX, STATCAT_Advanced);
@@ -0,0 +1,434 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuneXValidateCatalogCommandlet.h"
+#include "CarPartData.h"
+#include "VehicleCatalogManifest.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Sound/SoundWave.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+namespace TuneXValidateCatalog
+{
+	// What a soft reference is allowed to point at
+	enum EReferenceKind : uint8
+	{
+		Ref_Mesh		= 1 << 0,
+		Ref_Material	= 1 << 1,
+		Ref_Sound		= 1 << 2,
+	};
+
+	struct FResolvedReference
+	{
+		FTopLevelAssetPath ClassPath;
+
+		// Combination of EReferenceKind the asset satisfies (0 = exists but unsupported class)
+		uint8 KindMask = 0;
+
+		// Material slot count from the static mesh registry tags, INDEX_NONE if unknown
+		int32 NumMaterials = INDEX_NONE;
+
+		// Saved hash of the mesh's package, which baked part metadata must match
+		FString PackageHash;
+	};
+
+	struct FIssue
+	{
+		bool bError = true;
+		const TCHAR* Code = TEXT("");
+		FString Message;
+	};
+
+	struct FConfigResult
+	{
+		FString AssetPath;
+		int32 NumParts = 0;
+		int32 NumPaints = 0;
+		TArray<FIssue> Issues;
+
+		void Add(bool bError, const TCHAR* Code, FString&& Message)
+		{
+			FIssue& Issue = Issues.AddDefaulted_GetRef();
+			Issue.bError = bError;
+			Issue.Code = Code;
+			Issue.Message = MoveTemp(Message);
+		}
+	};
+
+	// Read-only lookup shared by all worker threads
+	using FReferenceTable = TMap<FSoftObjectPath, FResolvedReference>;
+
+	static void AddAssetsOfClass(IAssetRegistry& AssetRegistry, UClass* Class, uint8 KindMask, FReferenceTable& OutTable)
+	{
+		FARFilter Filter;
+		Filter.ClassPaths.Add(Class->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssets(Filter, Assets);
+
+		static const FName MaterialsTag(TEXT("Materials"));
+		for (const FAssetData& Asset : Assets)
+		{
+			FResolvedReference& Resolved = OutTable.FindOrAdd(Asset.GetSoftObjectPath());
+			Resolved.ClassPath = Asset.AssetClassPath;
+			Resolved.KindMask |= KindMask;
+
+			if (KindMask & Ref_Mesh)
+			{
+				Asset.GetTagValue(MaterialsTag, Resolved.NumMaterials);
+				if (const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(Asset.PackageName))
+				{
+					Resolved.PackageHash = LexToString(PackageData->GetPackageSavedHash());
+				}
+			}
+		}
+	}
+
+	static void CollectReferences(const FVehicleCatalogManifest& Manifest, TSet<FSoftObjectPath>& OutReferences)
+	{
+		for (const TArray<FVehicleCatalogManifestEntry>& SlotParts : Manifest.Parts)
+		{
+			for (const FVehicleCatalogManifestEntry& Entry : SlotParts)
+			{
+				OutReferences.Add(Entry.Asset);
+				OutReferences.Add(Entry.SoundModifier);
+				OutReferences.Append(Entry.MaterialOverrides);
+			}
+		}
+		for (const FVehicleCatalogManifestEntry& Entry : Manifest.Paints)
+		{
+			OutReferences.Add(Entry.Asset);
+		}
+	}
+
+	static const FResolvedReference* CheckReference(
+		const FReferenceTable& Table, const FSoftObjectPath& Path, uint8 ExpectedKind,
+		const TCHAR* Context, FConfigResult& Result)
+	{
+		const FResolvedReference* Resolved = Table.Find(Path);
+		if (!Resolved)
+		{
+			Result.Add(true, TEXT("MissingReference"),
+				FString::Printf(TEXT("%s references '%s' which does not exist"), Context, *Path.ToString()));
+			return nullptr;
+		}
+
+		if ((Resolved->KindMask & ExpectedKind) == 0)
+		{
+			Result.Add(true, TEXT("WrongClassReference"),
+				FString::Printf(TEXT("%s references '%s' of class %s"), Context, *Path.ToString(), *Resolved->ClassPath.ToString()));
+			return nullptr;
+		}
+
+		return Resolved;
+	}
+
+	static void CheckDefaultIndex(int32 Index, int32 Num, const TCHAR* Name, FConfigResult& Result)
+	{
+		// Empty lists are skipped by InitializeVehicle, so any default is harmless there
+		if (Num > 0 && (Index < 0 || Index >= Num))
+		{
+			Result.Add(true, TEXT("DefaultIndexOutOfRange"),
+				FString::Printf(TEXT("%s is %d but only %d entries exist"), Name, Index, Num));
+		}
+	}
+
+	static void ValidateManifest(
+		const FVehicleCatalogManifest& Manifest, const FReferenceTable& Table,
+		const TSet<FName>& KnownTags, FConfigResult& Result)
+	{
+		TMap<FName, FString> SeenPartIDs;
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			const TCHAR* SlotName = LexToString(static_cast<EVehiclePartSlot>(SlotIndex));
+			const TArray<FVehicleCatalogManifestEntry>& SlotParts = Manifest.Parts[SlotIndex];
+			Result.NumParts += SlotParts.Num();
+
+			for (int32 PartIndex = 0; PartIndex < SlotParts.Num(); ++PartIndex)
+			{
+				const FVehicleCatalogManifestEntry& Entry = SlotParts[PartIndex];
+				const FString Context = FString::Printf(TEXT("%s[%d] '%s'"), SlotName, PartIndex, *Entry.ID.ToString());
+
+				if (Entry.ID.IsNone())
+				{
+					Result.Add(true, TEXT("MissingID"), FString::Printf(TEXT("%s has no PartID"), *Context));
+				}
+				else if (const FString* Existing = SeenPartIDs.Find(Entry.ID))
+				{
+					Result.Add(true, TEXT("DuplicatePartID"),
+						FString::Printf(TEXT("%s duplicates the PartID of %s"), *Context, **Existing));
+				}
+				else
+				{
+					SeenPartIDs.Add(Entry.ID, Context);
+				}
+
+				const FResolvedReference* Mesh = nullptr;
+				if (Entry.Asset.IsNull())
+				{
+					Result.Add(false, TEXT("EmptyMeshAsset"), FString::Printf(TEXT("%s has no MeshAsset"), *Context));
+				}
+				else
+				{
+					Mesh = CheckReference(Table, Entry.Asset, Ref_Mesh, *Context, Result);
+				}
+
+				for (const FSoftObjectPath& Material : Entry.MaterialOverrides)
+				{
+					if (!Material.IsNull())
+					{
+						CheckReference(Table, Material, Ref_Material, *Context, Result);
+					}
+				}
+
+				if (Mesh && Mesh->NumMaterials != INDEX_NONE && Entry.MaterialOverrides.Num() > Mesh->NumMaterials)
+				{
+					Result.Add(true, TEXT("MaterialOverrideCountMismatch"),
+						FString::Printf(TEXT("%s has %d material overrides but its mesh only has %d material slots"),
+							*Context, Entry.MaterialOverrides.Num(), Mesh->NumMaterials));
+				}
+
+				if (Mesh && !Mesh->PackageHash.IsEmpty())
+				{
+					if (Entry.MetadataHash.IsEmpty())
+					{
+						Result.Add(false, TEXT("MissingPartMetadata"),
+							FString::Printf(TEXT("%s has no metadata baked from its mesh; run TuneXBakePartMetadata"), *Context));
+					}
+					else if (Entry.MetadataHash != Mesh->PackageHash)
+					{
+						Result.Add(false, TEXT("StalePartMetadata"),
+							FString::Printf(TEXT("%s has metadata older than its mesh; run TuneXBakePartMetadata"), *Context));
+					}
+				}
+
+				if (!Entry.SoundModifier.IsNull())
+				{
+					CheckReference(Table, Entry.SoundModifier, Ref_Sound, *Context, Result);
+				}
+
+				if (KnownTags.Num() > 0)
+				{
+					for (FName Tag : Entry.CompatibilityTags)
+					{
+						if (!KnownTags.Contains(Tag))
+						{
+							Result.Add(true, TEXT("UnknownCompatibilityTag"),
+								FString::Printf(TEXT("%s uses unknown compatibility tag '%s'"), *Context, *Tag.ToString()));
+						}
+					}
+				}
+			}
+		}
+
+		TSet<FName> SeenPaintIDs;
+		Result.NumPaints = Manifest.Paints.Num();
+		for (int32 PaintIndex = 0; PaintIndex < Manifest.Paints.Num(); ++PaintIndex)
+		{
+			const FVehicleCatalogManifestEntry& Entry = Manifest.Paints[PaintIndex];
+			const FString Context = FString::Printf(TEXT("PaintColors[%d] '%s'"), PaintIndex, *Entry.ID.ToString());
+
+			bool bAlreadySeen = false;
+			SeenPaintIDs.Add(Entry.ID, &bAlreadySeen);
+			if (Entry.ID.IsNone())
+			{
+				Result.Add(true, TEXT("MissingID"), FString::Printf(TEXT("%s has no PaintID"), *Context));
+			}
+			else if (bAlreadySeen)
+			{
+				Result.Add(true, TEXT("DuplicatePaintID"), FString::Printf(TEXT("%s duplicates an earlier PaintID"), *Context));
+			}
+
+			if (Entry.Asset.IsNull())
+			{
+				Result.Add(true, TEXT("EmptyMaterial"), FString::Printf(TEXT("%s has no Material"), *Context));
+			}
+			else
+			{
+				CheckReference(Table, Entry.Asset, Ref_Material, *Context, Result);
+			}
+		}
+
+		CheckDefaultIndex(Manifest.DefaultFrontBumperIndex, Manifest.Parts[static_cast<int32>(EVehiclePartSlot::FrontBumper)].Num(), TEXT("DefaultFrontBumperIndex"), Result);
+		CheckDefaultIndex(Manifest.DefaultRearBumperIndex, Manifest.Parts[static_cast<int32>(EVehiclePartSlot::RearBumper)].Num(), TEXT("DefaultRearBumperIndex"), Result);
+		CheckDefaultIndex(Manifest.DefaultPaintIndex, Manifest.Paints.Num(), TEXT("DefaultPaintIndex"), Result);
+	}
+}
+
+UTuneXValidateCatalogCommandlet::UTuneXValidateCatalogCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTuneXValidateCatalogCommandlet::Main(const FString& Params)
+{
+	using namespace TuneXValidateCatalog;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("CatalogValidation.json");
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+
+	FString PackagePath;
+	FParse::Value(*Params, TEXT("Path="), PackagePath);
+
+	TSet<FName> KnownTags(KnownCompatibilityTags);
+	FString KnownTagsParam;
+	if (FParse::Value(*Params, TEXT("KnownTags="), KnownTagsParam, /*bShouldStopOnSeparator*/ false))
+	{
+		TArray<FString> TagStrings;
+		KnownTagsParam.ParseIntoArray(TagStrings, TEXT(","), /*InCullEmpty*/ true);
+		for (const FString& Tag : TagStrings)
+		{
+			KnownTags.Add(FName(*Tag));
+		}
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(/*bSynchronousSearch*/ true);
+
+	// Gather config assets (registry data only, nothing is loaded)
+	TArray<FAssetData> ConfigAssets;
+	{
+		FARFilter Filter;
+		Filter.ClassPaths.Add(UVehicleConfigDataAsset::StaticClass()->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+		if (!PackagePath.IsEmpty())
+		{
+			Filter.PackagePaths.Add(FName(*PackagePath));
+			Filter.bRecursivePaths = true;
+		}
+		AssetRegistry.GetAssets(Filter, ConfigAssets);
+	}
+
+	// Decode every manifest in parallel
+	TArray<FVehicleCatalogManifest> Manifests;
+	Manifests.SetNum(ConfigAssets.Num());
+	TArray<bool> HasManifest;
+	HasManifest.SetNumZeroed(ConfigAssets.Num());
+
+	ParallelFor(ConfigAssets.Num(), [&](int32 Index)
+	{
+		FString Encoded;
+		if (ConfigAssets[Index].GetTagValue(FVehicleCatalogManifest::AssetRegistryTagName, Encoded))
+		{
+			HasManifest[Index] = FVehicleCatalogManifest::Decode(Encoded, Manifests[Index]);
+		}
+	});
+
+	// Build the reference table from typed registry queries, then classify whatever is left over
+	FReferenceTable References;
+	AddAssetsOfClass(AssetRegistry, UStaticMesh::StaticClass(), Ref_Mesh, References);
+	AddAssetsOfClass(AssetRegistry, UMaterialInterface::StaticClass(), Ref_Material, References);
+	AddAssetsOfClass(AssetRegistry, USoundWave::StaticClass(), Ref_Sound, References);
+
+	TSet<FSoftObjectPath> Referenced;
+	for (int32 Index = 0; Index < Manifests.Num(); ++Index)
+	{
+		if (HasManifest[Index])
+		{
+			CollectReferences(Manifests[Index], Referenced);
+		}
+	}
+
+	for (const FSoftObjectPath& Path : Referenced)
+	{
+		if (!Path.IsNull() && !References.Contains(Path))
+		{
+			const FAssetData Asset = AssetRegistry.GetAssetByObjectPath(Path);
+			if (Asset.IsValid())
+			{
+				References.Add(Path).ClassPath = Asset.AssetClassPath;
+			}
+		}
+	}
+
+	// Validate every config in parallel against the read-only table
+	TArray<FConfigResult> Results;
+	Results.SetNum(ConfigAssets.Num());
+
+	ParallelFor(ConfigAssets.Num(), [&](int32 Index)
+	{
+		FConfigResult& Result = Results[Index];
+		Result.AssetPath = ConfigAssets[Index].GetObjectPathString();
+
+		if (!HasManifest[Index])
+		{
+			Result.Add(true, TEXT("MissingManifest"),
+				TEXT("No catalog manifest in the Asset Registry; resave the asset to validate it"));
+			return;
+		}
+
+		ValidateManifest(Manifests[Index], References, KnownTags, Result);
+	});
+
+	// Write the report
+	int32 NumErrors = 0;
+	int32 NumWarnings = 0;
+	for (const FConfigResult& Result : Results)
+	{
+		for (const FIssue& Issue : Result.Issues)
+		{
+			(Issue.bError ? NumErrors : NumWarnings)++;
+		}
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	FString Json;
+	TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Json);
+	Writer->WriteObjectStart();
+
+	Writer->WriteObjectStart(TEXT("summary"));
+	Writer->WriteValue(TEXT("configs"), ConfigAssets.Num());
+	Writer->WriteValue(TEXT("errors"), NumErrors);
+	Writer->WriteValue(TEXT("warnings"), NumWarnings);
+	Writer->WriteValue(TEXT("knownTagsChecked"), KnownTags.Num() > 0);
+	Writer->WriteValue(TEXT("seconds"), ElapsedSeconds);
+	Writer->WriteObjectEnd();
+
+	Writer->WriteArrayStart(TEXT("configs"));
+	for (const FConfigResult& Result : Results)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("asset"), Result.AssetPath);
+		Writer->WriteValue(TEXT("parts"), Result.NumParts);
+		Writer->WriteValue(TEXT("paints"), Result.NumPaints);
+		Writer->WriteArrayStart(TEXT("issues"));
+		for (const FIssue& Issue : Result.Issues)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("severity"), FString(Issue.bError ? TEXT("error") : TEXT("warning")));
+			Writer->WriteValue(TEXT("code"), FString(Issue.Code));
+			Writer->WriteValue(TEXT("message"), Issue.Message);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Json, *ReportPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuneXValidateCatalog: Failed to write report to %s"), *ReportPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("TuneXValidateCatalog: %d configs, %d errors, %d warnings in %.2fs. Report: %s"),
+		ConfigAssets.Num(), NumErrors, NumWarnings, ElapsedSeconds, *ReportPath);
+
+	return NumErrors > 0 ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TuneXValidateCatalogCommandlet.generated.h"
+
+/**
+ * Validates every UVehicleConfigDataAsset in the project using Asset Registry data only
+ * No packages are loaded: configs are read from their catalog manifest tag and references are
+ * resolved against registry entries, so thousands of configs validate in seconds.
+ *
+ * Checks: duplicate part/paint IDs, missing or wrong-class soft references, out-of-range default
+ * indices, unknown compatibility tags, material override counts exceeding the mesh's slots and part
+ * metadata missing or baked from an older version of the mesh (see TuneXBakePartMetadata).
+ *
+ * Usage:
+ *   UnrealEditor-Cmd TuneX.uproject -run=TuneXValidateCatalog [-Path=/Game/Cars] [-Report=<file.json>] [-KnownTags=A,B]
+ *
+ * Returns 0 when no errors were found, 1 otherwise.
+ */
+UCLASS(config=Game)
+class TUNEX_API UTuneXValidateCatalogCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTuneXValidateCatalogCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	// Compatibility tags considered valid; the check is skipped when empty
+	UPROPERTY(config)
+	TArray<FName> KnownCompatibilityTags;
+};
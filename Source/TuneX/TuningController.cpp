@@ -2,13 +2,25 @@
 
 #include "TuningController.h"
 #include "VehicleMasterComponent.h"
+#include "VehiclePartConstraints.h"
+#include "TuningHitchWatchdog.h"
 #include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ScopeExit.h"
 
 ATuningController::ATuningController()
 {
 	TargetVehicle = nullptr;
 	bAutoFindVehicle = true;
+	bOperationsArePicks = true;
+
+	ScrubSlot = EVehiclePartSlot::FrontBumper;
+	ScrubInitialRate = 4.0f;
+	ScrubMaxRate = 40.0f;
+	ScrubAccelerationTime = 1.5f;
+	ScrubSettleTime = 0.3f;
+	ScrubProxyLookahead = 8;
 }
 
 void ATuningController::BeginPlay()
@@ -19,6 +31,20 @@ void ATuningController::BeginPlay()
 	{
 		AutoFindVehicle();
 	}
+
+	// -TuneXRecordSession[=<file>] records from the start, for showroom machines
+	FString RecordFilename;
+	if (IsLocalController() && (FParse::Value(FCommandLine::Get(), TEXT("TuneXRecordSession="), RecordFilename) || FParse::Param(FCommandLine::Get(), TEXT("TuneXRecordSession"))))
+	{
+		StartSessionRecording(RecordFilename);
+	}
+}
+
+void ATuningController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopSessionRecording();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ATuningController::SetupInputComponent()
@@ -37,20 +63,345 @@ void ATuningController::SetupInputComponent()
 		InputComponent->BindAction("PaintOption2", IE_Pressed, this, &ATuningController::HandlePaintInputW);
 		InputComponent->BindAction("PaintOption3", IE_Pressed, this, &ATuningController::HandlePaintInputE);
 
-		UE_LOG(LogTemp, Log, TEXT("TuningController: Input bindings set up. Use 1/2/3 for bumpers, Q/W/E for paint."));
+		// Bind catalog scrubbing (hold Left/Right, Tab switches category)
+		InputComponent->BindAction("ScrubNext", IE_Pressed, this, &ATuningController::HandleScrubNextPressed);
+		InputComponent->BindAction("ScrubNext", IE_Released, this, &ATuningController::HandleScrubReleased);
+		InputComponent->BindAction("ScrubPrevious", IE_Pressed, this, &ATuningController::HandleScrubPreviousPressed);
+		InputComponent->BindAction("ScrubPrevious", IE_Released, this, &ATuningController::HandleScrubReleased);
+		InputComponent->BindAction("ScrubCategory", IE_Pressed, this, &ATuningController::CycleScrubSlot);
+
+		UE_LOG(LogTemp, Log, TEXT("TuningController: Input bindings set up. Use 1/2/3 for bumpers, Q/W/E for paint, hold Left/Right to scrub."));
 	}
 }
 
+void ATuningController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (ScrubDirection == 0 && !bScrubPreviewPending)
+	{
+		return;
+	}
+
+	UVehicleMasterComponent* VehicleComponent = TargetVehicle ? TargetVehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	if (!VehicleComponent)
+	{
+		ScrubDirection = 0;
+		bScrubPreviewPending = false;
+		return;
+	}
+
+	ScrubIdleTime += DeltaTime;
+
+	if (ScrubDirection != 0)
+	{
+		// Ramp linearly from the initial to the maximum rate while held
+		ScrubHeldTime += DeltaTime;
+		const float Alpha = ScrubAccelerationTime > 0.0f ? FMath::Clamp(ScrubHeldTime / ScrubAccelerationTime, 0.0f, 1.0f) : 1.0f;
+		ScrubStepAccumulator += FMath::Lerp(ScrubInitialRate, FMath::Max(ScrubMaxRate, ScrubInitialRate), Alpha) * DeltaTime;
+
+		while (ScrubStepAccumulator >= 1.0f)
+		{
+			ScrubStepAccumulator -= 1.0f;
+			StepScrub(VehicleComponent);
+		}
+	}
+	else if (ScrubIdleTime >= ScrubSettleTime)
+	{
+		SettleScrub(VehicleComponent);
+	}
+}
+
+bool ATuningController::ExecuteTuningOperation(const FTuningOperation& Operation)
+{
+	UVehicleMasterComponent* VehicleComponent = TargetVehicle ? TargetVehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	if (!VehicleComponent)
+	{
+		return false;
+	}
+
+	FTuningHitchOperationScope TuneXHitchOperation(LexToString(Operation.Type));
+	TuneXHitchOperation.SetPartID(Operation.ID);
+
+	const bool bWasNotAPick = VehicleComponent->IsNotAPick();
+	VehicleComponent->SetNotAPick(bWasNotAPick || !bOperationsArePicks);
+	ON_SCOPE_EXIT
+	{
+		VehicleComponent->SetNotAPick(bWasNotAPick);
+	};
+
+	bool bChanged = false;
+	switch (Operation.Type)
+	{
+	case ETuningOperation::SetPartByID:		bChanged = VehicleComponent->SetPartByID(Operation.Slot, Operation.ID); break;
+	case ETuningOperation::SetPartByIndex:	bChanged = VehicleComponent->SetPartByIndex(Operation.Slot, Operation.Index); break;
+	case ETuningOperation::CycleNextPart:	bChanged = VehicleComponent->CycleNextPart(Operation.Slot); break;
+	case ETuningOperation::SetPaintByID:	bChanged = VehicleComponent->SetPaintByID(Operation.ID); break;
+	case ETuningOperation::SetPaintByIndex:	bChanged = VehicleComponent->SetPaintByIndex(Operation.Index); break;
+	case ETuningOperation::CycleNextPaint:	bChanged = VehicleComponent->CycleNextPaint(); break;
+	default:
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: %s is not a vehicle operation"), LexToString(Operation.Type));
+		return false;
+	}
+
+	if (bChanged)
+	{
+		CommitVehicleBuild(VehicleComponent, Operation);
+	}
+	return bChanged;
+}
+
+void ATuningController::BeginScrub(int32 Direction)
+{
+	UVehicleMasterComponent* VehicleComponent = TargetVehicle ? TargetVehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	if (!VehicleComponent || Direction == 0)
+	{
+		return;
+	}
+
+	if (!bScrubPreviewPending)
+	{
+		ScrubStepCount = 0;
+	}
+
+	ScrubDirection = Direction > 0 ? 1 : -1;
+	ScrubHeldTime = 0.0f;
+	ScrubStepAccumulator = 0.0f;
+
+	// A tap still moves one part
+	StepScrub(VehicleComponent);
+}
+
+void ATuningController::EndScrub()
+{
+	ScrubDirection = 0;
+}
+
+void ATuningController::CycleScrubSlot()
+{
+	if (bScrubPreviewPending)
+	{
+		if (UVehicleMasterComponent* VehicleComponent = TargetVehicle ? TargetVehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr)
+		{
+			SettleScrub(VehicleComponent);
+		}
+	}
+
+	ScrubDirection = 0;
+	ScrubSlot = static_cast<EVehiclePartSlot>((static_cast<int32>(ScrubSlot) + 1) % NumVehiclePartSlots);
+	UE_LOG(LogTemp, Display, TEXT("TuningController: Scrubbing %s"), LexToString(ScrubSlot));
+}
+
+void ATuningController::StepScrub(UVehicleMasterComponent* VehicleComponent)
+{
+	if (!VehicleComponent->VehicleConfig)
+	{
+		return;
+	}
+
+	const int32 NumParts = VehicleComponent->VehicleConfig->GetParts(ScrubSlot).Num();
+	if (NumParts == 0)
+	{
+		return;
+	}
+
+	const int32 FromIndex = FMath::Max(VehicleComponent->GetPreviewIndex(ScrubSlot), 0);
+	const int32 NextIndex = (FromIndex + ScrubDirection + NumParts) % NumParts;
+
+	if (VehicleComponent->PreviewPartByIndex(ScrubSlot, NextIndex))
+	{
+		VehicleComponent->PrefetchPartProxies(ScrubSlot, NextIndex, ScrubDirection, ScrubProxyLookahead);
+		bScrubPreviewPending = true;
+		ScrubIdleTime = 0.0f;
+		++ScrubStepCount;
+	}
+}
+
+void ATuningController::SettleScrub(UVehicleMasterComponent* VehicleComponent)
+{
+	bScrubPreviewPending = false;
+
+	const FVehicleBuild Build = VehicleComponent->CommitPreview();
+	const int32 Index = Build.GetPartIndex(ScrubSlot);
+	if (VehicleComponent->VehicleConfig && VehicleComponent->VehicleConfig->GetParts(ScrubSlot).IsValidIndex(Index))
+	{
+		UE_LOG(LogTemp, Display, TEXT("✓ %s settled on: %s (after scrubbing %d parts)"),
+			LexToString(ScrubSlot), *VehicleComponent->VehicleConfig->GetParts(ScrubSlot)[Index].DisplayName, ScrubStepCount);
+	}
+
+	CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPartByIndex, ScrubSlot, Index), Build);
+}
+
 void ATuningController::SetTargetVehicle(AActor* Vehicle)
 {
+	if (bScrubPreviewPending && TargetVehicle)
+	{
+		if (UVehicleMasterComponent* PreviousComponent = TargetVehicle->FindComponentByClass<UVehicleMasterComponent>())
+		{
+			PreviousComponent->CancelPreview();
+		}
+	}
+	ScrubDirection = 0;
+	bScrubPreviewPending = false;
+
 	TargetVehicle = Vehicle;
 	
 	if (TargetVehicle)
 	{
 		UE_LOG(LogTemp, Log, TEXT("TuningController: Target vehicle set to %s"), *TargetVehicle->GetName());
+
+		// Catalog handshake so mismatched content is caught at join instead of on the first build
+		UVehicleMasterComponent* VehicleComponent = TargetVehicle->FindComponentByClass<UVehicleMasterComponent>();
+		if (VehicleComponent && VehicleComponent->VehicleConfig && IsLocalController() && !HasAuthority())
+		{
+			ServerReportCatalogFingerprint(VehicleComponent->VehicleConfig, VehicleComponent->VehicleConfig->GetCatalogFingerprint());
+		}
+	}
+}
+
+void ATuningController::CommitVehicleBuild(UVehicleMasterComponent* VehicleComponent, const FTuningOperation& Operation)
+{
+	if (VehicleComponent)
+	{
+		CommitVehicleBuild(VehicleComponent, Operation, VehicleComponent->GetCurrentBuild());
+	}
+}
+
+void ATuningController::CommitVehicleBuild(UVehicleMasterComponent* VehicleComponent, const FTuningOperation& Operation, const FVehicleBuild& Build)
+{
+	if (!VehicleComponent)
+	{
+		return;
+	}
+
+	if (bRecordingSession && VehicleComponent->GetOwner() == SessionVehicle.Get())
+	{
+		FTuningSessionEntry Entry;
+		Entry.Time = FPlatformTime::Seconds() - SessionStartTime;
+		Entry.Operation = Operation;
+		Entry.Result = Build;
+		if (!SessionWriter.Append(Entry))
+		{
+			UE_LOG(LogTemp, Error, TEXT("TuningController: Failed to append to session log %s, stopping the recording"), *SessionFilename);
+			StopSessionRecording();
+		}
+	}
+
+	if (IsLocalController() && !HasAuthority())
+	{
+		ServerApplyVehicleBuild(VehicleComponent->GetOwner(), Build);
+	}
+}
+
+bool ATuningController::StartSessionRecording(const FString& Filename)
+{
+	UVehicleMasterComponent* VehicleComponent = TargetVehicle ? TargetVehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	if (!VehicleComponent || !VehicleComponent->VehicleConfig)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: Cannot record a session without a configured target vehicle"));
+		return false;
+	}
+
+	if (bRecordingSession)
+	{
+		StopSessionRecording();
+	}
+
+	FTuningSessionLog Header;
+	Header.ConfigPath = FSoftObjectPath(VehicleComponent->VehicleConfig);
+	Header.VehicleClass = FSoftClassPath(TargetVehicle->GetClass());
+	Header.CatalogFingerprint = VehicleComponent->VehicleConfig->GetCatalogFingerprint();
+	Header.InitialBuild = VehicleComponent->GetCurrentBuild();
+
+	// Entries go to disk as they are committed, so a crash keeps the session up to that point
+	SessionFilename = Filename.IsEmpty() ? FTuningSessionLog::MakeDefaultFilename() : Filename;
+	if (!SessionWriter.Open(SessionFilename, Header))
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuningController: Could not create session log %s"), *SessionFilename);
+		return false;
+	}
+
+	SessionVehicle = TargetVehicle;
+	SessionStartTime = FPlatformTime::Seconds();
+	bRecordingSession = true;
+
+	UE_LOG(LogTemp, Display, TEXT("TuningController: Recording session on %s to %s"), *TargetVehicle->GetName(), *SessionFilename);
+	return true;
+}
+
+bool ATuningController::StopSessionRecording()
+{
+	if (!bRecordingSession)
+	{
+		return false;
+	}
+
+	bRecordingSession = false;
+	SessionVehicle = nullptr;
+
+	UE_LOG(LogTemp, Display, TEXT("TuningController: Saved %d session operations to %s"), SessionWriter.GetNumEntries(), *SessionFilename);
+	SessionWriter.Close();
+	return true;
+}
+
+void ATuningController::ServerApplyVehicleBuild_Implementation(AActor* Vehicle, const FVehicleBuild& Build)
+{
+	// Only the player's own vehicle: owned by this controller or its pawn, or the pawn itself
+	const APawn* ControlledPawn = GetPawn();
+	const bool bOwnsVehicle = Vehicle && (Vehicle == ControlledPawn || Vehicle->GetOwner() == this
+		|| (ControlledPawn && Vehicle->GetOwner() == ControlledPawn) || Vehicle->GetInstigatorController() == this);
+	if (!bOwnsVehicle)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: Rejected build from %s for %s, which it does not own"),
+			*GetName(), Vehicle ? *Vehicle->GetName() : TEXT("None"));
+		return;
+	}
+
+	UVehicleMasterComponent* VehicleComponent = Vehicle->FindComponentByClass<UVehicleMasterComponent>();
+	if (!VehicleComponent || !VehicleComponent->VehicleConfig || !Build.IsValidFor(*VehicleComponent->VehicleConfig))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: Rejected build from %s"), *GetName());
+		return;
+	}
+
+	// Indices in range are not enough: the build must also fit the chassis and meet requires/excludes
+	const UVehicleConfigDataAsset& Config = *VehicleComponent->VehicleConfig;
+	UVehiclePartConstraintSubsystem* Rules = UVehiclePartConstraintSubsystem::Get();
+	const FVehicleConstraintResult RuleResult = Rules ? Rules->GetConstraints(Config)->Validate(Build) : FVehiclePartConstraints::Compile(Config)->Validate(Build);
+	if (!RuleResult.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: Rejected build from %s breaking the rules of %s (%s in slot %d)"),
+			*GetName(), *Config.GetName(), *UEnum::GetValueAsString(RuleResult.Violation), static_cast<int32>(RuleResult.Slot));
+		return;
+	}
+
+	// Publish right away; the server applies the meshes once they have streamed in
+	VehicleComponent->SetReplicatedBuild(Build);
+	VehicleComponent->ApplyBuildAsync(Build);
+}
+
+void ATuningController::ServerReportCatalogFingerprint_Implementation(UVehicleConfigDataAsset* Config, uint32 Fingerprint)
+{
+	if (!Config)
+	{
+		return;
+	}
+
+	const uint32 ServerFingerprint = Config->GetCatalogFingerprint();
+	if (Fingerprint != ServerFingerprint)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningController: %s has a different '%s' catalog (client %08x, server %08x)"),
+			*GetName(), *Config->GetName(), Fingerprint, ServerFingerprint);
+		ClientCatalogMismatch(Config, ServerFingerprint);
 	}
 }
 
+void ATuningController::ClientCatalogMismatch_Implementation(UVehicleConfigDataAsset* Config, uint32 ServerFingerprint)
+{
+	UE_LOG(LogTemp, Error, TEXT("TuningController: Catalog '%s' differs from the server (server %08x); other players' builds will not be shown"),
+		Config ? *Config->GetName() : TEXT("None"), ServerFingerprint);
+}
+
 void ATuningController::AutoFindVehicle()
 {
 	if (UWorld* World = GetWorld())
@@ -111,6 +462,21 @@ void ATuningController::HandlePaintInputE()
 	SelectPaintOption3();
 }
 
+void ATuningController::HandleScrubNextPressed()
+{
+	BeginScrub(1);
+}
+
+void ATuningController::HandleScrubPreviousPressed()
+{
+	BeginScrub(-1);
+}
+
+void ATuningController::HandleScrubReleased()
+{
+	EndScrub();
+}
+
 void ATuningController::SelectBumperOption1()
 {
 	if (!TargetVehicle)
@@ -126,6 +492,7 @@ void ATuningController::SelectBumperOption1()
 		{
 			FCarPart CurrentBumper = VehicleComponent->GetCurrentFrontBumper();
 			UE_LOG(LogTemp, Display, TEXT("✓ Bumper changed to: %s (Option 1)"), *CurrentBumper.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPartByIndex, EVehiclePartSlot::FrontBumper, 0));
 		}
 	}
 	else
@@ -148,6 +515,7 @@ void ATuningController::SelectBumperOption2()
 		{
 			FCarPart CurrentBumper = VehicleComponent->GetCurrentFrontBumper();
 			UE_LOG(LogTemp, Display, TEXT("✓ Bumper changed to: %s (Option 2)"), *CurrentBumper.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPartByIndex, EVehiclePartSlot::FrontBumper, 1));
 		}
 	}
 	else
@@ -170,6 +538,7 @@ void ATuningController::SelectBumperOption3()
 		{
 			FCarPart CurrentBumper = VehicleComponent->GetCurrentFrontBumper();
 			UE_LOG(LogTemp, Display, TEXT("✓ Bumper changed to: %s (Option 3)"), *CurrentBumper.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPartByIndex, EVehiclePartSlot::FrontBumper, 2));
 		}
 	}
 	else
@@ -192,6 +561,7 @@ void ATuningController::SelectPaintOption1()
 		{
 			FPaintColor CurrentPaint = VehicleComponent->GetCurrentPaint();
 			UE_LOG(LogTemp, Display, TEXT("✓ Paint changed to: %s (Option 1)"), *CurrentPaint.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPaintByIndex, EVehiclePartSlot::FrontBumper, 0));
 		}
 	}
 	else
@@ -214,6 +584,7 @@ void ATuningController::SelectPaintOption2()
 		{
 			FPaintColor CurrentPaint = VehicleComponent->GetCurrentPaint();
 			UE_LOG(LogTemp, Display, TEXT("✓ Paint changed to: %s (Option 2)"), *CurrentPaint.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPaintByIndex, EVehiclePartSlot::FrontBumper, 1));
 		}
 	}
 	else
@@ -236,6 +607,7 @@ void ATuningController::SelectPaintOption3()
 		{
 			FPaintColor CurrentPaint = VehicleComponent->GetCurrentPaint();
 			UE_LOG(LogTemp, Display, TEXT("✓ Paint changed to: %s (Option 3)"), *CurrentPaint.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::SetPaintByIndex, EVehiclePartSlot::FrontBumper, 2));
 		}
 	}
 	else
@@ -258,6 +630,7 @@ void ATuningController::CycleNextBumper()
 		{
 			FCarPart CurrentBumper = VehicleComponent->GetCurrentFrontBumper();
 			UE_LOG(LogTemp, Display, TEXT("✓ Bumper cycled to: %s"), *CurrentBumper.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::CycleNextPart, EVehiclePartSlot::FrontBumper));
 		}
 	}
 }
@@ -276,6 +649,29 @@ void ATuningController::CycleNextPaint()
 		{
 			FPaintColor CurrentPaint = VehicleComponent->GetCurrentPaint();
 			UE_LOG(LogTemp, Display, TEXT("✓ Paint cycled to: %s"), *CurrentPaint.DisplayName);
+			CommitVehicleBuild(VehicleComponent, FTuningOperation(ETuningOperation::CycleNextPaint));
 		}
 	}
 }
+
+static FAutoConsoleCommandWithWorldAndArgs GTuningSessionRecordCommand(
+	TEXT("TuneX.Session.Record"),
+	TEXT("Records the local tuning session for replay with -run=TuneXReplaySession. Usage: TuneX.Session.Record [File]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (ATuningController* Controller = World ? Cast<ATuningController>(World->GetFirstPlayerController()) : nullptr)
+		{
+			Controller->StartSessionRecording(Args.Num() > 0 ? Args[0] : FString());
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld GTuningSessionStopCommand(
+	TEXT("TuneX.Session.Stop"),
+	TEXT("Stops recording the tuning session and writes the log"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (ATuningController* Controller = World ? Cast<ATuningController>(World->GetFirstPlayerController()) : nullptr)
+		{
+			Controller->StopSessionRecording();
+		}
+	}));
@@ -5,8 +5,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "VehicleModifierInterface.h"
+#include "VehicleBuild.h"
+#include "TuningOperation.h"
+#include "TuningSessionLog.h"
 #include "TuningController.generated.h"
 
+class UVehicleMasterComponent;
+
 /**
  * Player controller specialized for vehicle tuning
  * Handles keyboard input for cycling through vehicle options
@@ -22,6 +27,8 @@ public:
 protected:
 	virtual void SetupInputComponent() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PlayerTick(float DeltaTime) override;
 
 public:
 	// Reference to the vehicle being tuned
@@ -32,6 +39,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
 	bool bAutoFindVehicle;
 
+	// Part category browsed by the scrub inputs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub")
+	EVehiclePartSlot ScrubSlot;
+
+	// Whether changes made by ExecuteTuningOperation count as player picks; soak runs and session replays turn it off
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
+	bool bOperationsArePicks;
+
+	// Parts per second when a scrub input is first held
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub", meta = (ClampMin = "0.1"))
+	float ScrubInitialRate;
+
+	// Parts per second once the scrub has fully accelerated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub", meta = (ClampMin = "0.1"))
+	float ScrubMaxRate;
+
+	// Seconds of holding to go from the initial to the maximum rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub", meta = (ClampMin = "0.0"))
+	float ScrubAccelerationTime;
+
+	// Seconds the selection must rest after release before full assets are requested
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub", meta = (ClampMin = "0.0"))
+	float ScrubSettleTime;
+
+	// Parts ahead of the scrub whose proxies are streamed in
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning|Scrub", meta = (ClampMin = "0"))
+	int32 ScrubProxyLookahead;
+
 	/**
 	 * Sets the target vehicle for tuning
 	 * @param Vehicle - The vehicle actor to tune
@@ -87,7 +122,96 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Tuning")
 	void CycleNextPaint();
 
+	/**
+	 * Runs a vehicle operation on the target vehicle and forwards the result to the server
+	 * @param Operation - One of the vehicle operations (see FTuningOperation::IsVehicleOperation)
+	 * @return true if the vehicle changed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning")
+	bool ExecuteTuningOperation(const FTuningOperation& Operation);
+
+	/**
+	 * Starts recording every committed operation on the target vehicle, with timestamps and resulting builds
+	 * Also started by -TuneXRecordSession[=<file>]. Each operation is appended to the log as it is committed; the
+	 * recording runs until stopped or EndPlay.
+	 * @param Filename - Output file; empty uses Saved/TuneX/Sessions/<timestamp>.txsession
+	 * @return false if there is no configured target vehicle or the file could not be created
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning|Session")
+	bool StartSessionRecording(const FString& Filename);
+
+	/**
+	 * Stops recording and closes the session log
+	 * @return true if a recording was running
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning|Session")
+	bool StopSessionRecording();
+
+	UFUNCTION(BlueprintPure, Category = "Tuning|Session")
+	bool IsRecordingSession() const { return bRecordingSession; }
+
+	/**
+	 * Starts scrubbing through ScrubSlot; the scrub runs until EndScrub
+	 * @param Direction - +1 for next, -1 for previous
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning|Scrub")
+	void BeginScrub(int32 Direction);
+
+	/**
+	 * Stops scrubbing; the selection is committed once it has settled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning|Scrub")
+	void EndScrub();
+
+	/**
+	 * Switches the scrub to the next part category, committing any pending preview first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tuning|Scrub")
+	void CycleScrubSlot();
+
+	/**
+	 * Sends a locally changed build to the server so other players see it
+	 * The server only accepts builds for a vehicle this controller owns (directly or through its pawn) that meet the
+	 * catalog's rules.
+	 * @param Vehicle - The tuned vehicle
+	 * @param Build - The build selected on this client
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerApplyVehicleBuild(AActor* Vehicle, const FVehicleBuild& Build);
+
+	/**
+	 * Catalog handshake: the client reports the fingerprint of its copy of a catalog
+	 * @param Config - The catalog in use
+	 * @param Fingerprint - The client's UVehicleConfigDataAsset::GetCatalogFingerprint()
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerReportCatalogFingerprint(UVehicleConfigDataAsset* Config, uint32 Fingerprint);
+
+	/**
+	 * Tells the client its catalog differs from the server's, so replicated builds will be ignored
+	 */
+	UFUNCTION(Client, Reliable)
+	void ClientCatalogMismatch(UVehicleConfigDataAsset* Config, uint32 ServerFingerprint);
+
 private:
+	/**
+	 * Records a committed operation when a session is being recorded, and forwards the vehicle's
+	 * build to the server when running as a client
+	 * @param Operation - The operation that produced the build
+	 */
+	void CommitVehicleBuild(UVehicleMasterComponent* VehicleComponent, const FTuningOperation& Operation);
+	void CommitVehicleBuild(UVehicleMasterComponent* VehicleComponent, const FTuningOperation& Operation, const FVehicleBuild& Build);
+
+	/**
+	 * Moves the scrub one part and previews it
+	 */
+	void StepScrub(UVehicleMasterComponent* VehicleComponent);
+
+	/**
+	 * Commits the previewed part of a settled scrub
+	 */
+	void SettleScrub(UVehicleMasterComponent* VehicleComponent);
+
 	/**
 	 * Gets the vehicle modifier interface from the target vehicle
 	 */
@@ -105,4 +229,26 @@ private:
 	void HandlePaintInputQ();
 	void HandlePaintInputW();
 	void HandlePaintInputE();
+	void HandleScrubNextPressed();
+	void HandleScrubPreviousPressed();
+	void HandleScrubReleased();
+
+	// Scrub state: direction held (0 when released), seconds held, fractional steps owed
+	int32 ScrubDirection = 0;
+	float ScrubHeldTime = 0.0f;
+	float ScrubStepAccumulator = 0.0f;
+
+	// Seconds since the last step, and whether a preview is waiting to settle
+	float ScrubIdleTime = 0.0f;
+	bool bScrubPreviewPending = false;
+
+	// Steps of the current scrub, reported when it settles
+	int32 ScrubStepCount = 0;
+
+	// Session recording: operations on SessionVehicle are appended to SessionFilename as they are committed
+	FTuningSessionWriter SessionWriter;
+	FString SessionFilename;
+	TWeakObjectPtr<AActor> SessionVehicle;
+	double SessionStartTime = 0.0;
+	bool bRecordingSession = false;
 };
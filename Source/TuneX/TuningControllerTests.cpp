@@ -0,0 +1,90 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuningController.h"
+#include "VehicleActor.h"
+#include "VehicleMasterComponent.h"
+#include "VehiclePopularity.h"
+#include "CarPartData.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTuningControllerHarnessPicksTest, "TuneX.Popularity.HarnessOperationsAreNotPicks",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTuningControllerHarnessPicksTest::RunTest(const FString& Parameters)
+{
+	UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get();
+	if (!TestNotNull(TEXT("Popularity subsystem"), Popularity))
+	{
+		return false;
+	}
+
+	UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage(), NAME_None, RF_Transient);
+	for (int32 OptionIndex = 0; OptionIndex < 3; ++OptionIndex)
+	{
+		Config->FrontBumpers.AddDefaulted_GetRef().PartID = FName(*FString::Printf(TEXT("test_bumper_%d"), OptionIndex));
+		Config->PaintColors.AddDefaulted_GetRef().PaintID = FName(*FString::Printf(TEXT("test_paint_%d"), OptionIndex));
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false, TEXT("TuneXPicksTest"));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AVehicleActor* Vehicle = World->SpawnActor<AVehicleActor>(AVehicleActor::StaticClass(), FTransform::Identity, SpawnParams);
+	ATuningController* Controller = World->SpawnActor<ATuningController>(ATuningController::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!TestTrue(TEXT("Vehicle and controller spawned"), Vehicle && Vehicle->VehicleMasterComponent && Controller))
+	{
+		World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+		return false;
+	}
+
+	UVehicleMasterComponent* VehicleComponent = Vehicle->VehicleMasterComponent;
+	VehicleComponent->MainVehicleMesh = Vehicle->VehicleMesh;
+	VehicleComponent->SetVehicleConfig(Config);
+	Controller->SetTargetVehicle(Vehicle);
+
+	const FTuningOperation Operations[] =
+	{
+		FTuningOperation(ETuningOperation::SetPartByIndex, EVehiclePartSlot::FrontBumper, 1),
+		FTuningOperation(ETuningOperation::CycleNextPart, EVehiclePartSlot::FrontBumper),
+		FTuningOperation(ETuningOperation::SetPartByID, EVehiclePartSlot::FrontBumper, INDEX_NONE, TEXT("test_bumper_0")),
+		FTuningOperation(ETuningOperation::SetPaintByIndex, EVehiclePartSlot::FrontBumper, 2),
+		FTuningOperation(ETuningOperation::CycleNextPaint),
+		FTuningOperation(ETuningOperation::SetPaintByID, EVehiclePartSlot::FrontBumper, INDEX_NONE, TEXT("test_paint_1")),
+	};
+
+	const uint64 SelectionsBefore = Popularity->GetStats().NumSelections;
+	TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters = Popularity->GetCounters(*Config);
+
+	// As TuneXReplaySession sets up its controller
+	Controller->bOperationsArePicks = false;
+	for (const FTuningOperation& Operation : Operations)
+	{
+		TestTrue(FString::Printf(TEXT("Replayed %s changed the vehicle"), LexToString(Operation.Type)), Controller->ExecuteTuningOperation(Operation));
+	}
+
+	// As the soak harness runs each operation
+	Controller->bOperationsArePicks = true;
+	for (const FTuningOperation& Operation : Operations)
+	{
+		TGuardValue<bool> PicksGuard(Controller->bOperationsArePicks, false);
+		Controller->ExecuteTuningOperation(Operation);
+	}
+
+	TestTrue(TEXT("Controller counts picks again after the soak guard"), Controller->bOperationsArePicks);
+	TestFalse(TEXT("Vehicle counts picks again after the operations"), VehicleComponent->IsNotAPick());
+	TestEqual(TEXT("Selections"), static_cast<int64>(Popularity->GetStats().NumSelections), static_cast<int64>(SelectionsBefore));
+	for (int32 OptionIndex = 0; OptionIndex < 3; ++OptionIndex)
+	{
+		TestEqual(TEXT("Bumper count"), static_cast<int32>(Counters->GetCount(static_cast<int32>(EVehiclePartSlot::FrontBumper), OptionIndex)), 0);
+		TestEqual(TEXT("Paint count"), static_cast<int32>(Counters->GetCount(VehicleBuildPaintBit, OptionIndex)), 0);
+	}
+
+	World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,235 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuningHitchWatchdog.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Object.h"
+
+static TAutoConsoleVariable<int32> CVarHitchEnable(
+	TEXT("TuneX.Hitch.Enable"),
+	1,
+	TEXT("Times tuning operations and writes the ones that ran in slow frames to Saved/TuneX/Hitches.csv"));
+
+static TAutoConsoleVariable<float> CVarHitchThresholdMs(
+	TEXT("TuneX.Hitch.ThresholdMs"),
+	50.0f,
+	TEXT("Game thread frame time above which the frame's tuning operations are written out"));
+
+static TAutoConsoleVariable<int32> CVarHitchMaxFileKB(
+	TEXT("TuneX.Hitch.MaxFileKB"),
+	512,
+	TEXT("Size at which the hitch file rolls over to Hitches.1.csv (the previous one is dropped)"));
+
+namespace TuningHitchWatchdog
+{
+	// A load phase faster than this found its asset resident, so its size is not worth reporting
+	static constexpr double SlowLoadSeconds = 0.001;
+
+	static double CyclesToMs(uint64 Cycles)
+	{
+		return FPlatformTime::ToMilliseconds64(Cycles);
+	}
+
+	// Quotes a CSV field, doubling any quotes inside it, so part IDs with commas keep the columns aligned
+	static FString QuoteCsvField(const FString& Field)
+	{
+		return TEXT("\"") + Field.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+}
+
+const TCHAR* LexToString(ETuningHitchPhase Phase)
+{
+	switch (Phase)
+	{
+	case ETuningHitchPhase::Load:		return TEXT("Load");
+	case ETuningHitchPhase::Register:	return TEXT("Register");
+	case ETuningHitchPhase::Mesh:		return TEXT("Mesh");
+	case ETuningHitchPhase::Material:	return TEXT("Material");
+	case ETuningHitchPhase::Broadcast:	return TEXT("Broadcast");
+	case ETuningHitchPhase::Publish:	return TEXT("Publish");
+	default:							return TEXT("Invalid");
+	}
+}
+
+FTuningHitchWatchdog& FTuningHitchWatchdog::Get()
+{
+	static FTuningHitchWatchdog Watchdog;
+	return Watchdog;
+}
+
+FTuningHitchWatchdog::FTuningHitchWatchdog()
+	: WritePipe(TEXT("TuningHitchWatchdog"))
+{
+	// Lives as long as the process, like the delegates
+	FCoreDelegates::OnBeginFrame.AddRaw(this, &FTuningHitchWatchdog::OnBeginFrame);
+	FCoreDelegates::OnEndFrame.AddRaw(this, &FTuningHitchWatchdog::OnEndFrame);
+}
+
+void FTuningHitchWatchdog::BeginOperation(const TCHAR* Operation)
+{
+	if (OperationDepth++ > 0)
+	{
+		return;
+	}
+
+	FOperationRecord& Record = FrameRecords.AddDefaulted_GetRef();
+	Record.Operation = Operation;
+	Record.StartCycles = FPlatformTime::Cycles64();
+}
+
+void FTuningHitchWatchdog::EndOperation()
+{
+	if (--OperationDepth > 0)
+	{
+		return;
+	}
+
+	FOperationRecord& Record = FrameRecords.Last();
+	Record.Cycles = FPlatformTime::Cycles64() - Record.StartCycles;
+	PhaseStack.Reset();
+}
+
+void FTuningHitchWatchdog::SetPartID(FName PartID)
+{
+	if (OperationDepth > 0 && FrameRecords.Last().PartID.IsNone())
+	{
+		FrameRecords.Last().PartID = PartID;
+	}
+}
+
+void FTuningHitchWatchdog::BeginPhase(ETuningHitchPhase Phase)
+{
+	const uint64 Now = FPlatformTime::Cycles64();
+	if (PhaseStack.Num() > 0)
+	{
+		FrameRecords.Last().PhaseCycles[static_cast<int32>(PhaseStack.Last())] += Now - PhaseStartCycles;
+	}
+	PhaseStack.Add(Phase);
+	PhaseStartCycles = Now;
+}
+
+void FTuningHitchWatchdog::EndPhase()
+{
+	if (PhaseStack.Num() == 0)
+	{
+		return;
+	}
+
+	const uint64 Now = FPlatformTime::Cycles64();
+	FrameRecords.Last().PhaseCycles[static_cast<int32>(PhaseStack.Pop(/*bAllowShrinking*/ false))] += Now - PhaseStartCycles;
+	PhaseStartCycles = Now;
+}
+
+void FTuningHitchWatchdog::AddAssetBytes(int64 Bytes)
+{
+	if (OperationDepth > 0)
+	{
+		FrameRecords.Last().AssetBytes += Bytes;
+	}
+}
+
+FString FTuningHitchWatchdog::GetCsvPath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("Hitches.csv");
+}
+
+void FTuningHitchWatchdog::OnBeginFrame()
+{
+	bEnabled = CVarHitchEnable.GetValueOnGameThread() != 0;
+	FrameStartCycles = FPlatformTime::Cycles64();
+}
+
+void FTuningHitchWatchdog::OnEndFrame()
+{
+	if (FrameStartCycles == 0)
+	{
+		return;
+	}
+
+	const double FrameSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - FrameStartCycles);
+	if (FrameSeconds * 1000.0 >= CVarHitchThresholdMs.GetValueOnGameThread())
+	{
+		++NumHitchFrames;
+		if (FrameRecords.Num() > 0)
+		{
+			++NumAttributedFrames;
+			WriteRecords(FrameSeconds);
+		}
+	}
+
+	FrameRecords.Reset();
+	FrameStartCycles = 0;
+}
+
+void FTuningHitchWatchdog::WriteRecords(double FrameSeconds)
+{
+	using namespace TuningHitchWatchdog;
+
+	const FString Timestamp = FDateTime::UtcNow().ToIso8601();
+	FString Rows;
+	for (const FOperationRecord& Record : FrameRecords)
+	{
+		const uint64 OperationCycles = Record.Cycles;
+
+		uint64 PhaseTotal = 0;
+		FString Phases;
+		for (const uint64 Cycles : Record.PhaseCycles)
+		{
+			PhaseTotal += Cycles;
+			Phases += FString::Printf(TEXT(",%.3f"), CyclesToMs(Cycles));
+		}
+
+		Rows += FString::Printf(TEXT("%s,%llu,%.3f,%s,%s,%.3f%s,%.3f,%lld\n"),
+			*Timestamp, GFrameCounter, FrameSeconds * 1000.0,
+			*QuoteCsvField(Record.Operation), *QuoteCsvField(Record.PartID.ToString()), CyclesToMs(OperationCycles), *Phases,
+			CyclesToMs(OperationCycles > PhaseTotal ? OperationCycles - PhaseTotal : 0), Record.AssetBytes / 1024);
+	}
+	NumRowsWritten += FrameRecords.Num();
+
+	FString Header = TEXT("UtcTime,Frame,FrameMs,Operation,PartID,OperationMs");
+	for (int32 PhaseIndex = 0; PhaseIndex < NumTuningHitchPhases; ++PhaseIndex)
+	{
+		Header += FString::Printf(TEXT(",%sMs"), LexToString(static_cast<ETuningHitchPhase>(PhaseIndex)));
+	}
+	Header += TEXT(",OtherMs,AssetKB\n");
+
+	const int64 MaxFileBytes = int64(FMath::Max(1, CVarHitchMaxFileKB.GetValueOnGameThread())) * 1024;
+	WritePipe.Launch(UE_SOURCE_LOCATION, [Path = GetCsvPath(), Header = MoveTemp(Header), Rows = MoveTemp(Rows), MaxFileBytes]()
+	{
+		IFileManager& FileManager = IFileManager::Get();
+		int64 FileBytes = FileManager.FileSize(*Path);
+		if (FileBytes + Rows.Len() > MaxFileBytes)
+		{
+			FileManager.Move(*FPaths::ChangeExtension(Path, TEXT("1.csv")), *Path, /*bReplace*/ true);
+			FileBytes = INDEX_NONE;
+		}
+
+		if (FileBytes <= 0)
+		{
+			FFileHelper::SaveStringToFile(Header, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &FileManager);
+		}
+		// AutoDetect would switch to UTF-16 for a non-ANSI part ID, mixing encodings in one appended file
+		FFileHelper::SaveStringToFile(Rows, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &FileManager, FILEWRITE_Append);
+	});
+}
+
+void FTuningHitchPhaseScope::NoteAsset(const UObject* Asset)
+{
+	if (bActive && Asset && FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) >= TuningHitchWatchdog::SlowLoadSeconds)
+	{
+		Watchdog.AddAssetBytes(const_cast<UObject*>(Asset)->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+	}
+}
+
+static FAutoConsoleCommand GTuningHitchStatsCommand(
+	TEXT("TuneX.Hitch.Stats"),
+	TEXT("Prints how many slow frames the hitch watchdog saw and attributed to tuning operations"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FTuningHitchWatchdog& Watchdog = FTuningHitchWatchdog::Get();
+		UE_LOG(LogTemp, Display, TEXT("TuningHitchWatchdog: %llu slow frames, %llu with tuning operations (%llu rows) written to %s"),
+			Watchdog.NumHitchFrames, Watchdog.NumAttributedFrames, Watchdog.NumRowsWritten, *Watchdog.GetCsvPath());
+	}));
@@ -0,0 +1,202 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Pipe.h"
+
+class UObject;
+
+/**
+ * Where a tuning operation spends its time
+ */
+enum class ETuningHitchPhase : uint8
+{
+	// Synchronous asset loads (resident assets resolve almost for free)
+	Load,
+	// Creating and registering part components
+	Register,
+	// Swapping meshes on components
+	Mesh,
+	// Swapping materials
+	Material,
+	// Change events and their handlers
+	Broadcast,
+	// Snapshot, rules and replication after a change
+	Publish,
+	Count
+};
+
+static constexpr int32 NumTuningHitchPhases = static_cast<int32>(ETuningHitchPhase::Count);
+
+/** Short, stable name for a phase (used as a CSV column) */
+TUNEX_API const TCHAR* LexToString(ETuningHitchPhase Phase);
+
+/**
+ * Attributes game thread hitches to the tuning operations that ran in the frame
+ * Operations and their phases are timed by TUNEX_HITCH_OPERATION and TUNEX_HITCH_PHASE scopes. When a frame
+ * takes longer than TuneX.Hitch.ThresholdMs, one row per operation (name, part ID, time per phase, size of
+ * assets that loaded slowly) is appended to Saved/TuneX/Hitches.csv, off the game thread; past
+ * TuneX.Hitch.MaxFileKB the file rolls over to Hitches.1.csv.
+ *
+ * Cheap enough for shipping: a scope reads two clocks and writes a few integers, phase time is exclusive
+ * (nested phases pause their parent) and nothing is allocated unless a frame runs more than a handful of
+ * operations. Operations nested in another one count towards the outer one.
+ * Game thread only; scopes on other threads do nothing, and so do scopes outside the engine loop's frames
+ * (commandlets that tick a world by hand).
+ *
+ * Stats: TuneX.Hitch.Stats
+ */
+class TUNEX_API FTuningHitchWatchdog
+{
+public:
+	static FTuningHitchWatchdog& Get();
+
+	// Only between the begin and end of an engine frame, which is when records are flushed
+	bool IsEnabled() const { return bEnabled && FrameStartCycles != 0; }
+
+	bool IsInOperation() const { return OperationDepth > 0; }
+
+	void BeginOperation(const TCHAR* Operation);
+	void EndOperation();
+
+	/**
+	 * Names the part the current operation is about, unless it was named already
+	 */
+	void SetPartID(FName PartID);
+
+	void BeginPhase(ETuningHitchPhase Phase);
+	void EndPhase();
+
+	/**
+	 * Counts an asset against the current operation
+	 */
+	void AddAssetBytes(int64 Bytes);
+
+	/**
+	 * Gets the file hitches are written to
+	 */
+	FString GetCsvPath() const;
+
+	// Frames over the threshold, and those of them in which a tuning operation ran
+	uint64 NumHitchFrames = 0;
+	uint64 NumAttributedFrames = 0;
+	uint64 NumRowsWritten = 0;
+
+private:
+	FTuningHitchWatchdog();
+
+	void OnBeginFrame();
+	void OnEndFrame();
+
+	/**
+	 * Formats the frame's operations and hands them to the writer task
+	 */
+	void WriteRecords(double FrameSeconds);
+
+	struct FOperationRecord
+	{
+		const TCHAR* Operation = nullptr;
+		FName PartID;
+		uint64 StartCycles = 0;
+		uint64 Cycles = 0;
+		uint64 PhaseCycles[NumTuningHitchPhases] = {};
+		int64 AssetBytes = 0;
+	};
+
+	// Operations of the current frame; the last one is running while OperationDepth > 0
+	TArray<FOperationRecord, TInlineAllocator<8>> FrameRecords;
+	int32 OperationDepth = 0;
+
+	// Phases open in the current operation, innermost last, and when the innermost last resumed
+	TArray<ETuningHitchPhase, TInlineAllocator<8>> PhaseStack;
+	uint64 PhaseStartCycles = 0;
+
+	// Start of the running frame, 0 between frames
+	uint64 FrameStartCycles = 0;
+
+	// Sampled from TuneX.Hitch.Enable at the start of every frame
+	bool bEnabled = true;
+
+	// Serializes file writes and roll-overs
+	UE::Tasks::FPipe WritePipe;
+};
+
+/**
+ * Times a tuning operation; use through TUNEX_HITCH_OPERATION
+ */
+class FTuningHitchOperationScope
+{
+public:
+	explicit FTuningHitchOperationScope(const TCHAR* Operation)
+		: Watchdog(FTuningHitchWatchdog::Get())
+		, bActive(Watchdog.IsEnabled() && IsInGameThread())
+	{
+		if (bActive)
+		{
+			Watchdog.BeginOperation(Operation);
+		}
+	}
+
+	~FTuningHitchOperationScope()
+	{
+		if (bActive)
+		{
+			Watchdog.EndOperation();
+		}
+	}
+
+	void SetPartID(FName PartID)
+	{
+		if (bActive)
+		{
+			Watchdog.SetPartID(PartID);
+		}
+	}
+
+private:
+	FTuningHitchWatchdog& Watchdog;
+	const bool bActive;
+};
+
+/**
+ * Times a phase of the running tuning operation; use through TUNEX_HITCH_PHASE
+ */
+class FTuningHitchPhaseScope
+{
+public:
+	explicit FTuningHitchPhaseScope(ETuningHitchPhase Phase)
+		: Watchdog(FTuningHitchWatchdog::Get())
+		, bActive(Watchdog.IsEnabled() && IsInGameThread() && Watchdog.IsInOperation())
+	{
+		if (bActive)
+		{
+			StartCycles = FPlatformTime::Cycles64();
+			Watchdog.BeginPhase(Phase);
+		}
+	}
+
+	~FTuningHitchPhaseScope()
+	{
+		if (bActive)
+		{
+			Watchdog.EndPhase();
+		}
+	}
+
+	/**
+	 * Counts a loaded asset against the operation if the phase has been slow so far (sizes are not free to get)
+	 */
+	TUNEX_API void NoteAsset(const UObject* Asset);
+
+private:
+	FTuningHitchWatchdog& Watchdog;
+	const bool bActive;
+	uint64 StartCycles = 0;
+};
+
+/** Times the enclosing block as a tuning operation; the scope is named TuneXHitchOperation */
+#define TUNEX_HITCH_OPERATION(Operation) FTuningHitchOperationScope TuneXHitchOperation(TEXT(Operation))
+
+/** Times the enclosing block as a phase (an ETuningHitchPhase name) of the running operation; the scope is named TuneXHitchPhase */
+#define TUNEX_HITCH_PHASE(Phase) FTuningHitchPhaseScope TuneXHitchPhase(ETuningHitchPhase::Phase)
@@ -0,0 +1,20 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuningOperation.h"
+
+const TCHAR* LexToString(ETuningOperation Operation)
+{
+	switch (Operation)
+	{
+	case ETuningOperation::SetPartByID:		return TEXT("SetPartByID");
+	case ETuningOperation::SetPartByIndex:	return TEXT("SetPartByIndex");
+	case ETuningOperation::CycleNextPart:	return TEXT("CycleNextPart");
+	case ETuningOperation::SetPaintByID:	return TEXT("SetPaintByID");
+	case ETuningOperation::SetPaintByIndex:	return TEXT("SetPaintByIndex");
+	case ETuningOperation::CycleNextPaint:	return TEXT("CycleNextPaint");
+	case ETuningOperation::SwitchTarget:	return TEXT("SwitchTarget");
+	case ETuningOperation::SpawnVehicle:	return TEXT("SpawnVehicle");
+	case ETuningOperation::DestroyVehicle:	return TEXT("DestroyVehicle");
+	default:								return TEXT("Invalid");
+	}
+}
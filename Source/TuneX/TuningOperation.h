@@ -0,0 +1,73 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CarPartData.h"
+#include "TuningOperation.generated.h"
+
+/**
+ * Everything a tuning session can do to a vehicle or the scene
+ * Shared by ATuningController, the soak harness and session recording.
+ */
+UENUM(BlueprintType)
+enum class ETuningOperation : uint8
+{
+	SetPartByID,
+	SetPartByIndex,
+	CycleNextPart,
+	SetPaintByID,
+	SetPaintByIndex,
+	CycleNextPaint,
+	SwitchTarget,
+	SpawnVehicle,
+	DestroyVehicle,
+	Count UMETA(Hidden)
+};
+
+/** Number of operation types */
+static constexpr int32 NumTuningOperations = static_cast<int32>(ETuningOperation::Count);
+
+/** Short, stable name for an operation (used in logs and reports) */
+TUNEX_API const TCHAR* LexToString(ETuningOperation Operation);
+
+/**
+ * One tuning operation and its arguments
+ * Only the arguments the operation uses are read: Slot for part operations, Index for *ByIndex, ID for *ByID.
+ */
+USTRUCT(BlueprintType)
+struct FTuningOperation
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
+	ETuningOperation Type;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
+	EVehiclePartSlot Slot;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
+	int32 Index;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tuning")
+	FName ID;
+
+	FTuningOperation()
+		: Type(ETuningOperation::CycleNextPart)
+		, Slot(EVehiclePartSlot::FrontBumper)
+		, Index(INDEX_NONE)
+		, ID(NAME_None)
+	{
+	}
+
+	explicit FTuningOperation(ETuningOperation InType, EVehiclePartSlot InSlot = EVehiclePartSlot::FrontBumper, int32 InIndex = INDEX_NONE, FName InID = NAME_None)
+		: Type(InType)
+		, Slot(InSlot)
+		, Index(InIndex)
+		, ID(InID)
+	{
+	}
+
+	/** Whether ATuningController::ExecuteTuningOperation handles this operation (the rest act on the scene) */
+	bool IsVehicleOperation() const { return Type < ETuningOperation::SwitchTarget; }
+};
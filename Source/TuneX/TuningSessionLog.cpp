@@ -0,0 +1,227 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuningSessionLog.h"
+#include "HAL/FileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace TuningSessionLog
+{
+	static constexpr uint32 Magic = 0x4C535854; // "TXSL"
+	static constexpr uint32 FormatVersion = 2;
+
+	// Indices are stored +1 so INDEX_NONE packs to a single zero byte
+	static void SerializeIndex(FArchive& Ar, int32& Index)
+	{
+		uint32 Packed = static_cast<uint32>(Index + 1);
+		Ar.SerializeIntPacked(Packed);
+		Index = static_cast<int32>(Packed) - 1;
+	}
+
+	static void SerializeBuild(FArchive& Ar, FVehicleBuild& Build)
+	{
+		for (int32& PartIndex : Build.PartIndices)
+		{
+			SerializeIndex(Ar, PartIndex);
+		}
+		SerializeIndex(Ar, Build.PaintIndex);
+	}
+}
+
+bool FTuningSessionLog::SaveToFile(const FString& Filename) const
+{
+	FTuningSessionWriter Writer;
+	return Writer.Open(Filename, *this);
+}
+
+bool FTuningSessionLog::LoadFromFile(const FString& Filename)
+{
+	using namespace TuningSessionLog;
+
+	*this = FTuningSessionLog();
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+
+	uint32 FileMagic = 0;
+	uint32 Version = 0;
+	Reader << FileMagic << Version;
+	if (Reader.IsError() || FileMagic != Magic || Version != FormatVersion)
+	{
+		return false;
+	}
+
+	FString ConfigPathString;
+	FString VehicleClassString;
+
+	Reader << ConfigPathString << VehicleClassString << CatalogFingerprint;
+	SerializeBuild(Reader, InitialBuild);
+	if (Reader.IsError())
+	{
+		*this = FTuningSessionLog();
+		return false;
+	}
+
+	ConfigPath = FSoftObjectPath(ConfigPathString);
+	VehicleClass = FSoftClassPath(VehicleClassString);
+
+	// Names are spelled out where they first appear; index 0 is None
+	TArray<FName> Names;
+	Names.Add(NAME_None);
+
+	uint64 TimeMs = 0;
+	while (Reader.Tell() < Reader.TotalSize())
+	{
+		uint32 DeltaMs = 0;
+		uint8 Type = 0;
+		uint8 Slot = 0;
+		uint32 NameIndex = 0;
+		FTuningSessionEntry Entry;
+
+		Reader.SerializeIntPacked(DeltaMs);
+		Reader << Type << Slot;
+		SerializeIndex(Reader, Entry.Operation.Index);
+		Reader.SerializeIntPacked(NameIndex);
+		if (NameIndex == static_cast<uint32>(Names.Num()))
+		{
+			FString Name;
+			Reader << Name;
+			Names.Add(FName(*Name));
+		}
+		SerializeBuild(Reader, Entry.Result);
+
+		if (Reader.IsError() || Type >= NumTuningOperations || Slot >= NumVehiclePartSlots || !Names.IsValidIndex(NameIndex))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TuningSessionLog: %s is cut short after %d entries"), *Filename, Entries.Num());
+			break;
+		}
+
+		TimeMs += DeltaMs;
+		Entry.Time = TimeMs / 1000.0;
+		Entry.Operation.Type = static_cast<ETuningOperation>(Type);
+		Entry.Operation.Slot = static_cast<EVehiclePartSlot>(Slot);
+		Entry.Operation.ID = Names[NameIndex];
+		Entries.Add(MoveTemp(Entry));
+	}
+
+	return true;
+}
+
+FString FTuningSessionLog::MakeDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("Sessions") / (FDateTime::Now().ToString() + TEXT(".txsession"));
+}
+
+bool FTuningSessionWriter::Open(const FString& Filename, const FTuningSessionLog& Log)
+{
+	using namespace TuningSessionLog;
+
+	Close();
+
+	File.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!File)
+	{
+		return false;
+	}
+
+	uint32 FileMagic = Magic;
+	uint32 Version = FormatVersion;
+	FString ConfigPathString = Log.ConfigPath.ToString();
+	FString VehicleClassString = Log.VehicleClass.ToString();
+	uint32 Fingerprint = Log.CatalogFingerprint;
+	FVehicleBuild Initial = Log.InitialBuild;
+
+	*File << FileMagic << Version << ConfigPathString << VehicleClassString << Fingerprint;
+	SerializeBuild(*File, Initial);
+	File->Flush();
+
+	for (const FTuningSessionEntry& Entry : Log.Entries)
+	{
+		if (!Append(Entry))
+		{
+			break;
+		}
+	}
+
+	if (File->IsError())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool FTuningSessionWriter::Append(const FTuningSessionEntry& Entry)
+{
+	using namespace TuningSessionLog;
+
+	if (!File)
+	{
+		return false;
+	}
+
+	// Times are millisecond deltas from the previous entry, rounded against the running total so they never drift
+	const uint64 EntryMs = FMath::Max<uint64>(static_cast<uint64>(FMath::RoundToDouble(Entry.Time * 1000.0)), PreviousMs);
+	uint32 DeltaMs = static_cast<uint32>(EntryMs - PreviousMs);
+	PreviousMs = EntryMs;
+
+	uint8 Type = static_cast<uint8>(Entry.Operation.Type);
+	uint8 Slot = static_cast<uint8>(Entry.Operation.Slot);
+	int32 Index = Entry.Operation.Index;
+	FVehicleBuild Result = Entry.Result;
+
+	// An ID not seen before gets the next number and is spelled out once
+	uint32 NameIndex = 0;
+	bool bNewName = false;
+	if (!Entry.Operation.ID.IsNone())
+	{
+		if (const uint32* Existing = NameIndices.Find(Entry.Operation.ID))
+		{
+			NameIndex = *Existing;
+		}
+		else
+		{
+			NameIndex = NameIndices.Num() + 1;
+			NameIndices.Add(Entry.Operation.ID, NameIndex);
+			bNewName = true;
+		}
+	}
+
+	Record.Reset();
+	FMemoryWriter Writer(Record);
+	Writer.SerializeIntPacked(DeltaMs);
+	Writer << Type << Slot;
+	SerializeIndex(Writer, Index);
+	Writer.SerializeIntPacked(NameIndex);
+	if (bNewName)
+	{
+		FString Name = Entry.Operation.ID.ToString();
+		Writer << Name;
+	}
+	SerializeBuild(Writer, Result);
+
+	File->Serialize(Record.GetData(), Record.Num());
+	File->Flush();
+	++NumEntries;
+	return !File->IsError();
+}
+
+void FTuningSessionWriter::Close()
+{
+	if (File)
+	{
+		File->Close();
+		File.Reset();
+	}
+	NameIndices.Reset();
+	PreviousMs = 0;
+	NumEntries = 0;
+}
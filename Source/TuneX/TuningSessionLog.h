@@ -0,0 +1,102 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TuningOperation.h"
+#include "VehicleBuild.h"
+
+/**
+ * One recorded operation and the selection it resulted in
+ */
+struct FTuningSessionEntry
+{
+	// Seconds since the recording started (stored at millisecond precision)
+	double Time = 0.0;
+
+	FTuningOperation Operation;
+
+	// The vehicle's build right after the operation, checked on replay
+	FVehicleBuild Result;
+};
+
+/**
+ * Recorded tuning session: the catalog it ran against, the vehicle, the starting build and every committed operation
+ * Saved as a compact binary file (.txsession): a header, then one record per entry up to the end of the file. A
+ * part/paint ID is spelled out the first time it appears and referred to by number afterwards, and times, indices
+ * and builds are packed integers, so an entry takes a handful of bytes and can be appended on its own.
+ *
+ * Recorded by ATuningController (through FTuningSessionWriter), replayed by UTuneXReplaySessionCommandlet.
+ */
+struct TUNEX_API FTuningSessionLog
+{
+	FSoftObjectPath ConfigPath;
+
+	// Class of the recorded vehicle actor, spawned again on replay
+	FSoftClassPath VehicleClass;
+
+	// UVehicleConfigDataAsset::GetCatalogFingerprint() at record time
+	uint32 CatalogFingerprint = 0;
+
+	FVehicleBuild InitialBuild;
+
+	TArray<FTuningSessionEntry> Entries;
+
+	/**
+	 * Writes the log to disk
+	 * @return false if the file could not be written
+	 */
+	bool SaveToFile(const FString& Filename) const;
+
+	/**
+	 * Reads a log written by SaveToFile or FTuningSessionWriter
+	 * An entry cut short (the recording process died while writing it) is dropped along with anything after it.
+	 * @return false if the file is missing, its header is truncated or it is of another version
+	 */
+	bool LoadFromFile(const FString& Filename);
+
+	/**
+	 * Default location for new recordings: Saved/TuneX/Sessions/<timestamp>.txsession
+	 */
+	static FString MakeDefaultFilename();
+};
+
+/**
+ * Writes a session while it is recorded: the header on Open, then every entry as it is appended, flushed to disk
+ * right away so a crash loses at most the entry being written
+ */
+class TUNEX_API FTuningSessionWriter
+{
+public:
+	~FTuningSessionWriter() { Close(); }
+
+	/**
+	 * Creates the file and writes the header of a log, followed by any entries it already has
+	 * @return false if the file could not be created
+	 */
+	bool Open(const FString& Filename, const FTuningSessionLog& Log);
+
+	/**
+	 * Writes one entry; entries are expected in time order
+	 * @return false if the writer is not open or the write failed
+	 */
+	bool Append(const FTuningSessionEntry& Entry);
+
+	void Close();
+
+	bool IsOpen() const { return File.IsValid(); }
+
+	int32 GetNumEntries() const { return NumEntries; }
+
+private:
+	TUniquePtr<FArchive> File;
+
+	// Number each ID was given when first written (0 = None)
+	TMap<FName, uint32> NameIndices;
+
+	uint64 PreviousMs = 0;
+	int32 NumEntries = 0;
+
+	// Encoded entry, reused
+	TArray<uint8> Record;
+};
@@ -0,0 +1,487 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "TuningSoakSubsystem.h"
+#include "TuningController.h"
+#include "VehicleMasterComponent.h"
+#include "CarPartData.h"
+#include "EngineUtils.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectArray.h"
+
+static TAutoConsoleVariable<float> CVarSoakSnapshotInterval(
+	TEXT("TuneX.Soak.SnapshotInterval"),
+	60.0f,
+	TEXT("Seconds between soak snapshots (garbage collection, UObject count, memory, latency percentiles)"));
+
+static TAutoConsoleVariable<int32> CVarSoakMaxObjectGrowth(
+	TEXT("TuneX.Soak.MaxObjectGrowth"),
+	2000,
+	TEXT("Live UObjects the soak may gain over its first snapshot before it fails"));
+
+static TAutoConsoleVariable<int32> CVarSoakMaxMemoryGrowthMB(
+	TEXT("TuneX.Soak.MaxMemoryGrowthMB"),
+	256,
+	TEXT("Used physical memory (MB) the soak may gain over its first snapshot before it fails"));
+
+static TAutoConsoleVariable<int32> CVarSoakMaxVehicles(
+	TEXT("TuneX.Soak.MaxVehicles"),
+	16,
+	TEXT("Vehicles the soak keeps spawned at most, besides the one it started on"));
+
+namespace TuningSoak
+{
+	// Caps the operations issued in one frame, so a hitch does not snowball into a longer one
+	static constexpr float MaxFrameBacklogSeconds = 0.25f;
+
+	// Operation weights out of 1000; the remainder after scene operations is split across vehicle operations
+	static constexpr int32 SpawnWeight = 5;
+	static constexpr int32 DestroyWeight = 5;
+	static constexpr int32 SwitchWeight = 10;
+
+	static float Percentile(TArray<float>& SortedSamples, float Fraction)
+	{
+		if (SortedSamples.Num() == 0)
+		{
+			return 0.0f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+		return SortedSamples[Index];
+	}
+
+	static UVehicleMasterComponent* GetVehicleComponent(const AActor* Vehicle)
+	{
+		return Vehicle ? Vehicle->FindComponentByClass<UVehicleMasterComponent>() : nullptr;
+	}
+}
+
+bool UTuningSoakSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UTuningSoakSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	float Seconds = 0.0f;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("TuneXSoak="), Seconds))
+	{
+		return;
+	}
+
+	float CommandLineOps = 2000.0f;
+	int32 Seed = 0;
+	FParse::Value(FCommandLine::Get(), TEXT("TuneXSoakOps="), CommandLineOps);
+	FParse::Value(FCommandLine::Get(), TEXT("TuneXSoakSeed="), Seed);
+
+	if (!StartSoak(Seconds, CommandLineOps, Seed, /*bExitWhenDone*/ true))
+	{
+		FPlatformMisc::RequestExitWithStatus(false, 1);
+	}
+}
+
+void UTuningSoakSubsystem::Deinitialize()
+{
+	if (bRunning)
+	{
+		StopSoak();
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UTuningSoakSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTuningSoakSubsystem, STATGROUP_Tickables);
+}
+
+bool UTuningSoakSubsystem::StartSoak(float DurationSeconds, float InOpsPerSecond, int32 Seed, bool bInExitWhenDone)
+{
+	if (bRunning)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("TuningSoak: Already running"));
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	Controller = nullptr;
+	for (TActorIterator<ATuningController> It(World); It; ++It)
+	{
+		Controller = *It;
+		break;
+	}
+
+	if (!Controller)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Controller = World->SpawnActor<ATuningController>(ATuningController::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	if (!Controller->TargetVehicle)
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			if (TuningSoak::GetVehicleComponent(*It))
+			{
+				Controller->SetTargetVehicle(*It);
+				break;
+			}
+		}
+	}
+
+	const UVehicleMasterComponent* VehicleComponent = TuningSoak::GetVehicleComponent(Controller->TargetVehicle);
+	if (!VehicleComponent || !VehicleComponent->VehicleConfig)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuningSoak: No configured vehicle in the world to drive"));
+		return false;
+	}
+
+	OriginalVehicle = Controller->TargetVehicle;
+	Config = VehicleComponent->VehicleConfig;
+	SpawnedVehicles.Reset();
+
+	Random.Initialize(Seed);
+	Duration = DurationSeconds;
+	OpsPerSecond = FMath::Max(1.0f, InOpsPerSecond);
+	bExitWhenDone = bInExitWhenDone;
+	Elapsed = 0.0;
+	SinceSnapshot = 0.0;
+	OpAccumulator = 0.0f;
+	NumOperations = 0;
+	NumChanges = 0;
+	BaselineObjects = INDEX_NONE;
+	BaselineUsedPhysical = 0;
+	bFailed = false;
+	bRunning = true;
+
+	for (TArray<float>& Samples : LatencySamples)
+	{
+		Samples.Reset();
+	}
+
+	CsvPath = FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("Soak.csv");
+	FFileHelper::SaveStringToFile(TEXT("Seconds,Operations,UObjects,UsedPhysicalMB,P50us,P95us,P99us,MaxUs\n"), *CsvPath);
+
+	UE_LOG(LogTemp, Display, TEXT("TuningSoak: Started for %.0f s at %.0f ops/s, seed %d, vehicle %s"),
+		Duration, OpsPerSecond, Seed, *OriginalVehicle->GetName());
+	return true;
+}
+
+void UTuningSoakSubsystem::StopSoak()
+{
+	FinishSoak(bFailed, TEXT("stopped"));
+}
+
+void UTuningSoakSubsystem::Tick(float DeltaTime)
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	if (!IsValid(Controller) || !IsValid(OriginalVehicle))
+	{
+		FinishSoak(true, TEXT("controller or vehicle was destroyed outside the soak"));
+		return;
+	}
+
+	Elapsed += DeltaTime;
+	SinceSnapshot += DeltaTime;
+
+	OpAccumulator = FMath::Min(OpAccumulator + OpsPerSecond * DeltaTime, OpsPerSecond * TuningSoak::MaxFrameBacklogSeconds);
+	while (OpAccumulator >= 1.0f)
+	{
+		OpAccumulator -= 1.0f;
+		RunOperation(MakeRandomOperation());
+	}
+
+	if (SinceSnapshot >= CVarSoakSnapshotInterval.GetValueOnGameThread())
+	{
+		SinceSnapshot = 0.0;
+		TakeSnapshot();
+		if (!bRunning)
+		{
+			return;
+		}
+	}
+
+	if (Duration > 0.0 && Elapsed >= Duration)
+	{
+		TakeSnapshot();
+		if (bRunning)
+		{
+			FinishSoak(false, TEXT("duration reached"));
+		}
+	}
+}
+
+FTuningOperation UTuningSoakSubsystem::MakeRandomOperation() const
+{
+	FTuningOperation Operation;
+
+	const int32 Roll = Random.RandHelper(1000);
+	if (Roll < TuningSoak::SpawnWeight)
+	{
+		Operation.Type = ETuningOperation::SpawnVehicle;
+		return Operation;
+	}
+	if (Roll < TuningSoak::SpawnWeight + TuningSoak::DestroyWeight)
+	{
+		Operation.Type = ETuningOperation::DestroyVehicle;
+		return Operation;
+	}
+	if (Roll < TuningSoak::SpawnWeight + TuningSoak::DestroyWeight + TuningSoak::SwitchWeight)
+	{
+		Operation.Type = ETuningOperation::SwitchTarget;
+		return Operation;
+	}
+
+	Operation.Type = static_cast<ETuningOperation>(Random.RandHelper(static_cast<int32>(ETuningOperation::SwitchTarget)));
+	Operation.Slot = static_cast<EVehiclePartSlot>(Random.RandHelper(NumVehiclePartSlots));
+
+	switch (Operation.Type)
+	{
+	case ETuningOperation::SetPartByID:
+	{
+		const TArray<FCarPart>& Parts = Config->GetParts(Operation.Slot);
+		Operation.ID = Parts.Num() > 0 ? Parts[Random.RandHelper(Parts.Num())].PartID : NAME_None;
+		break;
+	}
+	case ETuningOperation::SetPartByIndex:
+		// One past the end on purpose, so rejected input is exercised too
+		Operation.Index = Random.RandHelper(Config->GetParts(Operation.Slot).Num() + 1);
+		break;
+	case ETuningOperation::SetPaintByID:
+		Operation.ID = Config->PaintColors.Num() > 0 ? Config->PaintColors[Random.RandHelper(Config->PaintColors.Num())].PaintID : NAME_None;
+		break;
+	case ETuningOperation::SetPaintByIndex:
+		Operation.Index = Random.RandHelper(Config->PaintColors.Num() + 1);
+		break;
+	default:
+		break;
+	}
+
+	return Operation;
+}
+
+void UTuningSoakSubsystem::RunOperation(const FTuningOperation& Operation)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	if (Operation.IsVehicleOperation())
+	{
+		// Random operations are not anyone's pick and must not skew the popularity counts
+		TGuardValue<bool> PicksGuard(Controller->bOperationsArePicks, false);
+		NumChanges += Controller->ExecuteTuningOperation(Operation) ? 1 : 0;
+	}
+	else if (Operation.Type == ETuningOperation::SpawnVehicle)
+	{
+		SpawnVehicle();
+	}
+	else if (Operation.Type == ETuningOperation::DestroyVehicle)
+	{
+		DestroyVehicle();
+	}
+	else
+	{
+		SwitchTarget();
+	}
+
+	const double Microseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+	LatencySamples[static_cast<int32>(Operation.Type)].Add(static_cast<float>(Microseconds));
+	++NumOperations;
+}
+
+void UTuningSoakSubsystem::SpawnVehicle()
+{
+	if (SpawnedVehicles.Num() >= CVarSoakMaxVehicles.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const FVector Offset(0.0, 500.0 * (SpawnedVehicles.Num() + 1), 0.0);
+	const FTransform Transform(OriginalVehicle->GetActorRotation(), OriginalVehicle->GetActorLocation() + Offset);
+
+	AActor* Vehicle = GetWorld()->SpawnActor<AActor>(OriginalVehicle->GetClass(), Transform, SpawnParams);
+	UVehicleMasterComponent* VehicleComponent = TuningSoak::GetVehicleComponent(Vehicle);
+	if (!VehicleComponent)
+	{
+		if (Vehicle)
+		{
+			Vehicle->Destroy();
+		}
+		return;
+	}
+
+	if (VehicleComponent->VehicleConfig != Config)
+	{
+		VehicleComponent->SetVehicleConfig(Config);
+	}
+
+	SpawnedVehicles.Add(Vehicle);
+}
+
+void UTuningSoakSubsystem::DestroyVehicle()
+{
+	if (SpawnedVehicles.Num() == 0)
+	{
+		return;
+	}
+
+	AActor* Vehicle = SpawnedVehicles[Random.RandHelper(SpawnedVehicles.Num())];
+	SpawnedVehicles.RemoveSingleSwap(Vehicle);
+
+	if (Controller->TargetVehicle == Vehicle)
+	{
+		Controller->SetTargetVehicle(OriginalVehicle);
+	}
+
+	if (IsValid(Vehicle))
+	{
+		Vehicle->Destroy();
+	}
+}
+
+void UTuningSoakSubsystem::SwitchTarget()
+{
+	const int32 Choice = Random.RandHelper(SpawnedVehicles.Num() + 1);
+	AActor* Vehicle = Choice < SpawnedVehicles.Num() ? SpawnedVehicles[Choice].Get() : OriginalVehicle.Get();
+	Controller->SetTargetVehicle(IsValid(Vehicle) ? Vehicle : OriginalVehicle.Get());
+}
+
+void UTuningSoakSubsystem::TakeSnapshot()
+{
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	const int32 NumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	const double UsedPhysicalMB = static_cast<double>(UsedPhysical) / (1024.0 * 1024.0);
+
+	// Percentiles over every operation, then per type for the log
+	TArray<float> AllSamples;
+	for (const TArray<float>& Samples : LatencySamples)
+	{
+		AllSamples.Append(Samples);
+	}
+	AllSamples.Sort();
+
+	const float P50 = TuningSoak::Percentile(AllSamples, 0.50f);
+	const float P95 = TuningSoak::Percentile(AllSamples, 0.95f);
+	const float P99 = TuningSoak::Percentile(AllSamples, 0.99f);
+	const float Max = AllSamples.Num() > 0 ? AllSamples.Last() : 0.0f;
+
+	UE_LOG(LogTemp, Display, TEXT("TuningSoak: %.0f s, %llu ops (%llu changes), %d UObjects, %.1f MB used, p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us"),
+		Elapsed, NumOperations, NumChanges, NumObjects, UsedPhysicalMB, P50, P95, P99, Max);
+
+	for (int32 TypeIndex = 0; TypeIndex < NumTuningOperations; ++TypeIndex)
+	{
+		TArray<float>& Samples = LatencySamples[TypeIndex];
+		if (Samples.Num() > 0)
+		{
+			Samples.Sort();
+			UE_LOG(LogTemp, Display, TEXT("TuningSoak:   %-16s %8d ops, p50 %.1f us, p99 %.1f us, max %.1f us"),
+				LexToString(static_cast<ETuningOperation>(TypeIndex)), Samples.Num(),
+				TuningSoak::Percentile(Samples, 0.50f), TuningSoak::Percentile(Samples, 0.99f), Samples.Last());
+			Samples.Reset();
+		}
+	}
+
+	const FString Row = FString::Printf(TEXT("%.0f,%llu,%d,%.1f,%.1f,%.1f,%.1f,%.1f\n"),
+		Elapsed, NumOperations, NumObjects, UsedPhysicalMB, P50, P95, P99, Max);
+	FFileHelper::SaveStringToFile(Row, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+	if (BaselineObjects == INDEX_NONE)
+	{
+		// The first interval doubles as warm-up: caches and pools fill before the baseline is taken
+		BaselineObjects = NumObjects;
+		BaselineUsedPhysical = UsedPhysical;
+		return;
+	}
+
+	const int32 ObjectGrowth = NumObjects - BaselineObjects;
+	const double MemoryGrowthMB = (static_cast<double>(UsedPhysical) - static_cast<double>(BaselineUsedPhysical)) / (1024.0 * 1024.0);
+
+	if (ObjectGrowth > CVarSoakMaxObjectGrowth.GetValueOnGameThread())
+	{
+		FinishSoak(true, FString::Printf(TEXT("UObject count grew by %d"), ObjectGrowth));
+	}
+	else if (MemoryGrowthMB > CVarSoakMaxMemoryGrowthMB.GetValueOnGameThread())
+	{
+		FinishSoak(true, FString::Printf(TEXT("used physical memory grew by %.1f MB"), MemoryGrowthMB));
+	}
+}
+
+void UTuningSoakSubsystem::FinishSoak(bool bSoakFailed, const FString& Reason)
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	bRunning = false;
+	bFailed = bSoakFailed;
+
+	for (AActor* Vehicle : SpawnedVehicles)
+	{
+		if (IsValid(Vehicle))
+		{
+			Vehicle->Destroy();
+		}
+	}
+	SpawnedVehicles.Reset();
+
+	if (IsValid(Controller) && IsValid(OriginalVehicle))
+	{
+		Controller->SetTargetVehicle(OriginalVehicle);
+	}
+
+	if (bFailed)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TuningSoak: FAILED after %.0f s and %llu ops: %s (report: %s)"), Elapsed, NumOperations, *Reason, *CsvPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Display, TEXT("TuningSoak: Passed after %.0f s and %llu ops: %s (report: %s)"), Elapsed, NumOperations, *Reason, *CsvPath);
+	}
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GTuningSoakStartCommand(
+	TEXT("TuneX.Soak.Start"),
+	TEXT("Drives random tuning operations and tracks UObject/memory growth. Usage: TuneX.Soak.Start [Seconds=0 (until stopped)] [OpsPerSecond=2000] [Seed=0]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UTuningSoakSubsystem* Soak = World ? World->GetSubsystem<UTuningSoakSubsystem>() : nullptr;
+		if (!Soak)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("TuningSoak: Needs a game or PIE world"));
+			return;
+		}
+
+		const float Seconds = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.0f;
+		const float Ops = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 2000.0f;
+		const int32 Seed = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 0;
+		Soak->StartSoak(Seconds, Ops, Seed, /*bExitWhenDone*/ false);
+	}));
+
+static FAutoConsoleCommandWithWorld GTuningSoakStopCommand(
+	TEXT("TuneX.Soak.Stop"),
+	TEXT("Stops a running tuning soak"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UTuningSoakSubsystem* Soak = World ? World->GetSubsystem<UTuningSoakSubsystem>() : nullptr)
+		{
+			Soak->StopSoak();
+		}
+	}));
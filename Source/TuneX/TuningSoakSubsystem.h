@@ -0,0 +1,109 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TuningOperation.h"
+#include "TuningSoakSubsystem.generated.h"
+
+class ATuningController;
+class UVehicleConfigDataAsset;
+
+/**
+ * Soak/stress harness for long tuning sessions
+ * Drives random tuning operations (part and paint changes, vehicle spawn/destroy, target switching) through
+ * ATuningController and, every TuneX.Soak.SnapshotInterval seconds, collects garbage and records the live UObject
+ * count, used physical memory and operation latency percentiles to Saved/TuneX/Soak.csv. The first snapshot is
+ * the baseline; the soak fails once growth past it exceeds TuneX.Soak.MaxObjectGrowth or TuneX.Soak.MaxMemoryGrowthMB.
+ *
+ * Headless (exits with 1 on failure): -game -nullrhi -unattended -TuneXSoak=<Seconds> [-TuneXSoakOps=<PerSecond>] [-TuneXSoakSeed=<Seed>]
+ * Console: TuneX.Soak.Start [Seconds] [OpsPerSecond] [Seed], TuneX.Soak.Stop
+ */
+UCLASS()
+class TUNEX_API UTuningSoakSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Starts a soak on the world's tuning controller and its target vehicle
+	 * @param DurationSeconds - How long to run; 0 runs until StopSoak
+	 * @param OpsPerSecond - Operations issued per second of game time
+	 * @param Seed - Random seed, so a failing sequence can be reproduced
+	 * @param bExitWhenDone - Request engine exit with the result as exit code when the soak ends
+	 * @return false if there is no vehicle to drive
+	 */
+	bool StartSoak(float DurationSeconds, float OpsPerSecond, int32 Seed, bool bExitWhenDone);
+
+	/**
+	 * Ends the soak, destroying the vehicles it spawned
+	 */
+	void StopSoak();
+
+	bool IsRunning() const { return bRunning; }
+	bool HasFailed() const { return bFailed; }
+
+private:
+	/**
+	 * Picks the next operation; vehicle operations dominate, scene operations keep actor churn going
+	 */
+	FTuningOperation MakeRandomOperation() const;
+
+	/**
+	 * Runs one operation and records its latency
+	 */
+	void RunOperation(const FTuningOperation& Operation);
+
+	void SpawnVehicle();
+	void DestroyVehicle();
+	void SwitchTarget();
+
+	/**
+	 * Collects garbage, samples counters, appends a CSV row and checks growth against the baseline
+	 */
+	void TakeSnapshot();
+
+	void FinishSoak(bool bSoakFailed, const FString& Reason);
+
+	UPROPERTY()
+	TObjectPtr<ATuningController> Controller;
+
+	// Vehicle the soak started on; never destroyed
+	UPROPERTY()
+	TObjectPtr<AActor> OriginalVehicle;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> SpawnedVehicles;
+
+	UPROPERTY()
+	TObjectPtr<UVehicleConfigDataAsset> Config;
+
+	FRandomStream Random;
+
+	// Latency samples (microseconds) since the last snapshot, per operation type
+	TArray<float> LatencySamples[NumTuningOperations];
+
+	FString CsvPath;
+
+	double Duration = 0.0;
+	double Elapsed = 0.0;
+	double SinceSnapshot = 0.0;
+	float OpsPerSecond = 0.0f;
+	float OpAccumulator = 0.0f;
+	uint64 NumOperations = 0;
+	uint64 NumChanges = 0;
+
+	int32 BaselineObjects = INDEX_NONE;
+	uint64 BaselineUsedPhysical = 0;
+
+	bool bRunning = false;
+	bool bFailed = false;
+	bool bExitWhenDone = false;
+};
@@ -8,6 +8,10 @@ AVehicleActor::AVehicleActor()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
+	// Builds replicate through the master component; they change rarely, so a low update rate is enough
+	bReplicates = true;
+	NetUpdateFrequency = 10.0f;
+
 	// Create the root mesh component
 	VehicleMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VehicleMesh"));
 	RootComponent = VehicleMesh;
@@ -24,21 +28,43 @@ void AVehicleActor::BeginPlay()
 	if (VehicleMasterComponent)
 	{
 		VehicleMasterComponent->MainVehicleMesh = VehicleMesh;
+		BindModificationEvents();
+	}
+}
+
+void AVehicleActor::BindModificationEvents()
+{
+	// AddUniqueDynamic, so a pooled vehicle never ends up broadcasting twice per change
+	VehicleMasterComponent->OnBumperChanged.AddUniqueDynamic(this, &AVehicleActor::HandleBumperChanged);
+	VehicleMasterComponent->OnPaintChanged.AddUniqueDynamic(this, &AVehicleActor::HandlePaintChanged);
+}
 
-		// Bind to modification events
-		VehicleMasterComponent->OnBumperChanged.AddDynamic(this, 
-			[this](FName BumperID, const FString& DisplayName)
-			{
-				OnModificationComplete.Broadcast(FString::Printf(TEXT("Bumper: %s"), *DisplayName));
-			}
-		);
-
-		VehicleMasterComponent->OnPaintChanged.AddDynamic(this,
-			[this](FName PaintID, const FString& DisplayName)
-			{
-				OnModificationComplete.Broadcast(FString::Printf(TEXT("Paint: %s"), *DisplayName));
-			}
-		);
+void AVehicleActor::HandleBumperChanged(FName BumperID, const FString& DisplayName)
+{
+	OnModificationComplete.Broadcast(FString::Printf(TEXT("Bumper: %s"), *DisplayName));
+}
+
+void AVehicleActor::HandlePaintChanged(FName PaintID, const FString& DisplayName)
+{
+	OnModificationComplete.Broadcast(FString::Printf(TEXT("Paint: %s"), *DisplayName));
+}
+
+void AVehicleActor::ResetForReuse(UVehicleConfigDataAsset* Config, const FVehicleBuild& Build)
+{
+	if (!VehicleMasterComponent)
+	{
+		return;
+	}
+
+	BindModificationEvents();
+	VehicleMasterComponent->ResetForReuse(VehicleMesh, Config, Build);
+}
+
+void AVehicleActor::PrepareForPool()
+{
+	if (VehicleMasterComponent)
+	{
+		VehicleMasterComponent->PrepareForPool();
 	}
 }
 
@@ -5,9 +5,11 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "VehicleModifierInterface.h"
+#include "VehicleBuild.h"
 #include "VehicleActor.generated.h"
 
 class UVehicleMasterComponent;
+class UVehicleConfigDataAsset;
 
 /**
  * Base vehicle actor that implements the VehicleModifierInterface
@@ -37,6 +39,20 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
 	FOnModificationComplete OnModificationComplete;
 
+	/**
+	 * Gives a pooled vehicle a new model and build (see UVehicleActorPool)
+	 * Components stay registered and BeginPlay does not run again; only the catalog, the chassis binding
+	 * and the slots that differ are touched.
+	 * @param Config - Catalog to use
+	 * @param Build - Build to apply
+	 */
+	virtual void ResetForReuse(UVehicleConfigDataAsset* Config, const FVehicleBuild& Build);
+
+	/**
+	 * Stops pending work before the vehicle is parked in a pool
+	 */
+	virtual void PrepareForPool();
+
 	// IVehicleModifierInterface implementation
 	virtual bool SetFrontBumper_Implementation(FName BumperID) override;
 	virtual bool SetRearBumper_Implementation(FName BumperID) override;
@@ -45,4 +61,16 @@ public:
 	virtual FPaintColor GetCurrentPaint_Implementation() const override;
 	virtual bool CycleNextFrontBumper_Implementation() override;
 	virtual bool CycleNextPaint_Implementation() override;
+
+private:
+	/**
+	 * Binds the modification handlers; safe to call more than once
+	 */
+	void BindModificationEvents();
+
+	UFUNCTION()
+	void HandleBumperChanged(FName BumperID, const FString& DisplayName);
+
+	UFUNCTION()
+	void HandlePaintChanged(FName PaintID, const FString& DisplayName);
 };
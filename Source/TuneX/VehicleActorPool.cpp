@@ -0,0 +1,279 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleActorPool.h"
+#include "VehicleActor.h"
+#include "VehicleMasterComponent.h"
+#include "TuneXStats.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pool Acquire"), STAT_TuneX_PoolAcquire, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Reuses"), STAT_TuneX_PoolReuses, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Spawns"), STAT_TuneX_PoolSpawns, STATGROUP_TuneX);
+
+bool UVehicleActorPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UVehicleActorPool::Deinitialize()
+{
+	Buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+AVehicleActor* UVehicleActorPool::AcquireVehicle(TSubclassOf<AVehicleActor> VehicleClass, const FTransform& Transform, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build)
+{
+	if (!VehicleClass)
+	{
+		return nullptr;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TuneX_PoolAcquire);
+	const double StartTime = FPlatformTime::Seconds();
+
+	AVehicleActor* Vehicle = nullptr;
+	if (FVehicleActorPoolBucket* Bucket = Buckets.Find(VehicleClass.Get()))
+	{
+		while (!Vehicle && Bucket->FreeActors.Num() > 0)
+		{
+			Vehicle = Bucket->FreeActors.Pop(/*bAllowShrinking*/ false);
+			if (!IsValid(Vehicle))
+			{
+				Vehicle = nullptr;
+			}
+		}
+	}
+
+	const bool bReused = Vehicle != nullptr;
+	if (!Vehicle)
+	{
+		Vehicle = SpawnParkedVehicle(VehicleClass);
+		if (!Vehicle)
+		{
+			return nullptr;
+		}
+	}
+
+	Vehicle->SetActorTransform(Transform, /*bSweep*/ false, nullptr, ETeleportType::ResetPhysics);
+	Vehicle->SetActorHiddenInGame(false);
+	Vehicle->SetActorEnableCollision(true);
+	Vehicle->ResetForReuse(Config, Build);
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	++Stats.NumAcquires;
+	if (bReused)
+	{
+		++Stats.NumReuses;
+		Stats.ReuseSeconds += Seconds;
+		Stats.MaxReuseSeconds = FMath::Max(Stats.MaxReuseSeconds, Seconds);
+		INC_DWORD_STAT(STAT_TuneX_PoolReuses);
+	}
+	else
+	{
+		++Stats.NumSpawns;
+		Stats.SpawnSeconds += Seconds;
+		Stats.MaxSpawnSeconds = FMath::Max(Stats.MaxSpawnSeconds, Seconds);
+		INC_DWORD_STAT(STAT_TuneX_PoolSpawns);
+	}
+
+	return Vehicle;
+}
+
+void UVehicleActorPool::ReleaseVehicle(AVehicleActor* Vehicle)
+{
+	if (!IsValid(Vehicle))
+	{
+		return;
+	}
+
+	FVehicleActorPoolBucket& Bucket = Buckets.FindOrAdd(Vehicle->GetClass());
+	if (Bucket.FreeActors.Contains(Vehicle))
+	{
+		return;
+	}
+
+	Vehicle->PrepareForPool();
+	ParkVehicle(Vehicle);
+	Bucket.FreeActors.Add(Vehicle);
+	++Stats.NumReleases;
+}
+
+AVehicleActor* UVehicleActorPool::SwitchVehicle(AVehicleActor* Current, TSubclassOf<AVehicleActor> VehicleClass, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build)
+{
+	const FTransform Transform = IsValid(Current) ? Current->GetActorTransform() : FTransform::Identity;
+
+	// Release first, so switching back and forth between two models of one class reuses the same actor
+	ReleaseVehicle(Current);
+	++Stats.NumSwitches;
+	return AcquireVehicle(VehicleClass, Transform, Config, Build);
+}
+
+void UVehicleActorPool::Prewarm(TSubclassOf<AVehicleActor> VehicleClass, int32 Count)
+{
+	if (!VehicleClass)
+	{
+		return;
+	}
+
+	FVehicleActorPoolBucket& Bucket = Buckets.FindOrAdd(VehicleClass.Get());
+	Bucket.FreeActors.Reserve(Count);
+	while (Bucket.FreeActors.Num() < Count)
+	{
+		AVehicleActor* Vehicle = SpawnParkedVehicle(VehicleClass);
+		if (!Vehicle)
+		{
+			break;
+		}
+		Bucket.FreeActors.Add(Vehicle);
+	}
+}
+
+int32 UVehicleActorPool::GetNumFree(TSubclassOf<AVehicleActor> VehicleClass) const
+{
+	const FVehicleActorPoolBucket* Bucket = Buckets.Find(VehicleClass.Get());
+	return Bucket ? Bucket->FreeActors.Num() : 0;
+}
+
+AVehicleActor* UVehicleActorPool::SpawnParkedVehicle(TSubclassOf<AVehicleActor> VehicleClass)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	AVehicleActor* Vehicle = World->SpawnActorDeferred<AVehicleActor>(VehicleClass, FTransform::Identity, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Vehicle)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleActorPool: Failed to spawn %s"), *VehicleClass->GetName());
+		return nullptr;
+	}
+
+	// Parked vehicles have no catalog yet; AcquireVehicle sets it up through ResetForReuse
+	if (Vehicle->VehicleMasterComponent)
+	{
+		Vehicle->VehicleMasterComponent->bInitializeOnBeginPlay = false;
+	}
+	Vehicle->FinishSpawning(FTransform::Identity);
+
+	ParkVehicle(Vehicle);
+	return Vehicle;
+}
+
+void UVehicleActorPool::ParkVehicle(AVehicleActor* Vehicle)
+{
+	Vehicle->SetActorHiddenInGame(true);
+	Vehicle->SetActorEnableCollision(false);
+}
+
+static FAutoConsoleCommandWithWorld GVehicleActorPoolStatsCommand(
+	TEXT("TuneX.Pool.Stats"),
+	TEXT("Logs vehicle actor pool counters and acquire times"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UVehicleActorPool* Pool = World ? World->GetSubsystem<UVehicleActorPool>() : nullptr;
+		if (!Pool)
+		{
+			return;
+		}
+
+		const FVehicleActorPoolStats& Stats = Pool->GetStats();
+		UE_LOG(LogTemp, Display, TEXT("VehicleActorPool: %llu acquires (%llu reused, %llu spawned), %llu releases, %llu switches"),
+			Stats.NumAcquires, Stats.NumReuses, Stats.NumSpawns, Stats.NumReleases, Stats.NumSwitches);
+		UE_LOG(LogTemp, Display, TEXT("VehicleActorPool: reuse avg %.3f ms max %.3f ms, spawn avg %.3f ms max %.3f ms"),
+			Stats.NumReuses ? Stats.ReuseSeconds * 1000.0 / Stats.NumReuses : 0.0, Stats.MaxReuseSeconds * 1000.0,
+			Stats.NumSpawns ? Stats.SpawnSeconds * 1000.0 / Stats.NumSpawns : 0.0, Stats.MaxSpawnSeconds * 1000.0);
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GVehicleActorPoolBenchmarkCommand(
+	TEXT("TuneX.Pool.Benchmark"),
+	TEXT("Compares destroy+spawn against pooled switching between two showroom models. Usage: TuneX.Pool.Benchmark [NumSwitches=100]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UVehicleActorPool* Pool = World ? World->GetSubsystem<UVehicleActorPool>() : nullptr;
+		if (!Pool)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleActorPool: Benchmark needs a game or PIE world"));
+			return;
+		}
+
+		const int32 NumSwitches = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+
+		// Two models: the class and catalog of a vehicle in the level if there is one, plus a synthetic catalog
+		TSubclassOf<AVehicleActor> VehicleClass = AVehicleActor::StaticClass();
+		UVehicleConfigDataAsset* Configs[2] = { nullptr, NewObject<UVehicleConfigDataAsset>(GetTransientPackage()) };
+		for (TActorIterator<AVehicleActor> It(World); It; ++It)
+		{
+			if (It->VehicleMasterComponent && It->VehicleMasterComponent->VehicleConfig && !It->IsHidden())
+			{
+				VehicleClass = It->GetClass();
+				Configs[0] = It->VehicleMasterComponent->VehicleConfig;
+				break;
+			}
+		}
+		for (int32 PartIndex = 0; PartIndex < 4; ++PartIndex)
+		{
+			Configs[1]->FrontBumpers.AddDefaulted_GetRef().PartID = FName(*FString::Printf(TEXT("bench_bumper_%d"), PartIndex));
+			Configs[1]->PaintColors.AddDefaulted_GetRef().PaintID = FName(*FString::Printf(TEXT("bench_paint_%d"), PartIndex));
+		}
+		if (!Configs[0])
+		{
+			Configs[0] = Configs[1];
+		}
+		const FVehicleBuild Builds[2] = { FVehicleBuild::MakeDefault(*Configs[0]), FVehicleBuild::MakeDefault(*Configs[1]) };
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		const FTransform Platform(FVector(0.0, 0.0, -100000.0));
+
+		// Destroy and spawn, as the showroom did before pooling
+		double StartTime = FPlatformTime::Seconds();
+		AVehicleActor* Vehicle = nullptr;
+		for (int32 Switch = 0; Switch < NumSwitches; ++Switch)
+		{
+			if (Vehicle)
+			{
+				Vehicle->Destroy();
+			}
+			Vehicle = World->SpawnActor<AVehicleActor>(VehicleClass, Platform, SpawnParams);
+			if (Vehicle && Vehicle->VehicleMasterComponent)
+			{
+				Vehicle->VehicleMasterComponent->SetVehicleConfig(Configs[Switch & 1]);
+				Vehicle->VehicleMasterComponent->ApplyBuildAsync(Builds[Switch & 1]);
+			}
+		}
+		const double SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumSwitches;
+		if (Vehicle)
+		{
+			Vehicle->Destroy();
+		}
+
+		// Pooled: the first two switches spawn, the rest reuse
+		const FVehicleActorPoolStats StatsBefore = Pool->GetStats();
+		Vehicle = nullptr;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Switch = 0; Switch < NumSwitches; ++Switch)
+		{
+			Vehicle = Vehicle
+				? Pool->SwitchVehicle(Vehicle, VehicleClass, Configs[Switch & 1], Builds[Switch & 1])
+				: Pool->AcquireVehicle(VehicleClass, Platform, Configs[Switch & 1], Builds[Switch & 1]);
+		}
+		const double PooledMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumSwitches;
+		Pool->ReleaseVehicle(Vehicle);
+
+		const FVehicleActorPoolStats& StatsAfter = Pool->GetStats();
+		const uint64 NumReuses = StatsAfter.NumReuses - StatsBefore.NumReuses;
+		UE_LOG(LogTemp, Display, TEXT("VehicleActorPool: %d switches of %s, destroy+spawn %.3f ms each, pooled %.3f ms each (%llu reused, %llu spawned, reuse max %.3f ms)"),
+			NumSwitches, *VehicleClass->GetName(), SpawnMs, PooledMs, NumReuses, StatsAfter.NumSpawns - StatsBefore.NumSpawns, StatsAfter.MaxReuseSeconds * 1000.0);
+
+		// Slot loads finish asynchronously, so this is the game thread cost of the switch itself
+		const double FrameMs = 1000.0 / 60.0;
+		UE_LOG(LogTemp, Display, TEXT("VehicleActorPool: worst pooled switch is %.1f%% of a 60 Hz frame (destroy+spawn average %.1f%%)"),
+			StatsAfter.MaxReuseSeconds * 1000.0 * 100.0 / FrameMs, SpawnMs * 100.0 / FrameMs);
+	})
+);
@@ -0,0 +1,117 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VehicleBuild.h"
+#include "VehicleActorPool.generated.h"
+
+class AVehicleActor;
+class UVehicleConfigDataAsset;
+
+/**
+ * Free vehicle actors of one class
+ */
+USTRUCT()
+struct FVehicleActorPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AVehicleActor>> FreeActors;
+};
+
+/**
+ * Acquire and release counters of a pool
+ */
+struct FVehicleActorPoolStats
+{
+	uint64 NumAcquires = 0;
+	uint64 NumReuses = 0;
+	uint64 NumSpawns = 0;
+	uint64 NumReleases = 0;
+	uint64 NumSwitches = 0;
+
+	// Game thread time spent in AcquireVehicle, split by whether a parked actor was reused
+	double ReuseSeconds = 0.0;
+	double MaxReuseSeconds = 0.0;
+	double SpawnSeconds = 0.0;
+	double MaxSpawnSeconds = 0.0;
+};
+
+/**
+ * Pool of AVehicleActor instances per vehicle class
+ * Released actors are hidden and parked with their components still registered, so acquiring one
+ * skips spawning, construction and BeginPlay; AVehicleActor::ResetForReuse only swaps the catalog,
+ * rebinds the chassis and applies the slots that differ.
+ *
+ * Stats: stat TuneX, TuneX.Pool.Stats; benchmark: TuneX.Pool.Benchmark [NumSwitches], which needs a game world:
+ *   UnrealEditor TuneX.uproject -game -nullrhi -unattended -stdout -ExecCmds="TuneX.Pool.Benchmark 200,TuneX.Pool.Stats,Quit"
+ */
+UCLASS()
+class TUNEX_API UVehicleActorPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets a vehicle from the pool, spawning one if the pool is empty
+	 * @param VehicleClass - Class of the vehicle
+	 * @param Transform - Where to place it
+	 * @param Config - Catalog to use
+	 * @param Build - Build to apply (through the async path)
+	 * @return The vehicle, or nullptr if spawning failed
+	 */
+	AVehicleActor* AcquireVehicle(TSubclassOf<AVehicleActor> VehicleClass, const FTransform& Transform, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build);
+
+	/**
+	 * Returns a vehicle to the pool
+	 * @param Vehicle - A vehicle previously returned by AcquireVehicle
+	 */
+	void ReleaseVehicle(AVehicleActor* Vehicle);
+
+	/**
+	 * Replaces the vehicle on a showroom platform with another model, in place
+	 * @param Current - Vehicle shown now; released to the pool (may be nullptr)
+	 * @param VehicleClass - Class of the model to show
+	 * @param Config - Its catalog
+	 * @param Build - Its build
+	 * @return The vehicle now shown, at Current's transform
+	 */
+	AVehicleActor* SwitchVehicle(AVehicleActor* Current, TSubclassOf<AVehicleActor> VehicleClass, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build);
+
+	/**
+	 * Spawns parked vehicles ahead of time so later acquires never spawn
+	 * @param VehicleClass - Class to prewarm
+	 * @param Count - Number of free vehicles wanted in the pool
+	 */
+	void Prewarm(TSubclassOf<AVehicleActor> VehicleClass, int32 Count);
+
+	/**
+	 * Gets the number of free vehicles of a class
+	 */
+	int32 GetNumFree(TSubclassOf<AVehicleActor> VehicleClass) const;
+
+	const FVehicleActorPoolStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats = FVehicleActorPoolStats(); }
+
+private:
+	/**
+	 * Spawns a vehicle that starts parked
+	 */
+	AVehicleActor* SpawnParkedVehicle(TSubclassOf<AVehicleActor> VehicleClass);
+
+	/**
+	 * Hides a vehicle and stops it from colliding
+	 */
+	static void ParkVehicle(AVehicleActor* Vehicle);
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FVehicleActorPoolBucket> Buckets;
+
+	FVehicleActorPoolStats Stats;
+};
@@ -0,0 +1,390 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleAudioSubsystem.h"
+#include "VehicleMasterComponent.h"
+#include "VehiclePartResidency.h"
+#include "AudioDevice.h"
+#include "Components/AudioComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Sound/SoundWave.h"
+
+static TAutoConsoleVariable<int32> CVarAudioMaxVoices(
+	TEXT("TuneX.Audio.MaxVoices"),
+	32,
+	TEXT("Maximum number of part sound layers playing at once; the nearest to the listener win"));
+
+static TAutoConsoleVariable<float> CVarAudioCrossfadeTime(
+	TEXT("TuneX.Audio.CrossfadeTime"),
+	0.35f,
+	TEXT("Seconds to crossfade between the old and new sound of a part slot"));
+
+static TAutoConsoleVariable<float> CVarAudioMaxDistance(
+	TEXT("TuneX.Audio.MaxDistance"),
+	8000.0f,
+	TEXT("Distance (cm) beyond which part sound layers do not take a voice"));
+
+bool UVehicleAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UVehicleAudioSubsystem::Deinitialize()
+{
+	for (FVehicleSoundLayer& Layer : Layers)
+	{
+		if (Layer.LoadHandle.IsValid())
+		{
+			Layer.LoadHandle->CancelHandle();
+		}
+	}
+	Layers.Empty();
+
+	for (UAudioComponent* Component : FreeComponents)
+	{
+		if (IsValid(Component))
+		{
+			Component->DestroyComponent();
+		}
+	}
+	FreeComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UVehicleAudioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVehicleAudioSubsystem, STATGROUP_Tickables);
+}
+
+void UVehicleAudioSubsystem::Tick(float DeltaTime)
+{
+	if (Layers.Num() == 0)
+	{
+		return;
+	}
+
+	for (FVehicleSoundLayer& Layer : Layers)
+	{
+		if (Layer.FadingOut)
+		{
+			Layer.FadeOutRemaining -= DeltaTime;
+			if (Layer.FadeOutRemaining <= 0.0f)
+			{
+				ReleaseComponent(Layer.FadingOut);
+				Layer.FadingOut = nullptr;
+			}
+		}
+	}
+
+	// Layers of destroyed vehicles, and layers that finished fading to silence
+	Layers.RemoveAll([this](FVehicleSoundLayer& Layer)
+	{
+		const bool bVehicleGone = !Layer.Vehicle.IsValid();
+		const bool bSilent = Layer.Sound.IsNull() && !Layer.Active && !Layer.FadingOut;
+		if (!bVehicleGone && !bSilent)
+		{
+			return false;
+		}
+
+		ReleaseComponent(Layer.Active);
+		ReleaseComponent(Layer.FadingOut);
+		if (Layer.LoadHandle.IsValid())
+		{
+			Layer.LoadHandle->CancelHandle();
+		}
+		return true;
+	});
+
+	UpdateVoiceLimit();
+
+	for (FVehicleSoundLayer& Layer : Layers)
+	{
+		StartPendingWave(Layer);
+	}
+}
+
+void UVehicleAudioSubsystem::SetPartSound(UVehicleMasterComponent* Vehicle, EVehiclePartSlot Slot, const TSoftObjectPtr<USoundWave>& Sound)
+{
+	if (!Vehicle)
+	{
+		return;
+	}
+
+	FVehicleSoundLayer* Layer = FindLayer(Vehicle, Slot);
+	if (!Layer)
+	{
+		if (Sound.IsNull())
+		{
+			return;
+		}
+
+		Layer = &Layers.AddDefaulted_GetRef();
+		Layer->Vehicle = Vehicle;
+		Layer->Slot = Slot;
+	}
+
+	if (Layer->Sound == Sound)
+	{
+		return;
+	}
+
+	Layer->Sound = Sound;
+	Layer->PendingWave = nullptr;
+	if (Layer->LoadHandle.IsValid())
+	{
+		Layer->LoadHandle->CancelHandle();
+		Layer->LoadHandle.Reset();
+	}
+
+	if (Sound.IsNull())
+	{
+		// Fade to silence; Tick drops the layer once the fade is done
+		if (Layer->Active)
+		{
+			ReleaseComponent(Layer->FadingOut);
+			Layer->Active->FadeOut(CVarAudioCrossfadeTime.GetValueOnGameThread(), 0.0f);
+			Layer->FadingOut = Layer->Active;
+			Layer->FadeOutRemaining = CVarAudioCrossfadeTime.GetValueOnGameThread();
+			Layer->Active = nullptr;
+		}
+		return;
+	}
+
+	// Nothing can play it (-nosound, servers): the layer is tracked like any other, the wave is just never loaded
+	if (!GetWorld()->GetAudioDeviceRaw())
+	{
+		return;
+	}
+
+	// The handle stays with the layer so the wave is kept resident while it plays
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateUObject(this, &UVehicleAudioSubsystem::OnSoundLoaded, TWeakObjectPtr<UVehicleMasterComponent>(Vehicle), Slot, Sound);
+	TArray<FSoftObjectPath> Paths = { Sound.ToSoftObjectPath() };
+
+	if (UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get())
+	{
+		Layer->LoadHandle = Residency->RequestAsyncLoad(Paths, OnLoaded);
+	}
+	else
+	{
+		Layer->LoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, OnLoaded);
+	}
+}
+
+void UVehicleAudioSubsystem::RemoveVehicle(UVehicleMasterComponent* Vehicle)
+{
+	Layers.RemoveAll([this, Vehicle](FVehicleSoundLayer& Layer)
+	{
+		if (Layer.Vehicle.Get() != Vehicle)
+		{
+			return false;
+		}
+
+		ReleaseComponent(Layer.Active);
+		ReleaseComponent(Layer.FadingOut);
+		if (Layer.LoadHandle.IsValid())
+		{
+			Layer.LoadHandle->CancelHandle();
+		}
+		return true;
+	});
+}
+
+int32 UVehicleAudioSubsystem::GetNumAudible() const
+{
+	int32 NumAudible = 0;
+	for (const FVehicleSoundLayer& Layer : Layers)
+	{
+		NumAudible += Layer.Active ? 1 : 0;
+	}
+	return NumAudible;
+}
+
+FVehicleSoundLayer* UVehicleAudioSubsystem::FindLayer(const UVehicleMasterComponent* Vehicle, EVehiclePartSlot Slot)
+{
+	return Layers.FindByPredicate([Vehicle, Slot](const FVehicleSoundLayer& Layer)
+	{
+		return Layer.Vehicle.Get() == Vehicle && Layer.Slot == Slot;
+	});
+}
+
+void UVehicleAudioSubsystem::OnSoundLoaded(TWeakObjectPtr<UVehicleMasterComponent> Vehicle, EVehiclePartSlot Slot, TSoftObjectPtr<USoundWave> Sound)
+{
+	FVehicleSoundLayer* Layer = FindLayer(Vehicle.Get(), Slot);
+	USoundWave* Wave = Sound.Get();
+
+	// Superseded by a newer part while loading
+	if (!Layer || Layer->Sound != Sound || !Wave)
+	{
+		return;
+	}
+
+	// Decompression runs as an async task; the crossfade waits for it in StartPendingWave
+	if (FAudioDevice* AudioDevice = GetWorld()->GetAudioDeviceRaw())
+	{
+		AudioDevice->Precache(Wave, /*bSynchronous*/ false, /*bTrackMemory*/ true, /*bForceFullDecompression*/ false);
+		++NumPrecaches;
+	}
+
+	Layer->PendingWave = Wave;
+	StartPendingWave(*Layer);
+}
+
+void UVehicleAudioSubsystem::StartPendingWave(FVehicleSoundLayer& Layer)
+{
+	if (!Layer.PendingWave || !Layer.bAudible || !GetWorld()->GetAudioDeviceRaw())
+	{
+		return;
+	}
+
+	if (Layer.PendingWave->GetPrecacheState() == ESoundWavePrecacheState::InProgress)
+	{
+		return;
+	}
+
+	UVehicleMasterComponent* Vehicle = Layer.Vehicle.Get();
+	USceneComponent* AttachTo = Vehicle && Vehicle->GetOwner() ? Vehicle->GetOwner()->GetRootComponent() : nullptr;
+	if (!AttachTo)
+	{
+		return;
+	}
+
+	const float CrossfadeTime = CVarAudioCrossfadeTime.GetValueOnGameThread();
+
+	if (Layer.Active)
+	{
+		ReleaseComponent(Layer.FadingOut);
+		Layer.Active->FadeOut(CrossfadeTime, 0.0f);
+		Layer.FadingOut = Layer.Active;
+		Layer.FadeOutRemaining = CrossfadeTime;
+		Layer.Active = nullptr;
+		++NumCrossfades;
+	}
+
+	UAudioComponent* Component = AcquireComponent(AttachTo);
+	Component->SetSound(Layer.PendingWave);
+	Component->FadeIn(CrossfadeTime);
+
+	Layer.Active = Component;
+	Layer.PendingWave = nullptr;
+}
+
+void UVehicleAudioSubsystem::UpdateVoiceLimit()
+{
+	FVector ListenerLocation = FVector::ZeroVector;
+	if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		FVector FrontDir;
+		FVector RightDir;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+	}
+
+	const double MaxDistanceSq = FMath::Square(static_cast<double>(CVarAudioMaxDistance.GetValueOnGameThread()));
+
+	TArray<TPair<double, int32>, TInlineAllocator<64>> Candidates;
+	for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		const FVehicleSoundLayer& Layer = Layers[LayerIndex];
+		const AActor* Owner = Layer.Vehicle.IsValid() ? Layer.Vehicle->GetOwner() : nullptr;
+		if (!Owner || Layer.Sound.IsNull() || Owner->IsHidden())
+		{
+			continue;
+		}
+
+		const double DistanceSq = FVector::DistSquared(ListenerLocation, Owner->GetActorLocation());
+		if (DistanceSq <= MaxDistanceSq)
+		{
+			Candidates.Emplace(DistanceSq, LayerIndex);
+		}
+	}
+
+	Candidates.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+	TBitArray<> Audible(false, Layers.Num());
+	const int32 NumVoices = FMath::Min(Candidates.Num(), FMath::Max(0, CVarAudioMaxVoices.GetValueOnGameThread()));
+	for (int32 Rank = 0; Rank < NumVoices; ++Rank)
+	{
+		Audible[Candidates[Rank].Value] = true;
+	}
+
+	for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		FVehicleSoundLayer& Layer = Layers[LayerIndex];
+		if (Layer.bAudible == Audible[LayerIndex])
+		{
+			continue;
+		}
+
+		Layer.bAudible = Audible[LayerIndex];
+		if (!Layer.bAudible)
+		{
+			// Give the voice back; the loaded wave restarts when the layer wins a voice again
+			ReleaseComponent(Layer.Active);
+			Layer.Active = nullptr;
+			Layer.PendingWave = Layer.Sound.Get();
+		}
+		else if (!Layer.Active && !Layer.PendingWave)
+		{
+			Layer.PendingWave = Layer.Sound.Get();
+		}
+	}
+}
+
+UAudioComponent* UVehicleAudioSubsystem::AcquireComponent(USceneComponent* AttachTo)
+{
+	UAudioComponent* Component = nullptr;
+	while (!Component && FreeComponents.Num() > 0)
+	{
+		Component = FreeComponents.Pop(/*bAllowShrinking*/ false);
+		if (!IsValid(Component))
+		{
+			Component = nullptr;
+		}
+	}
+
+	if (!Component)
+	{
+		// Owned by the world rather than a vehicle, so it outlives any one vehicle and can move between them
+		Component = NewObject<UAudioComponent>(GetWorld());
+		Component->bAutoActivate = false;
+		Component->bAutoDestroy = false;
+		Component->bStopWhenOwnerDestroyed = false;
+		Component->RegisterComponentWithWorld(GetWorld());
+		++NumComponentsCreated;
+	}
+
+	Component->AttachToComponent(AttachTo, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	return Component;
+}
+
+void UVehicleAudioSubsystem::ReleaseComponent(UAudioComponent* Component)
+{
+	if (!IsValid(Component))
+	{
+		return;
+	}
+
+	Component->Stop();
+	Component->SetSound(nullptr);
+	Component->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	FreeComponents.Add(Component);
+}
+
+static FAutoConsoleCommandWithWorld GVehicleAudioStatsCommand(
+	TEXT("TuneX.Audio.Stats"),
+	TEXT("Prints part sound layer, voice and audio component pool usage"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		const UVehicleAudioSubsystem* Audio = World ? World->GetSubsystem<UVehicleAudioSubsystem>() : nullptr;
+		if (!Audio)
+		{
+			return;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("VehicleAudio: %d layers, %d audible (max %d), %d pooled components, %llu created, %llu precaches, %llu crossfades, audio device: %s"),
+			Audio->GetNumLayers(), Audio->GetNumAudible(), CVarAudioMaxVoices.GetValueOnGameThread(), Audio->GetNumPooled(),
+			Audio->NumComponentsCreated, Audio->NumPrecaches, Audio->NumCrossfades,
+			World->GetAudioDeviceRaw() ? TEXT("yes") : TEXT("none"));
+	}));
@@ -0,0 +1,116 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CarPartData.h"
+#include "VehicleAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundWave;
+class UVehicleMasterComponent;
+struct FStreamableHandle;
+
+/**
+ * Sound of one part slot on one vehicle
+ */
+USTRUCT()
+struct FVehicleSoundLayer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TWeakObjectPtr<UVehicleMasterComponent> Vehicle;
+
+	UPROPERTY()
+	EVehiclePartSlot Slot = EVehiclePartSlot::FrontBumper;
+
+	// Sound the layer should play; null once the part has no SoundModifier
+	UPROPERTY()
+	TSoftObjectPtr<USoundWave> Sound;
+
+	// Loaded wave waiting for its precache before it is faded in
+	UPROPERTY()
+	TObjectPtr<USoundWave> PendingWave;
+
+	// Playing component, and the one fading out after a change
+	UPROPERTY()
+	TObjectPtr<UAudioComponent> Active;
+
+	UPROPERTY()
+	TObjectPtr<UAudioComponent> FadingOut;
+
+	TSharedPtr<FStreamableHandle> LoadHandle;
+
+	float FadeOutRemaining = 0.0f;
+
+	// Set by voice limiting
+	bool bAudible = false;
+};
+
+/**
+ * Layers FCarPart::SoundModifier sounds onto vehicles
+ * Sounds are streamed in and precached before they are crossfaded in, so a part change never decompresses
+ * on the audio render thread. Audio components come from a pool, and only the TuneX.Audio.MaxVoices layers
+ * nearest to the listener hold one. Without an audio device (-nosound, servers) layers are tracked but silent,
+ * and their sounds are not loaded.
+ *
+ * Stats: TuneX.Audio.Stats
+ */
+UCLASS()
+class TUNEX_API UVehicleAudioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Changes the sound of a vehicle's part slot, crossfading from the previous one
+	 * @param Vehicle - The vehicle
+	 * @param Slot - The part slot
+	 * @param Sound - The part's SoundModifier; null fades the layer out
+	 */
+	void SetPartSound(UVehicleMasterComponent* Vehicle, EVehiclePartSlot Slot, const TSoftObjectPtr<USoundWave>& Sound);
+
+	/**
+	 * Stops every layer of a vehicle and returns its components to the pool
+	 */
+	void RemoveVehicle(UVehicleMasterComponent* Vehicle);
+
+	int32 GetNumLayers() const { return Layers.Num(); }
+	int32 GetNumAudible() const;
+	int32 GetNumPooled() const { return FreeComponents.Num(); }
+
+	uint64 NumComponentsCreated = 0;
+	uint64 NumCrossfades = 0;
+	uint64 NumPrecaches = 0;
+
+private:
+	FVehicleSoundLayer* FindLayer(const UVehicleMasterComponent* Vehicle, EVehiclePartSlot Slot);
+
+	void OnSoundLoaded(TWeakObjectPtr<UVehicleMasterComponent> Vehicle, EVehiclePartSlot Slot, TSoftObjectPtr<USoundWave> Sound);
+
+	/**
+	 * Fades the layer's pending wave in if it is precached and the layer is audible
+	 */
+	void StartPendingWave(FVehicleSoundLayer& Layer);
+
+	/**
+	 * Picks the layers nearest the listener, up to the voice limit
+	 */
+	void UpdateVoiceLimit();
+
+	UAudioComponent* AcquireComponent(USceneComponent* AttachTo);
+	void ReleaseComponent(UAudioComponent* Component);
+
+	UPROPERTY()
+	TArray<FVehicleSoundLayer> Layers;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UAudioComponent>> FreeComponents;
+};
@@ -0,0 +1,76 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleAudioSubsystem.h"
+#include "VehicleActor.h"
+#include "VehicleMasterComponent.h"
+#include "AudioDeviceHandle.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Sound/SoundWave.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVehicleAudioNullDeviceTest, "TuneX.Audio.NullDeviceBookkeeping",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FVehicleAudioNullDeviceTest::RunTest(const FString& Parameters)
+{
+	// A game world without an audio device, as under -nosound or on a dedicated server
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, /*bInformEngineOfWorld*/ false, TEXT("TuneXAudioTest"));
+	World->SetAudioDevice(FAudioDeviceHandle());
+
+	UVehicleAudioSubsystem* Audio = World->GetSubsystem<UVehicleAudioSubsystem>();
+	if (!TestNotNull(TEXT("Audio subsystem"), Audio) || !TestNull(TEXT("Audio device"), World->GetAudioDeviceRaw()))
+	{
+		World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AVehicleActor* First = World->SpawnActor<AVehicleActor>(AVehicleActor::StaticClass(), FTransform::Identity, SpawnParams);
+	AVehicleActor* Second = World->SpawnActor<AVehicleActor>(AVehicleActor::StaticClass(), FTransform::Identity, SpawnParams);
+	if (!TestTrue(TEXT("Vehicles spawned"), First && Second && First->VehicleMasterComponent && Second->VehicleMasterComponent))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	USoundWave* Wave = NewObject<USoundWave>(GetTransientPackage(), NAME_None, RF_Transient);
+	const TSoftObjectPtr<USoundWave> Sound(Wave);
+
+	Audio->SetPartSound(First->VehicleMasterComponent, EVehiclePartSlot::Wheels, Sound);
+	Audio->SetPartSound(First->VehicleMasterComponent, EVehiclePartSlot::Spoiler, Sound);
+	Audio->SetPartSound(Second->VehicleMasterComponent, EVehiclePartSlot::Wheels, Sound);
+	TestEqual(TEXT("Layers tracked without a device"), Audio->GetNumLayers(), 3);
+
+	// Voice limiting and fades run, but nothing takes a voice or gets precached
+	Audio->Tick(0.1f);
+	Audio->Tick(1.0f);
+	TestEqual(TEXT("Layers kept across ticks"), Audio->GetNumLayers(), 3);
+	TestEqual(TEXT("Audible layers"), Audio->GetNumAudible(), 0);
+	TestEqual(TEXT("Components created"), static_cast<int64>(Audio->NumComponentsCreated), 0ll);
+	TestEqual(TEXT("Precaches"), static_cast<int64>(Audio->NumPrecaches), 0ll);
+
+	// Clearing a slot drops its layer on the next tick
+	Audio->SetPartSound(First->VehicleMasterComponent, EVehiclePartSlot::Spoiler, TSoftObjectPtr<USoundWave>());
+	Audio->Tick(0.1f);
+	TestEqual(TEXT("Layers after clearing a slot"), Audio->GetNumLayers(), 2);
+
+	Audio->RemoveVehicle(First->VehicleMasterComponent);
+	TestEqual(TEXT("Layers after removing a vehicle"), Audio->GetNumLayers(), 1);
+
+	// Destroyed vehicles are dropped by Tick
+	Second->Destroy();
+	Second = nullptr;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	Audio->Tick(0.1f);
+	TestEqual(TEXT("Layers after the last vehicle is gone"), Audio->GetNumLayers(), 0);
+	TestEqual(TEXT("Pooled components"), Audio->GetNumPooled(), 0);
+
+	World->DestroyWorld(/*bInformEngineOfWorld*/ false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
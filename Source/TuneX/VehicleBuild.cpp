@@ -0,0 +1,277 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleBuild.h"
+#include "HAL/IConsoleManager.h"
+#include "Hash/CityHash.h"
+
+uint32 FVehicleBuild::GetChangedMask(const FVehicleBuild& Other) const
+{
+	uint32 Mask = 0;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (PartIndices[SlotIndex] != Other.PartIndices[SlotIndex])
+		{
+			Mask |= 1u << SlotIndex;
+		}
+	}
+
+	if (PaintIndex != Other.PaintIndex)
+	{
+		Mask |= 1u << VehicleBuildPaintBit;
+	}
+
+	return Mask;
+}
+
+bool FVehicleBuild::IsValidFor(const UVehicleConfigDataAsset& Config) const
+{
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 PartIndex = PartIndices[SlotIndex];
+		if (PartIndex != INDEX_NONE && !Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex)).IsValidIndex(PartIndex))
+		{
+			return false;
+		}
+	}
+
+	return PaintIndex == INDEX_NONE || Config.PaintColors.IsValidIndex(PaintIndex);
+}
+
+float FVehicleBuild::GetTotalPrice(const UVehicleConfigDataAsset& Config) const
+{
+	float TotalPrice = 0.0f;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		if (Parts.IsValidIndex(PartIndices[SlotIndex]))
+		{
+			TotalPrice += Parts[PartIndices[SlotIndex]].Price;
+		}
+	}
+
+	if (Config.PaintColors.IsValidIndex(PaintIndex))
+	{
+		TotalPrice += Config.PaintColors[PaintIndex].Price;
+	}
+
+	return TotalPrice;
+}
+
+int64 FVehicleBuild::GetEstimatedResourceSize(const UVehicleConfigDataAsset& Config, int32* OutNumMissing) const
+{
+	int64 TotalBytes = 0;
+	int32 NumMissing = 0;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		if (!Parts.IsValidIndex(PartIndices[SlotIndex]))
+		{
+			continue;
+		}
+
+		const FCarPart& Part = Parts[PartIndices[SlotIndex]];
+		if (Part.Metadata.IsBakedFor(Part.MeshAsset))
+		{
+			TotalBytes += Part.Metadata.ResourceSizeBytes;
+		}
+		else if (!Part.MeshAsset.IsNull())
+		{
+			++NumMissing;
+		}
+	}
+
+	if (OutNumMissing)
+	{
+		*OutNumMissing = NumMissing;
+	}
+	return TotalBytes;
+}
+
+uint64 FVehicleBuild::GetCanonicalHash(uint32 CatalogFingerprint) const
+{
+	uint32 Words[NumVehiclePartSlots + 2];
+	Words[0] = INTEL_ORDER32(CatalogFingerprint);
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		Words[SlotIndex + 1] = INTEL_ORDER32(static_cast<uint32>(PartIndices[SlotIndex]));
+	}
+	Words[NumVehiclePartSlots + 1] = INTEL_ORDER32(static_cast<uint32>(PaintIndex));
+
+	return CityHash64(reinterpret_cast<const char*>(Words), sizeof(Words));
+}
+
+FVehicleBuild FVehicleBuild::MakeDefault(const UVehicleConfigDataAsset& Config)
+{
+	FVehicleBuild Build;
+
+	if (Config.FrontBumpers.IsValidIndex(Config.DefaultFrontBumperIndex))
+	{
+		Build.SetPartIndex(EVehiclePartSlot::FrontBumper, Config.DefaultFrontBumperIndex);
+	}
+
+	if (Config.PaintColors.IsValidIndex(Config.DefaultPaintIndex))
+	{
+		Build.PaintIndex = Config.DefaultPaintIndex;
+	}
+
+	return Build;
+}
+
+namespace VehicleBuildNet
+{
+	// Change mask range: one bit per part slot plus paint
+	static constexpr uint32 MaskValueMax = VehicleBuildAllMask + 1;
+
+	class FDeltaState : public INetDeltaBaseState
+	{
+	public:
+		FVehicleBuild Build;
+		uint32 CatalogFingerprint = 0;
+
+		virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+		{
+			const FDeltaState* Other = static_cast<const FDeltaState*>(OtherState);
+			return Other && Other->CatalogFingerprint == CatalogFingerprint && Other->Build == Build;
+		}
+	};
+
+	static int32& IndexForBit(FVehicleBuild& Build, int32 Bit)
+	{
+		return Bit == VehicleBuildPaintBit ? Build.PaintIndex : Build.PartIndices[Bit];
+	}
+}
+
+bool FReplicatedVehicleBuild::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	using namespace VehicleBuildNet;
+
+	// No object references in here, nothing to map
+	if (DeltaParms.GatherGuidReferences || DeltaParms.MoveGuidToUnmapped || DeltaParms.bUpdateUnmappedObjects)
+	{
+		return false;
+	}
+
+	FVehicleBuildNetStats& Stats = FVehicleBuildNetStats::Get();
+
+	if (DeltaParms.Writer)
+	{
+		FBitWriter& Writer = *DeltaParms.Writer;
+		const FDeltaState* OldState = static_cast<const FDeltaState*>(DeltaParms.OldState);
+
+		// Nothing published yet
+		if (CatalogFingerprint == 0)
+		{
+			return false;
+		}
+
+		const bool bFullState = !OldState || OldState->CatalogFingerprint != CatalogFingerprint;
+		const uint32 ChangedMask = bFullState ? VehicleBuildAllMask : Build.GetChangedMask(OldState->Build);
+		if (ChangedMask == 0)
+		{
+			return false;
+		}
+
+		TSharedPtr<FDeltaState> NewState = MakeShared<FDeltaState>();
+		NewState->Build = Build;
+		NewState->CatalogFingerprint = CatalogFingerprint;
+		*DeltaParms.NewState = NewState;
+
+		const int64 StartBits = Writer.GetNumBits();
+
+		Writer.WriteBit(bFullState ? 1 : 0);
+		if (bFullState)
+		{
+			Writer << CatalogFingerprint;
+		}
+		else
+		{
+			Writer.WriteInt(ChangedMask, MaskValueMax);
+		}
+
+		// Indices are written +1 so INDEX_NONE packs to a single byte of zero
+		for (int32 Bit = 0; Bit <= VehicleBuildPaintBit; ++Bit)
+		{
+			if (ChangedMask & (1u << Bit))
+			{
+				uint32 PackedIndex = static_cast<uint32>(IndexForBit(Build, Bit) + 1);
+				Writer.SerializeIntPacked(PackedIndex);
+			}
+		}
+
+		const uint64 WrittenBits = static_cast<uint64>(Writer.GetNumBits() - StartBits);
+		if (bFullState)
+		{
+			++Stats.NumFullWrites;
+			Stats.FullBits += WrittenBits;
+			Stats.MaxFullBits = FMath::Max(Stats.MaxFullBits, WrittenBits);
+		}
+		else
+		{
+			++Stats.NumDeltaWrites;
+			Stats.DeltaBits += WrittenBits;
+			Stats.MaxDeltaBits = FMath::Max(Stats.MaxDeltaBits, WrittenBits);
+		}
+
+		return true;
+	}
+
+	if (DeltaParms.Reader)
+	{
+		FBitReader& Reader = *DeltaParms.Reader;
+
+		uint32 ChangedMask = VehicleBuildAllMask;
+		if (Reader.ReadBit())
+		{
+			Reader << CatalogFingerprint;
+		}
+		else
+		{
+			ChangedMask = Reader.ReadInt(MaskValueMax);
+		}
+
+		for (int32 Bit = 0; Bit <= VehicleBuildPaintBit; ++Bit)
+		{
+			if (ChangedMask & (1u << Bit))
+			{
+				uint32 PackedIndex = 0;
+				Reader.SerializeIntPacked(PackedIndex);
+				IndexForBit(Build, Bit) = static_cast<int32>(PackedIndex) - 1;
+			}
+		}
+
+		LastReceivedMask = ChangedMask;
+		++Stats.NumReads;
+
+		return !Reader.IsError();
+	}
+
+	return false;
+}
+
+FVehicleBuildNetStats& FVehicleBuildNetStats::Get()
+{
+	static FVehicleBuildNetStats Stats;
+	return Stats;
+}
+
+static FAutoConsoleCommand GVehicleBuildNetStatsCommand(
+	TEXT("TuneX.Net.BuildStats"),
+	TEXT("Prints replicated vehicle build bandwidth: average bytes per change and per full (late-join) state"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FVehicleBuildNetStats& Stats = FVehicleBuildNetStats::Get();
+		const double AvgDeltaBytes = Stats.NumDeltaWrites > 0 ? Stats.DeltaBits / 8.0 / Stats.NumDeltaWrites : 0.0;
+		const double AvgFullBytes = Stats.NumFullWrites > 0 ? Stats.FullBits / 8.0 / Stats.NumFullWrites : 0.0;
+
+		UE_LOG(LogTemp, Display, TEXT("VehicleBuildNet: %llu deltas (avg %.2f bytes, max %.2f), %llu full states (avg %.2f bytes, max %.2f), %llu reads, %llu fingerprint mismatches"),
+			Stats.NumDeltaWrites, AvgDeltaBytes, Stats.MaxDeltaBits / 8.0, Stats.NumFullWrites, AvgFullBytes, Stats.MaxFullBits / 8.0,
+			Stats.NumReads, Stats.NumFingerprintMismatches);
+	}));
+
+static FAutoConsoleCommand GVehicleBuildNetStatsResetCommand(
+	TEXT("TuneX.Net.ResetBuildStats"),
+	TEXT("Resets the replicated vehicle build bandwidth counters"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FVehicleBuildNetStats::Get() = FVehicleBuildNetStats();
+	}));
@@ -0,0 +1,168 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CarPartData.h"
+#include "Engine/NetSerialization.h"
+#include "VehicleBuild.generated.h"
+
+/** Bit used for the paint selection in FVehicleBuild change masks (part slots use bits 0..NumVehiclePartSlots-1) */
+static constexpr int32 VehicleBuildPaintBit = NumVehiclePartSlots;
+
+/** Change mask with every slot and the paint bit set */
+static constexpr uint32 VehicleBuildAllMask = (1u << (NumVehiclePartSlots + 1)) - 1;
+
+/**
+ * Compact description of a vehicle's configuration: one index per part slot plus the paint index
+ * Indices refer to the owning UVehicleConfigDataAsset; INDEX_NONE means nothing is selected
+ */
+USTRUCT(BlueprintType)
+struct TUNEX_API FVehicleBuild
+{
+	GENERATED_BODY()
+
+	// Selected part index per slot (indexed by EVehiclePartSlot)
+	UPROPERTY(EditAnywhere, Category = "Build")
+	int32 PartIndices[NumVehiclePartSlots];
+
+	// Selected paint index
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Build")
+	int32 PaintIndex;
+
+	FVehicleBuild()
+		: PaintIndex(INDEX_NONE)
+	{
+		for (int32& PartIndex : PartIndices)
+		{
+			PartIndex = INDEX_NONE;
+		}
+	}
+
+	int32 GetPartIndex(EVehiclePartSlot Slot) const
+	{
+		return PartIndices[static_cast<int32>(Slot)];
+	}
+
+	void SetPartIndex(EVehiclePartSlot Slot, int32 Index)
+	{
+		PartIndices[static_cast<int32>(Slot)] = Index;
+	}
+
+	/**
+	 * Gets the slots that differ from another build
+	 * @return Bit per part slot, plus VehicleBuildPaintBit for paint
+	 */
+	uint32 GetChangedMask(const FVehicleBuild& Other) const;
+
+	/**
+	 * Checks every selected index against a catalog
+	 * @return true if every index is INDEX_NONE or valid
+	 */
+	bool IsValidFor(const UVehicleConfigDataAsset& Config) const;
+
+	/**
+	 * Sums the price of every selected part and the paint
+	 * @param Config - The catalog the indices refer to
+	 */
+	float GetTotalPrice(const UVehicleConfigDataAsset& Config) const;
+
+	/**
+	 * Sums the baked mesh memory of every selected part, without loading anything
+	 * @param Config - The catalog the indices refer to
+	 * @param OutNumMissing - Receives the number of selected parts with no baked metadata (counted as 0)
+	 */
+	int64 GetEstimatedResourceSize(const UVehicleConfigDataAsset& Config, int32* OutNumMissing = nullptr) const;
+
+	/**
+	 * Gets a 64-bit hash of this build within a catalog layout
+	 * The bytes hashed are fixed (fingerprint, then every index, little-endian), so the value is the same on every
+	 * machine and across sessions; use it to key anything derived from the build.
+	 * @param CatalogFingerprint - UVehicleConfigDataAsset::GetCatalogFingerprint() of the catalog the indices refer to
+	 */
+	uint64 GetCanonicalHash(uint32 CatalogFingerprint) const;
+
+	/**
+	 * Builds the default selection of a catalog (Default*Index values, nothing elsewhere)
+	 */
+	static FVehicleBuild MakeDefault(const UVehicleConfigDataAsset& Config);
+
+	bool operator==(const FVehicleBuild& Other) const
+	{
+		return GetChangedMask(Other) == 0;
+	}
+
+	bool operator!=(const FVehicleBuild& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	friend uint32 GetTypeHash(const FVehicleBuild& Build)
+	{
+		uint32 Hash = ::GetTypeHash(Build.PaintIndex);
+		for (int32 PartIndex : Build.PartIndices)
+		{
+			Hash = HashCombine(Hash, ::GetTypeHash(PartIndex));
+		}
+		return Hash;
+	}
+};
+
+/**
+ * Replicated wrapper around FVehicleBuild
+ * Uses delta serialization against the last state sent to each connection: a change only costs a
+ * change mask plus a packed index for each changed slot. Full states (initial/late join) also carry
+ * the catalog fingerprint so clients can refuse indices from a different catalog.
+ */
+USTRUCT()
+struct TUNEX_API FReplicatedVehicleBuild
+{
+	GENERATED_BODY()
+
+	// The replicated selection
+	UPROPERTY()
+	FVehicleBuild Build;
+
+	// Fingerprint of the server's catalog, 0 until the server has published a build
+	UPROPERTY()
+	uint32 CatalogFingerprint = 0;
+
+	// Slots received in the most recent update (client only, not replicated)
+	uint32 LastReceivedMask = 0;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedVehicleBuild> : public TStructOpsTypeTraitsBase2<FReplicatedVehicleBuild>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Bandwidth counters for FReplicatedVehicleBuild (game thread only)
+ * Dump with the console command TuneX.Net.BuildStats, reset with TuneX.Net.ResetBuildStats
+ * Counters are per process: read the writes on the server (or listen host), where they cost bandwidth. To measure
+ * a late join, reset on the server, connect one more client and dump; every full state written is one vehicle.
+ */
+struct TUNEX_API FVehicleBuildNetStats
+{
+	// Delta updates written, their total size and the largest one
+	uint64 NumDeltaWrites = 0;
+	uint64 DeltaBits = 0;
+	uint64 MaxDeltaBits = 0;
+
+	// Full states written (initial replication / late join), their total size and the largest one
+	uint64 NumFullWrites = 0;
+	uint64 FullBits = 0;
+	uint64 MaxFullBits = 0;
+
+	// Updates received and rejected because of a catalog mismatch
+	uint64 NumReads = 0;
+	uint64 NumFingerprintMismatches = 0;
+
+	static FVehicleBuildNetStats& Get();
+};
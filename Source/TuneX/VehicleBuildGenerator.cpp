@@ -0,0 +1,409 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleBuildGenerator.h"
+#include "VehiclePopularity.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+namespace VehicleBuildGenerator
+{
+	// Builds generated per ParallelFor task
+	static constexpr int32 GenerationBatchSize = 256;
+
+	// Attempts at a build before falling back to the default
+	static constexpr int32 MaxAttempts = 8;
+
+	// Weight of an option exactly at the price tier; weights are integers so sampling is exact on every platform
+	static constexpr float WeightScale = 65536.0f;
+
+	// Share of WeightScale kept by options far outside the price spread, so a tier never empties a slot
+	static constexpr float MinPriceWeight = 1.0f / 256.0f;
+
+	// Keeps the sum of a large slot's weights far from overflowing
+	static constexpr uint32 MaxWeight = 1u << 24;
+
+	/** Hashes names by their lowercase text, which unlike FName indices is the same in every process */
+	static uint32 HashNames(const TArray<FName>& Names, uint32 Crc)
+	{
+		const int32 NumNames = Names.Num();
+		Crc = FCrc::MemCrc32(&NumNames, sizeof(NumNames), Crc);
+		for (const FName Name : Names)
+		{
+			Crc = FCrc::StrCrc32(*Name.ToString().ToLower(), Crc);
+		}
+		return Crc;
+	}
+
+	/** Hashes what the rules are compiled from: the chassis tag, then every part's fitment, requires and excludes */
+	static uint32 HashRules(const UVehicleConfigDataAsset& Config, uint32 Crc)
+	{
+		Crc = FCrc::StrCrc32(*Config.ChassisTag.ToString().ToLower(), Crc);
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			for (const FCarPart& Part : Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex)))
+			{
+				Crc = HashNames(Part.CompatibilityTags, Crc);
+				Crc = HashNames(Part.RequiresPartIDs, Crc);
+				Crc = HashNames(Part.ExcludesPartIDs, Crc);
+			}
+		}
+		return Crc;
+	}
+
+	/** SplitMix64 step: a fixed-width mix, identical everywhere */
+	static uint64 NextRandom(uint64& State)
+	{
+		State += 0x9E3779B97F4A7C15ull;
+		uint64 Value = State;
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+
+	/** Starts the stream of one build, independent of the builds around it */
+	static uint64 MakeBuildState(uint64 Seed, uint32 CatalogFingerprint, int32 BuildIndex)
+	{
+		uint64 State = Seed ^ (uint64(CatalogFingerprint) << 32);
+		State = NextRandom(State) ^ uint64(uint32(BuildIndex));
+		NextRandom(State);
+		return State;
+	}
+
+	/**
+	 * Draws an option in proportion to its weight
+	 * @param Mask - Options allowed, or nullptr for all of them
+	 * @return The option, or INDEX_NONE when none is allowed; allowed options that all weigh 0 are drawn evenly
+	 */
+	static int32 PickWeighted(TConstArrayView<uint32> Weights, const FVehicleSlotOptionMask* Mask, uint64& RandomState)
+	{
+		uint64 Total = 0;
+		int32 NumAllowed = 0;
+		for (int32 Option = 0; Option < Weights.Num(); ++Option)
+		{
+			if (!Mask || Mask->Get(Option))
+			{
+				Total += Weights[Option];
+				++NumAllowed;
+			}
+		}
+		if (NumAllowed == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const bool bEven = Total == 0;
+		uint64 Remaining = NextRandom(RandomState) % (bEven ? uint64(NumAllowed) : Total);
+		for (int32 Option = 0; Option < Weights.Num(); ++Option)
+		{
+			if (Mask && !Mask->Get(Option))
+			{
+				continue;
+			}
+			const uint64 Weight = bEven ? 1 : Weights[Option];
+			if (Remaining < Weight)
+			{
+				return Option;
+			}
+			Remaining -= Weight;
+		}
+		return INDEX_NONE;
+	}
+
+	/**
+	 * Computes the weight of every option of a slot
+	 * @param Prices - Price of each option
+	 * @param Tags - Compatibility tags of each option, or nullptr (paint)
+	 */
+	static void CompileWeights(TConstArrayView<float> Prices, TConstArrayView<const TArray<FName>*> Tags, const FVehicleBuildGeneratorSettings& Settings,
+		const FVehiclePopularityCounters* Popularity, int32 SlotBit, TArray<uint32>& OutWeights)
+	{
+		const int32 NumOptions = Prices.Num();
+		OutWeights.SetNumUninitialized(NumOptions);
+		if (NumOptions == 0)
+		{
+			return;
+		}
+
+		float MinPrice = Prices[0];
+		float MaxPrice = Prices[0];
+		for (const float Price : Prices)
+		{
+			MinPrice = FMath::Min(MinPrice, Price);
+			MaxPrice = FMath::Max(MaxPrice, Price);
+		}
+
+		uint32 MaxCount = 0;
+		if (Popularity)
+		{
+			for (int32 Option = 0; Option < NumOptions; ++Option)
+			{
+				MaxCount = FMath::Max(MaxCount, Popularity->GetCount(SlotBit, Option));
+			}
+		}
+
+		const float Tier = FMath::Clamp(Settings.PriceTier, 0.0f, 1.0f);
+		const float Spread = FMath::Clamp(Settings.PriceSpread, KINDA_SMALL_NUMBER, 1.0f);
+		for (int32 Option = 0; Option < NumOptions; ++Option)
+		{
+			// Triangle around the tier; a slot with a single price sits at the middle of its range
+			const float Normalized = MaxPrice > MinPrice ? (Prices[Option] - MinPrice) / (MaxPrice - MinPrice) : 0.5f;
+			float Weight = FMath::Max(MinPriceWeight, 1.0f - FMath::Abs(Normalized - Tier) / Spread);
+
+			if (Tags.IsValidIndex(Option) && Tags[Option])
+			{
+				for (const FName& Tag : Settings.PreferredTags)
+				{
+					if (Tags[Option]->Contains(Tag))
+					{
+						Weight *= FMath::Max(0.0f, Settings.PreferredTagWeight);
+						break;
+					}
+				}
+			}
+
+			if (MaxCount > 0)
+			{
+				Weight *= 1.0f + Settings.PopularityWeight * float(Popularity->GetCount(SlotBit, Option)) / float(MaxCount);
+			}
+
+			OutWeights[Option] = uint32(FMath::Clamp<float>(FMath::RoundToFloat(Weight * WeightScale), 0.0f, float(MaxWeight)));
+		}
+	}
+}
+
+TSharedRef<const FVehicleBuildGenerator, ESPMode::ThreadSafe> FVehicleBuildGenerator::Compile(const UVehicleConfigDataAsset& Config, const FVehicleBuildGeneratorSettings& Settings)
+{
+	using namespace VehicleBuildGenerator;
+	check(IsInGameThread());
+
+	TSharedRef<FVehicleBuildGenerator, ESPMode::ThreadSafe> Result = MakeShared<FVehicleBuildGenerator, ESPMode::ThreadSafe>();
+	FVehicleBuildGenerator& Generator = *Result;
+
+	UVehiclePartConstraintSubsystem* ConstraintSubsystem = UVehiclePartConstraintSubsystem::Get();
+	Generator.Constraints = ConstraintSubsystem ? ConstraintSubsystem->GetConstraints(Config) : FVehiclePartConstraints::Compile(Config);
+
+	TSharedPtr<FVehiclePopularityCounters, ESPMode::ThreadSafe> Popularity;
+	if (Settings.PopularityWeight > 0.0f)
+	{
+		if (UVehiclePopularitySubsystem* PopularitySubsystem = UVehiclePopularitySubsystem::Get())
+		{
+			Popularity = PopularitySubsystem->GetCounters(Config);
+		}
+	}
+
+	TArray<float> Prices;
+	TArray<const TArray<FName>*> Tags;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		Prices.Reset();
+		Tags.Reset();
+		for (const FCarPart& Part : Parts)
+		{
+			Prices.Add(Part.Price);
+			Tags.Add(&Part.CompatibilityTags);
+		}
+		CompileWeights(Prices, Tags, Settings, Popularity.Get(), SlotIndex, Generator.Weights[SlotIndex]);
+	}
+
+	Prices.Reset();
+	for (const FPaintColor& Paint : Config.PaintColors)
+	{
+		Prices.Add(Paint.Price);
+	}
+	CompileWeights(Prices, {}, Settings, Popularity.Get(), VehicleBuildPaintBit, Generator.Weights[VehicleBuildPaintBit]);
+
+	Generator.EmptySlotThreshold = uint32(FMath::Clamp(Settings.EmptySlotChance, 0.0f, 1.0f) * 65536.0f);
+	Generator.bPickPaint = Settings.bPickPaint;
+
+	Generator.FallbackBuild = FVehicleBuild::MakeDefault(Config);
+	if (!Generator.Constraints->Validate(Generator.FallbackBuild).IsValid())
+	{
+		Generator.FallbackBuild = FVehicleBuild();
+	}
+
+	Generator.CatalogFingerprint = Config.GetCatalogFingerprint();
+	Generator.ContentRevision = Config.GetContentRevision();
+
+	// Lets a replay tell when the same seed would no longer give the same builds; the catalog fingerprint only
+	// covers IDs, so the rules that narrow each pick are hashed too
+	uint32 Crc = VehicleBuildGenerator::HashRules(Config, Generator.CatalogFingerprint);
+	for (const TArray<uint32>& SlotWeights : Generator.Weights)
+	{
+		const int32 NumOptions = SlotWeights.Num();
+		Crc = FCrc::MemCrc32(&NumOptions, sizeof(NumOptions), Crc);
+		Crc = FCrc::MemCrc32(SlotWeights.GetData(), SlotWeights.Num() * sizeof(uint32), Crc);
+	}
+	const uint32 Flags = Generator.EmptySlotThreshold | (Generator.bPickPaint ? 1u << 31 : 0u);
+	Generator.Fingerprint = FCrc::MemCrc32(&Flags, sizeof(Flags), Crc);
+
+	return Result;
+}
+
+bool FVehicleBuildGenerator::GenerateBuild(uint64 Seed, int32 BuildIndex, FVehicleBuild& OutBuild) const
+{
+	uint64 RandomState = VehicleBuildGenerator::MakeBuildState(Seed, CatalogFingerprint, BuildIndex);
+	FVehicleSlotOptionMask Mask;
+	FVehicleSlotOptionMask PairMask;
+	for (int32 Attempt = 0; Attempt < VehicleBuildGenerator::MaxAttempts; ++Attempt)
+	{
+		if (TryGenerateBuild(RandomState, OutBuild, Mask, PairMask))
+		{
+			return true;
+		}
+	}
+
+	OutBuild = FallbackBuild;
+	return false;
+}
+
+bool FVehicleBuildGenerator::TryGenerateBuild(uint64& RandomState, FVehicleBuild& OutBuild, FVehicleSlotOptionMask& Mask, FVehicleSlotOptionMask& PairMask) const
+{
+	using namespace VehicleBuildGenerator;
+
+	OutBuild = FVehicleBuild();
+
+	// A shuffled order keeps parts with requirements from being starved in the first slots picked
+	int32 Order[NumVehiclePartSlots];
+	for (int32 Position = 0; Position < NumVehiclePartSlots; ++Position)
+	{
+		Order[Position] = Position;
+	}
+	for (int32 Position = NumVehiclePartSlots - 1; Position > 0; --Position)
+	{
+		Swap(Order[Position], Order[NextRandom(RandomState) % uint64(Position + 1)]);
+	}
+
+	uint32 PickedSlots = 0;
+	uint32 RequiredSlots = 0;
+	for (const int32 SlotIndex : Order)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		const uint32 SlotBit = 1u << SlotIndex;
+
+		// Only slots picked so far narrow this one (an empty pick rules out options needing that slot)
+		Mask = Constraints->GetFittingOptions(Slot);
+		if (Constraints->HasPairRules())
+		{
+			for (uint32 Picked = PickedSlots; Picked != 0; Picked &= Picked - 1)
+			{
+				const int32 OtherSlotIndex = FMath::CountTrailingZeros(Picked);
+				Constraints->GetCompatibleOptions(static_cast<EVehiclePartSlot>(OtherSlotIndex), OutBuild.PartIndices[OtherSlotIndex], Slot, PairMask);
+				Mask.AndWith(PairMask);
+			}
+		}
+		PickedSlots |= SlotBit;
+
+		const bool bRequired = (RequiredSlots & SlotBit) != 0;
+		if (!bRequired && EmptySlotThreshold > 0 && (NextRandom(RandomState) & 0xFFFF) < EmptySlotThreshold)
+		{
+			continue;
+		}
+
+		const int32 Part = PickWeighted(Weights[SlotIndex], &Mask, RandomState);
+		if (Part == INDEX_NONE)
+		{
+			if (bRequired)
+			{
+				return false;
+			}
+			continue;
+		}
+
+		OutBuild.PartIndices[SlotIndex] = Part;
+		if (Constraints->HasPairRules())
+		{
+			for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+			{
+				if (Constraints->RequiresSlot(Slot, Part, static_cast<EVehiclePartSlot>(OtherSlotIndex)))
+				{
+					RequiredSlots |= 1u << OtherSlotIndex;
+				}
+			}
+		}
+	}
+
+	if (bPickPaint)
+	{
+		OutBuild.PaintIndex = PickWeighted(Weights[VehicleBuildPaintBit], nullptr, RandomState);
+	}
+
+	checkSlow(Constraints->Validate(OutBuild).IsValid());
+	return true;
+}
+
+int32 FVehicleBuildGenerator::GenerateBuilds(uint64 Seed, int32 FirstBuildIndex, TArrayView<FVehicleBuild> OutBuilds) const
+{
+	using namespace VehicleBuildGenerator;
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(OutBuilds.Num(), GenerationBatchSize);
+	TArray<int32> BatchFallbacks;
+	BatchFallbacks.SetNumZeroed(NumBatches);
+	ParallelFor(TEXT("VehicleBuildGenerator"), NumBatches, 1, [this, Seed, FirstBuildIndex, OutBuilds, &BatchFallbacks](int32 BatchIndex)
+	{
+		const int32 Begin = BatchIndex * GenerationBatchSize;
+		const int32 End = FMath::Min(Begin + GenerationBatchSize, OutBuilds.Num());
+		for (int32 BuildIndex = Begin; BuildIndex < End; ++BuildIndex)
+		{
+			if (!GenerateBuild(Seed, FirstBuildIndex + BuildIndex, OutBuilds[BuildIndex]))
+			{
+				++BatchFallbacks[BatchIndex];
+			}
+		}
+	});
+
+	int32 NumFallbacks = 0;
+	for (const int32 Fallbacks : BatchFallbacks)
+	{
+		NumFallbacks += Fallbacks;
+	}
+	return NumFallbacks;
+}
+
+static FAutoConsoleCommand GVehicleBuildGeneratorBenchmarkCommand(
+	TEXT("TuneX.Generator.Benchmark"),
+	TEXT("Generates builds of a catalog, then checks them against its rules and regenerates them to confirm they repeat. Usage: TuneX.Generator.Benchmark CatalogPath [NumBuilds=100000] [Seed=1]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleBuildGenerator: Usage: TuneX.Generator.Benchmark CatalogPath [NumBuilds] [Seed]"));
+			return;
+		}
+
+		UVehicleConfigDataAsset* Config = LoadObject<UVehicleConfigDataAsset>(nullptr, *Args[0], nullptr, LOAD_NoWarn);
+		if (!Config)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleBuildGenerator: No catalog at '%s'"), *Args[0]);
+			return;
+		}
+		const int32 NumBuilds = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 100000;
+		const uint64 Seed = Args.Num() > 2 ? FCString::Strtoui64(*Args[2], nullptr, 10) : 1;
+
+		double StartTime = FPlatformTime::Seconds();
+		const FVehicleBuildGeneratorRef Generator = FVehicleBuildGenerator::Compile(*Config, FVehicleBuildGeneratorSettings());
+		const double CompileMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		TArray<FVehicleBuild> Builds;
+		Builds.SetNum(NumBuilds);
+		StartTime = FPlatformTime::Seconds();
+		const int32 NumFallbacks = Generator->GenerateBuilds(Seed, 0, Builds);
+		const double GenerateSeconds = FPlatformTime::Seconds() - StartTime;
+
+		TArray<FVehicleConstraintResult> Results;
+		const int32 NumInvalid = Generator->GetConstraints()->ValidateBuilds(Builds, Results);
+
+		// Regenerate a different split of the same sequence
+		TArray<FVehicleBuild> Repeated;
+		Repeated.SetNum(NumBuilds);
+		const int32 Half = NumBuilds / 2;
+		Generator->GenerateBuilds(Seed, Half, MakeArrayView(Repeated).Mid(Half));
+		Generator->GenerateBuilds(Seed, 0, MakeArrayView(Repeated).Left(Half));
+		const bool bRepeats = Repeated == Builds;
+
+		TSet<FVehicleBuild> Distinct(Builds);
+
+		UE_LOG(LogTemp, Display, TEXT("VehicleBuildGenerator: '%s' (fingerprint %08x) compiled in %.2f ms; %d builds in %.2f ms (%.0f builds/s), %d distinct, %d fallbacks, %d invalid, %s"),
+			*Config->GetName(), Generator->GetFingerprint(), CompileMs, NumBuilds, GenerateSeconds * 1000.0, NumBuilds / FMath::Max(GenerateSeconds, SMALL_NUMBER),
+			Distinct.Num(), NumFallbacks, NumInvalid, bRepeats ? TEXT("repeatable") : TEXT("NOT repeatable"));
+	}));
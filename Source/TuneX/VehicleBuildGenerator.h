@@ -0,0 +1,122 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VehicleBuild.h"
+#include "VehiclePartConstraints.h"
+#include "VehicleBuildGenerator.generated.h"
+
+/**
+ * How a build generator weighs the options of each slot
+ */
+USTRUCT(BlueprintType)
+struct FVehicleBuildGeneratorSettings
+{
+	GENERATED_BODY()
+
+	// Where picks land in each slot's price range: 0 the cheapest option, 1 the most expensive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0", ClampMax = "1"))
+	float PriceTier = 0.5f;
+
+	// How far from PriceTier (same 0..1 range) options are still likely; options further out stay possible but rare
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0", ClampMax = "1"))
+	float PriceSpread = 0.5f;
+
+	// Compatibility tags to favour (e.g. a style or a brand)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator")
+	TArray<FName> PreferredTags;
+
+	// Weight multiplier of options carrying any of PreferredTags; below 1 makes them rarer instead
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0"))
+	float PreferredTagWeight = 4.0f;
+
+	// How much players' picks favour an option: the most picked option of a slot weighs 1 + PopularityWeight times more.
+	// Counts are sampled when the generator is compiled, so with a non-zero value results also depend on that snapshot.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0"))
+	float PopularityWeight = 0.0f;
+
+	// Chance of leaving a slot empty when no other pick requires it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator", meta = (ClampMin = "0", ClampMax = "1"))
+	float EmptySlotChance = 0.0f;
+
+	// Whether builds get a paint
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Generator")
+	bool bPickPaint = true;
+};
+
+/**
+ * Generates random but plausible builds of one catalog, for AI opponents and traffic
+ * Each option gets an integer weight when the generator is compiled; a build then picks its slots in a shuffled
+ * order, each among the options the compiled rules still allow given the slots picked so far, so every build
+ * fits the chassis and meets requires/excludes without touching the catalog, actors or assets.
+ *
+ * Build N of seed S is a pure function of (S, N), the catalog (identified by its fingerprint) and the settings:
+ * sampling uses integer weights and a fixed-width counter-based generator, so it is the same on every machine,
+ * in any batch split and on any number of threads. Store the seed, the build index and GetFingerprint() to replay.
+ * Compile on the game thread; generating is thread-safe.
+ *
+ * Benchmark: TuneX.Generator.Benchmark CatalogPath [NumBuilds] [Seed]
+ */
+class TUNEX_API FVehicleBuildGenerator
+{
+public:
+	/**
+	 * Compiles the weights of a catalog (game thread)
+	 */
+	static TSharedRef<const FVehicleBuildGenerator, ESPMode::ThreadSafe> Compile(const UVehicleConfigDataAsset& Config, const FVehicleBuildGeneratorSettings& Settings);
+
+	/**
+	 * Generates one build
+	 * @param Seed - Sequence to draw from
+	 * @param BuildIndex - Position in the sequence
+	 * @param OutBuild - Receives the build
+	 * @return false if the rules left no way to complete the build, in which case OutBuild is the catalog default
+	 *         (or an empty build when the default breaks the rules)
+	 */
+	bool GenerateBuild(uint64 Seed, int32 BuildIndex, FVehicleBuild& OutBuild) const;
+
+	/**
+	 * Generates consecutive builds of a sequence in parallel
+	 * @param FirstBuildIndex - Index of OutBuilds[0] in the sequence
+	 * @return Number of builds that fell back to the default
+	 */
+	int32 GenerateBuilds(uint64 Seed, int32 FirstBuildIndex, TArrayView<FVehicleBuild> OutBuilds) const;
+
+	/**
+	 * Checks whether the generator still matches a catalog's content
+	 */
+	bool IsUpToDate(const UVehicleConfigDataAsset& Config) const { return ContentRevision == Config.GetContentRevision(); }
+
+	// Fingerprint of the catalog the indices refer to
+	uint32 GetCatalogFingerprint() const { return CatalogFingerprint; }
+
+	// Catalog fingerprint combined with its rules and the compiled weights; equal values generate equal sequences
+	uint32 GetFingerprint() const { return Fingerprint; }
+
+	const FVehiclePartConstraintsPtr& GetConstraints() const { return Constraints; }
+
+private:
+	/**
+	 * Makes one attempt at a build; fails when a required slot has no option left
+	 */
+	bool TryGenerateBuild(uint64& RandomState, FVehicleBuild& OutBuild, FVehicleSlotOptionMask& Mask, FVehicleSlotOptionMask& PairMask) const;
+
+	FVehiclePartConstraintsPtr Constraints;
+
+	// Weight of each option, indexed by slot bit (parts, then VehicleBuildPaintBit)
+	TArray<uint32> Weights[NumVehiclePartSlots + 1];
+
+	// EmptySlotChance out of 65536
+	uint32 EmptySlotThreshold = 0;
+	bool bPickPaint = true;
+
+	// Returned when a build cannot be completed
+	FVehicleBuild FallbackBuild;
+
+	uint32 CatalogFingerprint = 0;
+	uint32 Fingerprint = 0;
+	uint32 ContentRevision = 0;
+};
+
+using FVehicleBuildGeneratorRef = TSharedRef<const FVehicleBuildGenerator, ESPMode::ThreadSafe>;
@@ -0,0 +1,73 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleBuildSnapshot.h"
+#include <type_traits>
+
+// Readers copy the buffer bytewise while the writer may be lapping them; the sequence check discards torn copies
+static_assert(std::is_trivially_copyable_v<FVehicleBuildSnapshot>, "FVehicleBuildSnapshot must stay plain data");
+
+void FVehicleSnapshotChannel::Publish(const FVehicleBuildSnapshot& Snapshot)
+{
+	check(IsInGameThread());
+
+	const uint64 NewVersion = Version.load(std::memory_order_relaxed) + 1;
+	FBuffer& Buffer = Buffers[NewVersion & 1];
+
+	const uint32 Sequence = Buffer.Sequence.load(std::memory_order_relaxed);
+	Buffer.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	FMemory::Memcpy(&Buffer.Snapshot, &Snapshot, sizeof(FVehicleBuildSnapshot));
+	Buffer.Snapshot.Version = NewVersion;
+
+	Buffer.Sequence.store(Sequence + 2, std::memory_order_release);
+	Version.store(NewVersion, std::memory_order_release);
+
+	VersionChanged.Notify();
+}
+
+FVehicleBuildSnapshot FVehicleSnapshotChannel::Read() const
+{
+	FVehicleBuildSnapshot Result;
+	for (;;)
+	{
+		const FBuffer& Buffer = Buffers[Version.load(std::memory_order_acquire) & 1];
+
+		const uint32 SequenceBefore = Buffer.Sequence.load(std::memory_order_acquire);
+		if (SequenceBefore & 1)
+		{
+			// Only possible when the writer published twice during this read; take the newer buffer
+			FPlatformProcess::YieldThread();
+			continue;
+		}
+
+		FMemory::Memcpy(&Result, &Buffer.Snapshot, sizeof(FVehicleBuildSnapshot));
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (Buffer.Sequence.load(std::memory_order_relaxed) == SequenceBefore)
+		{
+			return Result;
+		}
+	}
+}
+
+bool FVehicleSnapshotChannel::WaitForNewerVersion(uint64 KnownVersion, uint32 TimeoutMs, FVehicleBuildSnapshot& OutSnapshot) const
+{
+	const FMonotonicTimePoint Deadline = FMonotonicTimePoint::Now() + FMonotonicTimeSpan::FromMilliseconds(TimeoutMs);
+	for (;;)
+	{
+		// Prepare before checking, so a publish between the check and the wait still wakes us
+		const UE::FEventCountToken Token = VersionChanged.PrepareWait();
+		if (GetVersion() > KnownVersion)
+		{
+			OutSnapshot = Read();
+			return true;
+		}
+
+		const FMonotonicTimeSpan Remaining = Deadline - FMonotonicTimePoint::Now();
+		if (Remaining <= FMonotonicTimeSpan::Zero() || !VersionChanged.WaitFor(Token, Remaining))
+		{
+			return false;
+		}
+	}
+}
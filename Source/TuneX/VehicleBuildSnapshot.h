@@ -0,0 +1,85 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/EventCount.h"
+#include "VehicleBuild.h"
+#include <atomic>
+
+/**
+ * Immutable copy of a vehicle's configuration and derived figures
+ * Plain data only (no UObject pointers), so it can be read and kept on any thread.
+ */
+struct FVehicleBuildSnapshot
+{
+	// Increases by one per publish; 0 until the vehicle publishes for the first time
+	uint64 Version = 0;
+
+	FVehicleBuild Build;
+
+	// IDs of the selected parts (indexed by EVehiclePartSlot) and paint, NAME_None when empty
+	FName PartIDs[NumVehiclePartSlots];
+	FName PaintID;
+
+	FVehiclePerformanceStats Stats;
+	float TotalPrice = 0.0f;
+
+	// Catalog the indices refer to (UVehicleConfigDataAsset::GetCatalogFingerprint())
+	uint32 CatalogFingerprint = 0;
+};
+
+/**
+ * Single-writer, multi-reader publication of a vehicle's FVehicleBuildSnapshot
+ * The game thread publishes into the back buffer of a double buffer and flips the version; readers on any
+ * thread copy the front buffer without locks and retry in the rare case the writer lapped them (seqlock).
+ * Readers can also block until a newer version than the one they hold is published.
+ *
+ * Owned through a thread-safe shared reference, so workers keep reading after the vehicle is destroyed.
+ */
+class TUNEX_API FVehicleSnapshotChannel
+{
+public:
+	/**
+	 * Publishes a new snapshot; its Version is assigned here
+	 * Game thread only (one writer).
+	 */
+	void Publish(const FVehicleBuildSnapshot& Snapshot);
+
+	/**
+	 * Copies the latest snapshot; lock-free, any thread
+	 */
+	FVehicleBuildSnapshot Read() const;
+
+	/**
+	 * Gets the latest published version without copying the snapshot
+	 */
+	uint64 GetVersion() const { return Version.load(std::memory_order_acquire); }
+
+	/**
+	 * Blocks until a version newer than KnownVersion is published
+	 * @param KnownVersion - Version the caller already has
+	 * @param TimeoutMs - Maximum wait; 0 returns immediately
+	 * @param OutSnapshot - The newer snapshot, when one arrived
+	 * @return false on timeout
+	 */
+	bool WaitForNewerVersion(uint64 KnownVersion, uint32 TimeoutMs, FVehicleBuildSnapshot& OutSnapshot) const;
+
+private:
+	struct FBuffer
+	{
+		// Odd while the writer is filling Snapshot
+		std::atomic<uint32> Sequence{ 0 };
+		FVehicleBuildSnapshot Snapshot;
+	};
+
+	FBuffer Buffers[2];
+
+	// Latest version; its buffer is Buffers[Version & 1]
+	std::atomic<uint64> Version{ 0 };
+
+	mutable UE::FEventCount VersionChanged;
+};
+
+using FVehicleSnapshotChannelRef = TSharedRef<FVehicleSnapshotChannel, ESPMode::ThreadSafe>;
+using FVehicleSnapshotChannelPtr = TSharedPtr<FVehicleSnapshotChannel, ESPMode::ThreadSafe>;
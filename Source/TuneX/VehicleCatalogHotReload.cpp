@@ -0,0 +1,106 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleCatalogHotReload.h"
+#include "CarPartData.h"
+#include "VehicleDerivedDataCache.h"
+#include "VehicleMasterComponent.h"
+#include "VehicleMeshMerger.h"
+#include "Engine/Engine.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
+
+void UVehicleCatalogHotReloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ContentEditedHandle = UVehicleConfigDataAsset::OnContentEdited.AddUObject(this, &UVehicleCatalogHotReloadSubsystem::OnCatalogEdited);
+
+#if WITH_EDITOR
+	PackageReloadedHandle = FCoreUObjectDelegates::OnPackageReloaded.AddUObject(this, &UVehicleCatalogHotReloadSubsystem::OnPackageReloaded);
+#endif
+}
+
+void UVehicleCatalogHotReloadSubsystem::Deinitialize()
+{
+	UVehicleConfigDataAsset::OnContentEdited.Remove(ContentEditedHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnPackageReloaded.Remove(PackageReloadedHandle);
+	ReloadedCatalogs.Empty();
+#endif
+
+	Super::Deinitialize();
+}
+
+UVehicleCatalogHotReloadSubsystem* UVehicleCatalogHotReloadSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UVehicleCatalogHotReloadSubsystem>() : nullptr;
+}
+
+void UVehicleCatalogHotReloadSubsystem::OnCatalogEdited(UVehicleConfigDataAsset& Catalog, const FVehicleCatalogChange& Change)
+{
+	FVehicleDerivedDataCache::Get().InvalidateCatalog(Catalog);
+
+	// Merged meshes are keyed by part indices, which still match after an edit in place
+	bool bPartsChanged = false;
+	for (const TBitArray<>& ChangedParts : Change.ChangedParts)
+	{
+		bPartsChanged |= ChangedParts.Contains(true);
+	}
+	if (bPartsChanged)
+	{
+		FVehicleMergedMeshCache::Get().Reset();
+	}
+
+	int32 NumVehicles = 0;
+	int32 NumAffected = 0;
+	for (TObjectIterator<UVehicleMasterComponent> It; It; ++It)
+	{
+		if (It->VehicleConfig != &Catalog || It->IsTemplate() || !It->HasBegunPlay())
+		{
+			continue;
+		}
+
+		++NumVehicles;
+		if (It->NotifyCatalogEdited(Change))
+		{
+			++NumAffected;
+		}
+	}
+	NumVehiclesReapplied += NumAffected;
+
+	UE_LOG(LogTemp, Log, TEXT("VehicleCatalogHotReload: '%s' changed %d entries%s; %d of %d vehicles re-applied"),
+		*Catalog.GetName(), Change.GetNumChangedEntries(), Change.bCatalogWide ? TEXT(" and catalog-wide settings") : TEXT(""),
+		NumAffected, NumVehicles);
+}
+
+#if WITH_EDITOR
+void UVehicleCatalogHotReloadSubsystem::OnPackageReloaded(EPackageReloadPhase Phase, FPackageReloadedEvent* Event)
+{
+	if (Phase == EPackageReloadPhase::PrePackageFixup && Event)
+	{
+		// Both objects are alive here; vehicles are repointed to the new one during fixup
+		for (const TPair<UObject*, UObject*>& Repointed : Event->GetRepointedObjects())
+		{
+			UVehicleConfigDataAsset* OldCatalog = Cast<UVehicleConfigDataAsset>(Repointed.Key);
+			UVehicleConfigDataAsset* NewCatalog = Cast<UVehicleConfigDataAsset>(Repointed.Value);
+			if (OldCatalog && NewCatalog && !OldCatalog->IsTemplate())
+			{
+				NewCatalog->AdoptEditBaseline(*OldCatalog);
+				ReloadedCatalogs.Add(NewCatalog);
+			}
+		}
+	}
+	else if (Phase == EPackageReloadPhase::PostBatchPreGC)
+	{
+		TArray<TWeakObjectPtr<UVehicleConfigDataAsset>> Catalogs = MoveTemp(ReloadedCatalogs);
+		for (const TWeakObjectPtr<UVehicleConfigDataAsset>& WeakCatalog : Catalogs)
+		{
+			if (UVehicleConfigDataAsset* Catalog = WeakCatalog.Get())
+			{
+				Catalog->PostContentEdit();
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,56 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/PackageReload.h"
+#include "VehicleCatalogHotReload.generated.h"
+
+class UVehicleConfigDataAsset;
+struct FVehicleCatalogChange;
+
+/**
+ * Pushes catalog edits made while playing (editor details panel, undo, package reload, live tuning) to the
+ * vehicles showing them, instead of requiring a restart
+ * Edits arrive through UVehicleConfigDataAsset::OnContentEdited with the changed entries. Derived data of the
+ * catalog is dropped, then only the vehicles using a changed entry (or all of them, if the base stats, chassis
+ * tag or defaults changed) re-apply the affected slots through ApplyBuildAsync.
+ * Rules recompile on the game thread the first time a vehicle asks: a worker compile could read the catalog
+ * while the next edit of an interactive drag is being made.
+ */
+UCLASS()
+class TUNEX_API UVehicleCatalogHotReloadSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the subsystem
+	 * @return The subsystem, or nullptr before the engine is up
+	 */
+	static UVehicleCatalogHotReloadSubsystem* Get();
+
+	/**
+	 * Gets the number of vehicles that re-applied slots after an edit, since startup
+	 */
+	int32 GetNumVehiclesReapplied() const { return NumVehiclesReapplied; }
+
+private:
+	void OnCatalogEdited(UVehicleConfigDataAsset& Catalog, const FVehicleCatalogChange& Change);
+
+#if WITH_EDITOR
+	void OnPackageReloaded(EPackageReloadPhase Phase, FPackageReloadedEvent* Event);
+
+	// Catalogs replaced by the reload in progress, diffed once every package is fixed up
+	TArray<TWeakObjectPtr<UVehicleConfigDataAsset>> ReloadedCatalogs;
+#endif
+
+	int32 NumVehiclesReapplied = 0;
+
+	FDelegateHandle ContentEditedHandle;
+	FDelegateHandle PackageReloadedHandle;
+};
@@ -0,0 +1,187 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleCatalogManifest.h"
+
+const FName FVehicleCatalogManifest::AssetRegistryTagName(TEXT("TuneXCatalog"));
+
+namespace VehicleCatalogManifest
+{
+	// Record layout (one record per line, fields separated by '|'):
+	//   V|<FormatVersion>
+	//   D|<DefaultFrontBumperIndex>|<DefaultRearBumperIndex>|<DefaultPaintIndex>
+	//   P|<Slot>|<PartID>|<MeshAsset>|<Tag,Tag,...>|<NumMaterials>;<Material>;...|<SoundModifier>|<MetadataHash>
+	//   C|<PaintID>|<Material>
+
+	static FString NameToField(FName Name)
+	{
+		return Name.IsNone() ? FString() : Name.ToString();
+	}
+
+	static FName FieldToName(const FString& Field)
+	{
+		return Field.IsEmpty() ? NAME_None : FName(*Field);
+	}
+
+	static FVehicleCatalogManifestEntry MakePartEntry(const FCarPart& Part)
+	{
+		FVehicleCatalogManifestEntry Entry;
+		Entry.ID = Part.PartID;
+		Entry.Asset = Part.MeshAsset.ToSoftObjectPath();
+		Entry.CompatibilityTags = Part.CompatibilityTags;
+		Entry.SoundModifier = Part.SoundModifier.ToSoftObjectPath();
+		if (Part.Metadata.IsBakedFor(Part.MeshAsset))
+		{
+			Entry.MetadataHash = Part.Metadata.SourcePackageHash;
+		}
+
+		Entry.MaterialOverrides.Reserve(Part.MaterialOverrides.Num());
+		for (const TSoftObjectPtr<UMaterialInterface>& Material : Part.MaterialOverrides)
+		{
+			Entry.MaterialOverrides.Add(Material.ToSoftObjectPath());
+		}
+		return Entry;
+	}
+}
+
+FVehicleCatalogManifest FVehicleCatalogManifest::FromConfig(const UVehicleConfigDataAsset& Config)
+{
+	FVehicleCatalogManifest Manifest;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& SlotParts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		Manifest.Parts[SlotIndex].Reserve(SlotParts.Num());
+		for (const FCarPart& Part : SlotParts)
+		{
+			Manifest.Parts[SlotIndex].Add(VehicleCatalogManifest::MakePartEntry(Part));
+		}
+	}
+
+	Manifest.Paints.Reserve(Config.PaintColors.Num());
+	for (const FPaintColor& Paint : Config.PaintColors)
+	{
+		FVehicleCatalogManifestEntry& Entry = Manifest.Paints.AddDefaulted_GetRef();
+		Entry.ID = Paint.PaintID;
+		Entry.Asset = Paint.Material.ToSoftObjectPath();
+	}
+
+	Manifest.DefaultFrontBumperIndex = Config.DefaultFrontBumperIndex;
+	Manifest.DefaultRearBumperIndex = Config.DefaultRearBumperIndex;
+	Manifest.DefaultPaintIndex = Config.DefaultPaintIndex;
+
+	return Manifest;
+}
+
+FString FVehicleCatalogManifest::Encode() const
+{
+	using namespace VehicleCatalogManifest;
+
+	TStringBuilder<4096> Builder;
+	Builder.Appendf(TEXT("V|%d\n"), FormatVersion);
+	Builder.Appendf(TEXT("D|%d|%d|%d\n"), DefaultFrontBumperIndex, DefaultRearBumperIndex, DefaultPaintIndex);
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		for (const FVehicleCatalogManifestEntry& Entry : Parts[SlotIndex])
+		{
+			Builder.Appendf(TEXT("P|%d|%s|%s|"), SlotIndex, *NameToField(Entry.ID), *Entry.Asset.ToString());
+
+			for (int32 TagIndex = 0; TagIndex < Entry.CompatibilityTags.Num(); ++TagIndex)
+			{
+				Builder << (TagIndex > 0 ? TEXT(",") : TEXT("")) << NameToField(Entry.CompatibilityTags[TagIndex]);
+			}
+			Builder.Appendf(TEXT("|%d"), Entry.MaterialOverrides.Num());
+
+			for (const FSoftObjectPath& Material : Entry.MaterialOverrides)
+			{
+				Builder << TEXT(";") << Material.ToString();
+			}
+			Builder << TEXT("|") << Entry.SoundModifier.ToString() << TEXT("|") << Entry.MetadataHash << TEXT("\n");
+		}
+	}
+
+	for (const FVehicleCatalogManifestEntry& Entry : Paints)
+	{
+		Builder.Appendf(TEXT("C|%s|%s\n"), *NameToField(Entry.ID), *Entry.Asset.ToString());
+	}
+
+	return FString(Builder.ToView());
+}
+
+bool FVehicleCatalogManifest::Decode(const FString& Encoded, FVehicleCatalogManifest& OutManifest)
+{
+	using namespace VehicleCatalogManifest;
+
+	OutManifest = FVehicleCatalogManifest();
+
+	TArray<FString> Lines;
+	Encoded.ParseIntoArray(Lines, TEXT("\n"), /*InCullEmpty*/ true);
+	if (Lines.Num() == 0 || Lines[0] != FString::Printf(TEXT("V|%d"), FormatVersion))
+	{
+		return false;
+	}
+
+	TArray<FString> Fields;
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		Fields.Reset();
+		Lines[LineIndex].ParseIntoArray(Fields, TEXT("|"), /*InCullEmpty*/ false);
+		if (Fields.Num() == 0)
+		{
+			return false;
+		}
+
+		if (Fields[0] == TEXT("D") && Fields.Num() == 4)
+		{
+			OutManifest.DefaultFrontBumperIndex = FCString::Atoi(*Fields[1]);
+			OutManifest.DefaultRearBumperIndex = FCString::Atoi(*Fields[2]);
+			OutManifest.DefaultPaintIndex = FCString::Atoi(*Fields[3]);
+		}
+		else if (Fields[0] == TEXT("P") && Fields.Num() == 8)
+		{
+			const int32 SlotIndex = FCString::Atoi(*Fields[1]);
+			if (SlotIndex < 0 || SlotIndex >= NumVehiclePartSlots)
+			{
+				return false;
+			}
+
+			FVehicleCatalogManifestEntry& Entry = OutManifest.Parts[SlotIndex].AddDefaulted_GetRef();
+			Entry.ID = FieldToName(Fields[2]);
+			Entry.Asset = FSoftObjectPath(Fields[3]);
+			Entry.SoundModifier = FSoftObjectPath(Fields[6]);
+			Entry.MetadataHash = Fields[7];
+
+			TArray<FString> SubFields;
+			Fields[4].ParseIntoArray(SubFields, TEXT(","), /*InCullEmpty*/ true);
+			for (const FString& Tag : SubFields)
+			{
+				Entry.CompatibilityTags.Add(FName(*Tag));
+			}
+
+			// Empty override entries are meaningful (they keep the mesh's own material), hence the explicit count
+			SubFields.Reset();
+			Fields[5].ParseIntoArray(SubFields, TEXT(";"), /*InCullEmpty*/ false);
+			const int32 NumMaterials = SubFields.Num() > 0 ? FCString::Atoi(*SubFields[0]) : 0;
+			if (NumMaterials != SubFields.Num() - 1)
+			{
+				return false;
+			}
+			for (int32 MaterialIndex = 1; MaterialIndex < SubFields.Num(); ++MaterialIndex)
+			{
+				Entry.MaterialOverrides.Add(FSoftObjectPath(SubFields[MaterialIndex]));
+			}
+		}
+		else if (Fields[0] == TEXT("C") && Fields.Num() == 3)
+		{
+			FVehicleCatalogManifestEntry& Entry = OutManifest.Paints.AddDefaulted_GetRef();
+			Entry.ID = FieldToName(Fields[1]);
+			Entry.Asset = FSoftObjectPath(Fields[2]);
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,72 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CarPartData.h"
+
+/**
+ * A single catalog entry as seen by tools: identifiers and soft references only
+ */
+struct TUNEX_API FVehicleCatalogManifestEntry
+{
+	// PartID or PaintID
+	FName ID;
+
+	// MeshAsset for parts, Material for paints
+	FSoftObjectPath Asset;
+
+	// Compatibility tags (parts only)
+	TArray<FName> CompatibilityTags;
+
+	// Material overrides (parts only)
+	TArray<FSoftObjectPath> MaterialOverrides;
+
+	// Sound modifier (parts only)
+	FSoftObjectPath SoundModifier;
+
+	// Package hash the part's metadata was baked against, empty when missing or baked from another mesh (parts only)
+	FString MetadataHash;
+};
+
+/**
+ * Compact, load-free description of a UVehicleConfigDataAsset
+ * Stored as a hidden Asset Registry tag so validation and batch tools never have to load the config package
+ */
+struct TUNEX_API FVehicleCatalogManifest
+{
+	// Asset Registry tag the manifest is stored under
+	static const FName AssetRegistryTagName;
+
+	// Bumped whenever the encoding changes
+	static constexpr int32 FormatVersion = 2;
+
+	// Parts per slot
+	TArray<FVehicleCatalogManifestEntry> Parts[NumVehiclePartSlots];
+
+	// Paint options
+	TArray<FVehicleCatalogManifestEntry> Paints;
+
+	int32 DefaultFrontBumperIndex = 0;
+	int32 DefaultRearBumperIndex = 0;
+	int32 DefaultPaintIndex = 0;
+
+	/**
+	 * Builds a manifest from a loaded config
+	 * @param Config - The config to describe
+	 */
+	static FVehicleCatalogManifest FromConfig(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Encodes the manifest into the line-based tag format
+	 */
+	FString Encode() const;
+
+	/**
+	 * Decodes a manifest previously produced by Encode
+	 * @param Encoded - The tag value
+	 * @param OutManifest - Receives the decoded manifest
+	 * @return false if the string is malformed or from a different format version
+	 */
+	static bool Decode(const FString& Encoded, FVehicleCatalogManifest& OutManifest);
+};
@@ -0,0 +1,529 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleCatalogSearch.h"
+#include "Algo/Unique.h"
+#include "HAL/IConsoleManager.h"
+
+namespace VehicleCatalogSearch
+{
+	// Kind of the paint docs; part docs use their slot index
+	static constexpr uint8 PaintKind = static_cast<uint8>(NumVehiclePartSlots);
+
+	// Share of query trigrams a doc must contain to be scored
+	static constexpr float MinTrigramShare = 0.5f;
+
+	// Rebuild instead of refreshing once this share of docs is dead
+	static constexpr float MaxDeadShare = 0.25f;
+
+	static uint64 MakeTrigram(TCHAR A, TCHAR B, TCHAR C)
+	{
+		return (static_cast<uint64>(static_cast<uint16>(A)) << 32) | (static_cast<uint64>(static_cast<uint16>(B)) << 16) | static_cast<uint64>(static_cast<uint16>(C));
+	}
+
+	struct FCandidate
+	{
+		float Score;
+		int32 NameLen;
+		int32 DocId;
+	};
+
+	static bool IsBetter(const FCandidate& A, const FCandidate& B)
+	{
+		if (A.Score != B.Score)
+		{
+			return A.Score > B.Score;
+		}
+		if (A.NameLen != B.NameLen)
+		{
+			return A.NameLen < B.NameLen;
+		}
+		return A.DocId < B.DocId;
+	}
+}
+
+FString FVehicleCatalogSearchIndex::Normalize(const FString& Text)
+{
+	FString Result;
+	Result.Reserve(Text.Len());
+	for (const TCHAR Char : Text)
+	{
+		if (FChar::IsAlnum(Char))
+		{
+			Result.AppendChar(FChar::ToLower(Char));
+		}
+		else if (Result.Len() > 0 && Result[Result.Len() - 1] != TEXT(' '))
+		{
+			Result.AppendChar(TEXT(' '));
+		}
+	}
+	if (Result.Len() > 0 && Result[Result.Len() - 1] == TEXT(' '))
+	{
+		Result.LeftChopInline(1, /*bAllowShrinking*/ false);
+	}
+	return Result;
+}
+
+void FVehicleCatalogSearchIndex::GatherTrigrams(const FString& Text, bool bOpenEnded, TArray<uint64>& OutTrigrams)
+{
+	const TCHAR* Chars = *Text;
+	const int32 Len = Text.Len();
+
+	int32 WordStart = 0;
+	while (WordStart < Len)
+	{
+		int32 WordEnd = WordStart;
+		while (WordEnd < Len && Chars[WordEnd] != TEXT(' '))
+		{
+			++WordEnd;
+		}
+
+		// Two leading spaces make the first letters trigrams of their own; the trailing one marks a whole word
+		const bool bPadEnd = !(bOpenEnded && WordEnd == Len);
+		const int32 PaddedLen = 2 + (WordEnd - WordStart) + (bPadEnd ? 1 : 0);
+		auto PaddedChar = [&](int32 Position) -> TCHAR
+		{
+			const int32 CharIndex = WordStart + Position - 2;
+			return (Position < 2 || CharIndex >= WordEnd) ? TEXT(' ') : Chars[CharIndex];
+		};
+		for (int32 Position = 0; Position + 3 <= PaddedLen; ++Position)
+		{
+			OutTrigrams.Add(VehicleCatalogSearch::MakeTrigram(PaddedChar(Position), PaddedChar(Position + 1), PaddedChar(Position + 2)));
+		}
+
+		WordStart = WordEnd + 1;
+	}
+
+	OutTrigrams.Sort();
+	OutTrigrams.SetNum(Algo::Unique(OutTrigrams), /*bAllowShrinking*/ false);
+}
+
+uint32 FVehicleCatalogSearchIndex::HashEntry(const FString& DisplayName, FName ID)
+{
+	return HashCombine(GetTypeHash(DisplayName), GetTypeHash(ID));
+}
+
+int32 FVehicleCatalogSearchIndex::AddDoc(uint8 Kind, int32 Index, const FString& DisplayName, FName ID)
+{
+	const int32 DocId = Docs.AddDefaulted();
+	FDoc& Doc = Docs[DocId];
+	Doc.Text = Normalize(DisplayName);
+	Doc.NameLen = Doc.Text.Len();
+	const FString NormalizedID = Normalize(ID.ToString());
+	if (NormalizedID.Len() > 0)
+	{
+		if (Doc.Text.Len() > 0)
+		{
+			Doc.Text.AppendChar(TEXT(' '));
+		}
+		Doc.Text += NormalizedID;
+	}
+	Doc.Kind = Kind;
+	Doc.Index = Index;
+	Doc.ContentHash = HashEntry(DisplayName, ID);
+
+	TArray<uint64> Trigrams;
+	GatherTrigrams(Doc.Text, false, Trigrams);
+
+	// Doc IDs only grow, so every posting list stays sorted
+	for (const uint64 Trigram : Trigrams)
+	{
+		Postings.FindOrAdd(Trigram).Add(DocId);
+	}
+
+	TArray<int32>& KindDocs = EntryDocs[Kind];
+	if (KindDocs.Num() <= Index)
+	{
+		KindDocs.SetNum(Index + 1);
+	}
+	KindDocs[Index] = DocId;
+	return DocId;
+}
+
+void FVehicleCatalogSearchIndex::KillDoc(int32 DocId)
+{
+	// Postings keep pointing at dead docs until the next rebuild; queries skip them
+	FDoc& Doc = Docs[DocId];
+	if (Doc.bAlive)
+	{
+		Doc.bAlive = false;
+		Doc.Text.Empty();
+		++NumDeadDocs;
+	}
+}
+
+void FVehicleCatalogSearchIndex::Build(const UVehicleConfigDataAsset& Config)
+{
+	Docs.Reset();
+	Postings.Reset();
+	for (TArray<int32>& KindDocs : EntryDocs)
+	{
+		KindDocs.Reset();
+	}
+	NumDeadDocs = 0;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+		{
+			AddDoc(static_cast<uint8>(SlotIndex), PartIndex, Parts[PartIndex].DisplayName, Parts[PartIndex].PartID);
+		}
+	}
+	for (int32 PaintIndex = 0; PaintIndex < Config.PaintColors.Num(); ++PaintIndex)
+	{
+		AddDoc(VehicleCatalogSearch::PaintKind, PaintIndex, Config.PaintColors[PaintIndex].DisplayName, Config.PaintColors[PaintIndex].PaintID);
+	}
+
+	ContentRevision = Config.GetContentRevision();
+}
+
+int32 FVehicleCatalogSearchIndex::Refresh(const UVehicleConfigDataAsset& Config)
+{
+	if (IsUpToDate(Config))
+	{
+		return 0;
+	}
+
+	int32 NumChanged = 0;
+	auto RefreshKind = [&](uint8 Kind, int32 NumEntries, auto&& GetEntry)
+	{
+		TArray<int32>& KindDocs = EntryDocs[Kind];
+		const int32 NumOld = KindDocs.Num();
+		for (int32 Index = 0; Index < NumEntries; ++Index)
+		{
+			const FString* DisplayName = nullptr;
+			FName ID;
+			GetEntry(Index, DisplayName, ID);
+			if (Index < NumOld)
+			{
+				if (Docs[KindDocs[Index]].ContentHash == HashEntry(*DisplayName, ID))
+				{
+					continue;
+				}
+				KillDoc(KindDocs[Index]);
+			}
+			AddDoc(Kind, Index, *DisplayName, ID);
+			++NumChanged;
+		}
+		for (int32 Index = NumEntries; Index < NumOld; ++Index)
+		{
+			KillDoc(KindDocs[Index]);
+			++NumChanged;
+		}
+		// AddDoc may have grown the array; entries past the end are gone
+		KindDocs.SetNum(NumEntries);
+	};
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		RefreshKind(static_cast<uint8>(SlotIndex), Parts.Num(), [&Parts](int32 Index, const FString*& OutName, FName& OutID)
+		{
+			OutName = &Parts[Index].DisplayName;
+			OutID = Parts[Index].PartID;
+		});
+	}
+	RefreshKind(VehicleCatalogSearch::PaintKind, Config.PaintColors.Num(), [&Config](int32 Index, const FString*& OutName, FName& OutID)
+	{
+		OutName = &Config.PaintColors[Index].DisplayName;
+		OutID = Config.PaintColors[Index].PaintID;
+	});
+
+	if (NumDeadDocs > Docs.Num() * VehicleCatalogSearch::MaxDeadShare)
+	{
+		Build(Config);
+	}
+
+	ContentRevision = Config.GetContentRevision();
+	return NumChanged;
+}
+
+int32 FVehicleCatalogSearchIndex::AppendNewEntries(const UVehicleConfigDataAsset& Config, uint32 AppendedSinceRevision, int32 MaxEntries)
+{
+	if (IsUpToDate(Config))
+	{
+		return 0;
+	}
+	if (ContentRevision != AppendedSinceRevision)
+	{
+		return INDEX_NONE;
+	}
+
+	int32 NumAdded = 0;
+	bool bCaughtUp = true;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		for (int32 PartIndex = EntryDocs[SlotIndex].Num(); PartIndex < Parts.Num() && NumAdded < MaxEntries; ++PartIndex, ++NumAdded)
+		{
+			AddDoc(static_cast<uint8>(SlotIndex), PartIndex, Parts[PartIndex].DisplayName, Parts[PartIndex].PartID);
+		}
+		bCaughtUp &= EntryDocs[SlotIndex].Num() >= Parts.Num();
+	}
+
+	TArray<int32>& PaintDocs = EntryDocs[VehicleCatalogSearch::PaintKind];
+	for (int32 PaintIndex = PaintDocs.Num(); PaintIndex < Config.PaintColors.Num() && NumAdded < MaxEntries; ++PaintIndex, ++NumAdded)
+	{
+		AddDoc(VehicleCatalogSearch::PaintKind, PaintIndex, Config.PaintColors[PaintIndex].DisplayName, Config.PaintColors[PaintIndex].PaintID);
+	}
+	bCaughtUp &= PaintDocs.Num() >= Config.PaintColors.Num();
+
+	// Until caught up the index stays at the old revision, so a search in between falls back to Refresh
+	if (bCaughtUp)
+	{
+		ContentRevision = Config.GetContentRevision();
+	}
+	return NumAdded;
+}
+
+void FVehicleCatalogSearchIndex::Search(const FString& Query, int32 MaxResults, bool bIncludePaints, uint32 SlotMask, TArray<FVehicleCatalogSearchHit>& OutHits) const
+{
+	using namespace VehicleCatalogSearch;
+
+	OutHits.Reset();
+	const FString NormalizedQuery = Normalize(Query);
+	if (NormalizedQuery.IsEmpty() || MaxResults <= 0)
+	{
+		return;
+	}
+
+	// The last word is still being typed, so it matches as a prefix
+	TArray<uint64> QueryTrigrams;
+	GatherTrigrams(NormalizedQuery, true, QueryTrigrams);
+	const int32 NumQueryTrigrams = FMath::Min<int32>(QueryTrigrams.Num(), MAX_uint16);
+	const int32 MinHits = FMath::Max(1, FMath::CeilToInt(NumQueryTrigrams * MinTrigramShare));
+
+	if (HitCounts.Num() < Docs.Num())
+	{
+		HitCounts.SetNumZeroed(Docs.Num());
+	}
+	TouchedDocs.Reset();
+	for (int32 TrigramIndex = 0; TrigramIndex < NumQueryTrigrams; ++TrigramIndex)
+	{
+		if (const TArray<int32>* DocIds = Postings.Find(QueryTrigrams[TrigramIndex]))
+		{
+			for (const int32 DocId : *DocIds)
+			{
+				if (HitCounts[DocId]++ == 0)
+				{
+					TouchedDocs.Add(DocId);
+				}
+			}
+		}
+	}
+
+	const TCHAR* QueryChars = *NormalizedQuery;
+	const int32 QueryLen = NormalizedQuery.Len();
+	const FString WordPrefixQuery = TEXT(" ") + NormalizedQuery;
+
+	// Worst candidate on top, so a better one replaces it once K are held
+	auto IsWorse = [](const FCandidate& A, const FCandidate& B) { return IsBetter(B, A); };
+	TArray<FCandidate, TInlineAllocator<32>> Heap;
+
+	for (const int32 DocId : TouchedDocs)
+	{
+		const int32 NumHits = HitCounts[DocId];
+		HitCounts[DocId] = 0;
+
+		const FDoc& Doc = Docs[DocId];
+		if (NumHits < MinHits || !Doc.bAlive)
+		{
+			continue;
+		}
+		if (Doc.Kind == PaintKind ? !bIncludePaints : !(SlotMask & (1u << Doc.Kind)))
+		{
+			continue;
+		}
+
+		float Score = static_cast<float>(NumHits) / NumQueryTrigrams;
+		const TCHAR* DocChars = *Doc.Text;
+		if (Doc.NameLen >= QueryLen && FCString::Strncmp(DocChars, QueryChars, QueryLen) == 0)
+		{
+			Score += Doc.NameLen == QueryLen ? 2.0f : 1.0f;
+		}
+		else if (FCString::Strstr(DocChars, *WordPrefixQuery))
+		{
+			Score += 0.75f;
+		}
+		else if (FCString::Strstr(DocChars, QueryChars))
+		{
+			Score += 0.5f;
+		}
+
+		const FCandidate Candidate{ Score, Doc.NameLen, DocId };
+		if (Heap.Num() < MaxResults)
+		{
+			Heap.HeapPush(Candidate, IsWorse);
+		}
+		else if (IsBetter(Candidate, Heap.HeapTop()))
+		{
+			Heap.HeapPopDiscard(IsWorse, /*bAllowShrinking*/ false);
+			Heap.HeapPush(Candidate, IsWorse);
+		}
+	}
+
+	Heap.Sort(&IsBetter);
+	OutHits.Reserve(Heap.Num());
+	for (const FCandidate& Candidate : Heap)
+	{
+		const FDoc& Doc = Docs[Candidate.DocId];
+		FVehicleCatalogSearchHit& Hit = OutHits.AddDefaulted_GetRef();
+		Hit.bIsPaint = Doc.Kind == PaintKind;
+		Hit.Slot = Hit.bIsPaint ? EVehiclePartSlot::FrontBumper : static_cast<EVehiclePartSlot>(Doc.Kind);
+		Hit.Index = Doc.Index;
+		Hit.Score = Candidate.Score;
+	}
+}
+
+SIZE_T FVehicleCatalogSearchIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = Docs.GetAllocatedSize() + Postings.GetAllocatedSize() + HitCounts.GetAllocatedSize() + TouchedDocs.GetAllocatedSize();
+	for (const FDoc& Doc : Docs)
+	{
+		Size += Doc.Text.GetAllocatedSize();
+	}
+	for (const TPair<uint64, TArray<int32>>& Posting : Postings)
+	{
+		Size += Posting.Value.GetAllocatedSize();
+	}
+	for (const TArray<int32>& KindDocs : EntryDocs)
+	{
+		Size += KindDocs.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void UVehicleCatalogSearchSubsystem::Deinitialize()
+{
+	Indices.Empty();
+	Super::Deinitialize();
+}
+
+const FVehicleCatalogSearchIndex& UVehicleCatalogSearchSubsystem::GetIndex(const UVehicleConfigDataAsset& Config)
+{
+	if (TUniquePtr<FVehicleCatalogSearchIndex>* Existing = Indices.Find(&Config))
+	{
+		FVehicleCatalogSearchIndex& Index = **Existing;
+		if (!Index.IsUpToDate(Config))
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			const int32 NumChanged = Index.Refresh(Config);
+			UE_LOG(LogTemp, Verbose, TEXT("VehicleCatalogSearch: Refreshed %d entries of %s in %.2f ms"),
+				NumChanged, *Config.GetName(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		return Index;
+	}
+
+	// Drop the indices of catalogs that were unloaded
+	for (auto It = Indices.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	TUniquePtr<FVehicleCatalogSearchIndex>& Index = Indices.Add(&Config, MakeUnique<FVehicleCatalogSearchIndex>());
+	Index->Build(Config);
+	UE_LOG(LogTemp, Display, TEXT("VehicleCatalogSearch: Indexed %d entries of %s in %.2f ms"),
+		Index->GetNumEntries(), *Config.GetName(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return *Index;
+}
+
+FVehicleCatalogSearchIndex* UVehicleCatalogSearchSubsystem::FindIndex(const UVehicleConfigDataAsset& Config)
+{
+	TUniquePtr<FVehicleCatalogSearchIndex>* Existing = Indices.Find(&Config);
+	return Existing ? Existing->Get() : nullptr;
+}
+
+TArray<FVehicleCatalogSearchHit> UVehicleCatalogSearchSubsystem::SearchCatalog(UVehicleConfigDataAsset* Config, const FString& Query, int32 MaxResults, bool bIncludeParts, bool bIncludePaints)
+{
+	TArray<FVehicleCatalogSearchHit> Hits;
+	if (Config)
+	{
+		const uint32 SlotMask = bIncludeParts ? (1u << NumVehiclePartSlots) - 1 : 0;
+		GetIndex(*Config).Search(Query, MaxResults, bIncludePaints, SlotMask, Hits);
+	}
+	return Hits;
+}
+
+TArray<FVehicleCatalogSearchHit> UVehicleCatalogSearchSubsystem::SearchSlot(UVehicleConfigDataAsset* Config, EVehiclePartSlot Slot, const FString& Query, int32 MaxResults)
+{
+	TArray<FVehicleCatalogSearchHit> Hits;
+	if (Config)
+	{
+		GetIndex(*Config).Search(Query, MaxResults, false, 1u << static_cast<uint32>(Slot), Hits);
+	}
+	return Hits;
+}
+
+static FAutoConsoleCommand GVehicleCatalogSearchBenchmarkCommand(
+	TEXT("TuneX.Search.Benchmark"),
+	TEXT("Measures index build, incremental refresh and top-20 query times on a synthetic catalog. Usage: TuneX.Search.Benchmark [NumParts=100000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumParts = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100000;
+
+		static const TCHAR* Styles[] = { TEXT("Carbon"), TEXT("Street"), TEXT("Race"), TEXT("Aero"), TEXT("Widebody"), TEXT("Classic"), TEXT("Drift"), TEXT("Touring"), TEXT("Rally"), TEXT("Vintage") };
+		static const TCHAR* Makers[] = { TEXT("Titan"), TEXT("Vortex"), TEXT("Apex"), TEXT("Nova"), TEXT("Falcon"), TEXT("Kaiju"), TEXT("Zenith"), TEXT("Orbit") };
+		static const TCHAR* Kinds[] = { TEXT("Lip"), TEXT("Diffuser"), TEXT("Skirt"), TEXT("Wing"), TEXT("Rim") };
+
+		UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage());
+		FRandomStream Random(NumParts);
+		for (int32 PartIndex = 0; PartIndex < NumParts; ++PartIndex)
+		{
+			const int32 SlotIndex = PartIndex % NumVehiclePartSlots;
+			FCarPart& Part = Config->GetParts(static_cast<EVehiclePartSlot>(SlotIndex)).AddDefaulted_GetRef();
+			Part.DisplayName = FString::Printf(TEXT("%s %s %s %d"),
+				Makers[Random.RandHelper(UE_ARRAY_COUNT(Makers))], Styles[Random.RandHelper(UE_ARRAY_COUNT(Styles))], Kinds[SlotIndex], PartIndex);
+			Part.PartID = FName(*FString::Printf(TEXT("part_%d"), PartIndex));
+		}
+		for (int32 PaintIndex = 0; PaintIndex < 256; ++PaintIndex)
+		{
+			FPaintColor& Paint = Config->PaintColors.AddDefaulted_GetRef();
+			Paint.DisplayName = FString::Printf(TEXT("%s Metallic %d"), Styles[PaintIndex % UE_ARRAY_COUNT(Styles)], PaintIndex);
+			Paint.PaintID = FName(*FString::Printf(TEXT("paint_%d"), PaintIndex));
+		}
+
+		FVehicleCatalogSearchIndex Index;
+		double StartTime = FPlatformTime::Seconds();
+		Index.Build(*Config);
+		const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		static const TCHAR* Queries[] = { TEXT("c"), TEXT("ca"), TEXT("carb"), TEXT("carbon wing"), TEXT("crabon"), TEXT("titan drift rim"), TEXT("vortx diffusr"), TEXT("part 4242"), TEXT("metallic 12"), TEXT("zzz") };
+		constexpr int32 NumRounds = 20;
+		TArray<FVehicleCatalogSearchHit> Hits;
+		for (const TCHAR* Query : Queries)
+		{
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Round = 0; Round < NumRounds; ++Round)
+			{
+				Index.Search(Query, 20, true, (1u << NumVehiclePartSlots) - 1, Hits);
+			}
+			const double QueryMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumRounds;
+
+			FString Best = TEXT("none");
+			if (Hits.Num() > 0)
+			{
+				Best = Hits[0].bIsPaint ? Config->PaintColors[Hits[0].Index].DisplayName : Config->GetParts(Hits[0].Slot)[Hits[0].Index].DisplayName;
+			}
+			UE_LOG(LogTemp, Display, TEXT("VehicleCatalogSearch: '%s' %.3f ms, %d hits, best '%s'"), Query, QueryMs, Hits.Num(), *Best);
+		}
+
+		// Rename a few parts, as an editor session or a content patch would
+		for (int32 PartIndex = 0; PartIndex < FMath::Min(NumParts, 100); ++PartIndex)
+		{
+			Config->GetParts(static_cast<EVehiclePartSlot>(PartIndex % NumVehiclePartSlots))[PartIndex / NumVehiclePartSlots].DisplayName += TEXT(" Mk2");
+		}
+		Config->InvalidateCatalogFingerprint();
+		StartTime = FPlatformTime::Seconds();
+		const int32 NumRefreshed = Index.Refresh(*Config);
+		const double RefreshMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		UE_LOG(LogTemp, Display, TEXT("VehicleCatalogSearch: %d entries, build %.1f ms, refresh of %d entries %.2f ms, %.1f MB"),
+			Index.GetNumEntries(), BuildMs, NumRefreshed, RefreshMs, Index.GetAllocatedSize() / (1024.0 * 1024.0));
+
+		Config->MarkAsGarbage();
+	})
+);
@@ -0,0 +1,170 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CarPartData.h"
+#include "VehicleCatalogSearch.generated.h"
+
+/**
+ * One search result
+ */
+USTRUCT(BlueprintType)
+struct FVehicleCatalogSearchHit
+{
+	GENERATED_BODY()
+
+	// Whether the hit is a paint (Index into PaintColors) rather than a part (Index into the Slot's parts)
+	UPROPERTY(BlueprintReadOnly, Category = "Search")
+	bool bIsPaint = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Search")
+	EVehiclePartSlot Slot = EVehiclePartSlot::FrontBumper;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Search")
+	int32 Index = INDEX_NONE;
+
+	// Higher is better; exact and prefix matches rank above fuzzy ones
+	UPROPERTY(BlueprintReadOnly, Category = "Search")
+	float Score = 0.0f;
+};
+
+/**
+ * Trigram index over the normalized display names and IDs of one catalog's parts and paints
+ * Names are lowercased, punctuation and underscores become spaces, and each word is padded so its first
+ * letters form their own trigrams; a query of one or two letters is therefore a word-prefix lookup and
+ * longer queries tolerate typos. Candidates are scored by the share of query trigrams they contain, plus
+ * bonuses for exact, prefix and substring matches, and the top K are kept with a bounded heap.
+ *
+ * Refresh() re-indexes only the entries whose name or ID changed. Not thread-safe: queries reuse scratch memory.
+ */
+class TUNEX_API FVehicleCatalogSearchIndex
+{
+public:
+	/**
+	 * Indexes a catalog from scratch
+	 */
+	void Build(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Brings the index up to date with the catalog, re-indexing changed entries only
+	 * @return Number of entries re-indexed
+	 */
+	int32 Refresh(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Indexes entries appended to the catalog (UVehicleConfigDataAsset::AppendContent), a batch per call
+	 * Unlike Refresh, entries already indexed are not looked at, so an append is indexed in small slices.
+	 * @param AppendedSinceRevision - Content revision of the catalog before the append
+	 * @param MaxEntries - Most entries to index in this call
+	 * @return Entries indexed, or INDEX_NONE if the catalog changed otherwise since (leave it to Refresh)
+	 */
+	int32 AppendNewEntries(const UVehicleConfigDataAsset& Config, uint32 AppendedSinceRevision, int32 MaxEntries);
+
+	bool IsUpToDate(const UVehicleConfigDataAsset& Config) const { return ContentRevision == Config.GetContentRevision(); }
+
+	/**
+	 * Finds the best matches for a query
+	 * @param Query - What the user typed
+	 * @param MaxResults - K
+	 * @param bIncludePaints - Also search paints
+	 * @param SlotMask - Part slots to search (bit per EVehiclePartSlot)
+	 * @param OutHits - Best first
+	 */
+	void Search(const FString& Query, int32 MaxResults, bool bIncludePaints, uint32 SlotMask, TArray<FVehicleCatalogSearchHit>& OutHits) const;
+
+	int32 GetNumEntries() const { return Docs.Num() - NumDeadDocs; }
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Lowercases, turns anything but letters and digits into single spaces and trims
+	 */
+	static FString Normalize(const FString& Text);
+
+private:
+	struct FDoc
+	{
+		// Normalized display name and ID, joined by a space
+		FString Text;
+
+		// Length of the name part of Text
+		int32 NameLen = 0;
+
+		// Slot index, or NumVehiclePartSlots for paints
+		uint8 Kind = 0;
+		bool bAlive = true;
+		int32 Index = INDEX_NONE;
+		uint32 ContentHash = 0;
+	};
+
+	int32 AddDoc(uint8 Kind, int32 Index, const FString& DisplayName, FName ID);
+	void KillDoc(int32 DocId);
+
+	static uint32 HashEntry(const FString& DisplayName, FName ID);
+
+	/**
+	 * Appends the padded trigrams of normalized text
+	 * @param bOpenEnded - Leave the last word unpadded at its end, so it matches as a prefix
+	 */
+	static void GatherTrigrams(const FString& Text, bool bOpenEnded, TArray<uint64>& OutTrigrams);
+
+	TArray<FDoc> Docs;
+	TMap<uint64, TArray<int32>> Postings;
+
+	// Doc of each entry (indexed by Kind, then entry index)
+	TArray<int32> EntryDocs[NumVehiclePartSlots + 1];
+
+	int32 NumDeadDocs = 0;
+	uint32 ContentRevision = 0;
+
+	// Query scratch: trigram hits per doc, and the docs with a non-zero count
+	mutable TArray<uint16> HitCounts;
+	mutable TArray<int32> TouchedDocs;
+};
+
+/**
+ * Search indices of every catalog, built on first search and refreshed when a catalog's content changes
+ *
+ * Benchmark: TuneX.Search.Benchmark [NumParts]
+ */
+UCLASS()
+class TUNEX_API UVehicleCatalogSearchSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Searches the parts and paints of a catalog by display name and ID
+	 * @param Config - The catalog
+	 * @param Query - What the user typed
+	 * @param MaxResults - Number of results wanted
+	 * @param bIncludeParts - Search parts of every slot
+	 * @param bIncludePaints - Search paints
+	 * @return Best matches first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Search")
+	TArray<FVehicleCatalogSearchHit> SearchCatalog(UVehicleConfigDataAsset* Config, const FString& Query, int32 MaxResults = 20, bool bIncludeParts = true, bool bIncludePaints = true);
+
+	/**
+	 * Same as above limited to one part slot
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Search")
+	TArray<FVehicleCatalogSearchHit> SearchSlot(UVehicleConfigDataAsset* Config, EVehiclePartSlot Slot, const FString& Query, int32 MaxResults = 20);
+
+	/**
+	 * Gets the up-to-date index of a catalog, building or refreshing it as needed
+	 */
+	const FVehicleCatalogSearchIndex& GetIndex(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Gets the index of a catalog as it is, if one was built
+	 */
+	FVehicleCatalogSearchIndex* FindIndex(const UVehicleConfigDataAsset& Config);
+
+private:
+	TMap<TObjectKey<UVehicleConfigDataAsset>, TUniquePtr<FVehicleCatalogSearchIndex>> Indices;
+};
@@ -0,0 +1,428 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleCrowdSubsystem.h"
+#include "VehicleActor.h"
+#include "VehicleActorPool.h"
+#include "VehicleDerivedDataCache.h"
+#include "VehicleMasterComponent.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarCrowdPromoteRadius(
+	TEXT("TuneX.Crowd.PromoteRadius"),
+	5000.0f,
+	TEXT("Distance (cm) under which a data-only crowd vehicle is promoted to an actor"));
+
+static TAutoConsoleVariable<float> CVarCrowdDemoteRadius(
+	TEXT("TuneX.Crowd.DemoteRadius"),
+	6000.0f,
+	TEXT("Distance (cm) over which a promoted crowd vehicle is demoted back to data"));
+
+static TAutoConsoleVariable<int32> CVarCrowdMaxPromotionsPerFrame(
+	TEXT("TuneX.Crowd.MaxPromotionsPerFrame"),
+	4,
+	TEXT("Maximum crowd vehicles promoted per frame"));
+
+static TAutoConsoleVariable<int32> CVarCrowdMaxDemotionsPerFrame(
+	TEXT("TuneX.Crowd.MaxDemotionsPerFrame"),
+	8,
+	TEXT("Maximum crowd vehicles demoted per frame"));
+
+namespace VehicleCrowd
+{
+	enum EProximityChange : uint8
+	{
+		Change_None,
+		Change_Promote,
+		Change_Demote,
+	};
+
+	// Vehicles per ParallelFor task in the proximity pass
+	static constexpr int32 ProximityBatchSize = 512;
+}
+
+bool UVehicleCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UVehicleCrowdSubsystem::Deinitialize()
+{
+	Builds.Empty();
+	Locations.Empty();
+	Rotations.Empty();
+	CachedPrices.Empty();
+	ConfigIndices.Empty();
+	ClassIndices.Empty();
+	PromotedFlags.Empty();
+	DenseToId.Empty();
+	PromotedActors.Empty();
+	IdToDense.Empty();
+	FreeIds.Empty();
+	NumPromoted = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UVehicleCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVehicleCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UVehicleCrowdSubsystem::Tick(float DeltaTime)
+{
+	if (Builds.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewerLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewerLocations.Add(ViewLocation);
+		}
+	}
+
+	UpdateProximity(ViewerLocations,
+		CVarCrowdPromoteRadius.GetValueOnGameThread(),
+		CVarCrowdDemoteRadius.GetValueOnGameThread(),
+		CVarCrowdMaxPromotionsPerFrame.GetValueOnGameThread(),
+		CVarCrowdMaxDemotionsPerFrame.GetValueOnGameThread());
+}
+
+FVehicleCrowdHandle UVehicleCrowdSubsystem::AddVehicle(TSubclassOf<AVehicleActor> VehicleClass, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build, const FTransform& Transform)
+{
+	FVehicleCrowdHandle Handle;
+	if (!VehicleClass || !Config)
+	{
+		return Handle;
+	}
+
+	Handle.Id = FreeIds.Num() > 0 ? FreeIds.Pop(/*bAllowShrinking*/ false) : IdToDense.AddUninitialized();
+
+	const int32 Index = Builds.Add(Build);
+	Locations.Add(Transform.GetLocation());
+	Rotations.Add(FQuat4f(Transform.GetRotation()));
+	CachedPrices.Add(FVehicleDerivedDataCache::Get().GetOrCompute(*Config, Config->GetCatalogFingerprint(), Build).TotalPrice);
+	ConfigIndices.Add(FindOrAddConfig(Config));
+	ClassIndices.Add(FindOrAddClass(VehicleClass));
+	PromotedFlags.Add(0);
+	PromotedActors.Add(nullptr);
+	DenseToId.Add(Handle.Id);
+	IdToDense[Handle.Id] = Index;
+
+	return Handle;
+}
+
+void UVehicleCrowdSubsystem::RemoveVehicle(FVehicleCrowdHandle Handle)
+{
+	if (!IdToDense.IsValidIndex(Handle.Id) || IdToDense[Handle.Id] == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 Index = IdToDense[Handle.Id];
+	if (PromotedFlags[Index])
+	{
+		DemoteVehicle(Index);
+	}
+
+	// Swap-remove keeps every array contiguous; patch the id of the element moved into the hole
+	const int32 LastIndex = Builds.Num() - 1;
+	if (Index != LastIndex)
+	{
+		IdToDense[DenseToId[LastIndex]] = Index;
+	}
+
+	Builds.RemoveAtSwap(Index, 1, /*bAllowShrinking*/ false);
+	Locations.RemoveAtSwap(Index, 1, false);
+	Rotations.RemoveAtSwap(Index, 1, false);
+	CachedPrices.RemoveAtSwap(Index, 1, false);
+	ConfigIndices.RemoveAtSwap(Index, 1, false);
+	ClassIndices.RemoveAtSwap(Index, 1, false);
+	PromotedFlags.RemoveAtSwap(Index, 1, false);
+	PromotedActors.RemoveAtSwap(Index, 1, false);
+	DenseToId.RemoveAtSwap(Index, 1, false);
+
+	IdToDense[Handle.Id] = INDEX_NONE;
+	FreeIds.Add(Handle.Id);
+}
+
+void UVehicleCrowdSubsystem::SetVehicleBuild(FVehicleCrowdHandle Handle, const FVehicleBuild& Build)
+{
+	if (!IdToDense.IsValidIndex(Handle.Id) || IdToDense[Handle.Id] == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 Index = IdToDense[Handle.Id];
+	Builds[Index] = Build;
+	const UVehicleConfigDataAsset* Config = ConfigTable[ConfigIndices[Index]];
+	CachedPrices[Index] = FVehicleDerivedDataCache::Get().GetOrCompute(*Config, Config->GetCatalogFingerprint(), Build).TotalPrice;
+
+	if (AVehicleActor* Vehicle = PromotedActors[Index])
+	{
+		Vehicle->VehicleMasterComponent->ApplyBuildAsync(Build);
+	}
+}
+
+AVehicleActor* UVehicleCrowdSubsystem::GetPromotedActor(FVehicleCrowdHandle Handle) const
+{
+	if (!IdToDense.IsValidIndex(Handle.Id) || IdToDense[Handle.Id] == INDEX_NONE)
+	{
+		return nullptr;
+	}
+	return PromotedActors[IdToDense[Handle.Id]];
+}
+
+void UVehicleCrowdSubsystem::UpdateProximity(TConstArrayView<FVector> ViewerLocations, float PromoteRadius, float DemoteRadius, int32 MaxPromotions, int32 MaxDemotions)
+{
+	using namespace VehicleCrowd;
+
+	const int32 NumVehicles = Builds.Num();
+	PendingChanges.SetNumUninitialized(NumVehicles, /*bAllowShrinking*/ false);
+
+	const double PromoteRadiusSq = FMath::Square(static_cast<double>(PromoteRadius));
+	const double DemoteRadiusSq = FMath::Square(static_cast<double>(FMath::Max(DemoteRadius, PromoteRadius)));
+
+	// Pure data pass: no UObjects are touched on the workers
+	ParallelFor(TEXT("VehicleCrowd.Proximity"), NumVehicles, ProximityBatchSize, [&](int32 Index)
+	{
+		double MinDistanceSq = TNumericLimits<double>::Max();
+		for (const FVector& Viewer : ViewerLocations)
+		{
+			MinDistanceSq = FMath::Min(MinDistanceSq, FVector::DistSquared(Viewer, Locations[Index]));
+		}
+
+		uint8 Change = Change_None;
+		if (!PromotedFlags[Index] && MinDistanceSq < PromoteRadiusSq)
+		{
+			Change = Change_Promote;
+		}
+		else if (PromotedFlags[Index] && MinDistanceSq > DemoteRadiusSq)
+		{
+			Change = Change_Demote;
+		}
+		PendingChanges[Index] = Change;
+	});
+
+	// Demote first so promotions can reuse the released actors
+	int32 NumDemoted = 0;
+	for (int32 Index = 0; Index < NumVehicles && NumDemoted < MaxDemotions; ++Index)
+	{
+		if (PendingChanges[Index] == Change_Demote)
+		{
+			DemoteVehicle(Index);
+			++NumDemoted;
+		}
+	}
+
+	int32 NumPromotedThisPass = 0;
+	for (int32 Index = 0; Index < NumVehicles && NumPromotedThisPass < MaxPromotions; ++Index)
+	{
+		if (PendingChanges[Index] == Change_Promote)
+		{
+			PromoteVehicle(Index);
+			++NumPromotedThisPass;
+		}
+	}
+}
+
+void UVehicleCrowdSubsystem::ComputeFleetStats(FVehicleStatsBatch& Out)
+{
+	StatsTables.SetNum(ConfigTable.Num());
+
+	TArray<const FVehicleStatsTable*, TInlineAllocator<8>> Tables;
+	for (int32 TableIndex = 0; TableIndex < ConfigTable.Num(); ++TableIndex)
+	{
+		if (ConfigTable[TableIndex] && !StatsTables[TableIndex].IsUpToDate(*ConfigTable[TableIndex]))
+		{
+			StatsTables[TableIndex] = FVehicleStatsTable::Build(*ConfigTable[TableIndex]);
+		}
+		Tables.Add(&StatsTables[TableIndex]);
+	}
+
+	FVehicleStatsBatch::Compute(Tables, ConfigIndices, Builds, Out);
+}
+
+int32 UVehicleCrowdSubsystem::GetVehicleIndex(FVehicleCrowdHandle Handle) const
+{
+	return IdToDense.IsValidIndex(Handle.Id) ? IdToDense[Handle.Id] : INDEX_NONE;
+}
+
+SIZE_T UVehicleCrowdSubsystem::GetAllocatedSize() const
+{
+	return Builds.GetAllocatedSize()
+		+ Locations.GetAllocatedSize()
+		+ Rotations.GetAllocatedSize()
+		+ CachedPrices.GetAllocatedSize()
+		+ ConfigIndices.GetAllocatedSize()
+		+ ClassIndices.GetAllocatedSize()
+		+ PromotedFlags.GetAllocatedSize()
+		+ DenseToId.GetAllocatedSize()
+		+ PromotedActors.GetAllocatedSize()
+		+ IdToDense.GetAllocatedSize()
+		+ FreeIds.GetAllocatedSize()
+		+ PendingChanges.GetAllocatedSize();
+}
+
+void UVehicleCrowdSubsystem::PromoteVehicle(int32 Index)
+{
+	UVehicleActorPool* Pool = GetWorld()->GetSubsystem<UVehicleActorPool>();
+	if (!Pool)
+	{
+		return;
+	}
+
+	const FTransform Transform(FQuat(Rotations[Index]), Locations[Index]);
+	AVehicleActor* Vehicle = Pool->AcquireVehicle(ClassTable[ClassIndices[Index]], Transform, ConfigTable[ConfigIndices[Index]], Builds[Index]);
+	if (Vehicle)
+	{
+		// Crowd vehicles are never tuned in place, so they render as one merged mesh
+		Vehicle->VehicleMasterComponent->SetAutoBakeMergedMesh(true);
+
+		PromotedActors[Index] = Vehicle;
+		PromotedFlags[Index] = 1;
+		++NumPromoted;
+	}
+}
+
+void UVehicleCrowdSubsystem::DemoteVehicle(int32 Index)
+{
+	if (AVehicleActor* Vehicle = PromotedActors[Index])
+	{
+		Vehicle->VehicleMasterComponent->SetAutoBakeMergedMesh(false);
+	}
+
+	if (UVehicleActorPool* Pool = GetWorld()->GetSubsystem<UVehicleActorPool>())
+	{
+		Pool->ReleaseVehicle(PromotedActors[Index]);
+	}
+
+	PromotedActors[Index] = nullptr;
+	PromotedFlags[Index] = 0;
+	--NumPromoted;
+}
+
+uint16 UVehicleCrowdSubsystem::FindOrAddConfig(UVehicleConfigDataAsset* Config)
+{
+	int32 TableIndex = ConfigTable.Find(Config);
+	if (TableIndex == INDEX_NONE)
+	{
+		TableIndex = ConfigTable.Add(Config);
+	}
+	check(TableIndex <= MAX_uint16);
+	return static_cast<uint16>(TableIndex);
+}
+
+uint16 UVehicleCrowdSubsystem::FindOrAddClass(TSubclassOf<AVehicleActor> VehicleClass)
+{
+	int32 TableIndex = ClassTable.Find(VehicleClass);
+	if (TableIndex == INDEX_NONE)
+	{
+		TableIndex = ClassTable.Add(VehicleClass);
+	}
+	check(TableIndex <= MAX_uint16);
+	return static_cast<uint16>(TableIndex);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GVehicleCrowdBenchmarkCommand(
+	TEXT("TuneX.Crowd.Benchmark"),
+	TEXT("Measures crowd memory per car, proximity pass time and promotion/demotion throughput. Usage: TuneX.Crowd.Benchmark [NumCars=5000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UVehicleCrowdSubsystem* Crowd = World ? World->GetSubsystem<UVehicleCrowdSubsystem>() : nullptr;
+		if (!Crowd)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleCrowd: Benchmark needs a game or PIE world"));
+			return;
+		}
+
+		const int32 NumCars = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 5000;
+
+		// Synthetic catalog without meshes, so the numbers measure the crowd and pool rather than streaming
+		UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage());
+		for (int32 PartIndex = 0; PartIndex < 8; ++PartIndex)
+		{
+			FCarPart& Part = Config->FrontBumpers.AddDefaulted_GetRef();
+			Part.PartID = FName(*FString::Printf(TEXT("bench_bumper_%d"), PartIndex));
+			Part.Price = 100.0f * PartIndex;
+			Part.Stats.Weight = 2.0f * PartIndex;
+			Part.Stats.Downforce = 0.01f * PartIndex;
+
+			FPaintColor& Paint = Config->PaintColors.AddDefaulted_GetRef();
+			Paint.PaintID = FName(*FString::Printf(TEXT("bench_paint_%d"), PartIndex));
+			Paint.Price = 10.0f * PartIndex;
+		}
+
+		const int32 GridSize = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCars)));
+		TArray<FVehicleCrowdHandle> Handles;
+		Handles.Reserve(NumCars);
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 CarIndex = 0; CarIndex < NumCars; ++CarIndex)
+		{
+			FVehicleBuild Build;
+			Build.SetPartIndex(EVehiclePartSlot::FrontBumper, CarIndex % 8);
+			Build.PaintIndex = (CarIndex / 8) % 8;
+
+			const FVector Location((CarIndex % GridSize) * 1000.0, (CarIndex / GridSize) * 1000.0, 0.0);
+			Handles.Add(Crowd->AddVehicle(AVehicleActor::StaticClass(), Config, Build, FTransform(Location)));
+		}
+		const double AddSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const double BytesPerCar = static_cast<double>(Crowd->GetAllocatedSize()) / Crowd->GetNumVehicles();
+
+		// Proximity pass with a viewer that reaches nothing
+		const FVector FarViewer(-1.0e7, -1.0e7, 0.0);
+		constexpr int32 NumProximityPasses = 20;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumProximityPasses; ++Pass)
+		{
+			Crowd->UpdateProximity(MakeArrayView(&FarViewer, 1), 5000.0f, 6000.0f, 0, 0);
+		}
+		const double ProximityMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumProximityPasses;
+
+		FVehicleStatsBatch FleetStats;
+		Crowd->ComputeFleetStats(FleetStats);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumProximityPasses; ++Pass)
+		{
+			Crowd->ComputeFleetStats(FleetStats);
+		}
+		const double FleetStatsMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumProximityPasses;
+
+		// Promote everything (cold: spawns), demote everything, then promote again (warm: pooled)
+		const FVector CenterViewer(GridSize * 500.0, GridSize * 500.0, 0.0);
+		const float EverywhereRadius = GridSize * 2000.0f;
+		auto TimePass = [&](TConstArrayView<FVector> Viewers)
+		{
+			const double PassStart = FPlatformTime::Seconds();
+			Crowd->UpdateProximity(Viewers, EverywhereRadius, EverywhereRadius, MAX_int32, MAX_int32);
+			return FPlatformTime::Seconds() - PassStart;
+		};
+
+		const double ColdPromoteSeconds = TimePass(MakeArrayView(&CenterViewer, 1));
+		const int32 NumPromoted = Crowd->GetNumPromoted();
+		const double DemoteSeconds = TimePass(TConstArrayView<FVector>());
+		const double WarmPromoteSeconds = TimePass(MakeArrayView(&CenterViewer, 1));
+		TimePass(TConstArrayView<FVector>());
+
+		for (const FVehicleCrowdHandle& Handle : Handles)
+		{
+			Crowd->RemoveVehicle(Handle);
+		}
+
+		auto PerSecond = [NumPromoted](double Seconds) { return Seconds > 0.0 ? NumPromoted / Seconds : 0.0; };
+		UE_LOG(LogTemp, Display, TEXT("VehicleCrowd: %d cars, %.1f bytes/car, add %.2f ms, proximity pass %.3f ms, fleet stats %.3f ms"),
+			NumCars, BytesPerCar, AddSeconds * 1000.0, ProximityMs, FleetStatsMs);
+		UE_LOG(LogTemp, Display, TEXT("VehicleCrowd: %d promotions: cold %.0f/s, pooled %.0f/s; demotions %.0f/s"),
+			NumPromoted, PerSecond(ColdPromoteSeconds), PerSecond(WarmPromoteSeconds), PerSecond(DemoteSeconds));
+	}));
@@ -0,0 +1,140 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VehicleBuild.h"
+#include "VehicleStatsBatch.h"
+#include "VehicleCrowdSubsystem.generated.h"
+
+class AVehicleActor;
+class UVehicleConfigDataAsset;
+
+/**
+ * Handle to a data-only vehicle owned by UVehicleCrowdSubsystem
+ */
+USTRUCT(BlueprintType)
+struct FVehicleCrowdHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = INDEX_NONE;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+/**
+ * Stores thousands of configured parked/traffic cars as plain data (build, transform, cached price)
+ * in contiguous arrays, and promotes them to real AVehicleActors through UVehicleActorPool when a
+ * player gets within TuneX.Crowd.PromoteRadius. They are demoted again beyond TuneX.Crowd.DemoteRadius.
+ *
+ * Headless benchmark: TuneX.Crowd.Benchmark [NumCars]
+ */
+UCLASS()
+class TUNEX_API UVehicleCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Adds a data-only vehicle
+	 * @param VehicleClass - Actor class used when the vehicle is promoted
+	 * @param Config - Catalog the build refers to
+	 * @param Build - The vehicle's build
+	 * @param Transform - Where the vehicle is parked (scale is ignored)
+	 * @return Handle to the vehicle
+	 */
+	FVehicleCrowdHandle AddVehicle(TSubclassOf<AVehicleActor> VehicleClass, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build, const FTransform& Transform);
+
+	/**
+	 * Removes a vehicle, returning its actor to the pool if it is promoted
+	 */
+	void RemoveVehicle(FVehicleCrowdHandle Handle);
+
+	/**
+	 * Changes a vehicle's build; a promoted actor applies it right away
+	 */
+	void SetVehicleBuild(FVehicleCrowdHandle Handle, const FVehicleBuild& Build);
+
+	/**
+	 * Gets the actor of a promoted vehicle
+	 * @return The actor, or nullptr while the vehicle is data-only
+	 */
+	AVehicleActor* GetPromotedActor(FVehicleCrowdHandle Handle) const;
+
+	/**
+	 * Runs one proximity pass and applies the resulting promotions and demotions
+	 * @param ViewerLocations - Points that promote nearby vehicles
+	 * @param PromoteRadius - Distance under which a data-only vehicle is promoted
+	 * @param DemoteRadius - Distance over which a promoted vehicle is demoted (keep above PromoteRadius)
+	 * @param MaxPromotions - Promotion budget for this pass
+	 * @param MaxDemotions - Demotion budget for this pass
+	 */
+	void UpdateProximity(TConstArrayView<FVector> ViewerLocations, float PromoteRadius, float DemoteRadius, int32 MaxPromotions, int32 MaxDemotions);
+
+	/**
+	 * Computes the performance stats of every vehicle in one parallel pass
+	 * @param Out - Receives one entry per vehicle, indexed by GetVehicleIndex
+	 */
+	void ComputeFleetStats(FVehicleStatsBatch& Out);
+
+	/**
+	 * Gets the position of a vehicle in per-vehicle outputs such as ComputeFleetStats
+	 * @return The index, or INDEX_NONE for a stale handle; changes when other vehicles are removed
+	 */
+	int32 GetVehicleIndex(FVehicleCrowdHandle Handle) const;
+
+	int32 GetNumVehicles() const { return Builds.Num(); }
+	int32 GetNumPromoted() const { return NumPromoted; }
+
+	/**
+	 * Gets the memory used by the per-vehicle arrays
+	 */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	void PromoteVehicle(int32 Index);
+	void DemoteVehicle(int32 Index);
+	uint16 FindOrAddConfig(UVehicleConfigDataAsset* Config);
+	uint16 FindOrAddClass(TSubclassOf<AVehicleActor> VehicleClass);
+
+	// Per-vehicle data, all indexed by dense index (swap-removed together)
+	TArray<FVehicleBuild> Builds;
+	TArray<FVector> Locations;
+	TArray<FQuat4f> Rotations;
+	TArray<float> CachedPrices;
+	TArray<uint16> ConfigIndices;
+	TArray<uint16> ClassIndices;
+	TArray<uint8> PromotedFlags;
+	TArray<int32> DenseToId;
+
+	// Actors of promoted vehicles, nullptr while data-only
+	UPROPERTY()
+	TArray<TObjectPtr<AVehicleActor>> PromotedActors;
+
+	// Handle id -> dense index, INDEX_NONE for free ids
+	TArray<int32> IdToDense;
+	TArray<int32> FreeIds;
+
+	// Proximity pass output (VehicleCrowd::EProximityChange), reused between passes
+	TArray<uint8> PendingChanges;
+
+	// Shared tables referenced by ConfigIndices / ClassIndices
+	UPROPERTY()
+	TArray<TObjectPtr<UVehicleConfigDataAsset>> ConfigTable;
+
+	UPROPERTY()
+	TArray<TSubclassOf<AVehicleActor>> ClassTable;
+
+	// Flattened stats of each ConfigTable entry, rebuilt when its catalog changes
+	TArray<FVehicleStatsTable> StatsTables;
+
+	int32 NumPromoted = 0;
+};
@@ -0,0 +1,192 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleDerivedDataCache.h"
+#include "TuneXStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Hash/CityHash.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Derived Data Hits"), STAT_TuneX_DerivedHits, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Derived Data Misses"), STAT_TuneX_DerivedMisses, STATGROUP_TuneX);
+
+static TAutoConsoleVariable<int32> CVarDerivedCacheSize(
+	TEXT("TuneX.Derived.CacheSize"),
+	8192,
+	TEXT("Maximum number of builds whose price, stats and part IDs are kept for reuse"));
+
+FVehicleBuildDerivedData FVehicleBuildDerivedData::Compute(const UVehicleConfigDataAsset& Config, const FVehicleBuild& Build)
+{
+	FVehicleBuildDerivedData Data;
+	Data.Stats = Config.BaseStats;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		const int32 PartIndex = Build.PartIndices[SlotIndex];
+		if (Parts.IsValidIndex(PartIndex))
+		{
+			const FCarPart& Part = Parts[PartIndex];
+			Data.PartIDs[SlotIndex] = Part.PartID;
+			Data.Stats += Part.Stats;
+			Data.TotalPrice += Part.Price;
+		}
+	}
+
+	if (Config.PaintColors.IsValidIndex(Build.PaintIndex))
+	{
+		const FPaintColor& Paint = Config.PaintColors[Build.PaintIndex];
+		Data.PaintID = Paint.PaintID;
+		Data.TotalPrice += Paint.Price;
+	}
+
+	return Data;
+}
+
+FVehicleDerivedDataCache& FVehicleDerivedDataCache::Get()
+{
+	static FVehicleDerivedDataCache Cache;
+	return Cache;
+}
+
+FVehicleBuildDerivedData FVehicleDerivedDataCache::GetOrCompute(const UVehicleConfigDataAsset& Config, uint32 CatalogFingerprint, const FVehicleBuild& Build)
+{
+	// Two catalogs with the same part IDs share a fingerprint, so the catalog itself is part of the key;
+	// otherwise they would keep evicting each other's entries from the same slot
+	const FObjectKey Catalog(&Config);
+	const uint64 Hash = CityHash128to64(Uint128_64(Build.GetCanonicalHash(CatalogFingerprint), GetTypeHash(Catalog)));
+	const uint32 ContentRevision = Config.GetContentRevision();
+	FShard& Shard = GetShard(Hash);
+
+	{
+		FScopeLock Lock(&Shard.Lock);
+		if (FEntry* Entry = Shard.Entries.Find(Hash))
+		{
+			// Same layout is not enough: prices, stats and names are not part of the fingerprint
+			if (Entry->Catalog == Catalog && Entry->ContentRevision == ContentRevision)
+			{
+				Entry->LastUsed = ++Shard.UseCounter;
+				NumHits.fetch_add(1, std::memory_order_relaxed);
+				INC_DWORD_STAT(STAT_TuneX_DerivedHits);
+				return Entry->Data;
+			}
+
+			NumStale.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	NumMisses.fetch_add(1, std::memory_order_relaxed);
+	INC_DWORD_STAT(STAT_TuneX_DerivedMisses);
+
+	// Computed outside the lock; a racing thread computing the same build just writes the same figures
+	FVehicleBuildDerivedData Data = FVehicleBuildDerivedData::Compute(Config, Build);
+
+	const int32 MaxEntriesPerShard = FMath::Max(1, CVarDerivedCacheSize.GetValueOnAnyThread() / NumShards);
+
+	FScopeLock Lock(&Shard.Lock);
+	FEntry& Entry = Shard.Entries.FindOrAdd(Hash);
+	Entry.Data = Data;
+	Entry.Catalog = Catalog;
+	Entry.ContentRevision = ContentRevision;
+	Entry.LastUsed = ++Shard.UseCounter;
+
+	if (Shard.Entries.Num() > MaxEntriesPerShard)
+	{
+		EvictOldest(Shard, MaxEntriesPerShard);
+	}
+
+	return Data;
+}
+
+void FVehicleDerivedDataCache::InvalidateCatalog(const UVehicleConfigDataAsset& Config)
+{
+	const FObjectKey Catalog(&Config);
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		for (auto It = Shard.Entries.CreateIterator(); It; ++It)
+		{
+			if (It->Value.Catalog == Catalog)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void FVehicleDerivedDataCache::Reset()
+{
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		Shard.Entries.Empty();
+		Shard.UseCounter = 0;
+	}
+
+	NumHits = 0;
+	NumMisses = 0;
+	NumStale = 0;
+	NumEvictions = 0;
+}
+
+FVehicleDerivedDataCacheStats FVehicleDerivedDataCache::GetStats() const
+{
+	FVehicleDerivedDataCacheStats Stats;
+	Stats.NumHits = NumHits.load(std::memory_order_relaxed);
+	Stats.NumMisses = NumMisses.load(std::memory_order_relaxed);
+	Stats.NumStale = NumStale.load(std::memory_order_relaxed);
+	Stats.NumEvictions = NumEvictions.load(std::memory_order_relaxed);
+
+	for (const FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		Stats.NumEntries += Shard.Entries.Num();
+	}
+
+	return Stats;
+}
+
+void FVehicleDerivedDataCache::EvictOldest(FShard& Shard, int32 MaxEntries)
+{
+	// Evicting a batch at a time keeps the sort off the common path
+	TArray<uint64, TInlineAllocator<1024>> UseStamps;
+	UseStamps.Reserve(Shard.Entries.Num());
+	for (const TPair<uint64, FEntry>& Pair : Shard.Entries)
+	{
+		UseStamps.Add(Pair.Value.LastUsed);
+	}
+	UseStamps.Sort();
+
+	const int32 NumToKeep = FMath::Max(1, MaxEntries * 3 / 4);
+	const uint64 OldestKept = UseStamps[UseStamps.Num() - NumToKeep];
+
+	const int32 NumBefore = Shard.Entries.Num();
+	for (auto It = Shard.Entries.CreateIterator(); It; ++It)
+	{
+		if (It->Value.LastUsed < OldestKept)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	NumEvictions.fetch_add(NumBefore - Shard.Entries.Num(), std::memory_order_relaxed);
+}
+
+static FAutoConsoleCommand GVehicleDerivedStatsCommand(
+	TEXT("TuneX.Derived.Stats"),
+	TEXT("Prints build derived data cache usage"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FVehicleDerivedDataCacheStats Stats = FVehicleDerivedDataCache::Get().GetStats();
+		const uint64 NumLookups = Stats.NumHits + Stats.NumMisses;
+		UE_LOG(LogTemp, Display, TEXT("VehicleDerivedDataCache: %d entries, %llu hits, %llu misses (%llu stale), %.1f%% hit rate, %llu evictions"),
+			Stats.NumEntries, Stats.NumHits, Stats.NumMisses, Stats.NumStale,
+			NumLookups > 0 ? 100.0 * Stats.NumHits / NumLookups : 0.0, Stats.NumEvictions);
+	}));
+
+static FAutoConsoleCommand GVehicleDerivedResetCommand(
+	TEXT("TuneX.Derived.Reset"),
+	TEXT("Empties the build derived data cache and zeroes its counters"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FVehicleDerivedDataCache::Get().Reset();
+	}));
@@ -0,0 +1,115 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "VehicleBuild.h"
+#include <atomic>
+
+/**
+ * Figures derived from a build and its catalog, shown wherever the build is
+ */
+struct TUNEX_API FVehicleBuildDerivedData
+{
+	// IDs of the selected parts (indexed by EVehiclePartSlot) and paint, NAME_None when empty
+	FName PartIDs[NumVehiclePartSlots];
+	FName PaintID;
+
+	// Catalog base stats plus every selected part
+	FVehiclePerformanceStats Stats;
+
+	float TotalPrice = 0.0f;
+
+	/**
+	 * Computes everything from the catalog
+	 */
+	static FVehicleBuildDerivedData Compute(const UVehicleConfigDataAsset& Config, const FVehicleBuild& Build);
+};
+
+/**
+ * Usage counters of FVehicleDerivedDataCache
+ */
+struct FVehicleDerivedDataCacheStats
+{
+	uint64 NumHits = 0;
+	uint64 NumMisses = 0;
+
+	// Misses on an entry computed before its catalog changed
+	uint64 NumStale = 0;
+
+	uint64 NumEvictions = 0;
+	int32 NumEntries = 0;
+};
+
+/**
+ * Bounded, thread-safe memo of FVehicleBuildDerivedData keyed by FVehicleBuild::GetCanonicalHash and the catalog
+ * The same few thousand builds recur constantly (showroom, garage, crowds), so their figures are computed once.
+ * Entries are spread over independently locked shards by hash; each shard drops its least recently used
+ * quarter when it goes over its share of TuneX.Derived.CacheSize.
+ *
+ * An entry remembers the catalog and content revision it was computed from, so editing a catalog (or
+ * UVehicleConfigDataAsset::InvalidateCatalogFingerprint) makes its entries miss and recompute.
+ *
+ * Stats: TuneX.Derived.Stats, reset with TuneX.Derived.Reset
+ */
+class TUNEX_API FVehicleDerivedDataCache
+{
+public:
+	static FVehicleDerivedDataCache& Get();
+
+	/**
+	 * Gets the derived data of a build, computing it on a miss
+	 * Any thread, as long as the catalog is not being edited at the same time. The fingerprint is passed in
+	 * because UVehicleConfigDataAsset::GetCatalogFingerprint caches it and is game thread only.
+	 * @param Config - The catalog the indices refer to
+	 * @param CatalogFingerprint - Config's GetCatalogFingerprint, read on the game thread
+	 * @param Build - The build
+	 */
+	FVehicleBuildDerivedData GetOrCompute(const UVehicleConfigDataAsset& Config, uint32 CatalogFingerprint, const FVehicleBuild& Build);
+
+	/**
+	 * Drops every entry computed from a catalog
+	 */
+	void InvalidateCatalog(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Drops every entry and zeroes the counters
+	 */
+	void Reset();
+
+	FVehicleDerivedDataCacheStats GetStats() const;
+
+private:
+	static constexpr int32 NumShards = 16;
+
+	struct FEntry
+	{
+		FVehicleBuildDerivedData Data;
+		FObjectKey Catalog;
+		uint32 ContentRevision = 0;
+		uint64 LastUsed = 0;
+	};
+
+	struct FShard
+	{
+		mutable FCriticalSection Lock;
+		TMap<uint64, FEntry> Entries;
+		uint64 UseCounter = 0;
+	};
+
+	// Top bits pick the shard; the map inside hashes the whole key
+	FShard& GetShard(uint64 Hash) { return Shards[Hash >> 60]; }
+
+	/**
+	 * Keeps the most recently used three quarters of a shard over its limit (shard lock held)
+	 */
+	void EvictOldest(FShard& Shard, int32 MaxEntries);
+
+	FShard Shards[NumShards];
+
+	std::atomic<uint64> NumHits{0};
+	std::atomic<uint64> NumMisses{0};
+	std::atomic<uint64> NumStale{0};
+	std::atomic<uint64> NumEvictions{0};
+};
@@ -0,0 +1,883 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleGarage.h"
+#include "VehicleMasterComponent.h"
+#include "CarPartData.h"
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+
+static TAutoConsoleVariable<float> CVarGarageCompactRatio(
+	TEXT("TuneX.Garage.CompactRatio"),
+	0.5f,
+	TEXT("Fraction of the garage journal that may be dead (overwritten or deleted records) before it is compacted"));
+
+namespace VehicleGarage
+{
+	static constexpr uint32 FileMagic = 0x47525854; // "TXRG"
+	static constexpr uint32 FormatVersion = 1;
+	static constexpr int64 FileHeaderSize = 2 * sizeof(uint32);
+
+	// Every record starts with its body size and the body's CRC
+	static constexpr int64 RecordPrefixSize = 2 * sizeof(uint32);
+
+	// Small journals are never worth compacting
+	static constexpr int64 MinCompactBytes = 64 * 1024;
+
+	enum class ERecordKind : uint8
+	{
+		Put = 1,
+		Delete = 2,
+	};
+
+	static void SerializeIndex(FArchive& Ar, int32& Index)
+	{
+		uint32 Packed = static_cast<uint32>(Index + 1);
+		Ar.SerializeIntPacked(Packed);
+		Index = static_cast<int32>(Packed) - 1;
+	}
+
+	/**
+	 * Record body: Kind, Id, then for Put the index fields followed by the build
+	 * The index fields come first so the scan can stop before the build.
+	 */
+	static void SerializeRecord(FArchive& Ar, ERecordKind& Kind, FGuid& Id, FVehicleGarageEntry* Entry, uint32* Fingerprint, FVehicleBuild* Build)
+	{
+		uint8 KindValue = static_cast<uint8>(Kind);
+		Ar << KindValue << Id;
+		Kind = static_cast<ERecordKind>(KindValue);
+
+		if (Kind != ERecordKind::Put || !Entry)
+		{
+			return;
+		}
+
+		int64 Ticks = Entry->SavedAt.GetTicks();
+		FString ConfigPath = Entry->Config.ToSoftObjectPath().ToString();
+		Ar << Ticks << ConfigPath << Entry->Name;
+		Entry->SavedAt = FDateTime(Ticks);
+		Entry->Config = TSoftObjectPtr<UVehicleConfigDataAsset>(FSoftObjectPath(ConfigPath));
+		Entry->Id = Id;
+
+		if (!Fingerprint || !Build)
+		{
+			return;
+		}
+
+		Ar << *Fingerprint;
+		for (int32& PartIndex : Build->PartIndices)
+		{
+			SerializeIndex(Ar, PartIndex);
+		}
+		SerializeIndex(Ar, Build->PaintIndex);
+	}
+}
+
+/**
+ * The journal file and where each live record is in it
+ * Only used from tasks on FVehicleGarage's pipe, so it needs no locking.
+ */
+class FVehicleGarageJournal
+{
+public:
+	explicit FVehicleGarageJournal(const FString& InFilename)
+		: Filename(InFilename)
+	{
+	}
+
+	/**
+	 * Opens (or creates) the journal and scans it, dropping a torn tail
+	 * A file of another format or version is moved aside to <Filename>.incompatible and a fresh journal started.
+	 * @param OutEntries - Index entries of the live builds
+	 * @return false if the journal cannot be read or written; appends then fail
+	 */
+	bool Open(TArray<FVehicleGarageEntry>& OutEntries)
+	{
+		using namespace VehicleGarage;
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+		// A crash between the two renames of a compaction leaves only the backup
+		const FString BackupFilename = Filename + TEXT(".bak");
+		if (!PlatformFile.FileExists(*Filename) && PlatformFile.FileExists(*BackupFilename))
+		{
+			PlatformFile.MoveFile(*Filename, *BackupFilename);
+		}
+		PlatformFile.DeleteFile(*BackupFilename);
+
+		PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+
+		TArray<uint8> Bytes;
+		if (TUniquePtr<IFileHandle> ReadHandle(PlatformFile.OpenRead(*Filename)); ReadHandle)
+		{
+			Bytes.SetNumUninitialized(ReadHandle->Size());
+			if (!ReadHandle->Read(Bytes.GetData(), Bytes.Num()))
+			{
+				return false;
+			}
+		}
+
+		TMap<FGuid, FVehicleGarageEntry> Entries;
+		Live.Reset();
+		LiveBytes = 0;
+
+		int64 ValidSize = 0;
+		if (Bytes.Num() >= FileHeaderSize)
+		{
+			uint32 Magic = 0;
+			uint32 Version = 0;
+			FMemory::Memcpy(&Magic, Bytes.GetData(), sizeof(uint32));
+			FMemory::Memcpy(&Version, Bytes.GetData() + sizeof(uint32), sizeof(uint32));
+			if (Magic != FileMagic || Version != FormatVersion)
+			{
+				// Kept for a build that can read it; saves go to a fresh journal rather than nowhere
+				const FString IncompatibleFilename = Filename + TEXT(".incompatible");
+				PlatformFile.DeleteFile(*IncompatibleFilename);
+				if (!PlatformFile.MoveFile(*IncompatibleFilename, *Filename))
+				{
+					UE_LOG(LogTemp, Error, TEXT("VehicleGarage: %s is not a garage journal of this version and cannot be moved aside"), *Filename);
+					return false;
+				}
+
+				UE_LOG(LogTemp, Warning, TEXT("VehicleGarage: %s is not a garage journal of this version, moved it to %s and starting a new one"),
+					*Filename, *IncompatibleFilename);
+				Bytes.Reset();
+			}
+			else
+			{
+				ValidSize = FileHeaderSize;
+			}
+		}
+
+		while (ValidSize + RecordPrefixSize <= Bytes.Num())
+		{
+			uint32 BodySize = 0;
+			uint32 BodyCrc = 0;
+			FMemory::Memcpy(&BodySize, Bytes.GetData() + ValidSize, sizeof(uint32));
+			FMemory::Memcpy(&BodyCrc, Bytes.GetData() + ValidSize + sizeof(uint32), sizeof(uint32));
+
+			const int64 BodyOffset = ValidSize + RecordPrefixSize;
+			if (BodyOffset + BodySize > Bytes.Num() || FCrc::MemCrc32(Bytes.GetData() + BodyOffset, BodySize) != BodyCrc)
+			{
+				break;
+			}
+
+			TArrayView<const uint8> Body(Bytes.GetData() + BodyOffset, BodySize);
+			FMemoryReaderView BodyReader(Body);
+			ERecordKind Kind = ERecordKind::Put;
+			FGuid Id;
+			FVehicleGarageEntry Entry;
+			SerializeRecord(BodyReader, Kind, Id, &Entry, nullptr, nullptr);
+			if (BodyReader.IsError())
+			{
+				break;
+			}
+
+			const int64 RecordSize = RecordPrefixSize + BodySize;
+			if (const FLocation* Previous = Live.Find(Id))
+			{
+				LiveBytes -= Previous->Size;
+			}
+
+			if (Kind == ERecordKind::Put)
+			{
+				Live.Add(Id, FLocation{ ValidSize, static_cast<int32>(RecordSize) });
+				LiveBytes += RecordSize;
+				Entries.Add(Id, MoveTemp(Entry));
+			}
+			else
+			{
+				Live.Remove(Id);
+				Entries.Remove(Id);
+			}
+
+			ValidSize += RecordSize;
+		}
+
+		Writer.Reset(PlatformFile.OpenWrite(*Filename, /*bAppend*/ true, /*bAllowRead*/ true));
+		if (!Writer)
+		{
+			UE_LOG(LogTemp, Error, TEXT("VehicleGarage: Cannot open %s for writing"), *Filename);
+			return false;
+		}
+
+		if (ValidSize < Bytes.Num())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleGarage: Dropping %lld bytes of incomplete records at the end of %s"), Bytes.Num() - ValidSize, *Filename);
+			Writer->Truncate(ValidSize);
+		}
+
+		if (ValidSize == 0)
+		{
+			WriteFileHeader(*Writer);
+			ValidSize = FileHeaderSize;
+		}
+
+		FileSize = ValidSize;
+		Writer->Seek(FileSize);
+
+		Reader.Reset(PlatformFile.OpenRead(*Filename, /*bAllowWrite*/ true));
+
+		Entries.GenerateValueArray(OutEntries);
+		return true;
+	}
+
+	/**
+	 * Appends one record
+	 * @param Body - Serialized record body
+	 */
+	bool Append(const FGuid& Id, VehicleGarage::ERecordKind Kind, const TArray<uint8>& Body)
+	{
+		using namespace VehicleGarage;
+
+		if (!Writer)
+		{
+			UE_LOG(LogTemp, Error, TEXT("VehicleGarage: %s is not open, record not saved"), *Filename);
+			return false;
+		}
+
+		uint32 Prefix[2] = { static_cast<uint32>(Body.Num()), FCrc::MemCrc32(Body.GetData(), Body.Num()) };
+
+		// One write per record, so a crash tears at most the last one
+		TArray<uint8, TInlineAllocator<256>> Record;
+		Record.Append(reinterpret_cast<const uint8*>(Prefix), sizeof(Prefix));
+		Record.Append(Body);
+
+		if (!Writer->Write(Record.GetData(), Record.Num()) || !Writer->Flush())
+		{
+			UE_LOG(LogTemp, Error, TEXT("VehicleGarage: Failed to append to %s"), *Filename);
+			return false;
+		}
+
+		if (const FLocation* Previous = Live.Find(Id))
+		{
+			LiveBytes -= Previous->Size;
+		}
+
+		if (Kind == ERecordKind::Put)
+		{
+			Live.Add(Id, FLocation{ FileSize, Record.Num() });
+			LiveBytes += Record.Num();
+		}
+		else
+		{
+			Live.Remove(Id);
+		}
+
+		FileSize += Record.Num();
+		++NumAppends;
+		return true;
+	}
+
+	/**
+	 * Reads the build of a live record
+	 */
+	bool ReadBuild(const FGuid& Id, uint32& OutFingerprint, FVehicleBuild& OutBuild)
+	{
+		using namespace VehicleGarage;
+
+		const FLocation* Location = Live.Find(Id);
+		if (!Location || !Reader)
+		{
+			return false;
+		}
+
+		TArray<uint8, TInlineAllocator<256>> Record;
+		Record.SetNumUninitialized(Location->Size);
+		if (!Reader->Seek(Location->Offset) || !Reader->Read(Record.GetData(), Record.Num()))
+		{
+			return false;
+		}
+		++NumReads;
+
+		TArrayView<const uint8> Body(Record.GetData() + RecordPrefixSize, Record.Num() - RecordPrefixSize);
+		FMemoryReaderView BodyReader(Body);
+		ERecordKind Kind = ERecordKind::Put;
+		FGuid RecordId;
+		FVehicleGarageEntry Entry;
+		SerializeRecord(BodyReader, Kind, RecordId, &Entry, &OutFingerprint, &OutBuild);
+
+		return !BodyReader.IsError() && RecordId == Id;
+	}
+
+	bool ShouldCompact() const
+	{
+		const int64 DeadBytes = FileSize - VehicleGarage::FileHeaderSize - LiveBytes;
+		return FileSize >= VehicleGarage::MinCompactBytes && DeadBytes > FileSize * CVarGarageCompactRatio.GetValueOnAnyThread();
+	}
+
+	/**
+	 * Copies the live records to a new file and swaps it in
+	 */
+	bool Compact()
+	{
+		using namespace VehicleGarage;
+
+		if (!Writer || !Reader)
+		{
+			return false;
+		}
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		const FString TempFilename = Filename + TEXT(".tmp");
+		const FString BackupFilename = Filename + TEXT(".bak");
+
+		// Copy in file order so the new file keeps the save order
+		TArray<TPair<FGuid, FLocation>> Records = Live.Array();
+		Records.Sort([](const TPair<FGuid, FLocation>& A, const TPair<FGuid, FLocation>& B) { return A.Value.Offset < B.Value.Offset; });
+
+		TMap<FGuid, FLocation> NewLive;
+		NewLive.Reserve(Records.Num());
+		int64 NewSize = FileHeaderSize;
+		{
+			TUniquePtr<IFileHandle> TempWriter(PlatformFile.OpenWrite(*TempFilename));
+			if (!TempWriter || !WriteFileHeader(*TempWriter))
+			{
+				return false;
+			}
+
+			TArray<uint8> Buffer;
+			for (const TPair<FGuid, FLocation>& Record : Records)
+			{
+				Buffer.SetNumUninitialized(Record.Value.Size, /*bAllowShrinking*/ false);
+				if (!Reader->Seek(Record.Value.Offset) || !Reader->Read(Buffer.GetData(), Record.Value.Size) || !TempWriter->Write(Buffer.GetData(), Record.Value.Size))
+				{
+					TempWriter.Reset();
+					PlatformFile.DeleteFile(*TempFilename);
+					return false;
+				}
+				NewLive.Add(Record.Key, FLocation{ NewSize, Record.Value.Size });
+				NewSize += Record.Value.Size;
+			}
+
+			if (!TempWriter->Flush())
+			{
+				TempWriter.Reset();
+				PlatformFile.DeleteFile(*TempFilename);
+				return false;
+			}
+		}
+
+		Writer.Reset();
+		Reader.Reset();
+
+		const bool bSwapped = PlatformFile.MoveFile(*BackupFilename, *Filename) && PlatformFile.MoveFile(*Filename, *TempFilename);
+		if (bSwapped)
+		{
+			PlatformFile.DeleteFile(*BackupFilename);
+			Live = MoveTemp(NewLive);
+			LiveBytes = NewSize - FileHeaderSize;
+			FileSize = NewSize;
+			++NumCompactions;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("VehicleGarage: Failed to replace %s with its compacted copy"), *Filename);
+			if (!PlatformFile.FileExists(*Filename))
+			{
+				PlatformFile.MoveFile(*Filename, *BackupFilename);
+			}
+			PlatformFile.DeleteFile(*TempFilename);
+		}
+
+		Writer.Reset(PlatformFile.OpenWrite(*Filename, /*bAppend*/ true, /*bAllowRead*/ true));
+		Reader.Reset(PlatformFile.OpenRead(*Filename, /*bAllowWrite*/ true));
+		if (Writer)
+		{
+			Writer->Seek(FileSize);
+		}
+		return bSwapped;
+	}
+
+	void Close()
+	{
+		Writer.Reset();
+		Reader.Reset();
+	}
+
+	// Read by the game thread for stats only; torn values are harmless there
+	std::atomic<int64> FileSize{ 0 };
+	std::atomic<int64> LiveBytes{ 0 };
+	std::atomic<uint64> NumAppends{ 0 };
+	std::atomic<uint64> NumCompactions{ 0 };
+	std::atomic<uint64> NumReads{ 0 };
+
+private:
+	struct FLocation
+	{
+		int64 Offset = 0;
+		int32 Size = 0;
+	};
+
+	static bool WriteFileHeader(IFileHandle& Handle)
+	{
+		const uint32 Header[2] = { VehicleGarage::FileMagic, VehicleGarage::FormatVersion };
+		return Handle.Write(reinterpret_cast<const uint8*>(Header), sizeof(Header));
+	}
+
+	FString Filename;
+	TUniquePtr<IFileHandle> Writer;
+	TUniquePtr<IFileHandle> Reader;
+
+	// Where the latest record of every live build is
+	TMap<FGuid, FLocation> Live;
+};
+
+TSharedRef<FVehicleGarage, ESPMode::ThreadSafe> FVehicleGarage::Create(const FString& Filename)
+{
+	return MakeShareable(new FVehicleGarage(Filename));
+}
+
+FVehicleGarage::FVehicleGarage(const FString& Filename)
+	: Journal(MakeShared<FVehicleGarageJournal, ESPMode::ThreadSafe>(Filename))
+	, Pipe(TEXT("VehicleGarage"))
+{
+}
+
+FVehicleGarage::~FVehicleGarage()
+{
+	Pipe.WaitUntilEmpty();
+	Journal->Close();
+}
+
+void FVehicleGarage::Open(TFunction<void()> OnIndexLoaded)
+{
+	TWeakPtr<FVehicleGarage, ESPMode::ThreadSafe> WeakThis = AsShared();
+	Pipe.Launch(TEXT("VehicleGarage.Open"), [Journal = Journal, WeakThis, OnIndexLoaded = MoveTemp(OnIndexLoaded)]() mutable
+	{
+		TArray<FVehicleGarageEntry> Entries;
+		const bool bOpened = Journal->Open(Entries);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bOpened, Entries = MoveTemp(Entries), OnIndexLoaded = MoveTemp(OnIndexLoaded)]() mutable
+		{
+			TSharedPtr<FVehicleGarage, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			if (!This)
+			{
+				return;
+			}
+
+			This->bJournalFailed = !bOpened;
+
+			// Saves made while the scan ran are newer than what it found
+			for (FVehicleGarageEntry& Entry : Entries)
+			{
+				if (!This->Index.Contains(Entry.Id) && !This->DeletedBeforeIndex.Contains(Entry.Id))
+				{
+					This->Index.Add(Entry.Id, MoveTemp(Entry));
+				}
+			}
+			This->DeletedBeforeIndex.Empty();
+			This->bIndexLoaded = true;
+
+			if (OnIndexLoaded)
+			{
+				OnIndexLoaded();
+			}
+		});
+	});
+}
+
+FGuid FVehicleGarage::SaveBuild(const UVehicleConfigDataAsset& Config, const FVehicleBuild& Build, const FString& Name, const FGuid& Id)
+{
+	check(IsInGameThread());
+
+	// The build would only live until the game closes
+	if (bJournalFailed)
+	{
+		UE_LOG(LogTemp, Error, TEXT("VehicleGarage: The garage journal could not be opened, build '%s' not saved"), *Name);
+		return FGuid();
+	}
+
+	FVehicleGarageEntry Entry;
+	Entry.Id = Id.IsValid() ? Id : FGuid::NewGuid();
+	Entry.Name = Name;
+	Entry.Config = TSoftObjectPtr<UVehicleConfigDataAsset>(FSoftObjectPath(&Config));
+	Entry.SavedAt = FDateTime::UtcNow();
+
+	FCachedBuild& Cached = Cache.FindOrAdd(Entry.Id);
+	Cached.CatalogFingerprint = Config.GetCatalogFingerprint();
+	Cached.Build = Build;
+
+	TArray<uint8> Body;
+	{
+		FMemoryWriter Writer(Body);
+		VehicleGarage::ERecordKind Kind = VehicleGarage::ERecordKind::Put;
+		FGuid RecordId = Entry.Id;
+		FVehicleGarageEntry RecordEntry = Entry;
+		uint32 Fingerprint = Cached.CatalogFingerprint;
+		FVehicleBuild RecordBuild = Build;
+		VehicleGarage::SerializeRecord(Writer, Kind, RecordId, &RecordEntry, &Fingerprint, &RecordBuild);
+	}
+
+	const FGuid SavedId = Entry.Id;
+	Index.Add(SavedId, MoveTemp(Entry));
+
+	Pipe.Launch(TEXT("VehicleGarage.Save"), [Journal = Journal, SavedId, Body = MoveTemp(Body)]()
+	{
+		Journal->Append(SavedId, VehicleGarage::ERecordKind::Put, Body);
+		if (Journal->ShouldCompact())
+		{
+			Journal->Compact();
+		}
+	});
+
+	return SavedId;
+}
+
+void FVehicleGarage::DeleteBuild(const FGuid& Id)
+{
+	check(IsInGameThread());
+
+	Index.Remove(Id);
+	Cache.Remove(Id);
+	if (!bIndexLoaded)
+	{
+		DeletedBeforeIndex.Add(Id);
+	}
+
+	TArray<uint8> Body;
+	{
+		FMemoryWriter Writer(Body);
+		VehicleGarage::ERecordKind Kind = VehicleGarage::ERecordKind::Delete;
+		FGuid RecordId = Id;
+		VehicleGarage::SerializeRecord(Writer, Kind, RecordId, nullptr, nullptr, nullptr);
+	}
+
+	Pipe.Launch(TEXT("VehicleGarage.Delete"), [Journal = Journal, Id, Body = MoveTemp(Body)]()
+	{
+		Journal->Append(Id, VehicleGarage::ERecordKind::Delete, Body);
+		if (Journal->ShouldCompact())
+		{
+			Journal->Compact();
+		}
+	});
+}
+
+void FVehicleGarage::LoadBuild(const FGuid& Id, FOnBuildLoaded OnLoaded)
+{
+	check(IsInGameThread());
+
+	if (const FCachedBuild* Cached = Cache.Find(Id))
+	{
+		++NumCacheHits;
+		OnLoaded(true, Cached->CatalogFingerprint, Cached->Build);
+		return;
+	}
+
+	TWeakPtr<FVehicleGarage, ESPMode::ThreadSafe> WeakThis = AsShared();
+	Pipe.Launch(TEXT("VehicleGarage.Load"), [Journal = Journal, WeakThis, Id, OnLoaded = MoveTemp(OnLoaded)]() mutable
+	{
+		FCachedBuild Loaded;
+		const bool bFound = Journal->ReadBuild(Id, Loaded.CatalogFingerprint, Loaded.Build);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Id, bFound, Loaded, OnLoaded = MoveTemp(OnLoaded)]()
+		{
+			TSharedPtr<FVehicleGarage, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			if (!This)
+			{
+				return;
+			}
+
+			// A save or delete issued while the read was queued wins over what was on disk
+			if (const FCachedBuild* Newer = This->Cache.Find(Id))
+			{
+				OnLoaded(true, Newer->CatalogFingerprint, Newer->Build);
+				return;
+			}
+
+			const bool bStillSaved = bFound && (This->Index.Contains(Id) || !This->bIndexLoaded);
+			if (bStillSaved)
+			{
+				This->Cache.Add(Id, Loaded);
+			}
+			OnLoaded(bStillSaved, Loaded.CatalogFingerprint, Loaded.Build);
+		});
+	});
+}
+
+void FVehicleGarage::GetEntries(const FSoftObjectPath& Config, TArray<FVehicleGarageEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+	for (const TPair<FGuid, FVehicleGarageEntry>& Pair : Index)
+	{
+		if (Pair.Value.Config.ToSoftObjectPath() == Config)
+		{
+			OutEntries.Add(Pair.Value);
+		}
+	}
+
+	OutEntries.Sort([](const FVehicleGarageEntry& A, const FVehicleGarageEntry& B) { return A.SavedAt > B.SavedAt; });
+}
+
+void FVehicleGarage::Compact()
+{
+	Pipe.Launch(TEXT("VehicleGarage.Compact"), [Journal = Journal]()
+	{
+		Journal->Compact();
+	});
+}
+
+void FVehicleGarage::Flush()
+{
+	Pipe.WaitUntilEmpty();
+}
+
+FVehicleGarageStats FVehicleGarage::GetStats() const
+{
+	FVehicleGarageStats Stats;
+	Stats.NumBuilds = Index.Num();
+	Stats.FileBytes = Journal->FileSize.load(std::memory_order_relaxed);
+	Stats.LiveBytes = Journal->LiveBytes.load(std::memory_order_relaxed);
+	Stats.NumAppends = Journal->NumAppends.load(std::memory_order_relaxed);
+	Stats.NumCompactions = Journal->NumCompactions.load(std::memory_order_relaxed);
+	Stats.NumDiskReads = Journal->NumReads.load(std::memory_order_relaxed);
+	Stats.NumCacheHits = NumCacheHits;
+	return Stats;
+}
+
+void UVehicleGarageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Garage = FVehicleGarage::Create(FPaths::ProjectSavedDir() / TEXT("SaveGames") / TEXT("Garage.txgarage"));
+
+	TWeakObjectPtr<UVehicleGarageSubsystem> WeakThis(this);
+	Garage->Open([WeakThis]()
+	{
+		if (UVehicleGarageSubsystem* This = WeakThis.Get())
+		{
+			UE_LOG(LogTemp, Log, TEXT("VehicleGarage: Index loaded, %d builds"), This->Garage->Num());
+			This->OnIndexLoaded.Broadcast();
+		}
+	});
+}
+
+void UVehicleGarageSubsystem::Deinitialize()
+{
+	// Pending saves are written before the game instance goes away
+	Garage.Reset();
+
+	Super::Deinitialize();
+}
+
+FGuid UVehicleGarageSubsystem::SaveVehicle(UVehicleMasterComponent* Vehicle, const FString& Name, FGuid Id)
+{
+	if (!Vehicle || !Vehicle->VehicleConfig)
+	{
+		return FGuid();
+	}
+	return Garage->SaveBuild(*Vehicle->VehicleConfig, Vehicle->GetCurrentBuild(), Name, Id);
+}
+
+void UVehicleGarageSubsystem::DeleteBuild(FGuid Id)
+{
+	Garage->DeleteBuild(Id);
+}
+
+void UVehicleGarageSubsystem::LoadIntoVehicle(UVehicleMasterComponent* Vehicle, FGuid Id)
+{
+	if (!Vehicle)
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UVehicleMasterComponent> WeakVehicle(Vehicle);
+	TWeakPtr<FVehicleGarage, ESPMode::ThreadSafe> WeakGarage(Garage);
+	Garage->LoadBuild(Id, [WeakVehicle, WeakGarage, Id](bool bFound, uint32 CatalogFingerprint, const FVehicleBuild& Build)
+	{
+		UVehicleMasterComponent* Target = WeakVehicle.Get();
+		if (!Target || !Target->VehicleConfig)
+		{
+			return;
+		}
+
+		if (!bFound)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleGarage: No saved build %s"), *Id.ToString());
+			return;
+		}
+
+		// Indices only mean something in the catalog they were saved against
+		const TSharedPtr<FVehicleGarage, ESPMode::ThreadSafe> PinnedGarage = WeakGarage.Pin();
+		const FVehicleGarageEntry* Entry = PinnedGarage ? PinnedGarage->FindEntry(Id) : nullptr;
+		if (Entry && Entry->Config.ToSoftObjectPath() != FSoftObjectPath(Target->VehicleConfig))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleGarage: Build %s belongs to '%s', not '%s'; not applied"),
+				*Id.ToString(), *Entry->Config.ToString(), *Target->VehicleConfig->GetPathName());
+			return;
+		}
+
+		// Builds store indices only, so there is nothing to remap by ID once the catalog's content moved on
+		if (CatalogFingerprint != Target->VehicleConfig->GetCatalogFingerprint())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("VehicleGarage: Build %s was saved against a different version of '%s'; not applied"),
+				*Id.ToString(), *Target->VehicleConfig->GetName());
+			return;
+		}
+
+		if (Build.IsValidFor(*Target->VehicleConfig))
+		{
+			Target->ApplyBuildAsync(Build);
+		}
+	});
+}
+
+TArray<FVehicleGarageEntry> UVehicleGarageSubsystem::GetBuilds(UVehicleConfigDataAsset* Config) const
+{
+	TArray<FVehicleGarageEntry> Entries;
+	if (Config)
+	{
+		Garage->GetEntries(FSoftObjectPath(Config), Entries);
+	}
+	return Entries;
+}
+
+bool UVehicleGarageSubsystem::IsIndexLoaded() const
+{
+	return Garage.IsValid() && Garage->IsIndexLoaded();
+}
+
+namespace VehicleGarage
+{
+	static void LogStats(const TCHAR* Label, const FVehicleGarage& Garage)
+	{
+		const FVehicleGarageStats Stats = Garage.GetStats();
+		UE_LOG(LogTemp, Display, TEXT("VehicleGarage: %s%d builds, %.1f KB file (%.1f KB live), %llu appends, %llu compactions, %llu disk reads, %llu cache hits"),
+			Label, Stats.NumBuilds, Stats.FileBytes / 1024.0, Stats.LiveBytes / 1024.0, Stats.NumAppends, Stats.NumCompactions, Stats.NumDiskReads, Stats.NumCacheHits);
+	}
+
+	static FVehicleGarage* GetGarage(UWorld* World)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UVehicleGarageSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UVehicleGarageSubsystem>() : nullptr;
+		return Subsystem ? Subsystem->GetGarage() : nullptr;
+	}
+}
+
+static FAutoConsoleCommandWithWorld GVehicleGarageStatsCommand(
+	TEXT("TuneX.Garage.Stats"),
+	TEXT("Prints the garage's build count, journal size and I/O counters"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (FVehicleGarage* Garage = VehicleGarage::GetGarage(World))
+		{
+			VehicleGarage::LogStats(TEXT(""), *Garage);
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld GVehicleGarageCompactCommand(
+	TEXT("TuneX.Garage.Compact"),
+	TEXT("Compacts the garage journal now"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (FVehicleGarage* Garage = VehicleGarage::GetGarage(World))
+		{
+			Garage->Compact();
+		}
+	}));
+
+static FAutoConsoleCommand GVehicleGarageBenchmarkCommand(
+	TEXT("TuneX.Garage.Benchmark"),
+	TEXT("Measures save, index load, on-demand read and compaction times on a scratch garage. Usage: TuneX.Garage.Benchmark [NumBuilds=10000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumBuilds = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+		const FString Filename = FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("GarageBenchmark.txgarage");
+		IFileManager::Get().Delete(*Filename);
+
+		UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage());
+		for (int32 PartIndex = 0; PartIndex < 8; ++PartIndex)
+		{
+			Config->FrontBumpers.AddDefaulted_GetRef().PartID = FName(*FString::Printf(TEXT("bench_bumper_%d"), PartIndex));
+			Config->Wheels.AddDefaulted_GetRef().PartID = FName(*FString::Printf(TEXT("bench_wheels_%d"), PartIndex));
+			Config->PaintColors.AddDefaulted_GetRef().PaintID = FName(*FString::Printf(TEXT("bench_paint_%d"), PartIndex));
+		}
+
+		auto PumpGameThread = []()
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		};
+
+		TArray<FGuid> Ids;
+		Ids.Reserve(NumBuilds);
+		double SaveCallSeconds = 0.0;
+		double SaveTotalSeconds = 0.0;
+		{
+			TSharedRef<FVehicleGarage, ESPMode::ThreadSafe> Garage = FVehicleGarage::Create(Filename);
+			Garage->Open(nullptr);
+			Garage->Flush();
+			PumpGameThread();
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 BuildIndex = 0; BuildIndex < NumBuilds; ++BuildIndex)
+			{
+				FVehicleBuild Build;
+				Build.SetPartIndex(EVehiclePartSlot::FrontBumper, BuildIndex % 8);
+				Build.SetPartIndex(EVehiclePartSlot::Wheels, (BuildIndex / 8) % 8);
+				Build.PaintIndex = (BuildIndex / 64) % 8;
+				Ids.Add(Garage->SaveBuild(*Config, Build, FString::Printf(TEXT("Build %d"), BuildIndex)));
+			}
+			SaveCallSeconds = FPlatformTime::Seconds() - StartTime;
+			Garage->Flush();
+			SaveTotalSeconds = FPlatformTime::Seconds() - StartTime;
+			VehicleGarage::LogStats(TEXT("after saving: "), *Garage);
+		}
+
+		// Cold open: a new garage on the same file
+		TSharedRef<FVehicleGarage, ESPMode::ThreadSafe> Garage = FVehicleGarage::Create(Filename);
+		double StartTime = FPlatformTime::Seconds();
+		Garage->Open(nullptr);
+		Garage->Flush();
+		PumpGameThread();
+		const double OpenSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const int32 NumLoads = FMath::Min(NumBuilds, 1000);
+		int32 NumLoaded = 0;
+		FRandomStream Random(NumBuilds);
+		StartTime = FPlatformTime::Seconds();
+		for (int32 LoadIndex = 0; LoadIndex < NumLoads; ++LoadIndex)
+		{
+			Garage->LoadBuild(Ids[Random.RandHelper(Ids.Num())], [&NumLoaded](bool bFound, uint32, const FVehicleBuild&)
+			{
+				NumLoaded += bFound ? 1 : 0;
+			});
+		}
+		Garage->Flush();
+		PumpGameThread();
+		const double LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+		// Overwriting most builds pushes the dead ratio over the threshold
+		StartTime = FPlatformTime::Seconds();
+		for (int32 BuildIndex = 0; BuildIndex < NumBuilds; BuildIndex += 4)
+		{
+			Garage->DeleteBuild(Ids[BuildIndex]);
+		}
+		for (int32 BuildIndex = 1; BuildIndex < NumBuilds; BuildIndex += 2)
+		{
+			FVehicleBuild Build;
+			Build.PaintIndex = BuildIndex % 8;
+			Garage->SaveBuild(*Config, Build, FString::Printf(TEXT("Build %d v2"), BuildIndex), Ids[BuildIndex]);
+		}
+		Garage->Flush();
+		const double ChurnSeconds = FPlatformTime::Seconds() - StartTime;
+		VehicleGarage::LogStats(TEXT("after churn: "), *Garage);
+
+		StartTime = FPlatformTime::Seconds();
+		Garage->Compact();
+		Garage->Flush();
+		const double CompactSeconds = FPlatformTime::Seconds() - StartTime;
+		VehicleGarage::LogStats(TEXT("after compaction: "), *Garage);
+
+		const FVehicleGarageStats Stats = Garage->GetStats();
+		UE_LOG(LogTemp, Display, TEXT("VehicleGarage: %d builds: save %.2f us/build on the game thread (%.1f ms until written), %.1f bytes/build, cold index load %.1f ms, %d/%d random reads in %.1f ms, churn %.1f ms, compaction %.1f ms"),
+			NumBuilds, SaveCallSeconds * 1.0e6 / NumBuilds, SaveTotalSeconds * 1000.0, static_cast<double>(Stats.LiveBytes) / FMath::Max(1, Stats.NumBuilds),
+			OpenSeconds * 1000.0, NumLoaded, NumLoads, LoadSeconds * 1000.0, ChurnSeconds * 1000.0, CompactSeconds * 1000.0);
+
+		Garage->Flush();
+		PumpGameThread();
+	}));
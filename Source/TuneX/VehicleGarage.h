@@ -0,0 +1,201 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tasks/Pipe.h"
+#include "VehicleBuild.h"
+#include "VehicleGarage.generated.h"
+
+class FVehicleGarageJournal;
+class UVehicleMasterComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnGarageIndexLoaded);
+
+/**
+ * Index entry of a saved build; the build itself is read on demand
+ */
+USTRUCT(BlueprintType)
+struct FVehicleGarageEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Garage")
+	FGuid Id;
+
+	// Name the player gave the build
+	UPROPERTY(BlueprintReadOnly, Category = "Garage")
+	FString Name;
+
+	// Catalog the build's indices refer to
+	UPROPERTY(BlueprintReadOnly, Category = "Garage")
+	TSoftObjectPtr<UVehicleConfigDataAsset> Config;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Garage")
+	FDateTime SavedAt;
+};
+
+/**
+ * Counters of one garage
+ */
+struct FVehicleGarageStats
+{
+	int32 NumBuilds = 0;
+	int64 FileBytes = 0;
+	int64 LiveBytes = 0;
+	uint64 NumAppends = 0;
+	uint64 NumCompactions = 0;
+	uint64 NumDiskReads = 0;
+	uint64 NumCacheHits = 0;
+};
+
+/**
+ * Player builds persisted in an append-only journal
+ * Every save or delete appends one small record (CRC-checked, so a torn tail from a crash is dropped on open);
+ * nothing is rewritten until dead records outweigh TuneX.Garage.CompactRatio of the file, when live records are
+ * copied to a fresh file that replaces the old one.
+ *
+ * Opening only builds the index (ID, name, catalog, date); builds are read when first requested and then cached.
+ * All file work runs in order on a background task pipe; results come back on the game thread.
+ */
+class TUNEX_API FVehicleGarage : public TSharedFromThis<FVehicleGarage, ESPMode::ThreadSafe>
+{
+public:
+	using FOnBuildLoaded = TFunction<void(bool bFound, uint32 CatalogFingerprint, const FVehicleBuild& Build)>;
+
+	static TSharedRef<FVehicleGarage, ESPMode::ThreadSafe> Create(const FString& Filename);
+
+	~FVehicleGarage();
+
+	/**
+	 * Scans the journal and fills the index
+	 * @param OnIndexLoaded - Called on the game thread once the index is ready
+	 */
+	void Open(TFunction<void()> OnIndexLoaded);
+
+	bool IsIndexLoaded() const { return bIndexLoaded; }
+
+	/**
+	 * Saves a build, appending one record
+	 * @param Config - Catalog the build refers to
+	 * @param Build - The build
+	 * @param Name - Player-facing name
+	 * @param Id - Build to overwrite; an invalid ID saves a new build
+	 * @return ID of the saved build, invalid if the journal could not be opened
+	 */
+	FGuid SaveBuild(const UVehicleConfigDataAsset& Config, const FVehicleBuild& Build, const FString& Name, const FGuid& Id = FGuid());
+
+	/**
+	 * Deletes a build, appending one record
+	 */
+	void DeleteBuild(const FGuid& Id);
+
+	/**
+	 * Gets a build, from the cache or from disk
+	 * @param OnLoaded - Called on the game thread; right away on a cache hit
+	 */
+	void LoadBuild(const FGuid& Id, FOnBuildLoaded OnLoaded);
+
+	const FVehicleGarageEntry* FindEntry(const FGuid& Id) const { return Index.Find(Id); }
+
+	/**
+	 * Gets the saved builds of one catalog, newest first
+	 */
+	void GetEntries(const FSoftObjectPath& Config, TArray<FVehicleGarageEntry>& OutEntries) const;
+
+	int32 Num() const { return Index.Num(); }
+
+	/**
+	 * Compacts now, whatever the dead ratio
+	 */
+	void Compact();
+
+	/**
+	 * Blocks until every queued file operation has finished
+	 * Their game-thread callbacks still run on the next task graph pump.
+	 */
+	void Flush();
+
+	FVehicleGarageStats GetStats() const;
+
+private:
+	explicit FVehicleGarage(const FString& Filename);
+
+	struct FCachedBuild
+	{
+		uint32 CatalogFingerprint = 0;
+		FVehicleBuild Build;
+	};
+
+	// Only touched by tasks on Pipe
+	TSharedRef<FVehicleGarageJournal, ESPMode::ThreadSafe> Journal;
+	UE::Tasks::FPipe Pipe;
+
+	// Game thread state
+	TMap<FGuid, FVehicleGarageEntry> Index;
+	TMap<FGuid, FCachedBuild> Cache;
+
+	// Deletes issued before the index arrived, so the scan does not bring them back
+	TSet<FGuid> DeletedBeforeIndex;
+
+	bool bIndexLoaded = false;
+
+	// Set once Open found the journal unusable; saves are refused instead of kept in memory only
+	bool bJournalFailed = false;
+
+	uint64 NumCacheHits = 0;
+};
+
+/**
+ * The player's garage, stored in Saved/SaveGames/Garage.txgarage
+ *
+ * Stats: TuneX.Garage.Stats, compaction: TuneX.Garage.Compact, benchmark: TuneX.Garage.Benchmark [NumBuilds]
+ */
+UCLASS()
+class TUNEX_API UVehicleGarageSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Saves a vehicle's current build
+	 * @param Vehicle - The vehicle
+	 * @param Name - Player-facing name
+	 * @param Id - Build to overwrite; leave invalid to save a new one
+	 * @return ID of the saved build, invalid if the vehicle has no catalog or the garage cannot be written
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Garage")
+	FGuid SaveVehicle(UVehicleMasterComponent* Vehicle, const FString& Name, FGuid Id);
+
+	UFUNCTION(BlueprintCallable, Category = "Garage")
+	void DeleteBuild(FGuid Id);
+
+	/**
+	 * Streams a saved build onto a vehicle
+	 * The build is read if it is not cached and applied through ApplyBuildAsync. Builds of another catalog, or saved
+	 * against another version of this one (its fingerprint differs), are not applied.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Garage")
+	void LoadIntoVehicle(UVehicleMasterComponent* Vehicle, FGuid Id);
+
+	/**
+	 * Gets the saved builds of a catalog, newest first
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Garage")
+	TArray<FVehicleGarageEntry> GetBuilds(UVehicleConfigDataAsset* Config) const;
+
+	UFUNCTION(BlueprintPure, Category = "Garage")
+	bool IsIndexLoaded() const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Garage")
+	FOnGarageIndexLoaded OnIndexLoaded;
+
+	FVehicleGarage* GetGarage() const { return Garage.Get(); }
+
+private:
+	TSharedPtr<FVehicleGarage, ESPMode::ThreadSafe> Garage;
+};
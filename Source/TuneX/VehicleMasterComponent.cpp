@@ -1,25 +1,163 @@
 // Copyright TuneX Project. All Rights Reserved.
 
 #include "VehicleMasterComponent.h"
+#include "VehicleAudioSubsystem.h"
+#include "VehicleDerivedDataCache.h"
+#include "VehicleGarage.h"
+#include "VehicleMeshMerger.h"
+#include "VehiclePopularity.h"
+#include "VehiclePartResidency.h"
+#include "TuningHitchWatchdog.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
 #include "Engine/StaticMesh.h"
 #include "Materials/MaterialInterface.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/GameInstance.h"
+#include "Net/UnrealNetwork.h"
+#include "Async/Async.h"
+#include "MeshDescription.h"
+#include "Tasks/Task.h"
+#include "HAL/IConsoleManager.h"
+
+namespace VehicleMasterAssets
+{
+	/** Loads through the residency manager when it is up, so the asset is tracked and budgeted */
+	static UObject* LoadTracked(const FSoftObjectPath& Path)
+	{
+		TUNEX_HITCH_PHASE(Load);
+		UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get();
+		UObject* Asset = Residency ? Residency->LoadSynchronous(Path) : Path.TryLoad();
+		TuneXHitchPhase.NoteAsset(Asset);
+		return Asset;
+	}
+
+	static TSharedPtr<FStreamableHandle> RequestAsyncLoad(const TArray<FSoftObjectPath>& Paths, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority)
+	{
+		if (UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get())
+		{
+			return Residency->RequestAsyncLoad(Paths, MoveTemp(OnLoaded), Priority);
+		}
+		return UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, MoveTemp(OnLoaded), Priority);
+	}
+
+	/** Mesh and material overrides of a part */
+	static void GatherPartAssets(const FCarPart& Part, TArray<FSoftObjectPath>& OutPaths)
+	{
+		if (!Part.MeshAsset.IsNull())
+		{
+			OutPaths.Add(Part.MeshAsset.ToSoftObjectPath());
+		}
+		for (const TSoftObjectPtr<UMaterialInterface>& Material : Part.MaterialOverrides)
+		{
+			if (!Material.IsNull())
+			{
+				OutPaths.Add(Material.ToSoftObjectPath());
+			}
+		}
+	}
+
+	/**
+	 * Replaces the override materials of a component with a single render state update, if any section differs
+	 * @param Materials - Material per section; nullptr shows the mesh's own material
+	 * @return Number of sections that changed
+	 */
+	static int32 SetOverrideMaterials(UMeshComponent* Component, TArray<TObjectPtr<UMaterialInterface>>&& Materials)
+	{
+		// Trailing empty overrides change nothing
+		while (Materials.Num() > 0 && !Materials.Last())
+		{
+			Materials.Pop(/*bAllowShrinking*/ false);
+		}
+
+		const TArray<TObjectPtr<UMaterialInterface>>& Current = Component->OverrideMaterials;
+		const int32 NumSections = FMath::Max(Current.Num(), Materials.Num());
+		int32 NumChanged = 0;
+		for (int32 Section = 0; Section < NumSections; ++Section)
+		{
+			const UMaterialInterface* Old = Current.IsValidIndex(Section) ? Current[Section].Get() : nullptr;
+			const UMaterialInterface* New = Materials.IsValidIndex(Section) ? Materials[Section].Get() : nullptr;
+			NumChanged += Old != New ? 1 : 0;
+		}
+
+		FVehiclePartApplyStats& Stats = FVehiclePartApplyStats::Get();
+		Stats.NumSectionsChanged += NumChanged;
+		Stats.NumSectionsUnchanged += NumSections - NumChanged;
+		if (NumChanged == 0)
+		{
+			++Stats.NumMaterialUpdatesAvoided;
+			return 0;
+		}
+		++Stats.NumMaterialUpdates;
+
+		// What SetMaterial does per section, once for all of them
+		Component->OverrideMaterials = MoveTemp(Materials);
+		Component->MarkCachedMaterialParameterNameIndicesDirty();
+		Component->MarkRenderStateDirty();
+		if (FBodyInstance* BodyInstance = Component->GetBodyInstance())
+		{
+			if (BodyInstance->IsValidBodyInstance())
+			{
+				BodyInstance->UpdatePhysicalMaterials();
+			}
+		}
+		return NumChanged;
+	}
+}
+
+FVehiclePartApplyStats& FVehiclePartApplyStats::Get()
+{
+	static FVehiclePartApplyStats Stats;
+	return Stats;
+}
 
 UVehicleMasterComponent::UVehicleMasterComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
 
-	CurrentFrontBumperIndex = 0;
-	CurrentRearBumperIndex = 0;
-	CurrentPaintIndex = 0;
+	SetIsReplicatedByDefault(true);
+
+	// Nothing is attached until InitializeVehicle or a setter runs
+	CurrentFrontBumperIndex = INDEX_NONE;
+	CurrentRearBumperIndex = INDEX_NONE;
+	CurrentPaintIndex = INDEX_NONE;
+	CurrentSideSkirtsIndex = INDEX_NONE;
+	CurrentSpoilerIndex = INDEX_NONE;
+	CurrentWheelsIndex = INDEX_NONE;
 
 	FrontBumperSocketName = FName("FrontBumperSocket");
 	RearBumperSocketName = FName("RearBumperSocket");
+	SideSkirtsSocketName = FName("SideSkirtsSocket");
+	SpoilerSocketName = FName("SpoilerSocket");
+	WheelsSocketName = FName("WheelsSocket");
 
 	FrontBumperComponent = nullptr;
 	RearBumperComponent = nullptr;
+	SideSkirtsComponent = nullptr;
+	SpoilerComponent = nullptr;
+	WheelsComponent = nullptr;
 	MainVehicleMesh = nullptr;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		PreviewPartIndices[SlotIndex] = INDEX_NONE;
+		PlaceholderBounds[SlotIndex] = FBox(ForceInit);
+	}
+	PlaceholderMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cube.Cube")));
+
+	bAutoBakeMergedMesh = false;
+	bInitializeOnBeginPlay = true;
+
+	SnapshotChannel = MakeShared<FVehicleSnapshotChannel, ESPMode::ThreadSafe>();
+}
+
+void UVehicleMasterComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UVehicleMasterComponent, ReplicatedBuild);
 }
 
 void UVehicleMasterComponent::BeginPlay()
@@ -43,7 +181,30 @@ void UVehicleMasterComponent::BeginPlay()
 		}
 	}
 
-	InitializeVehicle();
+	if (bInitializeOnBeginPlay)
+	{
+		InitializeVehicle();
+	}
+}
+
+void UVehicleMasterComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (PendingLoadHandle.IsValid())
+	{
+		PendingLoadHandle->CancelHandle();
+		PendingLoadHandle.Reset();
+	}
+
+	EndCompare(/*bKeepShown*/ true);
+
+	ReleaseAllPins();
+
+	if (UVehicleAudioSubsystem* Audio = GetWorld() ? GetWorld()->GetSubsystem<UVehicleAudioSubsystem>() : nullptr)
+	{
+		Audio->RemoveVehicle(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UVehicleMasterComponent::InitializeVehicle()
@@ -54,16 +215,42 @@ void UVehicleMasterComponent::InitializeVehicle()
 		return;
 	}
 
-	// Set default bumpers
-	if (VehicleConfig->FrontBumpers.Num() > 0)
+	// Clients take the server's build if it has already arrived
+	if (GetOwnerRole() != ROLE_Authority && ReplicatedBuild.CatalogFingerprint != 0)
+	{
+		OnRep_ReplicatedBuild();
+		return;
+	}
+
+	{
+		TGuardValue<bool> DefaultsGuard(bNotAPick, true);
+
+		// Set default bumpers
+		if (VehicleConfig->FrontBumpers.Num() > 0)
+		{
+			SetFrontBumperByIndex(VehicleConfig->DefaultFrontBumperIndex);
+		}
+
+		// Set default paint
+		if (VehicleConfig->PaintColors.Num() > 0)
+		{
+			SetPaintByIndex(VehicleConfig->DefaultPaintIndex);
+		}
+	}
+
+	if (GarageBuildId.IsValid())
 	{
-		SetFrontBumperByIndex(VehicleConfig->DefaultFrontBumperIndex);
+		UGameInstance* GameInstance = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+		if (UVehicleGarageSubsystem* Garage = GameInstance ? GameInstance->GetSubsystem<UVehicleGarageSubsystem>() : nullptr)
+		{
+			Garage->LoadIntoVehicle(this, GarageBuildId);
+		}
 	}
 
-	// Set default paint
-	if (VehicleConfig->PaintColors.Num() > 0)
+	// Stream in what players usually pick next while the showroom is idle
+	if (UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get())
 	{
-		SetPaintByIndex(VehicleConfig->DefaultPaintIndex);
+		Popularity->QueueWarmup(*VehicleConfig);
 	}
 
 	UE_LOG(LogTemp, Log, TEXT("VehicleMasterComponent: Vehicle initialized successfully"));
@@ -88,47 +275,93 @@ bool UVehicleMasterComponent::ValidateConfiguration() const
 
 bool UVehicleMasterComponent::SetFrontBumperByID(FName BumperID)
 {
-	if (!VehicleConfig)
+	return SetPartByID(EVehiclePartSlot::FrontBumper, BumperID);
+}
+
+bool UVehicleMasterComponent::SetFrontBumperByIndex(int32 Index)
+{
+	return SetPartByIndex(EVehiclePartSlot::FrontBumper, Index);
+}
+
+bool UVehicleMasterComponent::SetPartByID(EVehiclePartSlot Slot, FName PartID)
+{
+	if (!VehicleConfig || Slot >= EVehiclePartSlot::Count)
 	{
 		return false;
 	}
 
-	for (int32 i = 0; i < VehicleConfig->FrontBumpers.Num(); ++i)
+	const int32 Index = VehicleConfig->FindPartIndex(Slot, PartID);
+	if (Index != INDEX_NONE)
 	{
-		if (VehicleConfig->FrontBumpers[i].PartID == BumperID)
-		{
-			return SetFrontBumperByIndex(i);
-		}
+		return SetPartByIndex(Slot, Index);
 	}
 
-	UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Front bumper ID '%s' not found"), *BumperID.ToString());
+	UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: %s ID '%s' not found"), LexToString(Slot), *PartID.ToString());
 	return false;
 }
 
-bool UVehicleMasterComponent::SetFrontBumperByIndex(int32 Index)
+bool UVehicleMasterComponent::SetPartByIndex(EVehiclePartSlot Slot, int32 Index)
 {
-	if (!VehicleConfig || !VehicleConfig->FrontBumpers.IsValidIndex(Index))
+	TUNEX_HITCH_OPERATION("SetPart");
+
+	if (!VehicleConfig || Slot >= EVehiclePartSlot::Count || !VehicleConfig->GetParts(Slot).IsValidIndex(Index))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Invalid front bumper index %d"), Index);
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Invalid %s index %d"), LexToString(Slot), Index);
 		return false;
 	}
 
-	CurrentFrontBumperIndex = Index;
-	const FCarPart& BumperData = VehicleConfig->FrontBumpers[Index];
+	if (!bNotAPick)
+	{
+		RecordSelection(static_cast<int32>(Slot), Index);
+	}
+
+	UnbakeMergedMesh();
+
+	GetPartIndexRef(Slot) = Index;
+	PreviewPartIndices[static_cast<int32>(Slot)] = INDEX_NONE;
+	StatsDirtyMask |= 1u << static_cast<uint32>(Slot);
+	const FCarPart& PartData = VehicleConfig->GetParts(Slot)[Index];
+	TuneXHitchOperation.SetPartID(PartData.PartID);
 
-	// Create or get the bumper component
-	if (!FrontBumperComponent)
+	// Create or get the part component
+	UStaticMeshComponent*& PartComponent = GetPartComponentRef(Slot);
+	if (!PartComponent)
 	{
-		FrontBumperComponent = GetOrCreateBumperComponent(FName("FrontBumper"));
+		PartComponent = GetOrCreatePartComponent(FName(LexToString(Slot)), GetPartSocketName(Slot));
 	}
 
-	// Apply the mesh
-	ApplyBumperMesh(FrontBumperComponent, BumperData);
+	// Apply the mesh, undoing any placeholder sizing from a scrub
+	UndoScrubTransform(Slot);
+	ApplyBumperMesh(Slot, PartComponent, PartData);
 
-	// Broadcast the change event
-	OnBumperChanged.Broadcast(BumperData.PartID, BumperData.DisplayName);
+	if (PartComponent && PartComponent->GetStaticMesh())
+	{
+		PlaceholderBounds[static_cast<int32>(Slot)] = PartComponent->GetStaticMesh()->GetBoundingBox();
+	}
+
+	TArray<FSoftObjectPath> AppliedAssets;
+	VehicleMasterAssets::GatherPartAssets(PartData, AppliedAssets);
+	PinAppliedAssets(static_cast<int32>(Slot), MoveTemp(AppliedAssets));
 
-	UE_LOG(LogTemp, Log, TEXT("VehicleMasterComponent: Front bumper changed to '%s'"), *BumperData.DisplayName);
+	// Exhaust and intake parts change the engine note
+	if (UVehicleAudioSubsystem* Audio = GetWorld() ? GetWorld()->GetSubsystem<UVehicleAudioSubsystem>() : nullptr)
+	{
+		Audio->SetPartSound(this, Slot, PartData.SoundModifier);
+	}
+
+	// Broadcast the change events
+	{
+		TUNEX_HITCH_PHASE(Broadcast);
+		if (Slot == EVehiclePartSlot::FrontBumper)
+		{
+			OnBumperChanged.Broadcast(PartData.PartID, PartData.DisplayName);
+		}
+		OnPartChanged.Broadcast(Slot, PartData.PartID, PartData.DisplayName);
+	}
+
+	UpdateReplicatedBuild();
+
+	UE_LOG(LogTemp, Log, TEXT("VehicleMasterComponent: %s changed to '%s'"), LexToString(Slot), *PartData.DisplayName);
 
 	return true;
 }
@@ -140,12 +373,10 @@ bool UVehicleMasterComponent::SetPaintByID(FName PaintID)
 		return false;
 	}
 
-	for (int32 i = 0; i < VehicleConfig->PaintColors.Num(); ++i)
+	const int32 Index = VehicleConfig->FindPaintIndex(PaintID);
+	if (Index != INDEX_NONE)
 	{
-		if (VehicleConfig->PaintColors[i].PaintID == PaintID)
-		{
-			return SetPaintByIndex(i);
-		}
+		return SetPaintByIndex(Index);
 	}
 
 	UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Paint ID '%s' not found"), *PaintID.ToString());
@@ -154,20 +385,42 @@ bool UVehicleMasterComponent::SetPaintByID(FName PaintID)
 
 bool UVehicleMasterComponent::SetPaintByIndex(int32 Index)
 {
+	TUNEX_HITCH_OPERATION("SetPaint");
+
 	if (!VehicleConfig || !VehicleConfig->PaintColors.IsValidIndex(Index))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Invalid paint index %d"), Index);
 		return false;
 	}
 
+	if (!bNotAPick)
+	{
+		RecordSelection(VehicleBuildPaintBit, Index);
+	}
+
+	UnbakeMergedMesh();
+
 	CurrentPaintIndex = Index;
 	const FPaintColor& PaintData = VehicleConfig->PaintColors[Index];
+	TuneXHitchOperation.SetPartID(PaintData.PaintID);
 
 	// Apply the material
 	ApplyPaintMaterial(PaintData);
 
+	TArray<FSoftObjectPath> AppliedAssets;
+	if (!PaintData.Material.IsNull())
+	{
+		AppliedAssets.Add(PaintData.Material.ToSoftObjectPath());
+	}
+	PinAppliedAssets(VehicleBuildPaintBit, MoveTemp(AppliedAssets));
+
 	// Broadcast the change event
-	OnPaintChanged.Broadcast(PaintData.PaintID, PaintData.DisplayName);
+	{
+		TUNEX_HITCH_PHASE(Broadcast);
+		OnPaintChanged.Broadcast(PaintData.PaintID, PaintData.DisplayName);
+	}
+
+	UpdateReplicatedBuild();
 
 	UE_LOG(LogTemp, Log, TEXT("VehicleMasterComponent: Paint changed to '%s'"), *PaintData.DisplayName);
 
@@ -176,13 +429,18 @@ bool UVehicleMasterComponent::SetPaintByIndex(int32 Index)
 
 bool UVehicleMasterComponent::CycleNextFrontBumper()
 {
-	if (!VehicleConfig || VehicleConfig->FrontBumpers.Num() == 0)
+	return CycleNextPart(EVehiclePartSlot::FrontBumper);
+}
+
+bool UVehicleMasterComponent::CycleNextPart(EVehiclePartSlot Slot)
+{
+	if (!VehicleConfig || Slot >= EVehiclePartSlot::Count || VehicleConfig->GetParts(Slot).Num() == 0)
 	{
 		return false;
 	}
 
-	int32 NextIndex = (CurrentFrontBumperIndex + 1) % VehicleConfig->FrontBumpers.Num();
-	return SetFrontBumperByIndex(NextIndex);
+	int32 NextIndex = (GetPartIndex(Slot) + 1) % VehicleConfig->GetParts(Slot).Num();
+	return SetPartByIndex(Slot, NextIndex);
 }
 
 bool UVehicleMasterComponent::CycleNextPaint()
@@ -198,137 +456,1532 @@ bool UVehicleMasterComponent::CycleNextPaint()
 
 FCarPart UVehicleMasterComponent::GetCurrentFrontBumper() const
 {
-	if (VehicleConfig && VehicleConfig->FrontBumpers.IsValidIndex(CurrentFrontBumperIndex))
+	return GetCurrentPart(EVehiclePartSlot::FrontBumper);
+}
+
+FCarPart UVehicleMasterComponent::GetCurrentPart(EVehiclePartSlot Slot) const
+{
+	const int32 Index = GetPartIndex(Slot);
+	if (VehicleConfig && VehicleConfig->GetParts(Slot).IsValidIndex(Index))
 	{
-		return VehicleConfig->FrontBumpers[CurrentFrontBumperIndex];
+		return VehicleConfig->GetParts(Slot)[Index];
 	}
 	return FCarPart();
 }
 
-FPaintColor UVehicleMasterComponent::GetCurrentPaint() const
+int32 UVehicleMasterComponent::GetPartIndex(EVehiclePartSlot Slot) const
 {
-	if (VehicleConfig && VehicleConfig->PaintColors.IsValidIndex(CurrentPaintIndex))
+	if (Slot >= EVehiclePartSlot::Count)
 	{
-		return VehicleConfig->PaintColors[CurrentPaintIndex];
+		return INDEX_NONE;
 	}
-	return FPaintColor();
+	return const_cast<UVehicleMasterComponent*>(this)->GetPartIndexRef(Slot);
 }
 
-void UVehicleMasterComponent::ApplyBumperMesh(UStaticMeshComponent* BumperComponent, const FCarPart& PartData)
+FVehicleBuild UVehicleMasterComponent::GetCurrentBuild() const
 {
-	if (!BumperComponent)
+	FVehicleBuild Build;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
 	{
-		return;
+		Build.PartIndices[SlotIndex] = GetPartIndex(static_cast<EVehiclePartSlot>(SlotIndex));
+	}
+	Build.PaintIndex = CurrentPaintIndex;
+	return Build;
+}
+
+FVehiclePerformanceStats UVehicleMasterComponent::GetPerformanceStats() const
+{
+	return GetPerformanceStatsRef();
+}
+
+const FVehiclePerformanceStats& UVehicleMasterComponent::GetPerformanceStatsRef() const
+{
+	if (StatsDirtyMask != 0)
+	{
+		RefreshPerformanceStats();
 	}
+	return CachedPerformanceStats;
+}
 
-	// Load the mesh asset
-	if (PartData.MeshAsset.IsValid())
+void UVehicleMasterComponent::RefreshPerformanceStats() const
+{
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
 	{
-		UObject* LoadedAsset = PartData.MeshAsset.Get();
-		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(LoadedAsset))
+		if (!(StatsDirtyMask & (1u << SlotIndex)))
 		{
-			BumperComponent->SetStaticMesh(StaticMesh);
+			continue;
 		}
-		else
+
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		const int32 Index = GetPartIndex(Slot);
+		SlotStats[SlotIndex] = VehicleConfig && VehicleConfig->GetParts(Slot).IsValidIndex(Index)
+			? VehicleConfig->GetParts(Slot)[Index].Stats
+			: FVehiclePerformanceStats();
+	}
+
+	CachedPerformanceStats = VehicleConfig ? VehicleConfig->BaseStats : FVehiclePerformanceStats();
+	for (const FVehiclePerformanceStats& Contribution : SlotStats)
+	{
+		CachedPerformanceStats += Contribution;
+	}
+
+	StatsDirtyMask = 0;
+}
+
+void UVehicleMasterComponent::PublishSnapshot()
+{
+	FVehicleBuildSnapshot Snapshot;
+	Snapshot.Build = GetCurrentBuild();
+	Snapshot.Stats = GetPerformanceStatsRef();
+
+	if (VehicleConfig)
+	{
+		Snapshot.CatalogFingerprint = VehicleConfig->GetCatalogFingerprint();
+
+		const FVehicleBuildDerivedData Derived = FVehicleDerivedDataCache::Get().GetOrCompute(*VehicleConfig, Snapshot.CatalogFingerprint, Snapshot.Build);
+		Snapshot.TotalPrice = Derived.TotalPrice;
+		Snapshot.PaintID = Derived.PaintID;
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Mesh asset is not a StaticMesh"));
+			Snapshot.PartIDs[SlotIndex] = Derived.PartIDs[SlotIndex];
 		}
 	}
-	else if (!PartData.MeshAsset.IsNull())
+
+	SnapshotChannel->Publish(Snapshot);
+}
+
+void UVehicleMasterComponent::RefreshConstraintState() const
+{
+	UVehiclePartConstraintSubsystem* Rules = UVehiclePartConstraintSubsystem::Get();
+	if (!VehicleConfig || !Rules)
 	{
-		// Load asynchronously
-		PartData.MeshAsset.LoadSynchronous();
-		UObject* LoadedAsset = PartData.MeshAsset.Get();
-		if (UStaticMesh* StaticMesh = Cast<UStaticMesh>(LoadedAsset))
+		if (ConstraintState.GetConstraints())
 		{
-			BumperComponent->SetStaticMesh(StaticMesh);
+			ConstraintState.Reset(nullptr);
+			PendingValidOptionsMask = MAX_uint32;
 		}
+		return;
 	}
 
-	// Apply material overrides if any
-	if (PartData.MaterialOverrides.Num() > 0)
+	// Recompiled by the subsystem whenever the catalog's content changes
+	const FVehiclePartConstraintsRef Constraints = Rules->GetConstraints(*VehicleConfig);
+	if (ConstraintState.GetConstraints().Get() != &Constraints.Get())
 	{
-		for (int32 i = 0; i < PartData.MaterialOverrides.Num(); ++i)
+		ConstraintState.Reset(Constraints);
+	}
+	PendingValidOptionsMask |= ConstraintState.SetBuild(GetCurrentBuild());
+}
+
+bool UVehicleMasterComponent::IsPartOptionValid(EVehiclePartSlot Slot, int32 Index) const
+{
+	RefreshConstraintState();
+	return ConstraintState.IsOptionValid(Slot, Index);
+}
+
+TArray<int32> UVehicleMasterComponent::GetValidPartIndices(EVehiclePartSlot Slot) const
+{
+	const FVehicleSlotOptionMask& ValidOptions = GetValidOptions(Slot);
+	TArray<int32> Indices;
+	Indices.Reserve(ValidOptions.CountSetBits());
+	for (int32 Index = 0; Index < ValidOptions.Num(); ++Index)
+	{
+		if (ValidOptions.Get(Index))
 		{
-			if (PartData.MaterialOverrides[i].IsValid())
-			{
-				UMaterialInterface* Material = PartData.MaterialOverrides[i].Get();
-				BumperComponent->SetMaterial(i, Material);
-			}
-			else if (!PartData.MaterialOverrides[i].IsNull())
-			{
-				// Load synchronously
-				UMaterialInterface* Material = PartData.MaterialOverrides[i].LoadSynchronous();
-				if (Material)
-				{
-					BumperComponent->SetMaterial(i, Material);
-				}
-			}
+			Indices.Add(Index);
 		}
 	}
+	return Indices;
+}
 
-	BumperComponent->SetVisibility(true);
+bool UVehicleMasterComponent::IsCurrentBuildValid() const
+{
+	RefreshConstraintState();
+	return ConstraintState.IsBuildValid();
 }
 
-void UVehicleMasterComponent::ApplyPaintMaterial(const FPaintColor& PaintData)
+const FVehicleSlotOptionMask& UVehicleMasterComponent::GetValidOptions(EVehiclePartSlot Slot) const
 {
-	if (!MainVehicleMesh)
+	RefreshConstraintState();
+	return ConstraintState.GetValidOptions(Slot);
+}
+
+void UVehicleMasterComponent::ApplyBuildAsync(const FVehicleBuild& Build, bool bIsPlayerPick)
+{
+	if (!VehicleConfig)
 	{
 		return;
 	}
 
-	// Load the material
-	UMaterialInterface* Material = nullptr;
-	if (PaintData.Material.IsValid())
+	if (!Build.IsValidFor(*VehicleConfig))
 	{
-		Material = PaintData.Material.Get();
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Build does not match the current configuration, ignoring"));
+		return;
 	}
-	else if (!PaintData.Material.IsNull())
+
+	// A newer build supersedes whatever is still loading
+	if (PendingLoadHandle.IsValid())
 	{
-		Material = PaintData.Material.LoadSynchronous();
+		PendingLoadHandle->CancelHandle();
+		PendingLoadHandle.Reset();
 	}
+	PendingBuild = Build;
 
-	if (Material)
+	// Only the slots that actually change (or whose entry was edited) need their assets
+	const uint32 ChangedMask = Build.GetChangedMask(GetCurrentBuild()) | ForcedReapplyMask;
+	TArray<FSoftObjectPath> AssetsToLoad;
+
+	if (bIsPlayerPick && !bNotAPick)
 	{
-		// Apply to all material slots (typically paint affects the body)
-		// For more control, you might want to specify which slots to affect
-		int32 NumMaterials = MainVehicleMesh->GetNumMaterials();
-		for (int32 i = 0; i < NumMaterials; ++i)
+		// Before anything streams in, so prefetch hits are told apart from loads; re-applied entries are no picks
+		const uint32 PickedMask = Build.GetChangedMask(GetCurrentBuild()) & ~ForcedReapplyMask;
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			if ((PickedMask & (1u << SlotIndex)) && Build.PartIndices[SlotIndex] != INDEX_NONE)
+			{
+				RecordSelection(SlotIndex, Build.PartIndices[SlotIndex]);
+			}
+		}
+		if ((PickedMask & (1u << VehicleBuildPaintBit)) && Build.PaintIndex != INDEX_NONE)
 		{
-			MainVehicleMesh->SetMaterial(i, Material);
+			RecordSelection(VehicleBuildPaintBit, Build.PaintIndex);
 		}
 	}
-	else
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Failed to load paint material"));
+		const int32 PartIndex = Build.PartIndices[SlotIndex];
+		if (!(ChangedMask & (1u << SlotIndex)) || PartIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		VehicleMasterAssets::GatherPartAssets(VehicleConfig->GetParts(static_cast<EVehiclePartSlot>(SlotIndex))[PartIndex], AssetsToLoad);
+	}
+
+	if ((ChangedMask & (1u << VehicleBuildPaintBit)) && Build.PaintIndex != INDEX_NONE)
+	{
+		const FPaintColor& Paint = VehicleConfig->PaintColors[Build.PaintIndex];
+		if (!Paint.Material.IsNull())
+		{
+			AssetsToLoad.Add(Paint.Material.ToSoftObjectPath());
+		}
+	}
+
+	if (AssetsToLoad.Num() == 0)
+	{
+		OnBuildAssetsLoaded();
+		return;
 	}
+
+	PendingLoadHandle = VehicleMasterAssets::RequestAsyncLoad(
+		AssetsToLoad,
+		FStreamableDelegate::CreateUObject(this, &UVehicleMasterComponent::OnBuildAssetsLoaded),
+		FStreamableManager::AsyncLoadHighPriority);
 }
 
-UStaticMeshComponent* UVehicleMasterComponent::GetOrCreateBumperComponent(FName ComponentName)
+void UVehicleMasterComponent::OnBuildAssetsLoaded()
 {
-	AActor* Owner = GetOwner();
-	if (!Owner)
+	TUNEX_HITCH_OPERATION("ApplyBuild");
+
+	if (!VehicleConfig || !PendingBuild.IsValidFor(*VehicleConfig))
 	{
-		return nullptr;
+		return;
 	}
 
-	// Try to find existing component
-	UStaticMeshComponent* Component = Cast<UStaticMeshComponent>(
-		Owner->GetDefaultSubobjectByName(ComponentName)
-	);
+	// Everything is resident now, so the regular setters apply without loading
+	const uint32 ForcedMask = ForcedReapplyMask;
+	ForcedReapplyMask = 0;
+	const uint32 ChangedMask = PendingBuild.GetChangedMask(GetCurrentBuild()) | ForcedMask;
 
-	if (!Component)
 	{
-		// Create new component
-		Component = NewObject<UStaticMeshComponent>(Owner, UStaticMeshComponent::StaticClass(), ComponentName);
-		if (Component)
+		// Picks were counted when the build was requested, while residency still meant something;
+		// the build is published once for all slots
+		TGuardValue<bool> NotAPickGuard(bNotAPick, true);
+		TGuardValue<bool> BatchGuard(bBatchingBuildUpdates, true);
+
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
 		{
-			Component->RegisterComponent();
-			Component->AttachToComponent(MainVehicleMesh, FAttachmentTransformRules::KeepRelativeTransform);
-			Component->SetRelativeLocation(FVector::ZeroVector);
-			Component->SetRelativeRotation(FRotator::ZeroRotator);
+			if (!(ChangedMask & (1u << SlotIndex)))
+			{
+				continue;
+			}
+
+			const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+			if (PendingBuild.PartIndices[SlotIndex] == INDEX_NONE)
+			{
+				ClearPart(Slot);
+			}
+			else
+			{
+				SetPartByIndex(Slot, PendingBuild.PartIndices[SlotIndex]);
+			}
+		}
+
+		if (ChangedMask & (1u << VehicleBuildPaintBit))
+		{
+			if (PendingBuild.PaintIndex == INDEX_NONE)
+			{
+				ClearPaint();
+			}
+			else
+			{
+				SetPaintByIndex(PendingBuild.PaintIndex);
+			}
 		}
 	}
 
-	return Component;
+	if (bBuildUpdatePending)
+	{
+		bBuildUpdatePending = false;
+		UpdateReplicatedBuild();
+	}
+
+	if (bAutoBakeMergedMesh)
+	{
+		BakeMergedMesh();
+	}
 }
+
+void UVehicleMasterComponent::ResetForReuse(UMeshComponent* ChassisMesh, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build)
+{
+	PrepareForPool();
+
+	if (ChassisMesh && ChassisMesh != MainVehicleMesh)
+	{
+		// Parts are attached to the old chassis' sockets; start over on the new one
+		UnbakeMergedMesh();
+		MainVehicleMesh = ChassisMesh;
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+			if (UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot))
+			{
+				PartComponent->AttachToComponent(MainVehicleMesh, FAttachmentTransformRules::KeepRelativeTransform, GetPartSocketName(Slot));
+			}
+		}
+	}
+
+	SetVehicleConfig(Config);
+	ApplyBuildAsync(Build);
+
+	UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get();
+	if (Popularity && VehicleConfig)
+	{
+		Popularity->QueueWarmup(*VehicleConfig);
+	}
+}
+
+void UVehicleMasterComponent::RecordSelection(int32 SlotBit, int32 Index) const
+{
+	UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get();
+	if (!Popularity || !VehicleConfig)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> Assets;
+	if (SlotBit == VehicleBuildPaintBit)
+	{
+		Assets.Add(VehicleConfig->PaintColors[Index].Material.ToSoftObjectPath());
+	}
+	else
+	{
+		VehicleMasterAssets::GatherPartAssets(VehicleConfig->GetParts(static_cast<EVehiclePartSlot>(SlotBit))[Index], Assets);
+	}
+
+	const bool bWasResident = !Assets.ContainsByPredicate([](const FSoftObjectPath& Path)
+	{
+		return !Path.IsNull() && !Path.ResolveObject();
+	});
+	Popularity->RecordSelection(*VehicleConfig, SlotBit, Index, bWasResident);
+}
+
+void UVehicleMasterComponent::PrepareForPool()
+{
+	if (PendingLoadHandle.IsValid())
+	{
+		PendingLoadHandle->CancelHandle();
+		PendingLoadHandle.Reset();
+	}
+	PendingBuild = FVehicleBuild();
+	ForcedReapplyMask = 0;
+
+	EndCompare(/*bKeepShown*/ true);
+	CancelPreview();
+
+	if (bMergePending)
+	{
+		UnbakeMergedMesh();
+	}
+}
+
+bool UVehicleMasterComponent::BeginCompare(const FVehicleBuild& OtherBuild)
+{
+	if (!VehicleConfig || !OtherBuild.IsValidFor(*VehicleConfig))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Build to compare does not match the current configuration, ignoring"));
+		return false;
+	}
+
+	EndCompare(/*bKeepShown*/ true);
+
+	CompareBuilds[0] = GetCurrentBuild();
+	CompareBuilds[1] = OtherBuild;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (CompareBuilds[1].PartIndices[SlotIndex] == INDEX_NONE)
+		{
+			CompareBuilds[1].PartIndices[SlotIndex] = CompareBuilds[0].PartIndices[SlotIndex];
+		}
+	}
+	if (CompareBuilds[1].PaintIndex == INDEX_NONE)
+	{
+		CompareBuilds[1].PaintIndex = CompareBuilds[0].PaintIndex;
+	}
+
+	CompareSide = 0;
+	bComparing = true;
+	bCompareStaged = false;
+
+	// Each toggle publishes the other side's price and stats
+	FVehicleDerivedDataCache::Get().GetOrCompute(*VehicleConfig, VehicleConfig->GetCatalogFingerprint(), CompareBuilds[1]);
+
+	StageCompareBuilds();
+	return true;
+}
+
+bool UVehicleMasterComponent::ToggleCompare()
+{
+	TUNEX_HITCH_OPERATION("ToggleCompare");
+
+	if (!IsCompareReady() || !VehicleConfig)
+	{
+		return false;
+	}
+
+	// Whatever was changed on the shown side belongs to it now, and has to stay resident once hidden
+	const FVehicleBuild Shown = GetCurrentBuild();
+	if (Shown != CompareBuilds[CompareSide])
+	{
+		CompareBuilds[CompareSide] = Shown;
+		StageCompareBuilds();
+	}
+
+	const FVehicleBuild& Target = CompareBuilds[1 - CompareSide];
+	if (!Target.IsValidFor(*VehicleConfig))
+	{
+		return false;
+	}
+
+	// A toggle supersedes whatever was loading or previewed
+	if (PendingLoadHandle.IsValid())
+	{
+		PendingLoadHandle->CancelHandle();
+		PendingLoadHandle.Reset();
+	}
+	PendingBuild = FVehicleBuild();
+	ForcedReapplyMask = 0;
+	CancelPreview();
+
+	const uint32 DiffMask = Shown.GetChangedMask(Target);
+	{
+		// Switching sides is not a pick, and the build is published once for all slots
+		TGuardValue<bool> NotAPickGuard(bNotAPick, true);
+		TGuardValue<bool> BatchGuard(bBatchingBuildUpdates, true);
+
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			if (!(DiffMask & (1u << SlotIndex)))
+			{
+				continue;
+			}
+
+			const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+			if (Target.PartIndices[SlotIndex] == INDEX_NONE)
+			{
+				ClearPart(Slot);
+			}
+			else
+			{
+				SetPartByIndex(Slot, Target.PartIndices[SlotIndex]);
+			}
+		}
+
+		if (DiffMask & (1u << VehicleBuildPaintBit))
+		{
+			if (Target.PaintIndex == INDEX_NONE)
+			{
+				ClearPaint();
+			}
+			else
+			{
+				SetPaintByIndex(Target.PaintIndex);
+			}
+		}
+	}
+
+	CompareSide = 1 - CompareSide;
+
+	if (bBuildUpdatePending)
+	{
+		bBuildUpdatePending = false;
+		UpdateReplicatedBuild();
+	}
+
+	if (DiffMask != 0 && bAutoBakeMergedMesh)
+	{
+		BakeMergedMesh();
+	}
+
+	return true;
+}
+
+void UVehicleMasterComponent::EndCompare(bool bKeepShown)
+{
+	if (!bComparing)
+	{
+		return;
+	}
+
+	// Switch back while side 0 is still held resident
+	if (!bKeepShown && CompareSide == 1)
+	{
+		if (IsCompareReady())
+		{
+			ToggleCompare();
+		}
+		else
+		{
+			ApplyBuildAsync(CompareBuilds[0]);
+		}
+	}
+
+	bComparing = false;
+	bCompareStaged = false;
+	CompareSide = 0;
+
+	if (CompareLoadHandle.IsValid())
+	{
+		CompareLoadHandle->CancelHandle();
+		CompareLoadHandle.Reset();
+	}
+}
+
+FVehicleBuild UVehicleMasterComponent::GetCompareBuild(int32 Side) const
+{
+	if (!bComparing || (Side != 0 && Side != 1))
+	{
+		return FVehicleBuild();
+	}
+	return Side == CompareSide ? GetCurrentBuild() : CompareBuilds[Side];
+}
+
+uint32 UVehicleMasterComponent::GetCompareDiffMask() const
+{
+	return bComparing ? GetCurrentBuild().GetChangedMask(CompareBuilds[1 - CompareSide]) : 0;
+}
+
+TArray<EVehiclePartSlot> UVehicleMasterComponent::GetCompareDiff(bool& bOutPaintDiffers) const
+{
+	const uint32 DiffMask = GetCompareDiffMask();
+
+	TArray<EVehiclePartSlot> Slots;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (DiffMask & (1u << SlotIndex))
+		{
+			Slots.Add(static_cast<EVehiclePartSlot>(SlotIndex));
+		}
+	}
+
+	bOutPaintDiffers = (DiffMask & (1u << VehicleBuildPaintBit)) != 0;
+	return Slots;
+}
+
+void UVehicleMasterComponent::StageCompareBuilds()
+{
+	TArray<FSoftObjectPath> AssetsToLoad;
+	for (const FVehicleBuild& Build : CompareBuilds)
+	{
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			const TArray<FCarPart>& Parts = VehicleConfig->GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+			if (Parts.IsValidIndex(Build.PartIndices[SlotIndex]))
+			{
+				VehicleMasterAssets::GatherPartAssets(Parts[Build.PartIndices[SlotIndex]], AssetsToLoad);
+			}
+		}
+
+		if (VehicleConfig->PaintColors.IsValidIndex(Build.PaintIndex))
+		{
+			const FPaintColor& Paint = VehicleConfig->PaintColors[Build.PaintIndex];
+			if (!Paint.Material.IsNull())
+			{
+				AssetsToLoad.Add(Paint.Material.ToSoftObjectPath());
+			}
+		}
+	}
+
+	// Request the new set before letting go of the old one, so shared assets never drop out
+	TSharedPtr<FStreamableHandle> PreviousHandle = MoveTemp(CompareLoadHandle);
+
+	if (AssetsToLoad.Num() > 0)
+	{
+		CompareLoadHandle = VehicleMasterAssets::RequestAsyncLoad(
+			AssetsToLoad,
+			FStreamableDelegate::CreateUObject(this, &UVehicleMasterComponent::OnCompareAssetsLoaded),
+			FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (PreviousHandle.IsValid())
+	{
+		PreviousHandle->ReleaseHandle();
+	}
+
+	if (!CompareLoadHandle.IsValid() || CompareLoadHandle->HasLoadCompleted())
+	{
+		OnCompareAssetsLoaded();
+	}
+}
+
+void UVehicleMasterComponent::OnCompareAssetsLoaded()
+{
+	// Restaging after a toggle finds the comparison ready already
+	if (!bComparing || bCompareStaged)
+	{
+		return;
+	}
+
+	bCompareStaged = true;
+	OnCompareReady.Broadcast();
+}
+
+void UVehicleMasterComponent::SetVehicleConfig(UVehicleConfigDataAsset* NewConfig)
+{
+	if (NewConfig == VehicleConfig)
+	{
+		return;
+	}
+
+	EndCompare(/*bKeepShown*/ true);
+
+	if (PendingLoadHandle.IsValid())
+	{
+		PendingLoadHandle->CancelHandle();
+		PendingLoadHandle.Reset();
+	}
+	PendingBuild = FVehicleBuild();
+	ForcedReapplyMask = 0;
+
+	UnbakeMergedMesh();
+	ReleaseAllPins();
+
+	if (UVehicleAudioSubsystem* Audio = GetWorld() ? GetWorld()->GetSubsystem<UVehicleAudioSubsystem>() : nullptr)
+	{
+		Audio->RemoveVehicle(this);
+	}
+
+	VehicleConfig = NewConfig;
+
+	// Indices of the previous catalog mean nothing in the new one
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		GetPartIndexRef(Slot) = INDEX_NONE;
+		PreviewPartIndices[SlotIndex] = INDEX_NONE;
+		PlaceholderBounds[SlotIndex] = FBox(ForceInit);
+		if (UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot))
+		{
+			PartComponent->SetStaticMesh(nullptr);
+			PartComponent->SetVisibility(false);
+		}
+	}
+
+	// The previous catalog's paint goes too; the chassis shows its own materials until a paint is set
+	if (MainVehicleMesh)
+	{
+		VehicleMasterAssets::SetOverrideMaterials(MainVehicleMesh, TArray<TObjectPtr<UMaterialInterface>>());
+	}
+	CurrentPaintIndex = INDEX_NONE;
+	StatsDirtyMask = MAX_uint32;
+
+	UpdateReplicatedBuild();
+}
+
+bool UVehicleMasterComponent::PreviewPartByIndex(EVehiclePartSlot Slot, int32 Index)
+{
+	TUNEX_HITCH_OPERATION("PreviewPart");
+
+	if (!VehicleConfig || Slot >= EVehiclePartSlot::Count || !VehicleConfig->GetParts(Slot).IsValidIndex(Index))
+	{
+		return false;
+	}
+
+	UnbakeMergedMesh();
+
+	UStaticMeshComponent*& PartComponent = GetPartComponentRef(Slot);
+	if (!PartComponent)
+	{
+		PartComponent = GetOrCreatePartComponent(FName(LexToString(Slot)), GetPartSocketName(Slot));
+		if (!PartComponent)
+		{
+			return false;
+		}
+	}
+
+	PreviewPartIndices[static_cast<int32>(Slot)] = Index;
+	const FCarPart& PartData = VehicleConfig->GetParts(Slot)[Index];
+
+	// Only what is already in memory; nothing here may hit the disk
+	UStaticMesh* DisplayMesh = Cast<UStaticMesh>(PartData.MeshAsset.Get());
+	if (!DisplayMesh)
+	{
+		DisplayMesh = PartData.ProxyMesh.Get();
+	}
+
+	FTransform RelativeTransform = FTransform::Identity;
+	if (!DisplayMesh)
+	{
+		// The placeholder is engine content and tiny, so loading it once is fine
+		DisplayMesh = PlaceholderMesh.LoadSynchronous();
+
+		// Baked bounds size the placeholder like the part itself, otherwise it takes the size of the last real mesh
+		const FBox& TargetBounds = PartData.Metadata.IsBakedFor(PartData.MeshAsset) && PartData.Metadata.Bounds.IsValid
+			? PartData.Metadata.Bounds : PlaceholderBounds[static_cast<int32>(Slot)];
+		if (DisplayMesh && TargetBounds.IsValid)
+		{
+			const FBox MeshBounds = DisplayMesh->GetBoundingBox();
+			const FVector Scale = TargetBounds.GetSize() / MeshBounds.GetSize().ComponentMax(FVector(UE_KINDA_SMALL_NUMBER));
+			RelativeTransform.SetScale3D(Scale);
+			RelativeTransform.SetTranslation(TargetBounds.GetCenter() - MeshBounds.GetCenter() * Scale);
+		}
+	}
+
+	// Placeholder sizing goes on top of the component's own offset, which is put back once the scrub ends
+	const uint32 SlotBit = 1u << static_cast<uint32>(Slot);
+	if (!(ScrubTransformMask & SlotBit))
+	{
+		PreScrubTransforms[static_cast<int32>(Slot)] = PartComponent->GetRelativeTransform();
+		ScrubTransformMask |= SlotBit;
+	}
+
+	PartComponent->SetRelativeTransform(RelativeTransform * PreScrubTransforms[static_cast<int32>(Slot)]);
+	PartComponent->EmptyOverrideMaterials();
+	PartComponent->SetStaticMesh(DisplayMesh);
+	PartComponent->SetVisibility(DisplayMesh != nullptr);
+
+	return true;
+}
+
+int32 UVehicleMasterComponent::GetPreviewIndex(EVehiclePartSlot Slot) const
+{
+	if (Slot >= EVehiclePartSlot::Count)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 PreviewIndex = PreviewPartIndices[static_cast<int32>(Slot)];
+	return PreviewIndex != INDEX_NONE ? PreviewIndex : GetPartIndex(Slot);
+}
+
+FVehicleBuild UVehicleMasterComponent::CommitPreview()
+{
+	FVehicleBuild Build = GetCurrentBuild();
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 PreviewIndex = PreviewPartIndices[SlotIndex];
+		if (PreviewIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		// A scrub that ends where it started has nothing to load
+		if (PreviewIndex == Build.PartIndices[SlotIndex])
+		{
+			RestorePreviewedSlot(static_cast<EVehiclePartSlot>(SlotIndex));
+		}
+		else
+		{
+			Build.PartIndices[SlotIndex] = PreviewIndex;
+		}
+	}
+
+	if (ProxyPrefetchHandle.IsValid())
+	{
+		ProxyPrefetchHandle->ReleaseHandle();
+		ProxyPrefetchHandle.Reset();
+	}
+
+	// The proxies stay up until the full assets are in; the setters then clear the previews
+	ApplyBuildAsync(Build, /*bIsPlayerPick*/ true);
+	return Build;
+}
+
+void UVehicleMasterComponent::CancelPreview()
+{
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (PreviewPartIndices[SlotIndex] != INDEX_NONE)
+		{
+			RestorePreviewedSlot(static_cast<EVehiclePartSlot>(SlotIndex));
+		}
+	}
+
+	if (ProxyPrefetchHandle.IsValid())
+	{
+		ProxyPrefetchHandle->ReleaseHandle();
+		ProxyPrefetchHandle.Reset();
+	}
+}
+
+void UVehicleMasterComponent::PinAppliedAssets(int32 SlotBit, TArray<FSoftObjectPath>&& Paths)
+{
+	UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get();
+	if (!Residency)
+	{
+		return;
+	}
+
+	// Pin before unpinning so assets shared by both parts are never evictable in between
+	Residency->PinAssets(Paths);
+	Residency->UnpinAssets(PinnedAssets[SlotBit]);
+	PinnedAssets[SlotBit] = MoveTemp(Paths);
+}
+
+void UVehicleMasterComponent::ReleaseAllPins()
+{
+	UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get();
+	for (TArray<FSoftObjectPath>& SlotAssets : PinnedAssets)
+	{
+		if (Residency)
+		{
+			Residency->UnpinAssets(SlotAssets);
+		}
+		SlotAssets.Reset();
+	}
+}
+
+void UVehicleMasterComponent::RestorePreviewedSlot(EVehiclePartSlot Slot)
+{
+	PreviewPartIndices[static_cast<int32>(Slot)] = INDEX_NONE;
+
+	UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot);
+	if (!PartComponent)
+	{
+		return;
+	}
+
+	UndoScrubTransform(Slot);
+
+	const int32 Index = GetPartIndex(Slot);
+	if (VehicleConfig && VehicleConfig->GetParts(Slot).IsValidIndex(Index))
+	{
+		// The selected part was applied before the scrub, so its assets are still resident
+		ApplyBumperMesh(Slot, PartComponent, VehicleConfig->GetParts(Slot)[Index]);
+	}
+	else
+	{
+		PartComponent->SetStaticMesh(nullptr);
+		PartComponent->SetVisibility(false);
+	}
+}
+
+void UVehicleMasterComponent::UndoScrubTransform(EVehiclePartSlot Slot)
+{
+	const uint32 SlotBit = 1u << static_cast<uint32>(Slot);
+	if (!(ScrubTransformMask & SlotBit))
+	{
+		return;
+	}
+
+	ScrubTransformMask &= ~SlotBit;
+	if (UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot))
+	{
+		PartComponent->SetRelativeTransform(PreScrubTransforms[static_cast<int32>(Slot)]);
+	}
+}
+
+void UVehicleMasterComponent::ClearPart(EVehiclePartSlot Slot)
+{
+	const int32 SlotIndex = static_cast<int32>(Slot);
+	if (GetPartIndexRef(Slot) == INDEX_NONE)
+	{
+		return;
+	}
+
+	UnbakeMergedMesh();
+
+	GetPartIndexRef(Slot) = INDEX_NONE;
+	PreviewPartIndices[SlotIndex] = INDEX_NONE;
+	StatsDirtyMask |= 1u << SlotIndex;
+
+	if (UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot))
+	{
+		PartComponent->SetStaticMesh(nullptr);
+		PartComponent->SetVisibility(false);
+	}
+	PinAppliedAssets(SlotIndex, TArray<FSoftObjectPath>());
+
+	if (UVehicleAudioSubsystem* Audio = GetWorld() ? GetWorld()->GetSubsystem<UVehicleAudioSubsystem>() : nullptr)
+	{
+		Audio->SetPartSound(this, Slot, TSoftObjectPtr<USoundWave>());
+	}
+
+	OnPartChanged.Broadcast(Slot, NAME_None, FString());
+
+	UpdateReplicatedBuild();
+}
+
+void UVehicleMasterComponent::ClearPaint()
+{
+	if (CurrentPaintIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	UnbakeMergedMesh();
+
+	CurrentPaintIndex = INDEX_NONE;
+	if (MainVehicleMesh)
+	{
+		VehicleMasterAssets::SetOverrideMaterials(MainVehicleMesh, TArray<TObjectPtr<UMaterialInterface>>());
+	}
+	PinAppliedAssets(VehicleBuildPaintBit, TArray<FSoftObjectPath>());
+
+	OnPaintChanged.Broadcast(NAME_None, FString());
+
+	UpdateReplicatedBuild();
+}
+
+void UVehicleMasterComponent::PrefetchPartProxies(EVehiclePartSlot Slot, int32 FromIndex, int32 Direction, int32 Count)
+{
+	if (!VehicleConfig || Slot >= EVehiclePartSlot::Count || Count <= 0)
+	{
+		return;
+	}
+
+	const TArray<FCarPart>& Parts = VehicleConfig->GetParts(Slot);
+	if (Parts.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> ProxiesToLoad;
+	for (int32 Step = 1; Step <= FMath::Min(Count, Parts.Num()); ++Step)
+	{
+		const int32 Index = ((FromIndex + Step * Direction) % Parts.Num() + Parts.Num()) % Parts.Num();
+		const TSoftObjectPtr<UStaticMesh>& Proxy = Parts[Index].ProxyMesh;
+		if (!Proxy.IsNull() && !Proxy.IsValid())
+		{
+			ProxiesToLoad.Add(Proxy.ToSoftObjectPath());
+		}
+	}
+
+	if (ProxyPrefetchHandle.IsValid())
+	{
+		ProxyPrefetchHandle->ReleaseHandle();
+		ProxyPrefetchHandle.Reset();
+	}
+
+	if (ProxiesToLoad.Num() > 0)
+	{
+		ProxyPrefetchHandle = VehicleMasterAssets::RequestAsyncLoad(ProxiesToLoad, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+	}
+}
+
+bool UVehicleMasterComponent::BakeMergedMesh()
+{
+	UStaticMeshComponent* Chassis = Cast<UStaticMeshComponent>(MainVehicleMesh);
+	if (!VehicleConfig || !Chassis || !Chassis->GetStaticMesh())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Merging needs a configured static mesh chassis"));
+		return false;
+	}
+
+	if (bMergedMeshBaked || bMergePending)
+	{
+		return true;
+	}
+
+	FVehicleMergeKey Key;
+	Key.ChassisMesh = Chassis->GetStaticMesh();
+	Key.BuildHash = GetCurrentBuild().GetCanonicalHash(VehicleConfig->GetCatalogFingerprint());
+
+	// Every visible part in chassis space; the layout completes the key before any geometry is read
+	const FTransform ChassisTransform = Chassis->GetComponentTransform();
+	TArray<TPair<const UStaticMeshComponent*, FTransform>, TInlineAllocator<NumVehiclePartSlots>> Parts;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const UStaticMeshComponent* PartComponent = GetPartComponentRef(static_cast<EVehiclePartSlot>(SlotIndex));
+		if (!PartComponent || !PartComponent->IsVisible() || !PartComponent->GetStaticMesh())
+		{
+			continue;
+		}
+
+		const FTransform ToChassis = PartComponent->GetComponentTransform().GetRelativeTransform(ChassisTransform);
+		Key.LayoutHash = HashCombine(Key.LayoutHash, GetTypeHash(ToChassis.GetTranslation()));
+		Key.LayoutHash = HashCombine(Key.LayoutHash, GetTypeHash(ToChassis.GetRotation().Euler()));
+		Key.LayoutHash = HashCombine(Key.LayoutHash, GetTypeHash(ToChassis.GetScale3D()));
+		Parts.Emplace(PartComponent, ToChassis);
+	}
+
+	// A hit skips copying LOD0 of every mesh
+	if (UStaticMesh* CachedMesh = FVehicleMergedMeshCache::Get().Find(Key))
+	{
+		ApplyMergedMesh(CachedMesh);
+		return true;
+	}
+
+	// Chassis first, then the parts
+	TArray<UMaterialInterface*> Materials;
+	TArray<FVehicleMergeSource> Sources;
+	if (!FVehicleMeshMerger::ExtractSource(*Chassis, FTransform::Identity, Materials, Sources.AddDefaulted_GetRef()))
+	{
+		return false;
+	}
+	for (const TPair<const UStaticMeshComponent*, FTransform>& Part : Parts)
+	{
+		if (!FVehicleMeshMerger::ExtractSource(*Part.Key, Part.Value, Materials, Sources.AddDefaulted_GetRef()))
+		{
+			return false;
+		}
+	}
+
+	PendingMergeMaterials = Materials;
+	bMergePending = true;
+
+	const uint32 Serial = ++MergeSerial;
+	const int32 NumMaterials = Materials.Num();
+	TWeakObjectPtr<UVehicleMasterComponent> WeakThis(this);
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Serial, Key, NumMaterials, Sources = MoveTemp(Sources)]()
+	{
+		const FVehicleMergedGeometry Geometry = FVehicleMeshMerger::Merge(Sources, NumMaterials);
+
+		TSharedRef<FMeshDescription> Description = MakeShared<FMeshDescription>();
+		FVehicleMeshMerger::BuildMeshDescription(Geometry, *Description);
+
+		TArray<int32> SectionMaterialKeys;
+		for (const FVehicleMergeSection& Section : Geometry.Sections)
+		{
+			SectionMaterialKeys.Add(Section.MaterialKey);
+		}
+
+		UE_LOG(LogTemp, Verbose, TEXT("VehicleMasterComponent: Merged %d sections into %d"), Geometry.NumSourceSections, Geometry.Sections.Num());
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Key, Description, SectionMaterialKeys = MoveTemp(SectionMaterialKeys)]()
+		{
+			if (UVehicleMasterComponent* This = WeakThis.Get())
+			{
+				This->OnMergeComplete(Serial, Key, *Description, SectionMaterialKeys);
+			}
+		});
+	});
+
+	return true;
+}
+
+void UVehicleMasterComponent::OnMergeComplete(uint32 Serial, const FVehicleMergeKey& Key, const FMeshDescription& Description, const TArray<int32>& SectionMaterialKeys)
+{
+	// Modified or unbaked while the worker was busy
+	if (Serial != MergeSerial || !bMergePending)
+	{
+		return;
+	}
+
+	bMergePending = false;
+
+	TArray<UMaterialInterface*> SectionMaterials;
+	for (int32 MaterialKey : SectionMaterialKeys)
+	{
+		SectionMaterials.Add(PendingMergeMaterials[MaterialKey]);
+	}
+	PendingMergeMaterials.Reset();
+
+	// The hidden parts keep their own collision, so the merged mesh only has to keep the chassis'
+	const UStaticMeshComponent* Chassis = Cast<UStaticMeshComponent>(MainVehicleMesh);
+	UStaticMesh* MergedMesh = FVehicleMeshMerger::CreateStaticMesh(Description, SectionMaterials, Chassis ? Chassis->GetStaticMesh() : nullptr);
+	if (!MergedMesh)
+	{
+		return;
+	}
+
+	FVehicleMergedMeshCache::Get().Add(Key, MergedMesh);
+	ApplyMergedMesh(MergedMesh);
+}
+
+void UVehicleMasterComponent::ApplyMergedMesh(UStaticMesh* MergedMesh)
+{
+	UStaticMeshComponent* Chassis = Cast<UStaticMeshComponent>(MainVehicleMesh);
+	if (!Chassis)
+	{
+		return;
+	}
+
+	UnbakedChassisMesh = Chassis->GetStaticMesh();
+	UnbakedChassisMaterials = Chassis->OverrideMaterials;
+
+	// The merged mesh carries the final materials, including paint
+	Chassis->EmptyOverrideMaterials();
+	Chassis->SetStaticMesh(MergedMesh);
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (UStaticMeshComponent* PartComponent = GetPartComponentRef(static_cast<EVehiclePartSlot>(SlotIndex)))
+		{
+			PartComponent->SetVisibility(false);
+		}
+	}
+
+	bMergedMeshBaked = true;
+}
+
+void UVehicleMasterComponent::UnbakeMergedMesh()
+{
+	++MergeSerial;
+	bMergePending = false;
+	PendingMergeMaterials.Reset();
+
+	if (!bMergedMeshBaked)
+	{
+		return;
+	}
+	bMergedMeshBaked = false;
+
+	if (UStaticMeshComponent* Chassis = Cast<UStaticMeshComponent>(MainVehicleMesh))
+	{
+		Chassis->SetStaticMesh(UnbakedChassisMesh);
+		VehicleMasterAssets::SetOverrideMaterials(Chassis, TArray<TObjectPtr<UMaterialInterface>>(UnbakedChassisMaterials));
+	}
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		if (UStaticMeshComponent* PartComponent = GetPartComponentRef(Slot))
+		{
+			PartComponent->SetVisibility(GetPartIndex(Slot) != INDEX_NONE && PartComponent->GetStaticMesh() != nullptr);
+		}
+	}
+
+	UnbakedChassisMesh = nullptr;
+	UnbakedChassisMaterials.Reset();
+}
+
+void UVehicleMasterComponent::SetAutoBakeMergedMesh(bool bEnable)
+{
+	bAutoBakeMergedMesh = bEnable;
+
+	if (!bEnable)
+	{
+		UnbakeMergedMesh();
+	}
+	else if (!PendingLoadHandle.IsValid() || PendingLoadHandle->HasLoadCompleted())
+	{
+		// A build still loading bakes itself once applied
+		BakeMergedMesh();
+	}
+}
+
+void UVehicleMasterComponent::SetReplicatedBuild(const FVehicleBuild& Build)
+{
+	ReplicatedBuild.Build = Build;
+	ReplicatedBuild.CatalogFingerprint = VehicleConfig ? VehicleConfig->GetCatalogFingerprint() : 0;
+}
+
+void UVehicleMasterComponent::UpdateReplicatedBuild()
+{
+	if (bBatchingBuildUpdates)
+	{
+		bBuildUpdatePending = true;
+		return;
+	}
+
+	TUNEX_HITCH_PHASE(Publish);
+
+	// Every selection change ends up here, on servers and clients alike
+	PublishSnapshot();
+
+	RefreshConstraintState();
+	if (PendingValidOptionsMask != 0)
+	{
+		PendingValidOptionsMask = 0;
+		OnValidOptionsChanged.Broadcast();
+	}
+
+	AActor* Owner = GetOwner();
+	if (Owner && Owner->HasAuthority())
+	{
+		SetReplicatedBuild(GetCurrentBuild());
+	}
+}
+
+void UVehicleMasterComponent::NotifyCatalogExtended()
+{
+	UpdateReplicatedBuild();
+}
+
+bool UVehicleMasterComponent::NotifyCatalogEdited(const FVehicleCatalogChange& Change)
+{
+	if (!VehicleConfig)
+	{
+		return false;
+	}
+
+	const FVehicleBuild CurrentBuild = GetCurrentBuild();
+	uint32 AffectedMask = 0;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 PartIndex = CurrentBuild.PartIndices[SlotIndex];
+		if (PartIndex != INDEX_NONE && Change.IsPartChanged(static_cast<EVehiclePartSlot>(SlotIndex), PartIndex))
+		{
+			AffectedMask |= 1u << SlotIndex;
+		}
+	}
+	if (CurrentBuild.PaintIndex != INDEX_NONE && Change.IsPaintChanged(CurrentBuild.PaintIndex))
+	{
+		AffectedMask |= 1u << VehicleBuildPaintBit;
+	}
+
+	// The hidden side of a comparison may point at moved or removed entries even when the shown one does not
+	bool bCompareAffected = bComparing && (AffectedMask != 0 || Change.bCatalogWide);
+	if (bComparing && !bCompareAffected)
+	{
+		const FVehicleBuild& Hidden = CompareBuilds[1 - CompareSide];
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots && !bCompareAffected; ++SlotIndex)
+		{
+			const int32 PartIndex = Hidden.PartIndices[SlotIndex];
+			bCompareAffected = PartIndex != INDEX_NONE && Change.IsPartChanged(static_cast<EVehiclePartSlot>(SlotIndex), PartIndex);
+		}
+		bCompareAffected |= Hidden.PaintIndex != INDEX_NONE && Change.IsPaintChanged(Hidden.PaintIndex);
+	}
+	if (bCompareAffected)
+	{
+		EndCompare(/*bKeepShown*/ true);
+	}
+
+	if (AffectedMask == 0 && !Change.bCatalogWide)
+	{
+		return false;
+	}
+
+	// IDs as last published, from before the edit
+	const FVehicleBuildSnapshot Previous = SnapshotChannel->Read();
+
+	// A build still loading keeps the slots it changes; the rest is re-applied on top of it
+	FVehicleBuild Build = PendingLoadHandle.IsValid() ? PendingBuild : CurrentBuild;
+	uint32 ReapplyMask = 0;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		const int32 OldIndex = CurrentBuild.PartIndices[SlotIndex];
+		if (!(AffectedMask & (1u << SlotIndex)) || Build.PartIndices[SlotIndex] != OldIndex)
+		{
+			continue;
+		}
+
+		// Follow the part if it moved; an entry edited in place (even its ID) stays where it is
+		int32 NewIndex = VehicleConfig->FindPartIndex(Slot, Previous.PartIDs[SlotIndex]);
+		if (NewIndex == INDEX_NONE && VehicleConfig->GetParts(Slot).IsValidIndex(OldIndex))
+		{
+			NewIndex = OldIndex;
+		}
+
+		if (NewIndex == INDEX_NONE)
+		{
+			ClearPart(Slot);
+			UE_LOG(LogTemp, Log, TEXT("VehicleMasterComponent: %s part '%s' was removed from the catalog, slot emptied"),
+				LexToString(Slot), *Previous.PartIDs[SlotIndex].ToString());
+		}
+		else
+		{
+			ReapplyMask |= 1u << SlotIndex;
+		}
+		Build.PartIndices[SlotIndex] = NewIndex;
+	}
+
+	if ((AffectedMask & (1u << VehicleBuildPaintBit)) && Build.PaintIndex == CurrentBuild.PaintIndex)
+	{
+		int32 NewIndex = VehicleConfig->FindPaintIndex(Previous.PaintID);
+		if (NewIndex == INDEX_NONE && VehicleConfig->PaintColors.IsValidIndex(CurrentBuild.PaintIndex))
+		{
+			NewIndex = CurrentBuild.PaintIndex;
+		}
+
+		if (NewIndex == INDEX_NONE)
+		{
+			// The material stays on the body until another paint is picked
+			CurrentPaintIndex = INDEX_NONE;
+			PinAppliedAssets(VehicleBuildPaintBit, TArray<FSoftObjectPath>());
+		}
+		else
+		{
+			ReapplyMask |= 1u << VehicleBuildPaintBit;
+		}
+		Build.PaintIndex = NewIndex;
+	}
+
+	// Entries a pending build asked for may have gone with the edit; those slots are left as they are
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		if (!VehicleConfig->GetParts(static_cast<EVehiclePartSlot>(SlotIndex)).IsValidIndex(Build.PartIndices[SlotIndex]))
+		{
+			Build.PartIndices[SlotIndex] = INDEX_NONE;
+		}
+	}
+	if (!VehicleConfig->PaintColors.IsValidIndex(Build.PaintIndex))
+	{
+		Build.PaintIndex = INDEX_NONE;
+	}
+
+	StatsDirtyMask = Change.bCatalogWide ? MAX_uint32 : StatsDirtyMask | (AffectedMask & ~(1u << VehicleBuildPaintBit));
+
+	// Prices, stats and rules may have changed even where nothing needs re-applying
+	UpdateReplicatedBuild();
+
+	if (ReapplyMask != 0)
+	{
+		ForcedReapplyMask |= ReapplyMask;
+		ApplyBuildAsync(Build);
+	}
+
+	return true;
+}
+
+void UVehicleMasterComponent::OnRep_ReplicatedBuild()
+{
+	// InitializeVehicle picks the build up once the component is ready
+	if (!VehicleConfig || !HasBegunPlay())
+	{
+		return;
+	}
+
+	const uint32 LocalFingerprint = VehicleConfig->GetCatalogFingerprint();
+	if (ReplicatedBuild.CatalogFingerprint != LocalFingerprint)
+	{
+		++FVehicleBuildNetStats::Get().NumFingerprintMismatches;
+		UE_LOG(LogTemp, Error, TEXT("VehicleMasterComponent: Catalog mismatch for '%s' (server %08x, local %08x), ignoring replicated build"),
+			*VehicleConfig->GetName(), ReplicatedBuild.CatalogFingerprint, LocalFingerprint);
+		return;
+	}
+
+	ApplyBuildAsync(ReplicatedBuild.Build);
+}
+
+int32& UVehicleMasterComponent::GetPartIndexRef(EVehiclePartSlot Slot)
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::RearBumper:	return CurrentRearBumperIndex;
+	case EVehiclePartSlot::SideSkirts:	return CurrentSideSkirtsIndex;
+	case EVehiclePartSlot::Spoiler:		return CurrentSpoilerIndex;
+	case EVehiclePartSlot::Wheels:		return CurrentWheelsIndex;
+	default:							return CurrentFrontBumperIndex;
+	}
+}
+
+UStaticMeshComponent*& UVehicleMasterComponent::GetPartComponentRef(EVehiclePartSlot Slot)
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::RearBumper:	return RearBumperComponent;
+	case EVehiclePartSlot::SideSkirts:	return SideSkirtsComponent;
+	case EVehiclePartSlot::Spoiler:		return SpoilerComponent;
+	case EVehiclePartSlot::Wheels:		return WheelsComponent;
+	default:							return FrontBumperComponent;
+	}
+}
+
+FName UVehicleMasterComponent::GetPartSocketName(EVehiclePartSlot Slot) const
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::RearBumper:	return RearBumperSocketName;
+	case EVehiclePartSlot::SideSkirts:	return SideSkirtsSocketName;
+	case EVehiclePartSlot::Spoiler:		return SpoilerSocketName;
+	case EVehiclePartSlot::Wheels:		return WheelsSocketName;
+	default:							return FrontBumperSocketName;
+	}
+}
+
+FPaintColor UVehicleMasterComponent::GetCurrentPaint() const
+{
+	if (VehicleConfig && VehicleConfig->PaintColors.IsValidIndex(CurrentPaintIndex))
+	{
+		return VehicleConfig->PaintColors[CurrentPaintIndex];
+	}
+	return FPaintColor();
+}
+
+void UVehicleMasterComponent::ApplyBumperMesh(EVehiclePartSlot Slot, UStaticMeshComponent* BumperComponent, const FCarPart& PartData)
+{
+	if (!BumperComponent)
+	{
+		return;
+	}
+
+	FVehiclePartApplyStats& Stats = FVehiclePartApplyStats::Get();
+	++Stats.NumApplies;
+	FResolvedPartAssets& Resolved = ResolvedPartAssets[static_cast<int32>(Slot)];
+
+	// Load the mesh asset (resident assets resolve without touching the disk)
+	if (!PartData.MeshAsset.IsNull())
+	{
+		const FSoftObjectPath MeshPath = PartData.MeshAsset.ToSoftObjectPath();
+		UStaticMesh* StaticMesh = MeshPath == Resolved.MeshPath ? Resolved.Mesh.Get() : nullptr;
+		if (StaticMesh)
+		{
+			++Stats.NumResolvesAvoided;
+		}
+		else
+		{
+			UObject* LoadedAsset = VehicleMasterAssets::LoadTracked(MeshPath);
+			StaticMesh = Cast<UStaticMesh>(LoadedAsset);
+			if (!StaticMesh && LoadedAsset)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Mesh asset is not a StaticMesh"));
+			}
+			Resolved.MeshPath = MeshPath;
+			Resolved.Mesh = StaticMesh;
+		}
+
+		if (StaticMesh && StaticMesh != BumperComponent->GetStaticMesh())
+		{
+			TUNEX_HITCH_PHASE(Mesh);
+			BumperComponent->SetStaticMesh(StaticMesh);
+			++Stats.NumMeshUpdates;
+		}
+		else if (StaticMesh)
+		{
+			++Stats.NumMeshUpdatesAvoided;
+		}
+	}
+
+	// Resolve the material overrides, reusing whatever the previous part of the slot shared with this one
+	TArray<FSoftObjectPath> MaterialPaths;
+	TArray<TWeakObjectPtr<UMaterialInterface>> ResolvedMaterials;
+	TArray<TObjectPtr<UMaterialInterface>> Materials;
+	MaterialPaths.SetNum(PartData.MaterialOverrides.Num());
+	ResolvedMaterials.SetNum(PartData.MaterialOverrides.Num());
+	Materials.SetNum(PartData.MaterialOverrides.Num());
+	for (int32 i = 0; i < PartData.MaterialOverrides.Num(); ++i)
+	{
+		if (PartData.MaterialOverrides[i].IsNull())
+		{
+			continue;
+		}
+
+		MaterialPaths[i] = PartData.MaterialOverrides[i].ToSoftObjectPath();
+		const int32 CachedIndex = Resolved.MaterialPaths.Find(MaterialPaths[i]);
+		UMaterialInterface* Material = CachedIndex != INDEX_NONE ? Resolved.Materials[CachedIndex].Get() : nullptr;
+		if (Material)
+		{
+			++Stats.NumResolvesAvoided;
+		}
+		else
+		{
+			Material = Cast<UMaterialInterface>(VehicleMasterAssets::LoadTracked(MaterialPaths[i]));
+		}
+		ResolvedMaterials[i] = Material;
+		Materials[i] = Material;
+	}
+	Resolved.MaterialPaths = MoveTemp(MaterialPaths);
+	Resolved.Materials = MoveTemp(ResolvedMaterials);
+
+	{
+		TUNEX_HITCH_PHASE(Material);
+		VehicleMasterAssets::SetOverrideMaterials(BumperComponent, MoveTemp(Materials));
+	}
+
+	if (BumperComponent->GetVisibleFlag())
+	{
+		++Stats.NumVisibilityUpdatesAvoided;
+	}
+	else
+	{
+		BumperComponent->SetVisibility(true);
+	}
+}
+
+void UVehicleMasterComponent::ApplyPaintMaterial(const FPaintColor& PaintData)
+{
+	if (!MainVehicleMesh)
+	{
+		return;
+	}
+
+	// Load the material
+	UMaterialInterface* Material = nullptr;
+	if (!PaintData.Material.IsNull())
+	{
+		Material = Cast<UMaterialInterface>(VehicleMasterAssets::LoadTracked(PaintData.Material.ToSoftObjectPath()));
+	}
+
+	if (Material)
+	{
+		TUNEX_HITCH_PHASE(Material);
+		++FVehiclePartApplyStats::Get().NumApplies;
+
+		// Apply to all material slots (typically paint affects the body)
+		// For more control, you might want to specify which slots to affect
+		TArray<TObjectPtr<UMaterialInterface>> Materials;
+		Materials.Init(Material, MainVehicleMesh->GetNumMaterials());
+		VehicleMasterAssets::SetOverrideMaterials(MainVehicleMesh, MoveTemp(Materials));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMasterComponent: Failed to load paint material"));
+	}
+}
+
+UStaticMeshComponent* UVehicleMasterComponent::GetOrCreatePartComponent(FName ComponentName, FName SocketName)
+{
+	AActor* Owner = GetOwner();
+	if (!Owner)
+	{
+		return nullptr;
+	}
+
+	// Try to find existing component
+	UStaticMeshComponent* Component = Cast<UStaticMeshComponent>(
+		Owner->GetDefaultSubobjectByName(ComponentName)
+	);
+
+	if (!Component)
+	{
+		TUNEX_HITCH_PHASE(Register);
+
+		// Create new component
+		Component = NewObject<UStaticMeshComponent>(Owner, UStaticMeshComponent::StaticClass(), ComponentName);
+		if (Component)
+		{
+			Component->RegisterComponent();
+			Component->AttachToComponent(MainVehicleMesh, FAttachmentTransformRules::KeepRelativeTransform, SocketName);
+			Component->SetRelativeLocation(FVector::ZeroVector);
+			Component->SetRelativeRotation(FRotator::ZeroRotator);
+		}
+	}
+
+	return Component;
+}
+
+static FAutoConsoleCommand GVehiclePartApplyStatsCommand(
+	TEXT("TuneX.Parts.ApplyStats"),
+	TEXT("Prints how many mesh, material and visibility updates applying parts and paint pushed and skipped"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FVehiclePartApplyStats& Stats = FVehiclePartApplyStats::Get();
+		const uint64 NumAvoided = Stats.NumMeshUpdatesAvoided + Stats.NumMaterialUpdatesAvoided + Stats.NumVisibilityUpdatesAvoided;
+		UE_LOG(LogTemp, Display, TEXT("VehicleMasterComponent: %llu applies; %llu mesh updates (%llu avoided), %llu material updates (%llu avoided, %llu of %llu sections changed), %llu visibility updates avoided, %llu lookups avoided; %llu render state updates avoided in total"),
+			Stats.NumApplies, Stats.NumMeshUpdates, Stats.NumMeshUpdatesAvoided, Stats.NumMaterialUpdates, Stats.NumMaterialUpdatesAvoided,
+			Stats.NumSectionsChanged, Stats.NumSectionsChanged + Stats.NumSectionsUnchanged, Stats.NumVisibilityUpdatesAvoided, Stats.NumResolvesAvoided, NumAvoided);
+	}));
+
+static FAutoConsoleCommand GVehiclePartApplyStatsResetCommand(
+	TEXT("TuneX.Parts.ResetApplyStats"),
+	TEXT("Resets the part application counters"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FVehiclePartApplyStats::Get() = FVehiclePartApplyStats();
+	}));
@@ -5,13 +5,53 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "CarPartData.h"
+#include "VehicleBuild.h"
+#include "VehicleBuildSnapshot.h"
+#include "VehiclePartConstraints.h"
 #include "VehicleMasterComponent.generated.h"
 
+struct FStreamableHandle;
+struct FMeshDescription;
+struct FVehicleMergeKey;
+
 /**
  * Event dispatchers for component modifications
  */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBumperChanged, FName, BumperID, const FString&, DisplayName);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPaintChanged, FName, PaintID, const FString&, DisplayName);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnPartChanged, EVehiclePartSlot, Slot, FName, PartID, const FString&, DisplayName);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnValidOptionsChanged);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnCompareReady);
+
+/**
+ * Render state pushed and skipped when parts and paint are applied (game thread only)
+ * Dump with the console command TuneX.Parts.ApplyStats, reset with TuneX.Parts.ResetApplyStats
+ */
+struct TUNEX_API FVehiclePartApplyStats
+{
+	// Parts and paints applied
+	uint64 NumApplies = 0;
+
+	// Mesh swaps made and skipped because the component already showed the mesh
+	uint64 NumMeshUpdates = 0;
+	uint64 NumMeshUpdatesAvoided = 0;
+
+	// Bulk material pushes made and skipped because every section already matched
+	uint64 NumMaterialUpdates = 0;
+	uint64 NumMaterialUpdatesAvoided = 0;
+
+	// Sections whose material changed, and sections left alone
+	uint64 NumSectionsChanged = 0;
+	uint64 NumSectionsUnchanged = 0;
+
+	// Visibility changes skipped because the component was already visible
+	uint64 NumVisibilityUpdatesAvoided = 0;
+
+	// Assets taken from the per-slot resolved cache instead of being looked up again
+	uint64 NumResolvesAvoided = 0;
+
+	static FVehiclePartApplyStats& Get();
+};
 
 /**
  * Master component for managing vehicle configuration
@@ -28,8 +68,11 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	// Event dispatchers for UI binding
 	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
 	FOnBumperChanged OnBumperChanged;
@@ -37,6 +80,18 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
 	FOnPaintChanged OnPaintChanged;
 
+	// Fired for every part slot, including the front bumper
+	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
+	FOnPartChanged OnPartChanged;
+
+	// Fired when a change narrows or widens the options the catalog's rules leave in some slot
+	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
+	FOnValidOptionsChanged OnValidOptionsChanged;
+
+	// Fired once both builds of a comparison are resident and ToggleCompare can switch instantly
+	UPROPERTY(BlueprintAssignable, Category = "Vehicle Events")
+	FOnCompareReady OnCompareReady;
+
 	// Reference to the vehicle configuration data asset
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration")
 	UVehicleConfigDataAsset* VehicleConfig;
@@ -51,6 +106,15 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
 	int32 CurrentPaintIndex;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	int32 CurrentSideSkirtsIndex;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	int32 CurrentSpoilerIndex;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	int32 CurrentWheelsIndex;
+
 	// Socket names for attachment points
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Sockets")
 	FName FrontBumperSocketName;
@@ -58,6 +122,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Sockets")
 	FName RearBumperSocketName;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Sockets")
+	FName SideSkirtsSocketName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Sockets")
+	FName SpoilerSocketName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Sockets")
+	FName WheelsSocketName;
+
 	// Reference to the main vehicle mesh component
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration")
 	UMeshComponent* MainVehicleMesh;
@@ -69,8 +142,34 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
 	UStaticMeshComponent* RearBumperComponent;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	UStaticMeshComponent* SideSkirtsComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	UStaticMeshComponent* SpoilerComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle State")
+	UStaticMeshComponent* WheelsComponent;
+
+	// Shown during a scrub for parts with neither a resident mesh nor a resident proxy
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration|Scrub")
+	TSoftObjectPtr<UStaticMesh> PlaceholderMesh;
+
+	// Bake the chassis and parts into one mesh whenever a build finishes applying
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vehicle Configuration|Merging")
+	bool bAutoBakeMergedMesh;
+
+	// Garage build streamed in after the defaults on initialization (see UVehicleGarageSubsystem)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration")
+	FGuid GarageBuildId;
+
+	// Whether BeginPlay initializes the vehicle; the actor pool clears it for parked vehicles, which get their
+	// catalog and build when acquired
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle Configuration")
+	bool bInitializeOnBeginPlay;
+
 	/**
-	 * Initializes the vehicle with default configuration
+	 * Initializes the vehicle with default configuration, then the GarageBuildId build if one is set
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification")
 	void InitializeVehicle();
@@ -133,6 +232,290 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Modification")
 	FPaintColor GetCurrentPaint() const;
 
+	/**
+	 * Sets the part in any slot by part ID
+	 * @param Slot - The part slot
+	 * @param PartID - Unique identifier for the part
+	 * @return true if successful
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification")
+	bool SetPartByID(EVehiclePartSlot Slot, FName PartID);
+
+	/**
+	 * Sets the part in any slot by index
+	 * @param Slot - The part slot
+	 * @param Index - Index in the slot's part array
+	 * @return true if successful
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification")
+	bool SetPartByIndex(EVehiclePartSlot Slot, int32 Index);
+
+	/**
+	 * Cycles to the next part in a slot
+	 * @param Slot - The part slot
+	 * @return true if successful
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification")
+	bool CycleNextPart(EVehiclePartSlot Slot);
+
+	/**
+	 * Gets the selected index of a slot
+	 * @return The index, or INDEX_NONE if nothing is attached
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Modification")
+	int32 GetPartIndex(EVehiclePartSlot Slot) const;
+
+	/**
+	 * Gets the part data of a slot
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Modification")
+	FCarPart GetCurrentPart(EVehiclePartSlot Slot) const;
+
+	/**
+	 * Gets the complete current selection
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Modification")
+	FVehicleBuild GetCurrentBuild() const;
+
+	/**
+	 * Gets the vehicle's performance: the catalog's BaseStats plus the stats of every installed part
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Performance")
+	FVehiclePerformanceStats GetPerformanceStats() const;
+
+	/**
+	 * Native per-frame accessor for physics and AI
+	 * Only slots changed since the last call are looked up again; nothing is allocated.
+	 */
+	const FVehiclePerformanceStats& GetPerformanceStatsRef() const;
+
+	/**
+	 * Checks an option against the catalog's fitment, requires and excludes rules, given the other slots' selections
+	 * @param Slot - The part slot
+	 * @param Index - Index in the slot's part array
+	 * @return true if installing it would break no rule
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Rules")
+	bool IsPartOptionValid(EVehiclePartSlot Slot, int32 Index) const;
+
+	/**
+	 * Gets every option of a slot the rules still allow
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Rules")
+	TArray<int32> GetValidPartIndices(EVehiclePartSlot Slot) const;
+
+	/**
+	 * Checks the current build against the catalog's rules
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Rules")
+	bool IsCurrentBuildValid() const;
+
+	/**
+	 * Native access to the allowed options of a slot, one bit per option
+	 */
+	const FVehicleSlotOptionMask& GetValidOptions(EVehiclePartSlot Slot) const;
+
+	/**
+	 * Republishes the current build after entries were appended to the catalog (see UVehiclePartPackSubsystem)
+	 * Selections stay as they are; the replicated fingerprint, snapshot and valid options catch up.
+	 */
+	void NotifyCatalogExtended();
+
+	/**
+	 * Catches up with edits to the catalog's entries (see UVehicleCatalogHotReloadSubsystem)
+	 * Slots showing a changed entry are re-applied through ApplyBuildAsync, following the entry by ID if it moved;
+	 * a slot whose entry was removed is emptied. A build still loading keeps the slots it changes. A comparison either
+	 * side of which uses a touched entry ends, keeping the shown side.
+	 * @param Change - Entries the edit touched
+	 * @return false if the shown build uses none of them, in which case nothing else was done
+	 */
+	bool NotifyCatalogEdited(const FVehicleCatalogChange& Change);
+
+	/**
+	 * Gets the channel this vehicle publishes an FVehicleBuildSnapshot to after every change
+	 * Pricing, analytics and AI work on other threads should keep the channel and read or wait on it
+	 * instead of touching the component; it outlives the vehicle.
+	 */
+	FVehicleSnapshotChannelRef GetSnapshotChannel() const { return SnapshotChannel.ToSharedRef(); }
+
+	/**
+	 * Applies a complete build without blocking the game thread
+	 * Assets of the changed slots are streamed in first, then the slots are applied together.
+	 * A newer request supersedes one that is still loading.
+	 * @param Build - The build to apply; slots and paint with INDEX_NONE are cleared
+	 * @param bIsPlayerPick - Whether the changed slots are the player's choice and count towards popularity; pooled
+	 *                        reuse, garage loads, replication, AI and replays leave it false
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification")
+	void ApplyBuildAsync(const FVehicleBuild& Build, bool bIsPlayerPick = false);
+
+	/**
+	 * Sets whether changes through the part and paint setters stay out of the popularity telemetry
+	 * Code that drives the vehicle without a player behind it (soak runs, session replays) sets it around its changes.
+	 */
+	void SetNotAPick(bool bInNotAPick) { bNotAPick = bInNotAPick; }
+	bool IsNotAPick() const { return bNotAPick; }
+
+	/**
+	 * Starts comparing the current build (side 0) with another one (side 1)
+	 * The assets of both builds are streamed in and held until EndCompare; OnCompareReady fires once they are
+	 * resident. The current build stays shown.
+	 * @param OtherBuild - Build to compare with; slots with INDEX_NONE take the current selection
+	 * @return false if the build does not fit the catalog
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Compare")
+	bool BeginCompare(const FVehicleBuild& OtherBuild);
+
+	/**
+	 * Shows the other side of the comparison, applying only the slots in which the sides differ, within the frame
+	 * Changes made to the shown side since the last toggle are kept for that side.
+	 * @return false if not comparing or the builds are still loading
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Compare")
+	bool ToggleCompare();
+
+	/**
+	 * Stops comparing and releases the build not shown
+	 * @param bKeepShown - Keep the shown build; otherwise side 0 is shown again
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Compare")
+	void EndCompare(bool bKeepShown = true);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Compare")
+	bool IsComparing() const { return bComparing; }
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Compare")
+	bool IsCompareReady() const { return bComparing && bCompareStaged; }
+
+	/**
+	 * Gets the side shown: 0 for the build the comparison started from, 1 for the other
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Compare")
+	int32 GetCompareSide() const { return CompareSide; }
+
+	/**
+	 * Gets one side of the comparison, including changes made to it while shown
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Compare")
+	FVehicleBuild GetCompareBuild(int32 Side) const;
+
+	/**
+	 * Gets the slots in which the two sides differ, for highlighting
+	 * @param bOutPaintDiffers - Whether the paints differ too
+	 * @return The differing part slots, empty when not comparing
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Compare")
+	TArray<EVehiclePartSlot> GetCompareDiff(bool& bOutPaintDiffers) const;
+
+	/**
+	 * Native form of GetCompareDiff
+	 * @return Bit per part slot, plus VehicleBuildPaintBit for paint
+	 */
+	uint32 GetCompareDiffMask() const;
+
+	/**
+	 * Readies a pooled vehicle for its next use without re-registering any component
+	 * Drops whatever is still loading or previewed, binds ChassisMesh as MainVehicleMesh, switches catalog
+	 * and streams the build in. With the same catalog only the slots that differ are reloaded; slots and paint the
+	 * build leaves empty are cleared, paint falling back to the chassis' own materials.
+	 * @param ChassisMesh - Mesh to bind as MainVehicleMesh; nullptr keeps the current one
+	 * @param Config - Catalog to use
+	 * @param Build - Build to apply
+	 */
+	void ResetForReuse(UMeshComponent* ChassisMesh, UVehicleConfigDataAsset* Config, const FVehicleBuild& Build);
+
+	/**
+	 * Cancels loads, previews and merges in flight before the vehicle is parked
+	 * The applied parts stay, so reusing it with the same build costs nothing.
+	 */
+	void PrepareForPool();
+
+	/**
+	 * Switches to another catalog, detaching every part of the previous one
+	 * Part components stay registered so the next build can reuse them
+	 * @param NewConfig - The catalog to use
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Configuration")
+	void SetVehicleConfig(UVehicleConfigDataAsset* NewConfig);
+
+	/**
+	 * Shows a part while scrubbing without loading anything
+	 * Displays the full mesh if it is already resident, otherwise the part's resident ProxyMesh, otherwise
+	 * PlaceholderMesh scaled to the bounds of the last real mesh. The selection itself does not change.
+	 * @param Slot - The part slot
+	 * @param Index - Index in the slot's part array
+	 * @return true if the index is valid
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification|Scrub")
+	bool PreviewPartByIndex(EVehiclePartSlot Slot, int32 Index);
+
+	/**
+	 * Gets the index being previewed in a slot
+	 * @return The preview index, or the selected index if the slot is not being previewed
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Modification|Scrub")
+	int32 GetPreviewIndex(EVehiclePartSlot Slot) const;
+
+	/**
+	 * Selects the previewed parts, streaming their full assets in through ApplyBuildAsync
+	 * @return The build that was requested
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification|Scrub")
+	FVehicleBuild CommitPreview();
+
+	/**
+	 * Drops every preview and shows the selected parts again
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Modification|Scrub")
+	void CancelPreview();
+
+	/**
+	 * Streams in the proxies of the parts a scrub is heading towards
+	 * @param Slot - The part slot
+	 * @param FromIndex - Index the scrub is at
+	 * @param Direction - +1 or -1
+	 * @param Count - Number of parts to look ahead
+	 */
+	void PrefetchPartProxies(EVehiclePartSlot Slot, int32 FromIndex, int32 Direction, int32 Count);
+
+	/**
+	 * Merges the chassis and every attached part into a single mesh on a worker thread
+	 * The part components are hidden once the merged mesh is swapped in. Any modification unbakes it.
+	 * Requires a static mesh chassis; cooked meshes need bAllowCPUAccess.
+	 * @return true if the merged mesh was applied or is being built
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Merging")
+	bool BakeMergedMesh();
+
+	/**
+	 * Restores the chassis mesh and part components, cancelling a merge in flight
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Merging")
+	void UnbakeMergedMesh();
+
+	/**
+	 * Enables or disables bAutoBakeMergedMesh, baking or unbaking right away
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle Merging")
+	void SetAutoBakeMergedMesh(bool bEnable);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Vehicle Merging")
+	bool IsMergedMeshBaked() const { return bMergedMeshBaked; }
+
+	/**
+	 * Publishes a build to clients (server only)
+	 * @param Build - The build clients should apply
+	 */
+	void SetReplicatedBuild(const FVehicleBuild& Build);
+
+protected:
+	// Server-authoritative build, delta-replicated to clients
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedBuild)
+	FReplicatedVehicleBuild ReplicatedBuild;
+
+	UFUNCTION()
+	void OnRep_ReplicatedBuild();
+
 private:
 	/**
 	 * Validates the vehicle configuration data
@@ -142,10 +525,13 @@ private:
 
 	/**
 	 * Applies the bumper mesh to the component
+	 * Only what differs from the component's current mesh, materials and visibility is pushed, with at most one
+	 * material update; sections the part does not override go back to the mesh's own materials.
+	 * @param Slot - The slot the part belongs to, whose resolved assets are reused
 	 * @param BumperComponent - The component to modify
 	 * @param PartData - The part data containing mesh information
 	 */
-	void ApplyBumperMesh(UStaticMeshComponent* BumperComponent, const FCarPart& PartData);
+	void ApplyBumperMesh(EVehiclePartSlot Slot, UStaticMeshComponent* BumperComponent, const FCarPart& PartData);
 
 	/**
 	 * Applies the paint material to the main vehicle mesh
@@ -154,9 +540,193 @@ private:
 	void ApplyPaintMaterial(const FPaintColor& PaintData);
 
 	/**
-	 * Creates or gets a bumper component
+	 * Creates or gets a part component
 	 * @param ComponentName - Name for the component
+	 * @param SocketName - Socket on the main vehicle mesh to attach to
 	 * @return The static mesh component
 	 */
-	UStaticMeshComponent* GetOrCreateBumperComponent(FName ComponentName);
+	UStaticMeshComponent* GetOrCreatePartComponent(FName ComponentName, FName SocketName);
+
+	/**
+	 * Publishes the current build to clients if this is the server
+	 */
+	void UpdateReplicatedBuild();
+
+	/**
+	 * Called when the assets of a pending async build are resident
+	 */
+	void OnBuildAssetsLoaded();
+
+	/**
+	 * Called on the game thread when a worker finished merging
+	 * @param Serial - MergeSerial at the time of the request; stale results are dropped
+	 * @param Key - Cache key of the merge
+	 * @param Description - The merged geometry
+	 * @param SectionMaterialKeys - Index into PendingMergeMaterials for each section
+	 */
+	void OnMergeComplete(uint32 Serial, const FVehicleMergeKey& Key, const FMeshDescription& Description, const TArray<int32>& SectionMaterialKeys);
+
+	/**
+	 * Swaps the merged mesh in and hides the part components
+	 */
+	void ApplyMergedMesh(UStaticMesh* MergedMesh);
+
+	/**
+	 * Pins the assets now shown in a slot with the residency manager and unpins the previous ones
+	 * @param SlotBit - Part slot index, or VehicleBuildPaintBit for paint
+	 * @param Paths - Assets of the applied part or paint
+	 */
+	void PinAppliedAssets(int32 SlotBit, TArray<FSoftObjectPath>&& Paths);
+
+	/**
+	 * Unpins every asset this vehicle holds
+	 */
+	void ReleaseAllPins();
+
+	/**
+	 * Re-reads the stats of dirty slots and re-sums the totals
+	 */
+	void RefreshPerformanceStats() const;
+
+	/**
+	 * Publishes the current build, IDs, stats and price to SnapshotChannel
+	 */
+	void PublishSnapshot();
+
+	/**
+	 * Counts a player's pick with the popularity telemetry, noting whether its assets were already loaded
+	 * @param SlotBit - Part slot index, or VehicleBuildPaintBit for paint
+	 */
+	void RecordSelection(int32 SlotBit, int32 Index) const;
+
+	/**
+	 * Brings ConstraintState up to date with the catalog's rules and the current build
+	 */
+	void RefreshConstraintState() const;
+
+	/**
+	 * Puts the selected part back on a slot that was previewed
+	 */
+	void RestorePreviewedSlot(EVehiclePartSlot Slot);
+
+	/**
+	 * Puts a part component back where it was before a preview moved or resized it
+	 */
+	void UndoScrubTransform(EVehiclePartSlot Slot);
+
+	/**
+	 * Empties a slot, hiding its component
+	 */
+	void ClearPart(EVehiclePartSlot Slot);
+
+	/**
+	 * Removes the paint, so the chassis shows its own materials
+	 */
+	void ClearPaint();
+
+	/**
+	 * Streams in the assets of both compared builds, replacing the previous request
+	 */
+	void StageCompareBuilds();
+
+	/**
+	 * Called when the assets of both compared builds are resident
+	 */
+	void OnCompareAssetsLoaded();
+
+	// Per-slot state accessors
+	int32& GetPartIndexRef(EVehiclePartSlot Slot);
+	UStaticMeshComponent*& GetPartComponentRef(EVehiclePartSlot Slot);
+	FName GetPartSocketName(EVehiclePartSlot Slot) const;
+
+	// Build waiting for its assets to stream in
+	FVehicleBuild PendingBuild;
+
+	// Handle keeping the pending build's assets alive until applied
+	TSharedPtr<FStreamableHandle> PendingLoadHandle;
+
+	// Stats contributed by each slot's installed part, and their sum with the base stats
+	mutable FVehiclePerformanceStats SlotStats[NumVehiclePartSlots];
+	mutable FVehiclePerformanceStats CachedPerformanceStats;
+
+	// One bit per slot whose SlotStats entry is stale
+	mutable uint32 StatsDirtyMask = MAX_uint32;
+
+	// Lock-free view of the configuration for other threads
+	FVehicleSnapshotChannelPtr SnapshotChannel;
+
+	// Options each slot's rules leave, given the other selections
+	mutable FVehiclePartConstraintState ConstraintState;
+
+	// Slots whose valid options changed since OnValidOptionsChanged last fired
+	mutable uint32 PendingValidOptionsMask = 0;
+
+	// Set while changes that are not a player's pick are applied (catalog defaults, async builds, compare toggles),
+	// so they stay out of the popularity telemetry
+	bool bNotAPick = false;
+
+	// Slots (and VehicleBuildPaintBit) the next async build re-applies even if their index is unchanged
+	uint32 ForcedReapplyMask = 0;
+
+	// Set while several slots change together, so the build is published once at the end
+	bool bBatchingBuildUpdates = false;
+	bool bBuildUpdatePending = false;
+
+	// Both sides of a comparison; the shown one is refreshed from the selections on toggle
+	FVehicleBuild CompareBuilds[2];
+
+	// Keeps the assets of both sides resident while comparing
+	TSharedPtr<FStreamableHandle> CompareLoadHandle;
+
+	int32 CompareSide = 0;
+	bool bComparing = false;
+	bool bCompareStaged = false;
+
+	// Parts shown by PreviewPartByIndex, INDEX_NONE when the slot shows its selection
+	int32 PreviewPartIndices[NumVehiclePartSlots];
+
+	// Local bounds of the last real mesh per slot, used to size the placeholder
+	FBox PlaceholderBounds[NumVehiclePartSlots];
+
+	// Relative transform of each part component before a preview moved it (designer socket offsets included),
+	// valid for the slots in ScrubTransformMask
+	FTransform PreScrubTransforms[NumVehiclePartSlots];
+	uint32 ScrubTransformMask = 0;
+
+	/**
+	 * Assets ApplyBumperMesh last resolved for a slot, by path
+	 */
+	struct FResolvedPartAssets
+	{
+		FSoftObjectPath MeshPath;
+		TWeakObjectPtr<UStaticMesh> Mesh;
+		TArray<FSoftObjectPath> MaterialPaths;
+		TArray<TWeakObjectPtr<UMaterialInterface>> Materials;
+	};
+
+	// Lets re-applying a part, or a part sharing assets with the previous one, skip the lookups
+	FResolvedPartAssets ResolvedPartAssets[NumVehiclePartSlots];
+
+	// Assets pinned per slot (last entry is paint) so the residency manager never evicts what is shown
+	TArray<FSoftObjectPath> PinnedAssets[NumVehiclePartSlots + 1];
+
+	// Keeps the proxies ahead of a scrub loading
+	TSharedPtr<FStreamableHandle> ProxyPrefetchHandle;
+
+	// Chassis state to restore when unbaking
+	UPROPERTY(Transient)
+	TObjectPtr<UStaticMesh> UnbakedChassisMesh;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMaterialInterface>> UnbakedChassisMaterials;
+
+	// Material table of the merge in flight
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMaterialInterface>> PendingMergeMaterials;
+
+	// Incremented by every bake and unbake so late merge results can be recognised
+	uint32 MergeSerial = 0;
+
+	bool bMergePending = false;
+	bool bMergedMeshBaked = false;
 };
@@ -0,0 +1,334 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleMeshMerger.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInterface.h"
+#include "MeshDescription.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
+
+static TAutoConsoleVariable<int32> CVarMergeCacheSize(
+	TEXT("TuneX.Merge.CacheSize"),
+	32,
+	TEXT("Maximum number of merged vehicle meshes kept for reuse"));
+
+bool FVehicleMeshMerger::ExtractSource(const UStaticMeshComponent& Component, const FTransform& ToChassis, TArray<UMaterialInterface*>& InOutMaterials, FVehicleMergeSource& OutSource)
+{
+	check(IsInGameThread());
+
+	const UStaticMesh* Mesh = Component.GetStaticMesh();
+	const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+	if (!RenderData || RenderData->LODResources.Num() == 0)
+	{
+		return false;
+	}
+
+	const FStaticMeshLODResources& LOD = RenderData->LODResources[0];
+	const FPositionVertexBuffer& PositionBuffer = LOD.VertexBuffers.PositionVertexBuffer;
+	const FStaticMeshVertexBuffer& VertexBuffer = LOD.VertexBuffers.StaticMeshVertexBuffer;
+
+	TArray<uint32> MeshIndices;
+	LOD.IndexBuffer.GetCopy(MeshIndices);
+
+	if (!PositionBuffer.GetVertexData() || !VertexBuffer.GetTangentData() || MeshIndices.Num() != LOD.IndexBuffer.GetNumIndices())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMeshMerger: '%s' has no CPU geometry, enable bAllowCPUAccess to merge it"), *Mesh->GetName());
+		return false;
+	}
+
+	const bool bHasUVs = VertexBuffer.GetNumTexCoords() > 0;
+
+	OutSource.Transform = FTransform3f(ToChassis);
+	OutSource.Sections.Reset(LOD.Sections.Num());
+
+	for (const FStaticMeshSection& MeshSection : LOD.Sections)
+	{
+		if (MeshSection.NumTriangles == 0)
+		{
+			continue;
+		}
+
+		FVehicleMergeSection& Section = OutSource.Sections.AddDefaulted_GetRef();
+		Section.MaterialKey = InOutMaterials.AddUnique(Component.GetMaterial(MeshSection.MaterialIndex));
+
+		// Sections reference a contiguous vertex range; rebase it to zero
+		const uint32 FirstVertex = MeshSection.MinVertexIndex;
+		const int32 NumVertices = MeshSection.MaxVertexIndex - MeshSection.MinVertexIndex + 1;
+
+		Section.Positions.SetNumUninitialized(NumVertices);
+		Section.Normals.SetNumUninitialized(NumVertices);
+		Section.UVs.SetNumUninitialized(NumVertices);
+		for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+		{
+			Section.Positions[Vertex] = PositionBuffer.VertexPosition(FirstVertex + Vertex);
+			Section.Normals[Vertex] = FVector3f(VertexBuffer.VertexTangentZ(FirstVertex + Vertex));
+			Section.UVs[Vertex] = bHasUVs ? VertexBuffer.GetVertexUV(FirstVertex + Vertex, 0) : FVector2f::ZeroVector;
+		}
+
+		const int32 NumIndices = MeshSection.NumTriangles * 3;
+		Section.Indices.SetNumUninitialized(NumIndices);
+		for (int32 Index = 0; Index < NumIndices; ++Index)
+		{
+			Section.Indices[Index] = MeshIndices[MeshSection.FirstIndex + Index] - FirstVertex;
+		}
+	}
+
+	return OutSource.Sections.Num() > 0;
+}
+
+FVehicleMergedGeometry FVehicleMeshMerger::Merge(TConstArrayView<FVehicleMergeSource> Sources, int32 NumMaterials)
+{
+	FVehicleMergedGeometry Result;
+	Result.Sections.SetNum(NumMaterials);
+
+	// Size every output section up front so appending never reallocates
+	TArray<int32> NumVertices;
+	TArray<int32> NumIndices;
+	NumVertices.SetNumZeroed(NumMaterials);
+	NumIndices.SetNumZeroed(NumMaterials);
+
+	for (const FVehicleMergeSource& Source : Sources)
+	{
+		for (const FVehicleMergeSection& Section : Source.Sections)
+		{
+			check(Section.MaterialKey >= 0 && Section.MaterialKey < NumMaterials);
+			NumVertices[Section.MaterialKey] += Section.Positions.Num();
+			NumIndices[Section.MaterialKey] += Section.Indices.Num();
+			++Result.NumSourceSections;
+		}
+	}
+
+	for (int32 MaterialKey = 0; MaterialKey < NumMaterials; ++MaterialKey)
+	{
+		FVehicleMergeSection& Merged = Result.Sections[MaterialKey];
+		Merged.MaterialKey = MaterialKey;
+		Merged.Positions.Reserve(NumVertices[MaterialKey]);
+		Merged.Normals.Reserve(NumVertices[MaterialKey]);
+		Merged.UVs.Reserve(NumVertices[MaterialKey]);
+		Merged.Indices.Reserve(NumIndices[MaterialKey]);
+	}
+
+	for (const FVehicleMergeSource& Source : Sources)
+	{
+		const FTransform3f& Transform = Source.Transform;
+		const FVector3f Scale = Transform.GetScale3D();
+		const FVector3f InverseScale(
+			Scale.X != 0.0f ? 1.0f / Scale.X : 0.0f,
+			Scale.Y != 0.0f ? 1.0f / Scale.Y : 0.0f,
+			Scale.Z != 0.0f ? 1.0f / Scale.Z : 0.0f);
+
+		// Mirroring scale flips the winding
+		const bool bFlipWinding = Scale.X * Scale.Y * Scale.Z < 0.0f;
+
+		for (const FVehicleMergeSection& Section : Source.Sections)
+		{
+			FVehicleMergeSection& Merged = Result.Sections[Section.MaterialKey];
+			const uint32 BaseVertex = Merged.Positions.Num();
+
+			for (int32 Vertex = 0; Vertex < Section.Positions.Num(); ++Vertex)
+			{
+				const FVector3f Position = Transform.TransformPosition(Section.Positions[Vertex]);
+				Merged.Positions.Add(Position);
+				Result.Bounds += Position;
+
+				// Normals take the inverse transpose, which for TRS is the rotation times the inverse scale
+				const FVector3f Normal = Transform.GetRotation().RotateVector(Section.Normals[Vertex] * InverseScale);
+				Merged.Normals.Add(Normal.GetSafeNormal());
+			}
+			Merged.UVs.Append(Section.UVs);
+
+			for (int32 Index = 0; Index + 2 < Section.Indices.Num(); Index += 3)
+			{
+				Merged.Indices.Add(BaseVertex + Section.Indices[Index]);
+				Merged.Indices.Add(BaseVertex + Section.Indices[Index + (bFlipWinding ? 2 : 1)]);
+				Merged.Indices.Add(BaseVertex + Section.Indices[Index + (bFlipWinding ? 1 : 2)]);
+			}
+		}
+	}
+
+	Result.Sections.RemoveAll([](const FVehicleMergeSection& Section) { return Section.Indices.Num() == 0; });
+
+	return Result;
+}
+
+void FVehicleMeshMerger::BuildMeshDescription(const FVehicleMergedGeometry& Geometry, FMeshDescription& OutDescription)
+{
+	FStaticMeshAttributes Attributes(OutDescription);
+	Attributes.Register();
+
+	TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+	TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+	TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+	TPolygonGroupAttributesRef<FName> SlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+	UVs.SetNumChannels(1);
+
+	int32 NumVertices = 0;
+	int32 NumTriangles = 0;
+	for (const FVehicleMergeSection& Section : Geometry.Sections)
+	{
+		NumVertices += Section.Positions.Num();
+		NumTriangles += Section.Indices.Num() / 3;
+	}
+
+	OutDescription.ReserveNewVertices(NumVertices);
+	OutDescription.ReserveNewVertexInstances(NumVertices);
+	OutDescription.ReserveNewTriangles(NumTriangles);
+	OutDescription.ReserveNewPolygonGroups(Geometry.Sections.Num());
+
+	TArray<FVertexInstanceID> Instances;
+	for (int32 SectionIndex = 0; SectionIndex < Geometry.Sections.Num(); ++SectionIndex)
+	{
+		const FVehicleMergeSection& Section = Geometry.Sections[SectionIndex];
+
+		const FPolygonGroupID PolygonGroup = OutDescription.CreatePolygonGroup();
+		SlotNames[PolygonGroup] = GetSectionSlotName(SectionIndex);
+
+		Instances.Reset(Section.Positions.Num());
+		for (int32 Vertex = 0; Vertex < Section.Positions.Num(); ++Vertex)
+		{
+			const FVertexID VertexID = OutDescription.CreateVertex();
+			Positions[VertexID] = Section.Positions[Vertex];
+
+			const FVertexInstanceID InstanceID = OutDescription.CreateVertexInstance(VertexID);
+			Normals[InstanceID] = Section.Normals[Vertex];
+			UVs.Set(InstanceID, 0, Section.UVs[Vertex]);
+			Instances.Add(InstanceID);
+		}
+
+		for (int32 Index = 0; Index + 2 < Section.Indices.Num(); Index += 3)
+		{
+			const FVertexInstanceID Triangle[3] = {
+				Instances[Section.Indices[Index]],
+				Instances[Section.Indices[Index + 1]],
+				Instances[Section.Indices[Index + 2]]
+			};
+			OutDescription.CreateTriangle(PolygonGroup, Triangle);
+		}
+	}
+}
+
+UStaticMesh* FVehicleMeshMerger::CreateStaticMesh(const FMeshDescription& Description, TConstArrayView<UMaterialInterface*> SectionMaterials, const UStaticMesh* CollisionSource)
+{
+	check(IsInGameThread());
+
+	UStaticMesh* Mesh = NewObject<UStaticMesh>(GetTransientPackage(), NAME_None, RF_Transient);
+	for (int32 SectionIndex = 0; SectionIndex < SectionMaterials.Num(); ++SectionIndex)
+	{
+		const FName SlotName = GetSectionSlotName(SectionIndex);
+		Mesh->GetStaticMaterials().Add(FStaticMaterial(SectionMaterials[SectionIndex], SlotName, SlotName));
+	}
+
+	// Collision is copied from CollisionSource below rather than built from the merged triangles
+	UStaticMesh::FBuildMeshDescriptionsParams Params;
+	Params.bFastBuild = true;
+	Params.bBuildSimpleCollision = false;
+	Params.bCommitMeshDescription = false;
+	Params.bMarkPackageDirty = false;
+
+	if (!Mesh->BuildFromMeshDescriptions({ &Description }, Params))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehicleMeshMerger: Failed to build merged mesh"));
+		return nullptr;
+	}
+
+	if (const UBodySetup* SourceBodySetup = CollisionSource ? CollisionSource->GetBodySetup() : nullptr)
+	{
+		Mesh->CreateBodySetup();
+		UBodySetup* BodySetup = Mesh->GetBodySetup();
+		BodySetup->CopyBodyPropertiesFrom(SourceBodySetup);
+		BodySetup->CreatePhysicsMeshes();
+	}
+
+	return Mesh;
+}
+
+FName FVehicleMeshMerger::GetSectionSlotName(int32 SectionIndex)
+{
+	return FName(TEXT("MergedSection"), SectionIndex + 1);
+}
+
+FVehicleMergedMeshCache& FVehicleMergedMeshCache::Get()
+{
+	static FVehicleMergedMeshCache Cache;
+	return Cache;
+}
+
+UStaticMesh* FVehicleMergedMeshCache::Find(const FVehicleMergeKey& Key)
+{
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		++NumMisses;
+		return nullptr;
+	}
+
+	++NumHits;
+	Entry->LastUsed = ++UseCounter;
+	return Entry->Mesh;
+}
+
+void FVehicleMergedMeshCache::Add(const FVehicleMergeKey& Key, UStaticMesh* Mesh)
+{
+	if (!Mesh)
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.Mesh = Mesh;
+	Entry.LastUsed = ++UseCounter;
+
+	EvictToLimit(FMath::Max(1, CVarMergeCacheSize.GetValueOnGameThread()));
+}
+
+void FVehicleMergedMeshCache::Reset()
+{
+	Entries.Empty();
+}
+
+void FVehicleMergedMeshCache::EvictToLimit(int32 MaxEntries)
+{
+	// Meshes still on a component stay alive through it; the cache only drops its own reference
+	while (Entries.Num() > MaxEntries)
+	{
+		const FVehicleMergeKey* Oldest = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<FVehicleMergeKey, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUsed;
+				Oldest = &Pair.Key;
+			}
+		}
+
+		Entries.Remove(FVehicleMergeKey(*Oldest));
+		++NumEvictions;
+	}
+}
+
+void FVehicleMergedMeshCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<FVehicleMergeKey, FEntry>& Pair : Entries)
+	{
+		Collector.AddReferencedObject(Pair.Value.Mesh);
+	}
+}
+
+FString FVehicleMergedMeshCache::GetReferencerName() const
+{
+	return TEXT("FVehicleMergedMeshCache");
+}
+
+static FAutoConsoleCommand GVehicleMergeStatsCommand(
+	TEXT("TuneX.Merge.Stats"),
+	TEXT("Prints merged vehicle mesh cache usage"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FVehicleMergedMeshCache& Cache = FVehicleMergedMeshCache::Get();
+		UE_LOG(LogTemp, Display, TEXT("VehicleMeshMerger: %d cached meshes, %llu hits, %llu misses, %llu evictions"),
+			Cache.Num(), Cache.NumHits, Cache.NumMisses, Cache.NumEvictions);
+	}));
@@ -0,0 +1,167 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+#include "UObject/ObjectKey.h"
+#include "VehicleBuild.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+class UStaticMeshComponent;
+struct FMeshDescription;
+
+/**
+ * Triangles of one material, in plain CPU arrays
+ */
+struct FVehicleMergeSection
+{
+	TArray<FVector3f> Positions;
+	TArray<FVector3f> Normals;
+	TArray<FVector2f> UVs;
+	TArray<uint32> Indices;
+
+	// Index into the material table of the merge
+	int32 MaterialKey = INDEX_NONE;
+};
+
+/**
+ * Geometry of one mesh placed in chassis space
+ */
+struct FVehicleMergeSource
+{
+	TArray<FVehicleMergeSection> Sections;
+	FTransform3f Transform = FTransform3f::Identity;
+};
+
+/**
+ * Result of a merge: one section per material
+ */
+struct FVehicleMergedGeometry
+{
+	TArray<FVehicleMergeSection> Sections;
+	FBox3f Bounds = FBox3f(ForceInit);
+	int32 NumSourceSections = 0;
+};
+
+/**
+ * Merges a chassis and its parts into a single mesh
+ * Extraction reads LOD0 render data and must run on the game thread. Merge and BuildMeshDescription
+ * only touch the plain structs above, so they run on any thread and need neither a GPU nor UObjects.
+ */
+class TUNEX_API FVehicleMeshMerger
+{
+public:
+	/**
+	 * Copies LOD0 of a static mesh component into a merge source (game thread)
+	 * Cooked meshes need bAllowCPUAccess, otherwise their CPU copy of the render data is gone.
+	 * @param Component - The component to read; its material overrides are respected
+	 * @param ToChassis - Component transform relative to the chassis
+	 * @param InOutMaterials - Material table shared by all sources of one merge
+	 * @param OutSource - Receives the geometry
+	 * @return true if the geometry could be read
+	 */
+	static bool ExtractSource(const UStaticMeshComponent& Component, const FTransform& ToChassis, TArray<UMaterialInterface*>& InOutMaterials, FVehicleMergeSource& OutSource);
+
+	/**
+	 * Transforms every source into chassis space and consolidates sections sharing a material
+	 * @param Sources - Sources to merge
+	 * @param NumMaterials - Size of the material table the sources refer to
+	 * @return The merged geometry, sections ordered by material key
+	 */
+	static FVehicleMergedGeometry Merge(TConstArrayView<FVehicleMergeSource> Sources, int32 NumMaterials);
+
+	/**
+	 * Converts merged geometry into a mesh description, one polygon group per section
+	 */
+	static void BuildMeshDescription(const FVehicleMergedGeometry& Geometry, FMeshDescription& OutDescription);
+
+	/**
+	 * Creates a transient static mesh from a mesh description (game thread)
+	 * @param Description - Output of BuildMeshDescription
+	 * @param SectionMaterials - Material of each merged section
+	 * @param CollisionSource - Mesh whose simple collision the merged mesh takes over (typically the chassis), or nullptr
+	 * @return The mesh, or nullptr if building failed
+	 */
+	static UStaticMesh* CreateStaticMesh(const FMeshDescription& Description, TConstArrayView<UMaterialInterface*> SectionMaterials, const UStaticMesh* CollisionSource = nullptr);
+
+	/**
+	 * Gets the material slot name of a merged section
+	 */
+	static FName GetSectionSlotName(int32 SectionIndex);
+};
+
+/**
+ * Identifies a merged mesh: the same chassis with the same build of the same catalog merges identically
+ */
+struct FVehicleMergeKey
+{
+	FObjectKey ChassisMesh;
+
+	// FVehicleBuild::GetCanonicalHash of the build and its catalog
+	uint64 BuildHash = 0;
+
+	// Hash of the part transforms relative to the chassis
+	uint32 LayoutHash = 0;
+
+	bool operator==(const FVehicleMergeKey& Other) const
+	{
+		return ChassisMesh == Other.ChassisMesh
+			&& BuildHash == Other.BuildHash
+			&& LayoutHash == Other.LayoutHash;
+	}
+
+	friend uint32 GetTypeHash(const FVehicleMergeKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.ChassisMesh), HashCombine(GetTypeHash(Key.BuildHash), Key.LayoutHash));
+	}
+};
+
+/**
+ * Bounded LRU cache of merged meshes shared by all vehicles
+ * Size limit: TuneX.Merge.CacheSize
+ */
+class TUNEX_API FVehicleMergedMeshCache : public FGCObject
+{
+public:
+	static FVehicleMergedMeshCache& Get();
+
+	/**
+	 * Looks up a merged mesh and marks it as recently used
+	 * @return The mesh, or nullptr on a miss
+	 */
+	UStaticMesh* Find(const FVehicleMergeKey& Key);
+
+	/**
+	 * Adds a merged mesh, evicting the least recently used entries over the size limit
+	 */
+	void Add(const FVehicleMergeKey& Key, UStaticMesh* Mesh);
+
+	/**
+	 * Drops every entry
+	 */
+	void Reset();
+
+	int32 Num() const { return Entries.Num(); }
+
+	uint64 NumHits = 0;
+	uint64 NumMisses = 0;
+	uint64 NumEvictions = 0;
+
+	// FGCObject interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+
+private:
+	struct FEntry
+	{
+		TObjectPtr<UStaticMesh> Mesh;
+		uint64 LastUsed = 0;
+	};
+
+	void EvictToLimit(int32 MaxEntries);
+
+	TMap<FVehicleMergeKey, FEntry> Entries;
+	uint64 UseCounter = 0;
+};
@@ -0,0 +1,142 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleMeshMerger.h"
+#include "MeshDescription.h"
+#include "Misc/AutomationTest.h"
+#include "StaticMeshAttributes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace VehicleMeshMergerTests
+{
+	// One triangle in the XY plane facing +Z, with its first corner at Origin
+	static FVehicleMergeSection MakeTriangle(int32 MaterialKey, const FVector3f& Origin = FVector3f::ZeroVector)
+	{
+		FVehicleMergeSection Section;
+		Section.MaterialKey = MaterialKey;
+		Section.Positions = { Origin, Origin + FVector3f(1.0f, 0.0f, 0.0f), Origin + FVector3f(0.0f, 1.0f, 0.0f) };
+		Section.Normals = { FVector3f(0.0f, 0.0f, 1.0f), FVector3f(0.0f, 0.0f, 1.0f), FVector3f(0.0f, 0.0f, 1.0f) };
+		Section.UVs = { FVector2f(0.0f, 0.0f), FVector2f(1.0f, 0.0f), FVector2f(0.0f, 1.0f) };
+		Section.Indices = { 0, 1, 2 };
+		return Section;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVehicleMeshMergerMergeTest, "TuneX.Merge.ConsolidatesByMaterial",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FVehicleMeshMergerMergeTest::RunTest(const FString& Parameters)
+{
+	using namespace VehicleMeshMergerTests;
+
+	TArray<FVehicleMergeSource> Sources;
+
+	FVehicleMergeSource& Chassis = Sources.AddDefaulted_GetRef();
+	Chassis.Sections.Add(MakeTriangle(0));
+	Chassis.Sections.Add(MakeTriangle(1));
+
+	FVehicleMergeSource& Part = Sources.AddDefaulted_GetRef();
+	Part.Transform = FTransform3f(FQuat4f::Identity, FVector3f(100.0f, 0.0f, 0.0f), FVector3f(2.0f));
+	Part.Sections.Add(MakeTriangle(0));
+
+	// Material 2 is in the table but unused, so it gets no section
+	const FVehicleMergedGeometry Geometry = FVehicleMeshMerger::Merge(Sources, 3);
+
+	TestEqual(TEXT("Source sections"), Geometry.NumSourceSections, 3);
+	if (!TestEqual(TEXT("Merged sections"), Geometry.Sections.Num(), 2))
+	{
+		return false;
+	}
+
+	const FVehicleMergeSection& Shared = Geometry.Sections[0];
+	TestEqual(TEXT("First section material"), Shared.MaterialKey, 0);
+	TestEqual(TEXT("Second section material"), Geometry.Sections[1].MaterialKey, 1);
+	TestEqual(TEXT("Shared section vertices"), Shared.Positions.Num(), 6);
+	TestEqual(TEXT("Shared section normals"), Shared.Normals.Num(), 6);
+	TestEqual(TEXT("Shared section UVs"), Shared.UVs.Num(), 6);
+
+	if (TestEqual(TEXT("Shared section indices"), Shared.Indices.Num(), 6))
+	{
+		// The part's triangle follows the chassis' and refers to its own vertices
+		TestEqual(TEXT("Part index 0"), static_cast<int32>(Shared.Indices[3]), 3);
+		TestEqual(TEXT("Part index 1"), static_cast<int32>(Shared.Indices[4]), 4);
+		TestEqual(TEXT("Part index 2"), static_cast<int32>(Shared.Indices[5]), 5);
+	}
+
+	TestTrue(TEXT("Part placed in chassis space"), Shared.Positions[4].Equals(FVector3f(102.0f, 0.0f, 0.0f)));
+	TestTrue(TEXT("Normals stay unit length under uniform scale"), Shared.Normals[4].Equals(FVector3f(0.0f, 0.0f, 1.0f)));
+	TestTrue(TEXT("Bounds cover every source"), Geometry.Bounds.Max.Equals(FVector3f(102.0f, 2.0f, 0.0f)) && Geometry.Bounds.Min.Equals(FVector3f::ZeroVector));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVehicleMeshMergerMirrorTest, "TuneX.Merge.MirroredPartsKeepFacing",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FVehicleMeshMergerMirrorTest::RunTest(const FString& Parameters)
+{
+	using namespace VehicleMeshMergerTests;
+
+	FVehicleMergeSource Source;
+	Source.Transform = FTransform3f(FQuat4f::Identity, FVector3f::ZeroVector, FVector3f(-1.0f, 1.0f, 1.0f));
+	Source.Sections.Add(MakeTriangle(0));
+	Source.Sections[0].Normals[0] = FVector3f(1.0f, 0.0f, 0.0f);
+
+	const FVehicleMergedGeometry Geometry = FVehicleMeshMerger::Merge(MakeArrayView(&Source, 1), 1);
+	if (!TestEqual(TEXT("Merged sections"), Geometry.Sections.Num(), 1))
+	{
+		return false;
+	}
+
+	const FVehicleMergeSection& Section = Geometry.Sections[0];
+	TestTrue(TEXT("Positions mirrored"), Section.Positions[1].Equals(FVector3f(-1.0f, 0.0f, 0.0f)));
+	TestTrue(TEXT("Normals mirrored"), Section.Normals[0].Equals(FVector3f(-1.0f, 0.0f, 0.0f)));
+
+	// Mirroring reverses the winding; swapping two corners restores it
+	if (TestEqual(TEXT("Indices"), Section.Indices.Num(), 3))
+	{
+		TestEqual(TEXT("Index 0"), static_cast<int32>(Section.Indices[0]), 0);
+		TestEqual(TEXT("Index 1"), static_cast<int32>(Section.Indices[1]), 2);
+		TestEqual(TEXT("Index 2"), static_cast<int32>(Section.Indices[2]), 1);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVehicleMeshMergerDescriptionTest, "TuneX.Merge.BuildsMeshDescription",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FVehicleMeshMergerDescriptionTest::RunTest(const FString& Parameters)
+{
+	using namespace VehicleMeshMergerTests;
+
+	FVehicleMergeSource Source;
+	Source.Sections.Add(MakeTriangle(0));
+	Source.Sections.Add(MakeTriangle(1, FVector3f(0.0f, 0.0f, 5.0f)));
+	Source.Sections.Add(MakeTriangle(0, FVector3f(5.0f, 0.0f, 0.0f)));
+
+	const FVehicleMergedGeometry Geometry = FVehicleMeshMerger::Merge(MakeArrayView(&Source, 1), 2);
+
+	FMeshDescription Description;
+	FVehicleMeshMerger::BuildMeshDescription(Geometry, Description);
+
+	TestEqual(TEXT("Polygon groups"), Description.PolygonGroups().Num(), 2);
+	TestEqual(TEXT("Vertices"), Description.Vertices().Num(), 9);
+	TestEqual(TEXT("Vertex instances"), Description.VertexInstances().Num(), 9);
+	TestEqual(TEXT("Triangles"), Description.Triangles().Num(), 3);
+
+	// Slot names are what CreateStaticMesh binds the section materials to
+	FStaticMeshConstAttributes Attributes(Description);
+	TPolygonGroupAttributesConstRef<FName> SlotNames = Attributes.GetPolygonGroupMaterialSlotNames();
+	int32 GroupIndex = 0;
+	for (const FPolygonGroupID PolygonGroup : Description.PolygonGroups().GetElementIDs())
+	{
+		TestTrue(TEXT("Slot name"), SlotNames[PolygonGroup] == FVehicleMeshMerger::GetSectionSlotName(GroupIndex));
+		TestEqual(TEXT("Triangles per group"), Description.GetPolygonGroupTriangles(PolygonGroup).Num(), GroupIndex == 0 ? 2 : 1);
+		++GroupIndex;
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
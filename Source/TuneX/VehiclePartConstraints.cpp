@@ -0,0 +1,619 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehiclePartConstraints.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+
+namespace VehiclePartConstraints
+{
+	// Builds validated per ParallelFor task
+	static constexpr int32 ValidationBatchSize = 1024;
+
+	static constexpr uint32 AllSlotsMask = (1u << NumVehiclePartSlots) - 1;
+
+	static FVehicleConstraintResult MakeViolation(EVehicleConstraintViolation Violation, int32 Slot, int32 OtherSlot)
+	{
+		FVehicleConstraintResult Result;
+		Result.Violation = Violation;
+		Result.Slot = static_cast<EVehiclePartSlot>(Slot);
+		Result.OtherSlot = static_cast<EVehiclePartSlot>(OtherSlot);
+		return Result;
+	}
+}
+
+FVehiclePartRuleSource FVehiclePartRuleSource::Capture(const UVehicleConfigDataAsset& Config)
+{
+	FVehiclePartRuleSource Source;
+	Source.CatalogName = Config.GetName();
+	Source.ChassisTag = Config.ChassisTag;
+	Source.NumPaints = Config.PaintColors.Num();
+	Source.ContentRevision = Config.GetContentRevision();
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+		TArray<FPart>& SourceParts = Source.Parts[SlotIndex];
+		SourceParts.SetNum(Parts.Num());
+		for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+		{
+			SourceParts[PartIndex].PartID = Parts[PartIndex].PartID;
+			SourceParts[PartIndex].CompatibilityTags = Parts[PartIndex].CompatibilityTags;
+			SourceParts[PartIndex].RequiresPartIDs = Parts[PartIndex].RequiresPartIDs;
+			SourceParts[PartIndex].ExcludesPartIDs = Parts[PartIndex].ExcludesPartIDs;
+		}
+	}
+	return Source;
+}
+
+TSharedRef<const FVehiclePartConstraints, ESPMode::ThreadSafe> FVehiclePartConstraints::Compile(const UVehicleConfigDataAsset& Config)
+{
+	return Compile(FVehiclePartRuleSource::Capture(Config));
+}
+
+TSharedRef<const FVehiclePartConstraints, ESPMode::ThreadSafe> FVehiclePartConstraints::Compile(const FVehiclePartRuleSource& Source)
+{
+	TSharedRef<FVehiclePartConstraints, ESPMode::ThreadSafe> Result = MakeShared<FVehiclePartConstraints, ESPMode::ThreadSafe>();
+	FVehiclePartConstraints& Constraints = *Result;
+
+	// Number every part of every slot, and resolve IDs to those numbers
+	TMap<FName, int32> GlobalByID;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FVehiclePartRuleSource::FPart>& Parts = Source.Parts[SlotIndex];
+		Constraints.SlotOffsets[SlotIndex + 1] = Constraints.SlotOffsets[SlotIndex] + Parts.Num();
+		for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+		{
+			if (!Parts[PartIndex].PartID.IsNone() && !GlobalByID.Contains(Parts[PartIndex].PartID))
+			{
+				GlobalByID.Add(Parts[PartIndex].PartID, Constraints.ToGlobal(SlotIndex, PartIndex));
+			}
+		}
+	}
+	const int32 NumParts = Constraints.SlotOffsets[NumVehiclePartSlots];
+	Constraints.NumPaints = Source.NumPaints;
+	Constraints.ContentRevision = Source.ContentRevision;
+
+	TArray<TArray<int32>> Requires;
+	TArray<TArray<int32>> Excludes;
+	TArray<TArray<int32>> RequiredBy;
+	Requires.SetNum(NumParts);
+	Excludes.SetNum(NumParts);
+	RequiredBy.SetNum(NumParts);
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		const TArray<FVehiclePartRuleSource::FPart>& Parts = Source.Parts[SlotIndex];
+		FVehicleSlotOptionMask& FitMask = Constraints.FitMasks[SlotIndex];
+		FitMask.Init(Parts.Num(), true);
+
+		for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+		{
+			const FVehiclePartRuleSource::FPart& Part = Parts[PartIndex];
+			const int32 Global = Constraints.ToGlobal(SlotIndex, PartIndex);
+
+			if (!Source.ChassisTag.IsNone() && Part.CompatibilityTags.Num() > 0 && !Part.CompatibilityTags.Contains(Source.ChassisTag))
+			{
+				FitMask.Clear(PartIndex);
+			}
+
+			// Resolves a rule's target, rejecting unknown IDs and targets in the part's own slot
+			auto Resolve = [&](FName TargetID, const TCHAR* RuleName) -> int32
+			{
+				const int32* Target = GlobalByID.Find(TargetID);
+				if (!Target)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("VehiclePartConstraints: %s: %s part %s %s unknown part %s"),
+						*Source.CatalogName, LexToString(Slot), *Part.PartID.ToString(), RuleName, *TargetID.ToString());
+					return INDEX_NONE;
+				}
+				if (Constraints.SlotOfGlobal(*Target) == SlotIndex)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("VehiclePartConstraints: %s: %s part %s %s part %s of its own slot"),
+						*Source.CatalogName, LexToString(Slot), *Part.PartID.ToString(), RuleName, *TargetID.ToString());
+					return INDEX_NONE;
+				}
+				return *Target;
+			};
+
+			for (const FName TargetID : Part.RequiresPartIDs)
+			{
+				const int32 Target = Resolve(TargetID, TEXT("requires"));
+				if (Target != INDEX_NONE)
+				{
+					Requires[Global].AddUnique(Target);
+					RequiredBy[Target].AddUnique(Global);
+				}
+			}
+			for (const FName TargetID : Part.ExcludesPartIDs)
+			{
+				const int32 Target = Resolve(TargetID, TEXT("excludes"));
+				if (Target != INDEX_NONE)
+				{
+					Excludes[Global].AddUnique(Target);
+					Excludes[Target].AddUnique(Global);
+				}
+			}
+		}
+	}
+
+	// Flatten into one sorted pool so checks are binary searches over contiguous memory
+	Constraints.Rules.SetNum(NumParts);
+	auto AppendToPool = [&Constraints](TArray<int32>& Targets, int32& OutBegin, int32& OutEnd)
+	{
+		Targets.Sort();
+		OutBegin = Constraints.Pool.Num();
+		Constraints.Pool.Append(Targets);
+		OutEnd = Constraints.Pool.Num();
+	};
+	for (int32 Global = 0; Global < NumParts; ++Global)
+	{
+		FPartRules& PartRules = Constraints.Rules[Global];
+		AppendToPool(Requires[Global], PartRules.RequiresBegin, PartRules.RequiresEnd);
+		AppendToPool(Excludes[Global], PartRules.ExcludesBegin, PartRules.ExcludesEnd);
+		AppendToPool(RequiredBy[Global], PartRules.RequiredByBegin, PartRules.RequiredByEnd);
+		for (const int32 Target : Requires[Global])
+		{
+			PartRules.RequiredSlotMask |= 1u << Constraints.SlotOfGlobal(Target);
+		}
+	}
+	Constraints.bHasPairRules = Constraints.Pool.Num() > 0;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 NumOptions = Constraints.GetNumOptions(static_cast<EVehiclePartSlot>(SlotIndex));
+		for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+		{
+			FVehicleSlotOptionMask& RequirerMask = Constraints.RequirerMasks[SlotIndex][OtherSlotIndex];
+			RequirerMask.Init(NumOptions, false);
+			for (int32 PartIndex = 0; PartIndex < NumOptions; ++PartIndex)
+			{
+				if (Constraints.Rules[Constraints.ToGlobal(SlotIndex, PartIndex)].RequiredSlotMask & (1u << OtherSlotIndex))
+				{
+					RequirerMask.Set(PartIndex);
+				}
+			}
+		}
+	}
+
+	return Result;
+}
+
+int32 FVehiclePartConstraints::SlotOfGlobal(int32 Global) const
+{
+	int32 SlotIndex = 0;
+	while (SlotIndex + 1 < NumVehiclePartSlots && Global >= SlotOffsets[SlotIndex + 1])
+	{
+		++SlotIndex;
+	}
+	return SlotIndex;
+}
+
+bool FVehiclePartConstraints::PoolContains(int32 Begin, int32 End, int32 Global) const
+{
+	return Algo::BinarySearch(TConstArrayView<int32>(Pool.GetData() + Begin, End - Begin), Global) != INDEX_NONE;
+}
+
+bool FVehiclePartConstraints::RequiresSlot(EVehiclePartSlot Slot, int32 Part, EVehiclePartSlot OtherSlot) const
+{
+	return Part >= 0 && Part < GetNumOptions(Slot)
+		&& (Rules[ToGlobal(static_cast<int32>(Slot), Part)].RequiredSlotMask & (1u << static_cast<int32>(OtherSlot))) != 0;
+}
+
+void FVehiclePartConstraints::GetCompatibleOptions(EVehiclePartSlot OtherSlot, int32 Part, EVehiclePartSlot Slot, FVehicleSlotOptionMask& OutMask) const
+{
+	const int32 SlotIndex = static_cast<int32>(Slot);
+	const int32 OtherSlotIndex = static_cast<int32>(OtherSlot);
+	const int32 NumOptions = GetNumOptions(Slot);
+
+	// Options needing something in OtherSlot are out unless they accept Part
+	OutMask.Init(NumOptions, true);
+	OutMask.AndNotWith(RequirerMasks[SlotIndex][OtherSlotIndex]);
+	if (Part < 0 || Part >= GetNumOptions(OtherSlot))
+	{
+		return;
+	}
+
+	const FPartRules& PartRules = Rules[ToGlobal(OtherSlotIndex, Part)];
+	for (int32 PoolIndex = PartRules.RequiredByBegin; PoolIndex < PartRules.RequiredByEnd; ++PoolIndex)
+	{
+		const int32 Option = Pool[PoolIndex] - SlotOffsets[SlotIndex];
+		if (Option >= 0 && Option < NumOptions)
+		{
+			OutMask.Set(Option);
+		}
+	}
+
+	// Part's own requirements on Slot
+	if (PartRules.RequiredSlotMask & (1u << SlotIndex))
+	{
+		FVehicleSlotOptionMask RequiredMask;
+		RequiredMask.Init(NumOptions, false);
+		for (int32 PoolIndex = PartRules.RequiresBegin; PoolIndex < PartRules.RequiresEnd; ++PoolIndex)
+		{
+			const int32 Option = Pool[PoolIndex] - SlotOffsets[SlotIndex];
+			if (Option >= 0 && Option < NumOptions)
+			{
+				RequiredMask.Set(Option);
+			}
+		}
+		OutMask.AndWith(RequiredMask);
+	}
+
+	for (int32 PoolIndex = PartRules.ExcludesBegin; PoolIndex < PartRules.ExcludesEnd; ++PoolIndex)
+	{
+		const int32 Option = Pool[PoolIndex] - SlotOffsets[SlotIndex];
+		if (Option >= 0 && Option < NumOptions)
+		{
+			OutMask.Clear(Option);
+		}
+	}
+}
+
+FVehicleConstraintResult FVehiclePartConstraints::Validate(const FVehicleBuild& Build) const
+{
+	using namespace VehiclePartConstraints;
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 Part = Build.PartIndices[SlotIndex];
+		if (Part == INDEX_NONE)
+		{
+			continue;
+		}
+		if (!FitMasks[SlotIndex].IsValidIndex(Part))
+		{
+			return MakeViolation(EVehicleConstraintViolation::InvalidIndex, SlotIndex, SlotIndex);
+		}
+		if (!FitMasks[SlotIndex].Get(Part))
+		{
+			return MakeViolation(EVehicleConstraintViolation::Fitment, SlotIndex, SlotIndex);
+		}
+	}
+	if (Build.PaintIndex != INDEX_NONE && (Build.PaintIndex < 0 || Build.PaintIndex >= NumPaints))
+	{
+		// Paint has no slot of its own
+		return MakeViolation(EVehicleConstraintViolation::InvalidIndex, NumVehiclePartSlots, NumVehiclePartSlots);
+	}
+
+	if (!bHasPairRules)
+	{
+		return FVehicleConstraintResult();
+	}
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const int32 Part = Build.PartIndices[SlotIndex];
+		if (Part == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FPartRules& PartRules = Rules[ToGlobal(SlotIndex, Part)];
+		for (uint32 RequiredSlots = PartRules.RequiredSlotMask; RequiredSlots != 0; RequiredSlots &= RequiredSlots - 1)
+		{
+			const int32 OtherSlotIndex = FMath::CountTrailingZeros(RequiredSlots);
+			const int32 OtherPart = Build.PartIndices[OtherSlotIndex];
+			if (OtherPart == INDEX_NONE || !PoolContains(PartRules.RequiresBegin, PartRules.RequiresEnd, ToGlobal(OtherSlotIndex, OtherPart)))
+			{
+				return MakeViolation(EVehicleConstraintViolation::Requires, SlotIndex, OtherSlotIndex);
+			}
+		}
+
+		// Excludes are stored both ways, so each pair is checked once
+		if (PartRules.ExcludesBegin != PartRules.ExcludesEnd)
+		{
+			for (int32 OtherSlotIndex = SlotIndex + 1; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+			{
+				const int32 OtherPart = Build.PartIndices[OtherSlotIndex];
+				if (OtherPart != INDEX_NONE && PoolContains(PartRules.ExcludesBegin, PartRules.ExcludesEnd, ToGlobal(OtherSlotIndex, OtherPart)))
+				{
+					return MakeViolation(EVehicleConstraintViolation::Excludes, SlotIndex, OtherSlotIndex);
+				}
+			}
+		}
+	}
+
+	return FVehicleConstraintResult();
+}
+
+int32 FVehiclePartConstraints::ValidateBuilds(TConstArrayView<FVehicleBuild> Builds, TArray<FVehicleConstraintResult>& OutResults) const
+{
+	using namespace VehiclePartConstraints;
+
+	OutResults.SetNum(Builds.Num());
+	const int32 NumBatches = FMath::DivideAndRoundUp(Builds.Num(), ValidationBatchSize);
+	ParallelFor(NumBatches, [this, Builds, &OutResults](int32 BatchIndex)
+	{
+		const int32 Begin = BatchIndex * ValidationBatchSize;
+		const int32 End = FMath::Min(Begin + ValidationBatchSize, Builds.Num());
+		for (int32 BuildIndex = Begin; BuildIndex < End; ++BuildIndex)
+		{
+			OutResults[BuildIndex] = Validate(Builds[BuildIndex]);
+		}
+	});
+
+	int32 NumInvalid = 0;
+	for (const FVehicleConstraintResult& Result : OutResults)
+	{
+		NumInvalid += Result.IsValid() ? 0 : 1;
+	}
+	return NumInvalid;
+}
+
+void FVehiclePartConstraintState::Reset(FVehiclePartConstraintsPtr InConstraints)
+{
+	Constraints = MoveTemp(InConstraints);
+	for (FVehicleSlotOptionMask& ValidMask : ValidMasks)
+	{
+		ValidMask.Init(0, false);
+	}
+	RequiredSlotsMask = 0;
+	bInitialized = false;
+}
+
+uint32 FVehiclePartConstraintState::SetBuild(const FVehicleBuild& Build)
+{
+	using namespace VehiclePartConstraints;
+
+	if (!Constraints)
+	{
+		return 0;
+	}
+
+	const uint32 ChangedSelections = bInitialized ? (Build.GetChangedMask(CurrentBuild) & AllSlotsMask) : AllSlotsMask;
+	if (ChangedSelections == 0)
+	{
+		return 0;
+	}
+	CurrentBuild = Build;
+
+	// A slot's selection only narrows the other slots
+	uint32 DirtySlots = 0;
+	for (uint32 Changed = ChangedSelections; Changed != 0; Changed &= Changed - 1)
+	{
+		const int32 SlotIndex = FMath::CountTrailingZeros(Changed);
+		DirtySlots |= AllSlotsMask & ~(1u << SlotIndex);
+		if (!Constraints->HasPairRules())
+		{
+			continue;
+		}
+		for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+		{
+			if (OtherSlotIndex != SlotIndex)
+			{
+				Constraints->GetCompatibleOptions(static_cast<EVehiclePartSlot>(SlotIndex), Build.PartIndices[SlotIndex],
+					static_cast<EVehiclePartSlot>(OtherSlotIndex), PairMasks[SlotIndex][OtherSlotIndex]);
+			}
+		}
+	}
+	if (!bInitialized)
+	{
+		DirtySlots = AllSlotsMask;
+	}
+
+	RequiredSlotsMask = 0;
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+		{
+			if (Constraints->RequiresSlot(static_cast<EVehiclePartSlot>(SlotIndex), Build.PartIndices[SlotIndex], static_cast<EVehiclePartSlot>(OtherSlotIndex)))
+			{
+				RequiredSlotsMask |= 1u << OtherSlotIndex;
+			}
+		}
+	}
+
+	uint32 ChangedOptions = 0;
+	for (uint32 Dirty = DirtySlots; Dirty != 0; Dirty &= Dirty - 1)
+	{
+		const int32 SlotIndex = FMath::CountTrailingZeros(Dirty);
+		FVehicleSlotOptionMask NewMask = Constraints->GetFittingOptions(static_cast<EVehiclePartSlot>(SlotIndex));
+		if (Constraints->HasPairRules())
+		{
+			for (int32 OtherSlotIndex = 0; OtherSlotIndex < NumVehiclePartSlots; ++OtherSlotIndex)
+			{
+				if (OtherSlotIndex != SlotIndex)
+				{
+					NewMask.AndWith(PairMasks[OtherSlotIndex][SlotIndex]);
+				}
+			}
+		}
+
+		if (!bInitialized || NewMask != ValidMasks[SlotIndex])
+		{
+			ValidMasks[SlotIndex] = MoveTemp(NewMask);
+			ChangedOptions |= 1u << SlotIndex;
+		}
+	}
+
+	bInitialized = true;
+	return ChangedOptions;
+}
+
+bool FVehiclePartConstraintState::IsOptionValid(EVehiclePartSlot Slot, int32 Index) const
+{
+	const FVehicleSlotOptionMask& ValidMask = ValidMasks[static_cast<int32>(Slot)];
+	return ValidMask.IsValidIndex(Index) && ValidMask.Get(Index);
+}
+
+bool FVehiclePartConstraintState::IsBuildValid() const
+{
+	if (!bInitialized)
+	{
+		return false;
+	}
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const EVehiclePartSlot Slot = static_cast<EVehiclePartSlot>(SlotIndex);
+		const int32 Part = CurrentBuild.PartIndices[SlotIndex];
+		if (Part == INDEX_NONE ? !IsEmptyAllowed(Slot) : !IsOptionValid(Slot, Part))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void UVehiclePartConstraintSubsystem::Deinitialize()
+{
+	Compiled.Empty();
+	Super::Deinitialize();
+}
+
+UVehiclePartConstraintSubsystem* UVehiclePartConstraintSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UVehiclePartConstraintSubsystem>() : nullptr;
+}
+
+FVehiclePartConstraintsRef UVehiclePartConstraintSubsystem::GetConstraints(const UVehicleConfigDataAsset& Config)
+{
+	FVehiclePartConstraintsPtr* Existing = Compiled.Find(&Config);
+	if (Existing && (*Existing)->GetContentRevision() == Config.GetContentRevision())
+	{
+		return Existing->ToSharedRef();
+	}
+
+	if (!Existing)
+	{
+		// Drop the rules of catalogs that were unloaded
+		for (auto It = Compiled.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	FVehiclePartConstraintsRef Constraints = FVehiclePartConstraints::Compile(Config);
+	Compiled.Add(&Config, Constraints);
+	return Constraints;
+}
+
+void UVehiclePartConstraintSubsystem::CompileAsync(const UVehicleConfigDataAsset& Config, TFunction<void()> OnCompiled)
+{
+	const FVehiclePartConstraintsPtr* Existing = Compiled.Find(&Config);
+	if (Existing && (*Existing)->GetContentRevision() == Config.GetContentRevision())
+	{
+		if (OnCompiled)
+		{
+			OnCompiled();
+		}
+		return;
+	}
+
+	TWeakObjectPtr<UVehiclePartConstraintSubsystem> WeakThis(this);
+	TWeakObjectPtr<const UVehicleConfigDataAsset> WeakConfig(&Config);
+
+	// The worker only sees a copy; the catalog may be extended again before it is done
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, WeakConfig, Source = FVehiclePartRuleSource::Capture(Config), OnCompiled = MoveTemp(OnCompiled)]() mutable
+	{
+		FVehiclePartConstraintsRef Constraints = FVehiclePartConstraints::Compile(Source);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakConfig, Constraints, OnCompiled = MoveTemp(OnCompiled)]()
+		{
+			UVehiclePartConstraintSubsystem* This = WeakThis.Get();
+			const UVehicleConfigDataAsset* Config = WeakConfig.Get();
+			if (This && Config && Constraints->GetContentRevision() == Config->GetContentRevision())
+			{
+				This->Compiled.Add(Config, Constraints);
+			}
+			if (OnCompiled)
+			{
+				OnCompiled();
+			}
+		});
+	});
+}
+
+TArray<FVehicleConstraintResult> UVehiclePartConstraintSubsystem::ValidateBuilds(UVehicleConfigDataAsset* Config, const TArray<FVehicleBuild>& Builds)
+{
+	TArray<FVehicleConstraintResult> Results;
+	if (Config)
+	{
+		GetConstraints(*Config)->ValidateBuilds(Builds, Results);
+	}
+	return Results;
+}
+
+static FAutoConsoleCommand GVehiclePartConstraintsBenchmarkCommand(
+	TEXT("TuneX.Rules.Benchmark"),
+	TEXT("Measures rule compilation, per-change propagation and batch validation on a synthetic catalog. Usage: TuneX.Rules.Benchmark [NumBuilds=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumBuilds = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000000;
+		constexpr int32 PartsPerSlot = 400;
+
+		// Roughly one part in ten fits another chassis, one in twenty requires parts elsewhere, one in twenty excludes some
+		UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage());
+		Config->ChassisTag = TEXT("bench_chassis");
+		FRandomStream Random(PartsPerSlot);
+		auto RandomPartID = [&Random](int32 OtherThanSlot)
+		{
+			const int32 SlotIndex = (OtherThanSlot + 1 + Random.RandHelper(NumVehiclePartSlots - 1)) % NumVehiclePartSlots;
+			return FName(*FString::Printf(TEXT("bench_%d_%d"), SlotIndex, Random.RandHelper(PartsPerSlot)));
+		};
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			TArray<FCarPart>& Parts = Config->GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+			for (int32 PartIndex = 0; PartIndex < PartsPerSlot; ++PartIndex)
+			{
+				FCarPart& Part = Parts.AddDefaulted_GetRef();
+				Part.PartID = FName(*FString::Printf(TEXT("bench_%d_%d"), SlotIndex, PartIndex));
+				Part.CompatibilityTags.Add(Random.FRand() < 0.1f ? FName(TEXT("other_chassis")) : Config->ChassisTag);
+				if (Random.FRand() < 0.05f)
+				{
+					Part.RequiresPartIDs.Add(RandomPartID(SlotIndex));
+					Part.RequiresPartIDs.Add(RandomPartID(SlotIndex));
+				}
+				if (Random.FRand() < 0.05f)
+				{
+					Part.ExcludesPartIDs.Add(RandomPartID(SlotIndex));
+				}
+			}
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+		const FVehiclePartConstraintsRef Constraints = FVehiclePartConstraints::Compile(*Config);
+		const double CompileMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		constexpr int32 NumChanges = 10000;
+		FVehiclePartConstraintState State;
+		State.Reset(Constraints);
+		FVehicleBuild Build;
+		State.SetBuild(Build);
+		int32 NumValidAfterChange = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Change = 0; Change < NumChanges; ++Change)
+		{
+			Build.PartIndices[Random.RandHelper(NumVehiclePartSlots)] = Random.RandHelper(PartsPerSlot);
+			State.SetBuild(Build);
+			NumValidAfterChange += State.GetValidOptions(EVehiclePartSlot::Spoiler).CountSetBits();
+		}
+		const double ChangeUs = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumChanges;
+
+		TArray<FVehicleBuild> Builds;
+		Builds.SetNum(NumBuilds);
+		for (FVehicleBuild& RandomBuild : Builds)
+		{
+			for (int32& PartIndex : RandomBuild.PartIndices)
+			{
+				PartIndex = Random.RandHelper(PartsPerSlot);
+			}
+		}
+		TArray<FVehicleConstraintResult> Results;
+		StartTime = FPlatformTime::Seconds();
+		const int32 NumInvalid = Constraints->ValidateBuilds(Builds, Results);
+		const double ValidateSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogTemp, Display, TEXT("VehiclePartConstraints: compile %.2f ms for %d parts, %.2f us per slot change (avg %d spoilers valid), %d builds validated in %.1f ms (%.1f M/s), %d invalid"),
+			CompileMs, PartsPerSlot * NumVehiclePartSlots, ChangeUs, NumValidAfterChange / NumChanges,
+			NumBuilds, ValidateSeconds * 1000.0, NumBuilds / FMath::Max(ValidateSeconds, 1e-9) / 1000000.0, NumInvalid);
+
+		Config->MarkAsGarbage();
+	})
+);
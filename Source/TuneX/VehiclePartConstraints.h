@@ -0,0 +1,331 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "VehicleBuild.h"
+#include "VehiclePartConstraints.generated.h"
+
+/**
+ * One bit per option of a part slot
+ */
+struct FVehicleSlotOptionMask
+{
+	void Init(int32 InNumBits, bool bValue)
+	{
+		NumBits = InNumBits;
+		Words.Init(bValue ? ~0ull : 0ull, FMath::DivideAndRoundUp(InNumBits, 64));
+		ClearPadding();
+	}
+
+	bool Get(int32 Index) const { return (Words[Index >> 6] >> (Index & 63)) & 1; }
+	void Set(int32 Index) { Words[Index >> 6] |= 1ull << (Index & 63); }
+	void Clear(int32 Index) { Words[Index >> 6] &= ~(1ull << (Index & 63)); }
+
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < NumBits; }
+	int32 Num() const { return NumBits; }
+
+	void AndWith(const FVehicleSlotOptionMask& Other)
+	{
+		for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+		{
+			Words[WordIndex] &= Other.Words[WordIndex];
+		}
+	}
+
+	void AndNotWith(const FVehicleSlotOptionMask& Other)
+	{
+		for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+		{
+			Words[WordIndex] &= ~Other.Words[WordIndex];
+		}
+	}
+
+	int32 CountSetBits() const
+	{
+		int32 Count = 0;
+		for (const uint64 Word : Words)
+		{
+			Count += FMath::CountBits(Word);
+		}
+		return Count;
+	}
+
+	bool operator==(const FVehicleSlotOptionMask& Other) const { return NumBits == Other.NumBits && Words == Other.Words; }
+	bool operator!=(const FVehicleSlotOptionMask& Other) const { return !(*this == Other); }
+
+private:
+	void ClearPadding()
+	{
+		if (NumBits & 63)
+		{
+			Words.Last() &= (1ull << (NumBits & 63)) - 1;
+		}
+	}
+
+	TArray<uint64, TInlineAllocator<4>> Words;
+	int32 NumBits = 0;
+};
+
+/**
+ * Why a build breaks the rules
+ */
+UENUM(BlueprintType)
+enum class EVehicleConstraintViolation : uint8
+{
+	None,
+	// An index is out of range for the catalog
+	InvalidIndex,
+	// A part does not fit the catalog's ChassisTag
+	Fitment,
+	// A part's RequiresPartIDs are not met in OtherSlot
+	Requires,
+	// Two installed parts exclude each other
+	Excludes,
+};
+
+/**
+ * First rule a build breaks
+ */
+USTRUCT(BlueprintType)
+struct FVehicleConstraintResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Rules")
+	EVehicleConstraintViolation Violation = EVehicleConstraintViolation::None;
+
+	// Slot of the offending part; Count for an out of range paint index
+	UPROPERTY(BlueprintReadOnly, Category = "Rules")
+	EVehiclePartSlot Slot = EVehiclePartSlot::FrontBumper;
+
+	// Slot holding (or lacking) the part the rule refers to
+	UPROPERTY(BlueprintReadOnly, Category = "Rules")
+	EVehiclePartSlot OtherSlot = EVehiclePartSlot::FrontBumper;
+
+	bool IsValid() const { return Violation == EVehicleConstraintViolation::None; }
+};
+
+/**
+ * What compiling a catalog's rules reads from it, copied on the game thread so the rules can compile on a worker
+ * while the catalog keeps changing
+ */
+struct TUNEX_API FVehiclePartRuleSource
+{
+	struct FPart
+	{
+		FName PartID;
+		TArray<FName> CompatibilityTags;
+		TArray<FName> RequiresPartIDs;
+		TArray<FName> ExcludesPartIDs;
+	};
+
+	/**
+	 * Copies the rule inputs of a catalog (game thread)
+	 */
+	static FVehiclePartRuleSource Capture(const UVehicleConfigDataAsset& Config);
+
+	// For warnings
+	FString CatalogName;
+	FName ChassisTag;
+	TArray<FPart> Parts[NumVehiclePartSlots];
+	int32 NumPaints = 0;
+	uint32 ContentRevision = 0;
+};
+
+/**
+ * A catalog's fitment, requires and excludes rules compiled to part indices
+ * Part IDs are resolved once; afterwards checks only compare indices, so builds are validated without
+ * touching the catalog or loading anything, and the compiled rules can be shared across threads.
+ *
+ * Every rule involves at most two slots, so the options left in a slot are the options that fit the chassis,
+ * narrowed by one mask per other slot that only depends on that slot's selection (see FVehiclePartConstraintState).
+ */
+class TUNEX_API FVehiclePartConstraints
+{
+public:
+	/**
+	 * Compiles the rules of a catalog; rules naming unknown IDs or their own slot are dropped with a warning
+	 */
+	static TSharedRef<const FVehiclePartConstraints, ESPMode::ThreadSafe> Compile(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Compiles rules from a copy of a catalog; thread-safe
+	 */
+	static TSharedRef<const FVehiclePartConstraints, ESPMode::ThreadSafe> Compile(const FVehiclePartRuleSource& Source);
+
+	/**
+	 * Checks a build against every rule
+	 * @return The first rule broken, if any
+	 */
+	FVehicleConstraintResult Validate(const FVehicleBuild& Build) const;
+
+	/**
+	 * Checks many builds in parallel
+	 * @param Builds - Builds of this catalog
+	 * @param OutResults - One result per build
+	 * @return Number of invalid builds
+	 */
+	int32 ValidateBuilds(TConstArrayView<FVehicleBuild> Builds, TArray<FVehicleConstraintResult>& OutResults) const;
+
+	/**
+	 * Computes the options of slot Slot compatible with Part installed in slot OtherSlot
+	 * @param Part - Index in OtherSlot, or INDEX_NONE when OtherSlot is empty
+	 */
+	void GetCompatibleOptions(EVehiclePartSlot OtherSlot, int32 Part, EVehiclePartSlot Slot, FVehicleSlotOptionMask& OutMask) const;
+
+	/**
+	 * Gets the options of a slot that fit the chassis
+	 */
+	const FVehicleSlotOptionMask& GetFittingOptions(EVehiclePartSlot Slot) const { return FitMasks[static_cast<int32>(Slot)]; }
+
+	/**
+	 * Checks whether a part needs something in another slot, so that slot cannot be left empty
+	 */
+	bool RequiresSlot(EVehiclePartSlot Slot, int32 Part, EVehiclePartSlot OtherSlot) const;
+
+	int32 GetNumOptions(EVehiclePartSlot Slot) const { return SlotOffsets[static_cast<int32>(Slot) + 1] - SlotOffsets[static_cast<int32>(Slot)]; }
+
+	// Catalog state these rules were compiled from
+	uint32 GetContentRevision() const { return ContentRevision; }
+
+	// Whether any part has a rule; without rules every fitting option stays valid
+	bool HasPairRules() const { return bHasPairRules; }
+
+private:
+	struct FPartRules
+	{
+		// Ranges in Pool: required parts (sorted), excluded parts (sorted, both directions), parts requiring this one
+		int32 RequiresBegin = 0;
+		int32 RequiresEnd = 0;
+		int32 ExcludesBegin = 0;
+		int32 ExcludesEnd = 0;
+		int32 RequiredByBegin = 0;
+		int32 RequiredByEnd = 0;
+
+		// Slots RequiresBegin..End covers
+		uint8 RequiredSlotMask = 0;
+	};
+
+	int32 ToGlobal(int32 Slot, int32 Part) const { return SlotOffsets[Slot] + Part; }
+	int32 SlotOfGlobal(int32 Global) const;
+	bool PoolContains(int32 Begin, int32 End, int32 Global) const;
+
+	// First global index of each slot, plus the total
+	int32 SlotOffsets[NumVehiclePartSlots + 1] = {};
+
+	int32 NumPaints = 0;
+
+	// Indexed by global part index
+	TArray<FPartRules> Rules;
+	TArray<int32> Pool;
+
+	FVehicleSlotOptionMask FitMasks[NumVehiclePartSlots];
+
+	// Options of a slot that require something in another slot (indexed [Slot][OtherSlot])
+	FVehicleSlotOptionMask RequirerMasks[NumVehiclePartSlots][NumVehiclePartSlots];
+
+	uint32 ContentRevision = 0;
+	bool bHasPairRules = false;
+};
+
+using FVehiclePartConstraintsRef = TSharedRef<const FVehiclePartConstraints, ESPMode::ThreadSafe>;
+using FVehiclePartConstraintsPtr = TSharedPtr<const FVehiclePartConstraints, ESPMode::ThreadSafe>;
+
+/**
+ * The options left in every slot for one vehicle's build, kept up to date one slot change at a time
+ * Changing a slot recomputes that slot's mask on each other slot and re-intersects the others; nothing else.
+ */
+class TUNEX_API FVehiclePartConstraintState
+{
+public:
+	/**
+	 * Starts over with new rules; everything is recomputed on the next SetBuild
+	 */
+	void Reset(FVehiclePartConstraintsPtr InConstraints);
+
+	/**
+	 * Moves to a build
+	 * @return Bit per slot whose valid options changed
+	 */
+	uint32 SetBuild(const FVehicleBuild& Build);
+
+	/**
+	 * Gets the options of a slot compatible with the selections of every other slot
+	 */
+	const FVehicleSlotOptionMask& GetValidOptions(EVehiclePartSlot Slot) const { return ValidMasks[static_cast<int32>(Slot)]; }
+
+	bool IsOptionValid(EVehiclePartSlot Slot, int32 Index) const;
+
+	/**
+	 * Checks whether a slot may be left empty (no other selection requires it)
+	 */
+	bool IsEmptyAllowed(EVehiclePartSlot Slot) const { return !(RequiredSlotsMask & (1u << static_cast<int32>(Slot))); }
+
+	/**
+	 * Checks whether every selection is among its slot's valid options
+	 */
+	bool IsBuildValid() const;
+
+	const FVehiclePartConstraintsPtr& GetConstraints() const { return Constraints; }
+
+private:
+	FVehiclePartConstraintsPtr Constraints;
+
+	FVehicleBuild CurrentBuild;
+
+	// What each slot's selection allows in every other slot (indexed [Slot][OtherSlot])
+	FVehicleSlotOptionMask PairMasks[NumVehiclePartSlots][NumVehiclePartSlots];
+
+	FVehicleSlotOptionMask ValidMasks[NumVehiclePartSlots];
+
+	// Slots some selection requires
+	uint32 RequiredSlotsMask = 0;
+
+	bool bInitialized = false;
+};
+
+/**
+ * Compiled rules of every catalog, recompiled when a catalog's content changes
+ *
+ * Benchmark: TuneX.Rules.Benchmark [NumBuilds]
+ */
+UCLASS()
+class TUNEX_API UVehiclePartConstraintSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the subsystem
+	 * @return The subsystem, or nullptr before the engine is up
+	 */
+	static UVehiclePartConstraintSubsystem* Get();
+
+	/**
+	 * Gets the up-to-date rules of a catalog, compiling them as needed
+	 */
+	FVehiclePartConstraintsRef GetConstraints(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Compiles the rules of a catalog on a worker, so the next GetConstraints finds them ready
+	 * The rule inputs are copied first, so the catalog may change or unload meanwhile; a result for an outdated
+	 * revision is dropped.
+	 * @param OnCompiled - Called on the game thread once done, or right away if the rules are up to date
+	 */
+	void CompileAsync(const UVehicleConfigDataAsset& Config, TFunction<void()> OnCompiled = nullptr);
+
+	/**
+	 * Checks builds of a catalog against its rules
+	 * @return One result per build
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Rules")
+	TArray<FVehicleConstraintResult> ValidateBuilds(UVehicleConfigDataAsset* Config, const TArray<FVehicleBuild>& Builds);
+
+private:
+	TMap<TObjectKey<UVehicleConfigDataAsset>, FVehiclePartConstraintsPtr> Compiled;
+};
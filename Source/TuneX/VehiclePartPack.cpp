@@ -0,0 +1,602 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehiclePartPack.h"
+#include "VehicleCatalogSearch.h"
+#include "VehicleDerivedDataCache.h"
+#include "VehicleMasterComponent.h"
+#include "VehiclePartConstraints.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<float> CVarPacksFrameBudgetMs(
+	TEXT("TuneX.Packs.FrameBudgetMs"),
+	2.0f,
+	TEXT("Time per frame spent merging part packs into their catalogs (the append itself always runs whole)"),
+	ECVF_Default);
+
+namespace VehiclePartPack
+{
+	// Entries staged between clock checks
+	static constexpr int32 StageCheckInterval = 64;
+
+	// Entries handed to the search index per call
+	static constexpr int32 IndexBatchSize = 256;
+
+	static constexpr int32 PaintKind = NumVehiclePartSlots;
+}
+
+const TArray<FCarPart>& UVehiclePartPackDataAsset::GetParts(EVehiclePartSlot Slot) const
+{
+	return const_cast<UVehiclePartPackDataAsset*>(this)->GetParts(Slot);
+}
+
+TArray<FCarPart>& UVehiclePartPackDataAsset::GetParts(EVehiclePartSlot Slot)
+{
+	switch (Slot)
+	{
+	case EVehiclePartSlot::RearBumper:	return RearBumpers;
+	case EVehiclePartSlot::SideSkirts:	return SideSkirts;
+	case EVehiclePartSlot::Spoiler:		return Spoilers;
+	case EVehiclePartSlot::Wheels:		return Wheels;
+	default:
+		checkf(Slot == EVehiclePartSlot::FrontBumper, TEXT("Invalid part slot %d"), static_cast<int32>(Slot));
+		return FrontBumpers;
+	}
+}
+
+int32 UVehiclePartPackDataAsset::GetNumEntries() const
+{
+	int32 NumEntries = PaintColors.Num();
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		NumEntries += GetParts(static_cast<EVehiclePartSlot>(SlotIndex)).Num();
+	}
+	return NumEntries;
+}
+
+FVehiclePartPackMerge::FVehiclePartPackMerge(UVehiclePartPackDataAsset& InPack, UVehicleConfigDataAsset& InCatalog)
+	: Pack(&InPack)
+	, Catalog(&InCatalog)
+{
+	ResetStaging();
+}
+
+void FVehiclePartPackMerge::ResetStaging()
+{
+	for (TArray<FCarPart>& Parts : StagedParts)
+	{
+		Parts.Reset();
+	}
+	StagedPaints.Reset();
+	for (TSet<FName>& IDs : StagedIDs)
+	{
+		IDs.Reset();
+	}
+
+	StageKind = 0;
+	StageIndex = 0;
+	NumSkipped = 0;
+	StagedAtRevision = Catalog.IsValid() ? Catalog->GetContentRevision() : 0;
+}
+
+bool FVehiclePartPackMerge::Step(double BudgetSeconds)
+{
+	if (!Pack.IsValid() || !Catalog.IsValid())
+	{
+		Phase = EPhase::Done;
+		return true;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double EndTime = StartTime + BudgetSeconds;
+
+	switch (Phase)
+	{
+	case EPhase::Stage:
+		// Someone else changed the catalog: what was skipped or kept may no longer hold
+		if (StagedAtRevision != Catalog->GetContentRevision())
+		{
+			ResetStaging();
+		}
+		if (StageSlice(EndTime))
+		{
+			Phase = EPhase::Commit;
+		}
+		StageSeconds += FPlatformTime::Seconds() - StartTime;
+		break;
+
+	case EPhase::Commit:
+		if (StagedAtRevision != Catalog->GetContentRevision())
+		{
+			ResetStaging();
+			Phase = EPhase::Stage;
+			break;
+		}
+		Commit();
+		CommitSeconds += FPlatformTime::Seconds() - StartTime;
+		Phase = EPhase::Index;
+		break;
+
+	case EPhase::Index:
+		if (IndexSlice(EndTime))
+		{
+			Phase = EPhase::Done;
+		}
+		IndexSeconds += FPlatformTime::Seconds() - StartTime;
+		break;
+
+	default:
+		break;
+	}
+
+	return Phase == EPhase::Done;
+}
+
+bool FVehiclePartPackMerge::StageSlice(double EndTime)
+{
+	using namespace VehiclePartPack;
+
+	const UVehiclePartPackDataAsset& PackRef = *Pack;
+	const UVehicleConfigDataAsset& CatalogRef = *Catalog;
+
+	// Entries without an ID cannot clash with anything
+	auto IsNewID = [this, &CatalogRef](int32 Kind, FName ID)
+	{
+		if (ID.IsNone())
+		{
+			return true;
+		}
+
+		const bool bInCatalog = Kind == PaintKind
+			? CatalogRef.FindPaintIndex(ID) != INDEX_NONE
+			: CatalogRef.FindPartIndex(static_cast<EVehiclePartSlot>(Kind), ID) != INDEX_NONE;
+		if (bInCatalog)
+		{
+			return false;
+		}
+
+		bool bAlreadyStaged = false;
+		StagedIDs[Kind].Add(ID, &bAlreadyStaged);
+		return !bAlreadyStaged;
+	};
+
+	int32 SinceCheck = 0;
+	while (StageKind <= PaintKind)
+	{
+		const bool bPaint = StageKind == PaintKind;
+		const int32 NumEntries = bPaint ? PackRef.PaintColors.Num() : PackRef.GetParts(static_cast<EVehiclePartSlot>(StageKind)).Num();
+		if (StageIndex >= NumEntries)
+		{
+			++StageKind;
+			StageIndex = 0;
+			continue;
+		}
+
+		if (bPaint)
+		{
+			const FPaintColor& Paint = PackRef.PaintColors[StageIndex];
+			if (IsNewID(StageKind, Paint.PaintID))
+			{
+				StagedPaints.Add(Paint);
+			}
+			else
+			{
+				++NumSkipped;
+			}
+		}
+		else
+		{
+			const FCarPart& Part = PackRef.GetParts(static_cast<EVehiclePartSlot>(StageKind))[StageIndex];
+			if (IsNewID(StageKind, Part.PartID))
+			{
+				StagedParts[StageKind].Add(Part);
+			}
+			else
+			{
+				++NumSkipped;
+			}
+		}
+		++StageIndex;
+
+		if (++SinceCheck == StageCheckInterval)
+		{
+			SinceCheck = 0;
+			if (FPlatformTime::Seconds() >= EndTime)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void FVehiclePartPackMerge::Commit()
+{
+	NumMerged = StagedPaints.Num();
+	for (const TArray<FCarPart>& Parts : StagedParts)
+	{
+		NumMerged += Parts.Num();
+	}
+
+	CommittedFromRevision = Catalog->GetContentRevision();
+	Catalog->AppendContent(StagedParts, StagedPaints);
+
+	for (TSet<FName>& IDs : StagedIDs)
+	{
+		IDs.Empty();
+	}
+}
+
+bool FVehiclePartPackMerge::IndexSlice(double EndTime)
+{
+	UVehicleCatalogSearchSubsystem* Search = GEngine ? GEngine->GetEngineSubsystem<UVehicleCatalogSearchSubsystem>() : nullptr;
+	FVehicleCatalogSearchIndex* Index = Search ? Search->FindIndex(*Catalog) : nullptr;
+
+	// Without an index there is nothing to extend; the first search builds one
+	if (!Index)
+	{
+		return true;
+	}
+
+	for (;;)
+	{
+		const int32 NumAdded = Index->AppendNewEntries(*Catalog, CommittedFromRevision, VehiclePartPack::IndexBatchSize);
+		if (NumAdded <= 0 || Index->IsUpToDate(*Catalog))
+		{
+			return true;
+		}
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+	}
+}
+
+void UVehiclePartPackSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UVehiclePartPackSubsystem::Tick));
+
+	if (!GIsEditor)
+	{
+		PakMountedHandle = FCoreDelegates::GetOnPakFileMounted2().AddWeakLambda(this, [this](const IPakFile&)
+		{
+			bScanPending = true;
+		});
+		ContentPathMountedHandle = FPackageName::OnContentPathMounted().AddWeakLambda(this, [this](const FString&, const FString&)
+		{
+			bScanPending = true;
+		});
+
+		// Packs cooked with the game or mounted before the engine came up
+		bScanPending = true;
+	}
+}
+
+void UVehiclePartPackSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	FCoreDelegates::GetOnPakFileMounted2().Remove(PakMountedHandle);
+	FPackageName::OnContentPathMounted().Remove(ContentPathMountedHandle);
+
+	for (const TSharedPtr<FStreamableHandle>& Handle : LoadHandles)
+	{
+		Handle->CancelHandle();
+	}
+	LoadHandles.Empty();
+
+	CurrentMerge.Reset();
+	MergeQueue.Empty();
+
+	Super::Deinitialize();
+}
+
+UVehiclePartPackSubsystem* UVehiclePartPackSubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UVehiclePartPackSubsystem>() : nullptr;
+}
+
+void UVehiclePartPackSubsystem::RegisterPack(UVehiclePartPackDataAsset* Pack)
+{
+	if (!Pack || Packs.Contains(Pack))
+	{
+		return;
+	}
+
+	if (Pack->TargetCatalog.IsNull())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehiclePartPack: '%s' has no target catalog"), *Pack->GetName());
+		return;
+	}
+
+	Packs.Add(Pack);
+	KnownPackPaths.Add(FSoftObjectPath(Pack));
+
+	if (Pack->TargetCatalog.Get())
+	{
+		QueueMerge(*Pack);
+		return;
+	}
+
+	TWeakObjectPtr<UVehiclePartPackDataAsset> WeakPack(Pack);
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Pack->TargetCatalog.ToSoftObjectPath(),
+		FStreamableDelegate::CreateWeakLambda(this, [this, WeakPack]()
+		{
+			UVehiclePartPackDataAsset* LoadedPack = WeakPack.Get();
+			if (!LoadedPack)
+			{
+				return;
+			}
+
+			if (LoadedPack->TargetCatalog.Get())
+			{
+				QueueMerge(*LoadedPack);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("VehiclePartPack: Could not load catalog '%s' of '%s'"),
+					*LoadedPack->TargetCatalog.ToString(), *LoadedPack->GetName());
+			}
+		}));
+
+	if (Handle.IsValid())
+	{
+		LoadHandles.Add(Handle);
+	}
+}
+
+void UVehiclePartPackSubsystem::QueueMerge(UVehiclePartPackDataAsset& Pack)
+{
+	// Referenced from here on, so the catalog cannot unload and take the merged entries with it
+	ExtendedCatalogs.AddUnique(Pack.TargetCatalog.Get());
+	MergeQueue.Add(&Pack);
+}
+
+void UVehiclePartPackSubsystem::ScanForPacks()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssetsByClass(UVehiclePartPackDataAsset::StaticClass()->GetClassPathName(), Assets, /*bSearchSubClasses*/ true);
+
+	TArray<FSoftObjectPath> NewPaths;
+	for (const FAssetData& Asset : Assets)
+	{
+		const FSoftObjectPath Path = Asset.GetSoftObjectPath();
+		if (!KnownPackPaths.Contains(Path))
+		{
+			KnownPackPaths.Add(Path);
+			NewPaths.Add(Path);
+		}
+	}
+
+	if (NewPaths.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("VehiclePartPack: Found %d new part packs"), NewPaths.Num());
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(NewPaths,
+		FStreamableDelegate::CreateWeakLambda(this, [this, NewPaths]()
+		{
+			for (const FSoftObjectPath& Path : NewPaths)
+			{
+				RegisterPack(Cast<UVehiclePartPackDataAsset>(Path.ResolveObject()));
+			}
+		}));
+
+	if (Handle.IsValid())
+	{
+		LoadHandles.Add(Handle);
+	}
+}
+
+bool UVehiclePartPackSubsystem::IsPackMerged(const UVehiclePartPackDataAsset* Pack) const
+{
+	return Pack && MergedPacks.Contains(Pack);
+}
+
+void UVehiclePartPackSubsystem::NotifyCatalogExtended(UVehicleConfigDataAsset& Catalog)
+{
+	FVehicleDerivedDataCache::Get().InvalidateCatalog(Catalog);
+
+	// Vehicles refresh their valid options from the rules, so let those compile off the game thread first
+	TWeakObjectPtr<UVehicleConfigDataAsset> WeakCatalog(&Catalog);
+	auto NotifyVehicles = [WeakCatalog]()
+	{
+		const UVehicleConfigDataAsset* ExtendedCatalog = WeakCatalog.Get();
+		if (!ExtendedCatalog)
+		{
+			return;
+		}
+
+		for (TObjectIterator<UVehicleMasterComponent> It; It; ++It)
+		{
+			if (It->VehicleConfig == ExtendedCatalog && !It->IsTemplate() && It->HasBegunPlay())
+			{
+				It->NotifyCatalogExtended();
+			}
+		}
+	};
+
+	if (UVehiclePartConstraintSubsystem* Rules = UVehiclePartConstraintSubsystem::Get())
+	{
+		Rules->CompileAsync(Catalog, MoveTemp(NotifyVehicles));
+	}
+	else
+	{
+		NotifyVehicles();
+	}
+}
+
+bool UVehiclePartPackSubsystem::Tick(float DeltaTime)
+{
+	if (bScanPending.exchange(false))
+	{
+		ScanForPacks();
+	}
+
+	LoadHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle)
+	{
+		return Handle->HasLoadCompleted() || Handle->WasCanceled();
+	});
+
+	while (!CurrentMerge && MergeQueue.Num() > 0)
+	{
+		UVehiclePartPackDataAsset* Pack = MergeQueue[0].Get();
+		MergeQueue.RemoveAt(0);
+		if (UVehicleConfigDataAsset* Catalog = Pack ? Pack->TargetCatalog.Get() : nullptr)
+		{
+			CurrentMerge = MakeUnique<FVehiclePartPackMerge>(*Pack, *Catalog);
+		}
+	}
+
+	if (!CurrentMerge)
+	{
+		return true;
+	}
+
+	const FVehiclePartPackMerge::EPhase PhaseBefore = CurrentMerge->GetPhase();
+	const bool bDone = CurrentMerge->Step(FMath::Max(0.0f, CVarPacksFrameBudgetMs.GetValueOnGameThread()) / 1000.0);
+
+	UVehiclePartPackDataAsset* Pack = CurrentMerge->GetPack();
+	UVehicleConfigDataAsset* Catalog = CurrentMerge->GetCatalog();
+
+	if (PhaseBefore == FVehiclePartPackMerge::EPhase::Commit && CurrentMerge->GetPhase() == FVehiclePartPackMerge::EPhase::Index)
+	{
+		MergedPacks.Add(Pack);
+		NotifyCatalogExtended(*Catalog);
+		OnPackMerged.Broadcast(Pack, Catalog);
+	}
+
+	if (bDone)
+	{
+		if (Pack && Catalog)
+		{
+			UE_LOG(LogTemp, Log, TEXT("VehiclePartPack: Merged %d entries of '%s' into '%s' (%d skipped): stage %.2f ms, append %.2f ms, search index %.2f ms"),
+				CurrentMerge->NumMerged, *Pack->GetName(), *Catalog->GetName(), CurrentMerge->NumSkipped,
+				CurrentMerge->StageSeconds * 1000.0, CurrentMerge->CommitSeconds * 1000.0, CurrentMerge->IndexSeconds * 1000.0);
+		}
+		CurrentMerge.Reset();
+	}
+
+	return true;
+}
+
+static FAutoConsoleCommand GVehiclePartPackListCommand(
+	TEXT("TuneX.Packs.List"),
+	TEXT("Lists registered part packs and whether they were merged"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		UVehiclePartPackSubsystem* Subsystem = UVehiclePartPackSubsystem::Get();
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		for (TObjectIterator<UVehiclePartPackDataAsset> It; It; ++It)
+		{
+			if (!It->IsTemplate())
+			{
+				UE_LOG(LogTemp, Display, TEXT("VehiclePartPack: '%s' -> '%s', %d entries, %s"),
+					*It->GetName(), *It->TargetCatalog.ToString(), It->GetNumEntries(), Subsystem->IsPackMerged(*It) ? TEXT("merged") : TEXT("not merged"));
+			}
+		}
+	}));
+
+static FAutoConsoleCommand GVehiclePartPackBenchmarkCommand(
+	TEXT("TuneX.Packs.Benchmark"),
+	TEXT("Measures merging a synthetic part pack into a synthetic catalog against rebuilding its lookups. Usage: TuneX.Packs.Benchmark [CatalogParts=100000] [PackParts=5000]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 NumCatalogParts = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100000;
+		const int32 NumPackParts = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 5000;
+
+		static const TCHAR* Styles[] = { TEXT("Carbon"), TEXT("Street"), TEXT("Race"), TEXT("Aero"), TEXT("Widebody"), TEXT("Classic"), TEXT("Drift"), TEXT("Touring") };
+		static const FName Tags[] = { TEXT("bench_chassis"), TEXT("widebody"), TEXT("street"), TEXT("track") };
+
+		auto MakePart = [](FCarPart& Part, const TCHAR* Prefix, int32 Number)
+		{
+			Part.DisplayName = FString::Printf(TEXT("%s %s %d"), Prefix, Styles[Number % UE_ARRAY_COUNT(Styles)], Number);
+			Part.PartID = FName(*FString::Printf(TEXT("%s_%d"), Prefix, Number));
+			Part.CompatibilityTags.Add(Tags[Number % UE_ARRAY_COUNT(Tags)]);
+			Part.Price = 100.0f + Number % 5000;
+		};
+
+		UVehicleConfigDataAsset* Config = NewObject<UVehicleConfigDataAsset>(GetTransientPackage());
+		for (int32 PartIndex = 0; PartIndex < NumCatalogParts; ++PartIndex)
+		{
+			MakePart(Config->GetParts(static_cast<EVehiclePartSlot>(PartIndex % NumVehiclePartSlots)).AddDefaulted_GetRef(), TEXT("base"), PartIndex);
+		}
+
+		UVehiclePartPackDataAsset* Pack = NewObject<UVehiclePartPackDataAsset>(GetTransientPackage());
+		for (int32 PartIndex = 0; PartIndex < NumPackParts; ++PartIndex)
+		{
+			MakePart(Pack->GetParts(static_cast<EVehiclePartSlot>(PartIndex % NumVehiclePartSlots)).AddDefaulted_GetRef(), TEXT("pack"), PartIndex);
+		}
+
+		// Lookups and search index as a running game would have them
+		double StartTime = FPlatformTime::Seconds();
+		Config->FindPartIndex(EVehiclePartSlot::FrontBumper, NAME_None);
+		const double LookupBuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		UVehicleCatalogSearchSubsystem* Search = GEngine ? GEngine->GetEngineSubsystem<UVehicleCatalogSearchSubsystem>() : nullptr;
+		if (Search)
+		{
+			Search->GetIndex(*Config);
+		}
+
+		const FName SelectedID = Config->Wheels.Last().PartID;
+		const int32 SelectedIndex = Config->Wheels.Num() - 1;
+
+		const double BudgetSeconds = FMath::Max(0.1f, CVarPacksFrameBudgetMs.GetValueOnGameThread()) / 1000.0;
+		FVehiclePartPackMerge Merge(*Pack, *Config);
+		int32 NumSteps = 0;
+		double WorstStepMs = 0.0;
+		bool bDone = false;
+		while (!bDone)
+		{
+			StartTime = FPlatformTime::Seconds();
+			bDone = Merge.Step(BudgetSeconds);
+			WorstStepMs = FMath::Max(WorstStepMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+			++NumSteps;
+		}
+
+		const bool bSelectionKept = Config->Wheels[SelectedIndex].PartID == SelectedID && Config->FindPartIndex(EVehiclePartSlot::Wheels, SelectedID) == SelectedIndex;
+		const bool bPackFound = Config->FindPartIndex(EVehiclePartSlot::Wheels, Pack->Wheels.Last().PartID) != INDEX_NONE
+			&& Config->GetPartsWithTag(EVehiclePartSlot::Wheels, Tags[0]).Num() > 0;
+
+		UE_LOG(LogTemp, Display, TEXT("VehiclePartPack: %d-part pack into %d-part catalog: %d merged, %d steps of %.1f ms budget, worst step %.2f ms"),
+			NumPackParts, NumCatalogParts, Merge.NumMerged, NumSteps, BudgetSeconds * 1000.0, WorstStepMs);
+		UE_LOG(LogTemp, Display, TEXT("VehiclePartPack: stage %.2f ms, append %.2f ms, search index %.2f ms; selection kept: %s, pack parts found: %s"),
+			Merge.StageSeconds * 1000.0, Merge.CommitSeconds * 1000.0, Merge.IndexSeconds * 1000.0,
+			bSelectionKept ? TEXT("yes") : TEXT("no"), bPackFound ? TEXT("yes") : TEXT("no"));
+
+		// What a monolithic catalog update costs instead
+		Config->InvalidateCatalogFingerprint();
+		StartTime = FPlatformTime::Seconds();
+		Config->FindPartIndex(EVehiclePartSlot::FrontBumper, NAME_None);
+		const double LookupRebuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		FVehicleCatalogSearchIndex SearchIndex;
+		StartTime = FPlatformTime::Seconds();
+		SearchIndex.Build(*Config);
+		const double SearchRebuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		FVehiclePartConstraints::Compile(*Config);
+		const double RulesCompileMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		UE_LOG(LogTemp, Display, TEXT("VehiclePartPack: full rebuild: lookups %.2f ms (initial %.2f ms), search index %.2f ms; rules compile (on a worker after a merge) %.2f ms"),
+			LookupRebuildMs, LookupBuildMs, SearchRebuildMs, RulesCompileMs);
+	}));
@@ -0,0 +1,214 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "CarPartData.h"
+#include <atomic>
+#include "VehiclePartPack.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * Parts and paints shipped apart from a vehicle's catalog (downloadable pak, plugin) and merged into it at runtime
+ * Entries are appended after the catalog's own, so existing indices, selections and saved builds stay valid.
+ * Entries whose ID the catalog (or an earlier entry of the pack) already uses are skipped.
+ */
+UCLASS(BlueprintType)
+class TUNEX_API UVehiclePartPackDataAsset : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Catalog this pack extends
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pack")
+	TSoftObjectPtr<UVehicleConfigDataAsset> TargetCatalog;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parts|Bumpers")
+	TArray<FCarPart> FrontBumpers;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parts|Bumpers")
+	TArray<FCarPart> RearBumpers;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parts|Body")
+	TArray<FCarPart> SideSkirts;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parts|Aero")
+	TArray<FCarPart> Spoilers;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Parts|Wheels")
+	TArray<FCarPart> Wheels;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Paint")
+	TArray<FPaintColor> PaintColors;
+
+	/**
+	 * Gets the part list for a slot
+	 */
+	const TArray<FCarPart>& GetParts(EVehiclePartSlot Slot) const;
+	TArray<FCarPart>& GetParts(EVehiclePartSlot Slot);
+
+	int32 GetNumEntries() const;
+};
+
+/**
+ * One pack being merged into its catalog without stalling the frame
+ * Stage copies the pack's new entries a slice at a time; Commit appends them to the catalog in one go (lookups
+ * are extended, not rebuilt); Index then feeds the new entries to the catalog's search index in slices.
+ * If the catalog changes while staging, staging starts over.
+ */
+class TUNEX_API FVehiclePartPackMerge
+{
+public:
+	enum class EPhase : uint8
+	{
+		Stage,
+		Commit,
+		Index,
+		Done,
+	};
+
+	FVehiclePartPackMerge(UVehiclePartPackDataAsset& InPack, UVehicleConfigDataAsset& InCatalog);
+
+	/**
+	 * Advances the merge until the budget is spent or a phase ends (game thread)
+	 * @param BudgetSeconds - Time to spend; the commit always runs whole
+	 * @return true once done (or the pack or catalog went away)
+	 */
+	bool Step(double BudgetSeconds);
+
+	EPhase GetPhase() const { return Phase; }
+	UVehiclePartPackDataAsset* GetPack() const { return Pack.Get(); }
+	UVehicleConfigDataAsset* GetCatalog() const { return Catalog.Get(); }
+
+	// Entries appended, and skipped because their ID was taken
+	int32 NumMerged = 0;
+	int32 NumSkipped = 0;
+
+	// Time spent in each phase
+	double StageSeconds = 0.0;
+	double CommitSeconds = 0.0;
+	double IndexSeconds = 0.0;
+
+private:
+	void ResetStaging();
+	bool StageSlice(double EndTime);
+	void Commit();
+	bool IndexSlice(double EndTime);
+
+	TWeakObjectPtr<UVehiclePartPackDataAsset> Pack;
+	TWeakObjectPtr<UVehicleConfigDataAsset> Catalog;
+
+	EPhase Phase = EPhase::Stage;
+
+	// Next pack entry to stage: kind (slot index, or NumVehiclePartSlots for paints) and index
+	int32 StageKind = 0;
+	int32 StageIndex = 0;
+
+	// Catalog revision staging started from
+	uint32 StagedAtRevision = 0;
+
+	TArray<FCarPart> StagedParts[NumVehiclePartSlots];
+	TArray<FPaintColor> StagedPaints;
+
+	// IDs staged so far (indexed like StageKind), to skip duplicates within the pack
+	TSet<FName> StagedIDs[NumVehiclePartSlots + 1];
+
+	// Catalog revision before the commit
+	uint32 CommittedFromRevision = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnVehiclePartPackMerged, UVehiclePartPackDataAsset*, Pack, UVehicleConfigDataAsset*, Catalog);
+
+/**
+ * Finds part packs as paks and plugins mount and merges them into their catalogs, one at a time
+ * Each frame spends at most TuneX.Packs.FrameBudgetMs on the current merge. After a commit, the catalog's rules
+ * are recompiled on a worker and every vehicle showing the catalog republishes its build.
+ * Catalogs that received a pack are kept loaded so the merged entries are not lost.
+ *
+ * Packs are discovered automatically in game builds only: in the editor, saving a catalog would bake the
+ * merged entries in, so packs there have to be registered explicitly.
+ *
+ * List: TuneX.Packs.List
+ * Benchmark: TuneX.Packs.Benchmark [CatalogParts] [PackParts]; it needs no world, so it also runs headless:
+ *   UnrealEditor-Cmd TuneX.uproject -nullrhi -unattended -stdout -ExecCmds="TuneX.Packs.Benchmark 100000 5000,Quit"
+ */
+UCLASS()
+class TUNEX_API UVehiclePartPackSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the subsystem
+	 * @return The subsystem, or nullptr before the engine is up
+	 */
+	static UVehiclePartPackSubsystem* Get();
+
+	/**
+	 * Queues a pack for merging, loading its catalog first if needed; registering a pack twice does nothing
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Part Packs")
+	void RegisterPack(UVehiclePartPackDataAsset* Pack);
+
+	/**
+	 * Looks for pack assets the asset registry knows about but that were not registered yet
+	 */
+	void ScanForPacks();
+
+	/**
+	 * Checks whether a pack was merged into its catalog
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Part Packs")
+	bool IsPackMerged(const UVehiclePartPackDataAsset* Pack) const;
+
+	// Called after a pack's entries were appended to its catalog
+	UPROPERTY(BlueprintAssignable, Category = "Part Packs")
+	FOnVehiclePartPackMerged OnPackMerged;
+
+	/**
+	 * Makes every system holding data derived from a catalog catch up with an append
+	 */
+	static void NotifyCatalogExtended(UVehicleConfigDataAsset& Catalog);
+
+private:
+	bool Tick(float DeltaTime);
+
+	/**
+	 * Queues a pack whose catalog is loaded
+	 */
+	void QueueMerge(UVehiclePartPackDataAsset& Pack);
+
+	// Registered packs, whether merged, merging or waiting
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UVehiclePartPackDataAsset>> Packs;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UVehiclePartPackDataAsset>> MergedPacks;
+
+	// Catalogs packs were or are about to be merged into
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UVehicleConfigDataAsset>> ExtendedCatalogs;
+
+	// Packs whose catalog is loaded, in merge order
+	TArray<TWeakObjectPtr<UVehiclePartPackDataAsset>> MergeQueue;
+	TUniquePtr<FVehiclePartPackMerge> CurrentMerge;
+
+	// Pack asset paths already seen by ScanForPacks
+	TSet<FSoftObjectPath> KnownPackPaths;
+
+	TArray<TSharedPtr<FStreamableHandle>> LoadHandles;
+
+	// Set when a pak or plugin mounts, possibly off the game thread
+	std::atomic<bool> bScanPending{false};
+
+	FTSTicker::FDelegateHandle TickerHandle;
+	FDelegateHandle PakMountedHandle;
+	FDelegateHandle ContentPathMountedHandle;
+};
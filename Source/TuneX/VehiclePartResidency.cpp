@@ -0,0 +1,255 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehiclePartResidency.h"
+#include "TuneXStats.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_MEMORY_STAT(TEXT("Resident Part Assets"), STAT_TuneX_ResidentPartBytes, STATGROUP_TuneX);
+DECLARE_MEMORY_STAT(TEXT("Part Residency Budget"), STAT_TuneX_ResidencyBudgetBytes, STATGROUP_TuneX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Part Count"), STAT_TuneX_ResidentPartCount, STATGROUP_TuneX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pinned Part Count"), STAT_TuneX_PinnedPartCount, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Residency Hits"), STAT_TuneX_ResidencyHits, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Residency Misses"), STAT_TuneX_ResidencyMisses, STATGROUP_TuneX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Residency Evictions"), STAT_TuneX_ResidencyEvictions, STATGROUP_TuneX);
+
+static TAutoConsoleVariable<int32> CVarResidencyBudgetMB(
+	TEXT("TuneX.Residency.BudgetMB"),
+	512,
+	TEXT("Memory budget (MB) for resident part meshes and materials; pinned assets may exceed it"));
+
+void UVehiclePartResidencySubsystem::Deinitialize()
+{
+	for (TPair<FSoftObjectPath, FEntry>& Pair : Entries)
+	{
+		if (Pair.Value.Handle.IsValid())
+		{
+			Pair.Value.Handle->ReleaseHandle();
+		}
+	}
+	Entries.Empty();
+	ResidentBytes = 0;
+	NumPinned = 0;
+
+	Super::Deinitialize();
+}
+
+UVehiclePartResidencySubsystem* UVehiclePartResidencySubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UVehiclePartResidencySubsystem>() : nullptr;
+}
+
+TSharedPtr<FStreamableHandle> UVehiclePartResidencySubsystem::RequestAsyncLoad(const TArray<FSoftObjectPath>& Paths, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority)
+{
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		RecordAccess(Path);
+	}
+
+	TWeakObjectPtr<UVehiclePartResidencySubsystem> WeakThis(this);
+	FStreamableDelegate TrackThenNotify = FStreamableDelegate::CreateLambda([WeakThis, Paths, OnLoaded]()
+	{
+		if (UVehiclePartResidencySubsystem* This = WeakThis.Get())
+		{
+			for (const FSoftObjectPath& Path : Paths)
+			{
+				This->TrackResident(Path);
+			}
+			This->EnforceBudget();
+		}
+		OnLoaded.ExecuteIfBound();
+	});
+
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, MoveTemp(TrackThenNotify), Priority);
+}
+
+UObject* UVehiclePartResidencySubsystem::LoadSynchronous(const FSoftObjectPath& Path)
+{
+	if (Path.IsNull())
+	{
+		return nullptr;
+	}
+
+	RecordAccess(Path);
+
+	UObject* Object = Path.ResolveObject();
+	if (!Object)
+	{
+		Object = Path.TryLoad();
+	}
+
+	if (Object)
+	{
+		TrackResident(Path);
+		EnforceBudget();
+	}
+
+	return Object;
+}
+
+void UVehiclePartResidencySubsystem::PinAssets(TConstArrayView<FSoftObjectPath> Paths)
+{
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		if (Path.IsNull())
+		{
+			continue;
+		}
+
+		// Pins are counted even before the asset is resident so pin/unpin always pair up
+		FEntry& Entry = Entries.FindOrAdd(Path);
+		if (Entry.PinCount++ == 0)
+		{
+			++NumPinned;
+		}
+		TrackResident(Path);
+	}
+
+	UpdateStats();
+}
+
+void UVehiclePartResidencySubsystem::UnpinAssets(TConstArrayView<FSoftObjectPath> Paths)
+{
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		FEntry* Entry = Entries.Find(Path);
+		if (!Entry || Entry->PinCount == 0)
+		{
+			continue;
+		}
+
+		if (--Entry->PinCount == 0)
+		{
+			--NumPinned;
+
+			// Recently shown parts are the likeliest to come back, so they go to the warm end of the LRU
+			Entry->LastUsed = ++UseCounter;
+		}
+	}
+
+	EnforceBudget();
+}
+
+void UVehiclePartResidencySubsystem::EnforceBudget()
+{
+	const int64 BudgetBytes = static_cast<int64>(FMath::Max(0, CVarResidencyBudgetMB.GetValueOnGameThread())) * 1024 * 1024;
+
+	while (ResidentBytes > BudgetBytes)
+	{
+		const FSoftObjectPath* Coldest = nullptr;
+		uint64 ColdestUse = MAX_uint64;
+		for (const TPair<FSoftObjectPath, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.PinCount == 0 && Pair.Value.LastUsed < ColdestUse)
+			{
+				ColdestUse = Pair.Value.LastUsed;
+				Coldest = &Pair.Key;
+			}
+		}
+
+		// Everything left is pinned
+		if (!Coldest)
+		{
+			break;
+		}
+
+		const FSoftObjectPath Path = *Coldest;
+		FEntry Entry = Entries.FindAndRemoveChecked(Path);
+		if (Entry.Handle.IsValid())
+		{
+			Entry.Handle->ReleaseHandle();
+		}
+
+		ResidentBytes -= Entry.Bytes;
+		EvictedBytes += Entry.Bytes;
+		++NumEvictions;
+		INC_DWORD_STAT(STAT_TuneX_ResidencyEvictions);
+
+		UE_LOG(LogTemp, Verbose, TEXT("VehiclePartResidency: Evicted %s (%.1f KB)"), *Path.ToString(), Entry.Bytes / 1024.0);
+	}
+
+	UpdateStats();
+}
+
+UVehiclePartResidencySubsystem::FEntry* UVehiclePartResidencySubsystem::TrackResident(const FSoftObjectPath& Path)
+{
+	UObject* Object = Path.ResolveObject();
+	if (!Object)
+	{
+		return nullptr;
+	}
+
+	FEntry& Entry = Entries.FindOrAdd(Path);
+	Entry.LastUsed = ++UseCounter;
+
+	if (!Entry.Handle.IsValid())
+	{
+		// Already in memory, so this only takes a reference
+		Entry.Handle = UAssetManager::GetStreamableManager().RequestSyncLoad(Path);
+		Entry.Bytes = static_cast<int64>(Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal));
+		ResidentBytes += Entry.Bytes;
+	}
+
+	return &Entry;
+}
+
+void UVehiclePartResidencySubsystem::RecordAccess(const FSoftObjectPath& Path)
+{
+	if (Path.ResolveObject())
+	{
+		++NumHits;
+		INC_DWORD_STAT(STAT_TuneX_ResidencyHits);
+
+		if (FEntry* Entry = Entries.Find(Path))
+		{
+			Entry->LastUsed = ++UseCounter;
+		}
+	}
+	else
+	{
+		++NumMisses;
+		INC_DWORD_STAT(STAT_TuneX_ResidencyMisses);
+	}
+}
+
+void UVehiclePartResidencySubsystem::UpdateStats() const
+{
+	SET_MEMORY_STAT(STAT_TuneX_ResidentPartBytes, ResidentBytes);
+	SET_MEMORY_STAT(STAT_TuneX_ResidencyBudgetBytes, static_cast<int64>(CVarResidencyBudgetMB.GetValueOnGameThread()) * 1024 * 1024);
+	SET_DWORD_STAT(STAT_TuneX_ResidentPartCount, Entries.Num());
+	SET_DWORD_STAT(STAT_TuneX_PinnedPartCount, NumPinned);
+}
+
+void UVehiclePartResidencySubsystem::Dump() const
+{
+	TArray<TPair<FSoftObjectPath, const FEntry*>> Sorted;
+	for (const TPair<FSoftObjectPath, FEntry>& Pair : Entries)
+	{
+		Sorted.Emplace(Pair.Key, &Pair.Value);
+	}
+	Sorted.Sort([](const TPair<FSoftObjectPath, const FEntry*>& A, const TPair<FSoftObjectPath, const FEntry*>& B)
+	{
+		return A.Value->LastUsed > B.Value->LastUsed;
+	});
+
+	UE_LOG(LogTemp, Display, TEXT("VehiclePartResidency: %d assets, %.1f / %d MB, %d pinned, %llu hits, %llu misses, %llu evictions (%.1f MB)"),
+		Entries.Num(), ResidentBytes / (1024.0 * 1024.0), CVarResidencyBudgetMB.GetValueOnGameThread(), NumPinned,
+		NumHits, NumMisses, NumEvictions, EvictedBytes / (1024.0 * 1024.0));
+
+	for (const TPair<FSoftObjectPath, const FEntry*>& Pair : Sorted)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %8.1f KB  pins %d  %s"), Pair.Value->Bytes / 1024.0, Pair.Value->PinCount, *Pair.Key.ToString());
+	}
+}
+
+static FAutoConsoleCommand GVehiclePartResidencyDumpCommand(
+	TEXT("TuneX.Residency.Dump"),
+	TEXT("Lists resident part assets with their size and pin count, most recently used first"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (const UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get())
+		{
+			Residency->Dump();
+		}
+	}));
@@ -0,0 +1,101 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "VehiclePartResidency.generated.h"
+
+/**
+ * Keeps part meshes and materials resident under a memory budget
+ * Every asset loaded through here is held by its own streamable handle. Assets shown on a vehicle are
+ * pinned; the rest stay in an LRU until the resident total exceeds TuneX.Residency.BudgetMB, at which
+ * point the least recently used are released to GC.
+ *
+ * Stats: stat TuneX, TuneX.Residency.Dump
+ */
+UCLASS()
+class TUNEX_API UVehiclePartResidencySubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the subsystem
+	 * @return The subsystem, or nullptr before the engine is up (e.g. during early commandlet startup)
+	 */
+	static UVehiclePartResidencySubsystem* Get();
+
+	/**
+	 * Streams assets in and keeps them tracked once loaded
+	 * @param Paths - Assets to load
+	 * @param OnLoaded - Called when every asset is resident
+	 * @param Priority - Streaming priority
+	 * @return Handle for the whole request (cancel it to drop the callback)
+	 */
+	TSharedPtr<FStreamableHandle> RequestAsyncLoad(const TArray<FSoftObjectPath>& Paths, FStreamableDelegate OnLoaded, TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+	/**
+	 * Loads an asset on the game thread if it is not resident yet, and tracks it
+	 * @return The asset, or nullptr if it does not exist
+	 */
+	UObject* LoadSynchronous(const FSoftObjectPath& Path);
+
+	/**
+	 * Adds one pin per asset; pinned assets are never evicted
+	 */
+	void PinAssets(TConstArrayView<FSoftObjectPath> Paths);
+
+	/**
+	 * Removes one pin per asset, then evicts if over budget
+	 */
+	void UnpinAssets(TConstArrayView<FSoftObjectPath> Paths);
+
+	/**
+	 * Evicts least recently used unpinned assets until the resident total fits the budget
+	 */
+	void EnforceBudget();
+
+	int64 GetResidentBytes() const { return ResidentBytes; }
+	int32 GetNumResident() const { return Entries.Num(); }
+	int32 GetNumPinned() const { return NumPinned; }
+
+	uint64 NumHits = 0;
+	uint64 NumMisses = 0;
+	uint64 NumEvictions = 0;
+	int64 EvictedBytes = 0;
+
+	/**
+	 * Logs every tracked asset, most recently used first
+	 */
+	void Dump() const;
+
+private:
+	struct FEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		int64 Bytes = 0;
+		int32 PinCount = 0;
+		uint64 LastUsed = 0;
+	};
+
+	/**
+	 * Starts tracking a resident asset, or refreshes its LRU position
+	 */
+	FEntry* TrackResident(const FSoftObjectPath& Path);
+
+	/**
+	 * Counts a request as a hit or a miss
+	 */
+	void RecordAccess(const FSoftObjectPath& Path);
+
+	void UpdateStats() const;
+
+	TMap<FSoftObjectPath, FEntry> Entries;
+	int64 ResidentBytes = 0;
+	int32 NumPinned = 0;
+	uint64 UseCounter = 0;
+};
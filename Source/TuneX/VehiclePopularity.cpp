@@ -0,0 +1,451 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehiclePopularity.h"
+#include "VehiclePartResidency.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static TAutoConsoleVariable<int32> CVarPopularityWarmupPerSlot(
+	TEXT("TuneX.Popularity.WarmupPerSlot"),
+	3,
+	TEXT("Most picked options per slot (and paint) to stream in after a vehicle initializes; 0 disables warm-up"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPopularityIdleFrameMs(
+	TEXT("TuneX.Popularity.IdleFrameMs"),
+	20.0f,
+	TEXT("Warm-up only issues loads on frames shorter than this"),
+	ECVF_Default);
+
+namespace VehiclePopularity
+{
+	static constexpr uint32 Magic = 0x50505854; // "TXPP"
+	static constexpr uint32 FormatVersion = 1;
+
+	static FString GetFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("TuneX") / TEXT("Popularity.txpop");
+	}
+
+	/** Assets of an option that are not in memory yet */
+	static void GatherMissingAssets(const UVehicleConfigDataAsset& Config, int32 SlotBit, int32 Index, TArray<FSoftObjectPath>& OutPaths)
+	{
+		auto AddIfMissing = [&OutPaths](const FSoftObjectPath& Path)
+		{
+			if (!Path.IsNull() && !Path.ResolveObject())
+			{
+				OutPaths.Add(Path);
+			}
+		};
+
+		if (SlotBit == VehicleBuildPaintBit)
+		{
+			if (Config.PaintColors.IsValidIndex(Index))
+			{
+				AddIfMissing(Config.PaintColors[Index].Material.ToSoftObjectPath());
+			}
+			return;
+		}
+
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotBit));
+		if (Parts.IsValidIndex(Index))
+		{
+			AddIfMissing(Parts[Index].MeshAsset.ToSoftObjectPath());
+			for (const TSoftObjectPtr<UMaterialInterface>& Material : Parts[Index].MaterialOverrides)
+			{
+				AddIfMissing(Material.ToSoftObjectPath());
+			}
+		}
+	}
+}
+
+void FVehiclePopularityCounters::GetRanked(int32 SlotBit, int32 MaxCount, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	for (int32 Index = 0; Index < IDs[SlotBit].Num(); ++Index)
+	{
+		if (GetCount(SlotBit, Index) > 0)
+		{
+			OutIndices.Add(Index);
+		}
+	}
+
+	OutIndices.Sort([this, SlotBit](int32 A, int32 B)
+	{
+		const uint32 CountA = GetCount(SlotBit, A);
+		const uint32 CountB = GetCount(SlotBit, B);
+		return CountA != CountB ? CountA > CountB : A < B;
+	});
+	if (OutIndices.Num() > MaxCount)
+	{
+		OutIndices.SetNum(MaxCount);
+	}
+}
+
+void UVehiclePopularitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LoadCounts();
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UVehiclePopularitySubsystem::TickWarmup));
+}
+
+void UVehiclePopularitySubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	if (WarmupHandle.IsValid())
+	{
+		WarmupHandle->CancelHandle();
+		WarmupHandle.Reset();
+	}
+	for (const TPair<FWarmupKey, TSharedPtr<FStreamableHandle>>& Held : HeldWarmupHandles)
+	{
+		Held.Value->ReleaseHandle();
+	}
+	HeldWarmupHandles.Empty();
+	WarmupQueue.Empty();
+
+	SaveCounts();
+	Live.Empty();
+
+	Super::Deinitialize();
+}
+
+UVehiclePopularitySubsystem* UVehiclePopularitySubsystem::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UVehiclePopularitySubsystem>() : nullptr;
+}
+
+TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> UVehiclePopularitySubsystem::GetCounters(const UVehicleConfigDataAsset& Config)
+{
+	check(IsInGameThread());
+
+	if (const TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe>* Existing = Live.Find(&Config))
+	{
+		if ((*Existing)->ContentRevision == Config.GetContentRevision())
+		{
+			return *Existing;
+		}
+
+		// The catalog was edited; keep what was counted under the old layout
+		FoldIntoPersisted(**Existing);
+	}
+
+	TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters = MakeShared<FVehiclePopularityCounters, ESPMode::ThreadSafe>();
+	Counters->CatalogPath = FSoftObjectPath(&Config);
+	Counters->ContentRevision = Config.GetContentRevision();
+
+	const FPersistedCatalog* Saved = Persisted.Find(Counters->CatalogPath);
+	for (int32 SlotBit = 0; SlotBit <= NumVehiclePartSlots; ++SlotBit)
+	{
+		TArray<FName>& IDs = Counters->IDs[SlotBit];
+		if (SlotBit == VehicleBuildPaintBit)
+		{
+			for (const FPaintColor& Paint : Config.PaintColors)
+			{
+				IDs.Add(Paint.PaintID);
+			}
+		}
+		else
+		{
+			for (const FCarPart& Part : Config.GetParts(static_cast<EVehiclePartSlot>(SlotBit)))
+			{
+				IDs.Add(Part.PartID);
+			}
+		}
+
+		Counters->Counts[SlotBit] = MakeUnique<std::atomic<uint32>[]>(IDs.Num());
+		Counters->Prefetched[SlotBit].Init(false, IDs.Num());
+		for (int32 Index = 0; Index < IDs.Num(); ++Index)
+		{
+			const uint32* SavedCount = Saved && !IDs[Index].IsNone() ? Saved->Counts[SlotBit].Find(IDs[Index]) : nullptr;
+			Counters->Counts[SlotBit][Index].store(SavedCount ? *SavedCount : 0, std::memory_order_relaxed);
+		}
+	}
+
+	Live.Add(&Config, Counters);
+	return Counters;
+}
+
+void UVehiclePopularitySubsystem::RecordSelection(const UVehicleConfigDataAsset& Config, int32 SlotBit, int32 Index, bool bWasResident)
+{
+	TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters = GetCounters(Config);
+	Counters->Record(SlotBit, Index);
+
+	++Stats.NumSelections;
+	if (!bWasResident)
+	{
+		++Stats.NumColdSelections;
+		return;
+	}
+
+	++Stats.NumWarmSelections;
+	if (Counters->Prefetched[SlotBit].IsValidIndex(Index) && Counters->Prefetched[SlotBit][Index])
+	{
+		++Stats.NumPrefetchHits;
+	}
+}
+
+void UVehiclePopularitySubsystem::QueueWarmup(const UVehicleConfigDataAsset& Config)
+{
+	const int32 PerSlot = CVarPopularityWarmupPerSlot.GetValueOnGameThread();
+	if (PerSlot <= 0)
+	{
+		return;
+	}
+
+	TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters = GetCounters(Config);
+	TArray<int32> Ranked;
+
+	// Interleave the slots, so every slot's favourite loads before any slot's second choice
+	for (int32 Rank = 0; Rank < PerSlot; ++Rank)
+	{
+		for (int32 SlotBit = 0; SlotBit <= NumVehiclePartSlots; ++SlotBit)
+		{
+			Counters->GetRanked(SlotBit, PerSlot, Ranked);
+			if (!Ranked.IsValidIndex(Rank) || Counters->Prefetched[SlotBit][Ranked[Rank]])
+			{
+				continue;
+			}
+
+			const bool bAlreadyQueued = WarmupQueue.ContainsByPredicate([&](const FWarmupRequest& Request)
+			{
+				return Request.Counters.HasSameObject(&Counters.Get()) && Request.SlotBit == SlotBit && Request.Index == Ranked[Rank];
+			});
+			if (!bAlreadyQueued)
+			{
+				FWarmupRequest& Request = WarmupQueue.AddDefaulted_GetRef();
+				Request.Config = &Config;
+				Request.Counters = Counters;
+				Request.SlotBit = SlotBit;
+				Request.Index = Ranked[Rank];
+			}
+		}
+	}
+}
+
+bool UVehiclePopularitySubsystem::TickWarmup(float DeltaTime)
+{
+	using namespace VehiclePopularity;
+
+	if (WarmupHandle.IsValid())
+	{
+		if (!WarmupHandle->HasLoadCompleted() && !WarmupHandle->WasCanceled())
+		{
+			return true;
+		}
+
+		// The residency manager tracks what was loaded; without it the handle has to keep the assets alive
+		if (!UVehiclePartResidencySubsystem::Get() && WarmupHandle->HasLoadCompleted())
+		{
+			TSharedPtr<FStreamableHandle>& Held = HeldWarmupHandles.FindOrAdd(WarmupHandleKey);
+			if (Held.IsValid())
+			{
+				Held->ReleaseHandle();
+			}
+			Held = WarmupHandle;
+		}
+		WarmupHandle.Reset();
+	}
+
+	if (WarmupQueue.Num() == 0 || FApp::GetDeltaTime() * 1000.0 > CVarPopularityIdleFrameMs.GetValueOnGameThread())
+	{
+		return true;
+	}
+
+	// One option per idle frame
+	while (WarmupQueue.Num() > 0)
+	{
+		const FWarmupRequest Request = WarmupQueue[0];
+		WarmupQueue.RemoveAt(0, 1, /*bAllowShrinking*/ false);
+
+		const UVehicleConfigDataAsset* Config = Request.Config.Get();
+		TSharedPtr<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters = Request.Counters.Pin();
+		if (!Config || !Counters || Counters->ContentRevision != Config->GetContentRevision())
+		{
+			continue;
+		}
+
+		TArray<FSoftObjectPath> Paths;
+		GatherMissingAssets(*Config, Request.SlotBit, Request.Index, Paths);
+		if (Paths.Num() == 0)
+		{
+			// Already in memory; a selection now would not be a warm-up hit
+			continue;
+		}
+
+		Counters->Prefetched[Request.SlotBit][Request.Index] = true;
+		++Stats.NumPrefetched;
+		WarmupHandleKey = FWarmupKey(Counters->CatalogPath, Request.SlotBit, Counters->IDs[Request.SlotBit][Request.Index]);
+
+		if (UVehiclePartResidencySubsystem* Residency = UVehiclePartResidencySubsystem::Get())
+		{
+			WarmupHandle = Residency->RequestAsyncLoad(Paths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+		}
+		else
+		{
+			WarmupHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+		}
+		break;
+	}
+
+	return true;
+}
+
+void UVehiclePopularitySubsystem::FoldIntoPersisted(const FVehiclePopularityCounters& Counters)
+{
+	FPersistedCatalog& Catalog = Persisted.FindOrAdd(Counters.CatalogPath);
+	for (int32 SlotBit = 0; SlotBit <= NumVehiclePartSlots; ++SlotBit)
+	{
+		for (int32 Index = 0; Index < Counters.IDs[SlotBit].Num(); ++Index)
+		{
+			const uint32 Count = Counters.GetCount(SlotBit, Index);
+			if (Count > 0 && !Counters.IDs[SlotBit][Index].IsNone())
+			{
+				// Counters start from the persisted value, so they already include it
+				Catalog.Counts[SlotBit].Add(Counters.IDs[SlotBit][Index], Count);
+			}
+		}
+	}
+}
+
+bool UVehiclePopularitySubsystem::SaveCounts()
+{
+	using namespace VehiclePopularity;
+
+	for (const TPair<TObjectKey<UVehicleConfigDataAsset>, TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe>>& Pair : Live)
+	{
+		FoldIntoPersisted(*Pair.Value);
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	uint32 FileMagic = Magic;
+	uint32 Version = FormatVersion;
+	int32 NumCatalogs = Persisted.Num();
+	int32 NumSlotBits = NumVehiclePartSlots + 1;
+	Writer << FileMagic << Version << NumCatalogs << NumSlotBits;
+
+	for (TPair<FSoftObjectPath, FPersistedCatalog>& Pair : Persisted)
+	{
+		FString CatalogPath = Pair.Key.ToString();
+		Writer << CatalogPath;
+		for (TMap<FName, uint32>& Counts : Pair.Value.Counts)
+		{
+			int32 NumEntries = Counts.Num();
+			Writer << NumEntries;
+			for (TPair<FName, uint32>& Entry : Counts)
+			{
+				// FName indices differ between processes, so store the string
+				FString ID = Entry.Key.ToString();
+				Writer << ID;
+				Writer.SerializeIntPacked(Entry.Value);
+			}
+		}
+	}
+
+	const FString Filename = GetFilename();
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehiclePopularity: Failed to write %s"), *Filename);
+		return false;
+	}
+	return true;
+}
+
+void UVehiclePopularitySubsystem::LoadCounts()
+{
+	using namespace VehiclePopularity;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetFilename(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 FileMagic = 0;
+	uint32 Version = 0;
+	int32 NumCatalogs = 0;
+	int32 NumSlotBits = 0;
+	Reader << FileMagic << Version << NumCatalogs << NumSlotBits;
+	if (Reader.IsError() || FileMagic != Magic || Version != FormatVersion || NumCatalogs < 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehiclePopularity: Ignoring unreadable %s"), *GetFilename());
+		return;
+	}
+
+	for (int32 CatalogIndex = 0; CatalogIndex < NumCatalogs && !Reader.IsError(); ++CatalogIndex)
+	{
+		FString CatalogPath;
+		Reader << CatalogPath;
+		FPersistedCatalog& Catalog = Persisted.FindOrAdd(FSoftObjectPath(CatalogPath));
+
+		for (int32 SlotBit = 0; SlotBit < NumSlotBits && !Reader.IsError(); ++SlotBit)
+		{
+			int32 NumEntries = 0;
+			Reader << NumEntries;
+			for (int32 EntryIndex = 0; EntryIndex < NumEntries && !Reader.IsError(); ++EntryIndex)
+			{
+				FString ID;
+				uint32 Count = 0;
+				Reader << ID;
+				Reader.SerializeIntPacked(Count);
+
+				// Slots added since the file was written start empty; removed ones are dropped
+				if (SlotBit <= NumVehiclePartSlots)
+				{
+					Catalog.Counts[SlotBit].Add(FName(*ID), Count);
+				}
+			}
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VehiclePopularity: %s is truncated, keeping what was read"), *GetFilename());
+	}
+}
+
+static FAutoConsoleCommand GVehiclePopularityStatsCommand(
+	TEXT("TuneX.Popularity.Stats"),
+	TEXT("Logs selection counts and how many selections warm-up had already loaded"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get();
+		if (!Popularity)
+		{
+			return;
+		}
+
+		const FVehiclePopularityStats& Stats = Popularity->GetStats();
+		const double Selections = FMath::Max<double>(1.0, Stats.NumSelections);
+		UE_LOG(LogTemp, Display, TEXT("VehiclePopularity: %llu selections, %llu warm (%.1f%%), %llu cold loads (%.1f%%)"),
+			Stats.NumSelections, Stats.NumWarmSelections, 100.0 * Stats.NumWarmSelections / Selections,
+			Stats.NumColdSelections, 100.0 * Stats.NumColdSelections / Selections);
+		UE_LOG(LogTemp, Display, TEXT("VehiclePopularity: %llu options prefetched, %llu selections hit them (hit rate %.1f%%, %.1f%% of prefetches used)"),
+			Stats.NumPrefetched, Stats.NumPrefetchHits, 100.0 * Stats.NumPrefetchHits / Selections,
+			100.0 * Stats.NumPrefetchHits / FMath::Max<double>(1.0, Stats.NumPrefetched));
+	})
+);
+
+static FAutoConsoleCommand GVehiclePopularitySaveCommand(
+	TEXT("TuneX.Popularity.Save"),
+	TEXT("Writes the selection counts to Saved/TuneX/Popularity.txpop now"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		if (UVehiclePopularitySubsystem* Popularity = UVehiclePopularitySubsystem::Get())
+		{
+			Popularity->SaveCounts();
+		}
+	})
+);
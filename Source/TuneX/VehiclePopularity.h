@@ -0,0 +1,167 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "UObject/ObjectKey.h"
+#include "VehicleBuild.h"
+#include <atomic>
+#include "VehiclePopularity.generated.h"
+
+struct FStreamableHandle;
+
+/**
+ * How often each part and paint of one catalog was picked, across sessions
+ * Increments and reads are lock-free; the layout is fixed when the counters are created, so a catalog
+ * edit gets a fresh set (counts carry over by ID).
+ */
+class TUNEX_API FVehiclePopularityCounters
+{
+public:
+	/**
+	 * Counts one selection
+	 * @param SlotBit - Part slot index, or VehicleBuildPaintBit for paint
+	 * @param Index - Index of the part or paint
+	 */
+	void Record(int32 SlotBit, int32 Index)
+	{
+		if (Index >= 0 && Index < IDs[SlotBit].Num())
+		{
+			Counts[SlotBit][Index].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	uint32 GetCount(int32 SlotBit, int32 Index) const
+	{
+		return Index >= 0 && Index < IDs[SlotBit].Num() ? Counts[SlotBit][Index].load(std::memory_order_relaxed) : 0;
+	}
+
+	/**
+	 * Gets the most picked options of a slot, most popular first; never-picked options are left out
+	 */
+	void GetRanked(int32 SlotBit, int32 MaxCount, TArray<int32>& OutIndices) const;
+
+	const FSoftObjectPath& GetCatalogPath() const { return CatalogPath; }
+
+private:
+	friend class UVehiclePopularitySubsystem;
+
+	FSoftObjectPath CatalogPath;
+	uint32 ContentRevision = 0;
+
+	// Per slot bit: option IDs at creation, their counters, and whether warm-up already loaded them (game thread)
+	TArray<FName> IDs[NumVehiclePartSlots + 1];
+	TUniquePtr<std::atomic<uint32>[]> Counts[NumVehiclePartSlots + 1];
+	TBitArray<> Prefetched[NumVehiclePartSlots + 1];
+};
+
+/**
+ * Selection and warm-up counters of the current session
+ */
+struct FVehiclePopularityStats
+{
+	uint64 NumSelections = 0;
+
+	// Selections whose assets were already in memory, and those of them warm-up had loaded
+	uint64 NumWarmSelections = 0;
+	uint64 NumPrefetchHits = 0;
+
+	// Selections that had to load
+	uint64 NumColdSelections = 0;
+
+	// Options warm-up loaded
+	uint64 NumPrefetched = 0;
+};
+
+/**
+ * Tracks which parts players pick and preloads the favourites
+ * Counts persist in Saved/TuneX/Popularity.txpop, keyed by catalog and ID so they survive catalog reordering.
+ * After a vehicle initializes, the TuneX.Popularity.WarmupPerSlot most picked options of every slot are
+ * streamed in, one at a time and only on frames shorter than TuneX.Popularity.IdleFrameMs.
+ *
+ * Stats: TuneX.Popularity.Stats
+ */
+UCLASS()
+class TUNEX_API UVehiclePopularitySubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Gets the subsystem
+	 * @return The subsystem, or nullptr before the engine is up
+	 */
+	static UVehiclePopularitySubsystem* Get();
+
+	/**
+	 * Gets the counters of a catalog, creating or re-laying them out as needed (game thread)
+	 */
+	TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe> GetCounters(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Counts a player's selection
+	 * @param Config - Catalog of the vehicle
+	 * @param SlotBit - Part slot index, or VehicleBuildPaintBit for paint
+	 * @param Index - Index of the part or paint
+	 * @param bWasResident - Whether its assets were already in memory
+	 */
+	void RecordSelection(const UVehicleConfigDataAsset& Config, int32 SlotBit, int32 Index, bool bWasResident);
+
+	/**
+	 * Queues the most popular options of a catalog for loading on idle frames
+	 */
+	void QueueWarmup(const UVehicleConfigDataAsset& Config);
+
+	/**
+	 * Writes the counts to disk
+	 */
+	bool SaveCounts();
+
+	const FVehiclePopularityStats& GetStats() const { return Stats; }
+
+private:
+	struct FPersistedCatalog
+	{
+		// Count per option ID (indexed by slot bit)
+		TMap<FName, uint32> Counts[NumVehiclePartSlots + 1];
+	};
+
+	struct FWarmupRequest
+	{
+		TWeakObjectPtr<const UVehicleConfigDataAsset> Config;
+		TWeakPtr<FVehiclePopularityCounters, ESPMode::ThreadSafe> Counters;
+		int32 SlotBit = 0;
+		int32 Index = INDEX_NONE;
+	};
+
+	void LoadCounts();
+
+	/**
+	 * Copies live counts into Persisted
+	 */
+	void FoldIntoPersisted(const FVehiclePopularityCounters& Counters);
+
+	bool TickWarmup(float DeltaTime);
+
+	TMap<FSoftObjectPath, FPersistedCatalog> Persisted;
+	TMap<TObjectKey<UVehicleConfigDataAsset>, TSharedRef<FVehiclePopularityCounters, ESPMode::ThreadSafe>> Live;
+
+	// Option a warm-up load is for: catalog, slot bit and option ID, which outlive catalog edits
+	using FWarmupKey = TTuple<FSoftObjectPath, int32, FName>;
+
+	TArray<FWarmupRequest> WarmupQueue;
+	TSharedPtr<FStreamableHandle> WarmupHandle;
+	FWarmupKey WarmupHandleKey;
+
+	// Finished warm-up loads, kept when there is no residency manager to hold them; one per option, so warming
+	// the same option again after a catalog edit replaces its handle
+	TMap<FWarmupKey, TSharedPtr<FStreamableHandle>> HeldWarmupHandles;
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	FVehiclePopularityStats Stats;
+};
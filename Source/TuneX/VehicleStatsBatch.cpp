@@ -0,0 +1,126 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#include "VehicleStatsBatch.h"
+#include "Async/ParallelFor.h"
+
+namespace VehicleStatsBatch
+{
+	// Builds per ParallelFor task; each task walks its chunk once per slot
+	static constexpr int32 ChunkSize = 1024;
+
+	/**
+	 * Evaluates Builds[Start, End) with the table picked per build
+	 * Slot-major loops over contiguous output arrays keep the inner loop free of branches.
+	 */
+	template <typename TableForBuildType>
+	static void ComputeChunk(TableForBuildType&& TableForBuild, TConstArrayView<FVehicleBuild> Builds, int32 Start, int32 End, FVehicleStatsBatch& Out)
+	{
+		float* RESTRICT Weight = Out.Weight.GetData();
+		float* RESTRICT Downforce = Out.Downforce.GetData();
+		float* RESTRICT Drag = Out.Drag.GetData();
+		float* RESTRICT Grip = Out.Grip.GetData();
+
+		for (int32 Index = Start; Index < End; ++Index)
+		{
+			const FVehiclePerformanceStats& Base = TableForBuild(Index).Base;
+			Weight[Index] = Base.Weight;
+			Downforce[Index] = Base.Downforce;
+			Drag[Index] = Base.Drag;
+			Grip[Index] = Base.Grip;
+		}
+
+		for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+		{
+			for (int32 Index = Start; Index < End; ++Index)
+			{
+				const FVehicleStatsTable& Table = TableForBuild(Index);
+				// Checked in every build configuration: a stale or foreign build reads the zero row instead of past the end
+				const int32 PartRow = Builds[Index].PartIndices[SlotIndex] + 1;
+				const int32 Row = static_cast<uint32>(PartRow) < static_cast<uint32>(Table.Weight[SlotIndex].Num()) ? PartRow : 0;
+
+				Weight[Index] += Table.Weight[SlotIndex].GetData()[Row];
+				Downforce[Index] += Table.Downforce[SlotIndex].GetData()[Row];
+				Drag[Index] += Table.Drag[SlotIndex].GetData()[Row];
+				Grip[Index] += Table.Grip[SlotIndex].GetData()[Row];
+			}
+		}
+	}
+}
+
+FVehicleStatsTable FVehicleStatsTable::Build(const UVehicleConfigDataAsset& Config)
+{
+	FVehicleStatsTable Table;
+	Table.Base = Config.BaseStats;
+	Table.ContentRevision = Config.GetContentRevision();
+
+	for (int32 SlotIndex = 0; SlotIndex < NumVehiclePartSlots; ++SlotIndex)
+	{
+		const TArray<FCarPart>& Parts = Config.GetParts(static_cast<EVehiclePartSlot>(SlotIndex));
+
+		Table.Weight[SlotIndex].Reserve(Parts.Num() + 1);
+		Table.Downforce[SlotIndex].Reserve(Parts.Num() + 1);
+		Table.Drag[SlotIndex].Reserve(Parts.Num() + 1);
+		Table.Grip[SlotIndex].Reserve(Parts.Num() + 1);
+
+		// Row 0: nothing installed
+		Table.Weight[SlotIndex].Add(0.0f);
+		Table.Downforce[SlotIndex].Add(0.0f);
+		Table.Drag[SlotIndex].Add(0.0f);
+		Table.Grip[SlotIndex].Add(0.0f);
+
+		for (const FCarPart& Part : Parts)
+		{
+			Table.Weight[SlotIndex].Add(Part.Stats.Weight);
+			Table.Downforce[SlotIndex].Add(Part.Stats.Downforce);
+			Table.Drag[SlotIndex].Add(Part.Stats.Drag);
+			Table.Grip[SlotIndex].Add(Part.Stats.Grip);
+		}
+	}
+
+	return Table;
+}
+
+void FVehicleStatsBatch::SetNum(int32 Num)
+{
+	Weight.SetNumUninitialized(Num, /*bAllowShrinking*/ false);
+	Downforce.SetNumUninitialized(Num, false);
+	Drag.SetNumUninitialized(Num, false);
+	Grip.SetNumUninitialized(Num, false);
+}
+
+FVehiclePerformanceStats FVehicleStatsBatch::Get(int32 Index) const
+{
+	FVehiclePerformanceStats Stats;
+	Stats.Weight = Weight[Index];
+	Stats.Downforce = Downforce[Index];
+	Stats.Drag = Drag[Index];
+	Stats.Grip = Grip[Index];
+	return Stats;
+}
+
+void FVehicleStatsBatch::Compute(const FVehicleStatsTable& Table, TConstArrayView<FVehicleBuild> Builds, FVehicleStatsBatch& Out)
+{
+	Out.SetNum(Builds.Num());
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(Builds.Num(), VehicleStatsBatch::ChunkSize);
+	ParallelFor(TEXT("VehicleStatsBatch"), NumChunks, 1, [&](int32 ChunkIndex)
+	{
+		const int32 Start = ChunkIndex * VehicleStatsBatch::ChunkSize;
+		const int32 End = FMath::Min(Start + VehicleStatsBatch::ChunkSize, Builds.Num());
+		VehicleStatsBatch::ComputeChunk([&Table](int32) -> const FVehicleStatsTable& { return Table; }, Builds, Start, End, Out);
+	});
+}
+
+void FVehicleStatsBatch::Compute(TConstArrayView<const FVehicleStatsTable*> Tables, TConstArrayView<uint16> TableIndices, TConstArrayView<FVehicleBuild> Builds, FVehicleStatsBatch& Out)
+{
+	check(TableIndices.Num() == Builds.Num());
+	Out.SetNum(Builds.Num());
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(Builds.Num(), VehicleStatsBatch::ChunkSize);
+	ParallelFor(TEXT("VehicleStatsBatch"), NumChunks, 1, [&](int32 ChunkIndex)
+	{
+		const int32 Start = ChunkIndex * VehicleStatsBatch::ChunkSize;
+		const int32 End = FMath::Min(Start + VehicleStatsBatch::ChunkSize, Builds.Num());
+		VehicleStatsBatch::ComputeChunk([&Tables, &TableIndices](int32 Index) -> const FVehicleStatsTable& { return *Tables[TableIndices[Index]]; }, Builds, Start, End, Out);
+	});
+}
@@ -0,0 +1,61 @@
+// Copyright TuneX Project. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VehicleBuild.h"
+
+/**
+ * Per-part stats of one catalog, flattened for batch evaluation
+ * Each slot stores its parts at index + 1 with a zero row at 0, so an empty slot (INDEX_NONE) needs no branch.
+ */
+struct TUNEX_API FVehicleStatsTable
+{
+	FVehiclePerformanceStats Base;
+
+	TArray<float> Weight[NumVehiclePartSlots];
+	TArray<float> Downforce[NumVehiclePartSlots];
+	TArray<float> Drag[NumVehiclePartSlots];
+	TArray<float> Grip[NumVehiclePartSlots];
+
+	// Catalog content revision the table was built from; the fingerprint misses stat edits
+	uint32 ContentRevision = 0;
+
+	/**
+	 * Flattens a catalog
+	 */
+	static FVehicleStatsTable Build(const UVehicleConfigDataAsset& Config);
+
+	bool IsUpToDate(const UVehicleConfigDataAsset& Config) const { return ContentRevision == Config.GetContentRevision(); }
+};
+
+/**
+ * Stats of many vehicles, one array per figure
+ */
+struct TUNEX_API FVehicleStatsBatch
+{
+	TArray<float> Weight;
+	TArray<float> Downforce;
+	TArray<float> Drag;
+	TArray<float> Grip;
+
+	void SetNum(int32 Num);
+	int32 Num() const { return Weight.Num(); }
+
+	FVehiclePerformanceStats Get(int32 Index) const;
+
+	/**
+	 * Computes the totals of every build against one catalog, in parallel chunks
+	 * @param Table - The catalog's stats table
+	 * @param Builds - Builds to evaluate; out of range indices count as an empty slot
+	 * @param Out - Resized to Builds.Num()
+	 */
+	static void Compute(const FVehicleStatsTable& Table, TConstArrayView<FVehicleBuild> Builds, FVehicleStatsBatch& Out);
+
+	/**
+	 * Same as above for builds of different catalogs
+	 * @param Tables - One table per catalog
+	 * @param TableIndices - Index into Tables for each build
+	 */
+	static void Compute(TConstArrayView<const FVehicleStatsTable*> Tables, TConstArrayView<uint16> TableIndices, TConstArrayView<FVehicleBuild> Builds, FVehicleStatsBatch& Out);
+};